@@ -8,7 +8,10 @@
 
 #include "KibakoEngine/Core/Debug.h"
 #include "KibakoEngine/Core/Input.h"
+#include "KibakoEngine/Core/InputRecorder.h"
+#include "KibakoEngine/Core/JobSystem.h"
 #include "KibakoEngine/Core/Time.h"
+#include "KibakoEngine/Gameplay/TimerService.h"
 #include "KibakoEngine/Renderer/RendererD3D11.h"
 #include "KibakoEngine/Resources/AssetManager.h"
 #include "KibakoEngine/UI/RmlUIContext.h"
@@ -49,6 +52,27 @@ namespace KibakoEngine {
         [[nodiscard]] Input& InputSys() { return m_input; }
         [[nodiscard]] const Input& InputSys() const { return m_input; }
 
+        // Input capture/replay: while playing back, recorded frames replace live
+        // SDL input (window events are still processed)
+        void StartInputRecording();
+        bool StopInputRecording(const std::filesystem::path& path);
+        bool StartInputPlayback(const std::filesystem::path& path, bool quitWhenFinished = true);
+        void StopInputPlayback();
+        [[nodiscard]] bool IsRecordingInput() const { return m_inputRecorder.IsRecording(); }
+        [[nodiscard]] bool IsPlayingInput() const { return m_playingInput; }
+
+        // 0 = wall clock; > 0 = every frame advances exactly this much
+        // (deterministic replays and benchmarks)
+        void SetFixedFrameDelta(double seconds) { m_fixedFrameDelta = seconds > 0.0 ? seconds : 0.0; }
+        [[nodiscard]] double FixedFrameDelta() const { return m_fixedFrameDelta; }
+
+        // Shared worker pool (hardware threads - 1 workers)
+        [[nodiscard]] JobSystem& Jobs() { return m_jobs; }
+
+        // Updated every frame right after GameServices (scaled + raw clocks)
+        [[nodiscard]] Gameplay::TimerService& Timers() { return m_timers; }
+        [[nodiscard]] const Gameplay::TimerService& Timers() const { return m_timers; }
+
         [[nodiscard]] AssetManager& Assets() { return m_assets; }
         [[nodiscard]] const AssetManager& Assets() const { return m_assets; }
 
@@ -86,6 +110,10 @@ namespace KibakoEngine {
 
         void ResolvePaths();
 
+        bool UpdateInputSource();
+
+        void RenderViews(SpriteBatch2D& batch);
+
     private:
         SDL_Window* m_window = nullptr;
         HWND        m_hwnd = nullptr;
@@ -100,9 +128,18 @@ namespace KibakoEngine {
         bool m_fullscreen = false;
         bool m_running = false;
 
+        double m_frameDelta = 0.0;      // delta used by Run() for the current frame
+        double m_fixedFrameDelta = 0.0;
+        bool   m_playingInput = false;
+        bool   m_quitWhenPlaybackEnds = false;
+
         RendererD3D11 m_renderer;
         Time          m_time;
         Input         m_input;
+        InputRecorder m_inputRecorder;
+        InputPlayback m_inputPlayback;
+        Gameplay::TimerService m_timers;
+        JobSystem     m_jobs;
         AssetManager  m_assets;
         RmlUIContext  m_ui;
 
@@ -115,6 +152,7 @@ namespace KibakoEngine {
 #endif
 
         std::vector<Layer*> m_layers;
+        std::vector<std::size_t> m_viewOrder; // scratch: view indices sorted by order
     };
 
 } // namespace KibakoEngine
\ No newline at end of file
@@ -3,8 +3,9 @@
 
 #include <SDL2/SDL.h>
 
-#include <array>
+#include <bitset>
 #include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -12,9 +13,43 @@
 
 namespace KibakoEngine {
 
+    // Packed keyboard snapshot (one bit per scancode)
+    using KeyboardBits = std::bitset<SDL_NUM_SCANCODES>;
+
+    // Pre-resolved action handle: resolve once with RegisterAction/FindAction,
+    // then every query is a bit test in a flat array (no hashing, no allocation).
+    struct ActionId
+    {
+        static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+        std::uint32_t index = kInvalidIndex;
+
+        [[nodiscard]] bool IsValid() const { return index != kInvalidIndex; }
+        [[nodiscard]] bool operator==(const ActionId&) const = default;
+    };
+
+    // Raw per-frame device state; actions are derived from it, so replaying
+    // frames through Input::ApplyFrame reproduces action states exactly.
+    struct InputFrame
+    {
+        KeyboardBits keys;
+
+        int32_t  mouseX = 0;
+        int32_t  mouseY = 0;
+        uint32_t mouseButtons = 0;
+        int32_t  wheelX = 0;
+        int32_t  wheelY = 0;
+        uint32_t textChar = 0;
+
+        uint32_t padButtons = 0;
+        float    padAxes[SDL_CONTROLLER_AXIS_MAX]{};
+    };
+
     class Input
     {
     public:
+        static constexpr float kDefaultAxisThreshold = 0.25f;
+
         Input();
 
         // Called at the beginning of the frame (before event pumping)
@@ -29,6 +64,17 @@ namespace KibakoEngine {
         // Called at the end of the frame (after rendering)
         void EndFrame();
 
+        // Closes opened game controllers (call before SDL_Quit)
+        void Shutdown();
+
+        // Snapshot of the state produced by the last AfterEvents()/ApplyFrame()
+        [[nodiscard]] InputFrame CaptureFrame() const;
+
+        // Replaces AfterEvents() when input comes from a recording: takes the
+        // device state from the frame instead of SDL and updates actions.
+        // Does not touch SDL, so it also works without a window.
+        void ApplyFrame(const InputFrame& frame);
+
         // ------------------------------------------------------------
         // Low-level keyboard
         // ------------------------------------------------------------
@@ -36,6 +82,8 @@ namespace KibakoEngine {
         [[nodiscard]] bool KeyPressed(SDL_Scancode scancode) const;
         [[nodiscard]] bool KeyReleased(SDL_Scancode scancode) const;
 
+        [[nodiscard]] const KeyboardBits& Keys() const { return m_keys; }
+
         // ------------------------------------------------------------
         // Mouse
         // ------------------------------------------------------------
@@ -51,25 +99,61 @@ namespace KibakoEngine {
         // Single ASCII char (32..126) captured this frame, 0 if none
         [[nodiscard]] uint32_t TextChar() const { return m_textChar; }
 
+        // ------------------------------------------------------------
+        // Gamepad (all connected controllers are merged)
+        // ------------------------------------------------------------
+        [[nodiscard]] bool  GamepadButtonDown(SDL_GameControllerButton button) const;
+        [[nodiscard]] float GamepadAxis(SDL_GameControllerAxis axis) const; // -1..+1
+
         // ------------------------------------------------------------
         // Input Actions (ergonomic layer)
         // ------------------------------------------------------------
-        void BindAction(std::string action, SDL_Scancode scancode);
+
+        // Returns the existing handle or creates an unbound action
+        ActionId RegisterAction(std::string_view action);
+        [[nodiscard]] ActionId FindAction(std::string_view action) const;
+        [[nodiscard]] const std::string& ActionName(ActionId id) const;
+
+        // Any bound key triggers the action
+        ActionId BindAction(std::string_view action, SDL_Scancode scancode);
+
+        // Every key of the chord must be held (e.g. { LCTRL, S })
+        ActionId BindChord(std::string_view action, std::initializer_list<SDL_Scancode> keys);
+
+        ActionId BindGamepadButton(std::string_view action, SDL_GameControllerButton button);
+
+        // direction selects the half of the axis (+1 / -1); the action is down
+        // once the deflection exceeds threshold and ActionValue reports it 0..1
+        ActionId BindGamepadAxis(std::string_view action,
+            SDL_GameControllerAxis axis,
+            float direction,
+            float threshold = kDefaultAxisThreshold);
+
+        // Handles stay valid: only bindings and states are cleared
+        void ClearActionBindings(ActionId id);
         void ClearActionBindings(std::string_view action);
         void ClearAllActionBindings();
 
+        [[nodiscard]] bool  ActionDown(ActionId id) const;
+        [[nodiscard]] bool  ActionPressed(ActionId id) const;
+        [[nodiscard]] bool  ActionReleased(ActionId id) const;
+        [[nodiscard]] float ActionValue(ActionId id) const; // 0..1 (1 for digital bindings)
+
+        // Returns -1..+1 (e.g. Left/Right), analog when bound to an axis
+        [[nodiscard]] float ActionAxis1D(ActionId negativeAction, ActionId positiveAction) const;
+
+        // Name-based variants (one hash lookup per call; prefer ActionId in hot code)
         [[nodiscard]] bool ActionDown(std::string_view action) const;
         [[nodiscard]] bool ActionPressed(std::string_view action) const;
         [[nodiscard]] bool ActionReleased(std::string_view action) const;
 
-        // Returns -1..+1 (e.g. Left/Right)
         [[nodiscard]] float ActionAxis1D(std::string_view negativeAction,
             std::string_view positiveAction) const;
 
     private:
         // --- Low-level state
-        const uint8_t* m_keyboard = nullptr;
-        std::array<uint8_t, SDL_NUM_SCANCODES> m_prevKeyboard{};
+        KeyboardBits m_keys;
+        KeyboardBits m_prevKeys;
 
         int      m_mouseX = 0;
         int      m_mouseY = 0;
@@ -80,13 +164,26 @@ namespace KibakoEngine {
 
         uint32_t m_textChar = 0;
 
-        // --- Actions
-        struct ActionState
+        // --- Gamepad
+        std::vector<SDL_GameController*> m_controllers;
+        uint32_t m_padButtons = 0;
+        float    m_padAxes[SDL_CONTROLLER_AXIS_MAX]{};
+
+        // --- Actions (bindings are only touched at bind time)
+        struct AxisBinding
+        {
+            SDL_GameControllerAxis axis = SDL_CONTROLLER_AXIS_INVALID;
+            float direction = 1.0f;
+            float threshold = kDefaultAxisThreshold;
+        };
+
+        struct ActionBindings
         {
-            std::vector<SDL_Scancode> bindings;
-            bool down = false;
-            bool pressed = false;
-            bool released = false;
+            std::string               name;
+            KeyboardBits              anyKeys;    // single-key bindings
+            std::vector<KeyboardBits> chords;     // all keys of a chord required
+            uint32_t                  padButtons = 0;
+            std::vector<AxisBinding>  axes;
         };
 
         // Heterogeneous lookup (string + string_view) without MSVC ambiguity
@@ -111,10 +208,22 @@ namespace KibakoEngine {
             }
         };
 
-        std::unordered_map<std::string, ActionState, TransparentHash, TransparentEq> m_actions;
+        // Name -> index, only used when resolving handles
+        std::unordered_map<std::string, uint32_t, TransparentHash, TransparentEq> m_actionLookup;
+
+        std::vector<ActionBindings> m_bindings;
+
+        // Flat per-frame state, one bit per action
+        std::vector<uint64_t> m_actionDown;
+        std::vector<uint64_t> m_actionPrevDown;
+        std::vector<float>    m_actionValues;
 
     private:
         void UpdateActions();
+        void OpenController(int deviceIndex);
+        void CloseController(SDL_JoystickID instanceId);
+
+        [[nodiscard]] bool TestActionBit(const std::vector<uint64_t>& bits, ActionId id) const;
     };
 
-} // namespace KibakoEngine
\ No newline at end of file
+} // namespace KibakoEngine
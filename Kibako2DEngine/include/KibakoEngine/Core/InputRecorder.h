@@ -0,0 +1,77 @@
+// Records per-frame input into a compact delta stream and plays it back
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "KibakoEngine/Core/Input.h"
+
+namespace KibakoEngine {
+
+    // Stream layout (one record per frame):
+    //   u8 flags                  which fields changed since the previous frame
+    //   [delta]   varint          frame delta in microseconds
+    //   [keys]    varint count + varint gaps between toggled scancodes (ascending)
+    //   [mouse]   zigzag dx, dy
+    //   [buttons] varint mask
+    //   [wheel]   zigzag x, y
+    //   [text]    varint char
+    //   [pad]     varint button mask
+    //   [axes]    u8 axis mask + zigzag delta of each changed axis (int16 scale)
+    // Unchanged frames therefore cost a single byte.
+    class InputRecorder
+    {
+    public:
+        void Begin();
+        void End();
+
+        // Appends one frame (call once per frame, after input is final)
+        void Record(const InputFrame& frame, double deltaSeconds);
+
+        [[nodiscard]] bool IsRecording() const { return m_recording; }
+        [[nodiscard]] std::uint32_t FrameCount() const { return m_frameCount; }
+        [[nodiscard]] const std::vector<std::uint8_t>& Stream() const { return m_stream; }
+
+        [[nodiscard]] bool SaveToFile(const std::filesystem::path& path) const;
+
+    private:
+        std::vector<std::uint8_t> m_stream;
+        InputFrame    m_previous{};
+        std::uint32_t m_previousDeltaMicros = 0;
+        std::uint32_t m_frameCount = 0;
+        bool          m_recording = false;
+    };
+
+    // Decodes a recorded stream frame by frame. Pure CPU, no SDL/window needed,
+    // so a headless harness can feed Input::ApplyFrame directly.
+    class InputPlayback
+    {
+    public:
+        [[nodiscard]] bool LoadFromFile(const std::filesystem::path& path);
+        void LoadFromMemory(std::span<const std::uint8_t> stream, std::uint32_t frameCount);
+        void Unload();
+
+        void Rewind();
+
+        // Returns false when the stream is exhausted (or corrupt)
+        [[nodiscard]] bool Next(InputFrame& outFrame, double& outDeltaSeconds);
+
+        [[nodiscard]] bool IsLoaded() const { return m_loaded; }
+        [[nodiscard]] bool IsFinished() const { return m_frameIndex >= m_frameCount; }
+        [[nodiscard]] std::uint32_t FrameIndex() const { return m_frameIndex; }
+        [[nodiscard]] std::uint32_t FrameCount() const { return m_frameCount; }
+
+    private:
+        std::vector<std::uint8_t> m_stream;
+        std::size_t   m_cursor = 0;
+        InputFrame    m_current{};
+        std::uint32_t m_deltaMicros = 0;
+        std::uint32_t m_frameIndex = 0;
+        std::uint32_t m_frameCount = 0;
+        bool          m_loaded = false;
+    };
+
+} // namespace KibakoEngine
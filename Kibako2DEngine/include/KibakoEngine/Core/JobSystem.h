@@ -0,0 +1,78 @@
+// Fixed worker pool running data-parallel loops
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace KibakoEngine {
+
+    // One ParallelFor runs at a time; the calling thread works on chunks too and
+    // blocks until every chunk is done. Calls made from inside a job (or with no
+    // workers) simply run inline, so nesting never deadlocks.
+    class JobSystem
+    {
+    public:
+        // Upper bound on threads that can run jobs (workers + the dispatching thread)
+        static constexpr std::uint32_t kMaxThreads = 64;
+
+        JobSystem() = default;
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // workerCount 0 = hardware threads - 1 (the caller is the extra thread)
+        void Init(std::uint32_t workerCount = 0);
+        void Shutdown();
+
+        [[nodiscard]] std::uint32_t WorkerCount() const { return static_cast<std::uint32_t>(m_workers.size()); }
+
+        // 1..WorkerCount() on pool workers, 0 on any other thread
+        [[nodiscard]] static std::uint32_t CurrentThreadIndex();
+
+        // fn(begin, end) over [0, count) in chunks of at least minChunk items
+        template <typename Fn>
+        void ParallelFor(std::size_t count, std::size_t minChunk, Fn&& fn)
+        {
+            using FnType = std::remove_reference_t<Fn>;
+            Dispatch(count, minChunk,
+                [](void* ctx, std::size_t begin, std::size_t end) {
+                    (*static_cast<FnType*>(ctx))(begin, end);
+                },
+                const_cast<void*>(static_cast<const void*>(&fn)));
+        }
+
+    private:
+        using RangeFn = void (*)(void* ctx, std::size_t begin, std::size_t end);
+
+        void Dispatch(std::size_t count, std::size_t minChunk, RangeFn fn, void* ctx);
+        void RunChunks();
+        void WorkerLoop(std::uint32_t threadIndex);
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex              m_dispatchMutex; // serializes ParallelFor callers
+        std::mutex              m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+
+        // Current job (written under m_mutex before m_generation is bumped)
+        RangeFn     m_fn = nullptr;
+        void*       m_ctx = nullptr;
+        std::size_t m_count = 0;
+        std::size_t m_chunkSize = 0;
+        std::size_t m_chunkCount = 0;
+
+        std::atomic<std::size_t> m_nextChunk{ 0 };
+        std::uint64_t            m_generation = 0;
+        std::uint32_t            m_busyWorkers = 0;
+        bool                     m_stop = false;
+    };
+
+} // namespace KibakoEngine
@@ -1,6 +1,8 @@
 // Base interface implemented by application layers
 #pragma once
 
+#include <cstddef>
+#include <span>
 #include <string>
 #include <utility>
 
@@ -8,6 +10,7 @@ namespace KibakoEngine
 {
     class Application;
     class SpriteBatch2D;
+    struct RenderView2D;
 
     // Minimal interface used by the application loop to drive layers.
     class Layer
@@ -28,6 +31,12 @@ namespace KibakoEngine
         // Render step
         virtual void OnRender(SpriteBatch2D& /*batch*/) {}
 
+        // Extra views (only when the renderer has views registered).
+        // OnPrepareViews runs once per frame before any view pass: cull/extract there
+        // (Scene2D::ExtractVisible) so OnRenderView only replays the shared result.
+        virtual void OnPrepareViews(std::span<const RenderView2D> /*views*/) {}
+        virtual void OnRenderView(SpriteBatch2D& /*batch*/, std::size_t /*viewIndex*/, const RenderView2D& /*view*/) {}
+
         const std::string& Name() const { return m_name; }
 
     protected:
@@ -19,6 +19,9 @@ namespace KibakoEngine::Profiler {
     void BeginFrame();
     void Flush();
 
+    // Unitless value sample (counts, ratios), summarised next to the timings
+    void RecordCounter(const char* name, double value);
+
     class ScopedEvent
     {
     public:
@@ -37,6 +40,7 @@ namespace KibakoEngine::Profiler {
 
     inline void BeginFrame() {}
     inline void Flush() {}
+    inline void RecordCounter(const char*, double) {}
 
     class ScopedEvent
     {
@@ -53,8 +57,10 @@ namespace KibakoEngine::Profiler {
 
 #if KBK_ENABLE_PROFILING
 #    define KBK_PROFILE_SCOPE(name) ::KibakoEngine::Profiler::ScopedEvent KBK_CONCAT(_kbkProfileScope, __LINE__)(name)
+#    define KBK_PROFILE_COUNTER(name, value) ::KibakoEngine::Profiler::RecordCounter((name), static_cast<double>(value))
 #else
 #    define KBK_PROFILE_SCOPE(name) ((void)0)
+#    define KBK_PROFILE_COUNTER(name, value) ((void)0)
 #endif
 
 #define KBK_PROFILE_FUNCTION() KBK_PROFILE_SCOPE(__FUNCTION__)
@@ -0,0 +1,112 @@
+// Centralized deadline scheduler driven by GameServices time
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "KibakoEngine/Core/GameServices.h"
+
+namespace KibakoEngine::Gameplay {
+
+    enum class TimerClock : std::uint8_t
+    {
+        Scaled = 0, // follows time scale and pause (gameplay cooldowns)
+        Raw,        // wall clock, keeps running while paused (UI, menus)
+        Count
+    };
+
+    // Generation-checked handle: stays safe to use after the timer fired or was cancelled
+    struct TimerHandle
+    {
+        static constexpr std::uint32_t kInvalidSlot = 0xFFFFFFFFu;
+
+        std::uint32_t slot = kInvalidSlot;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool IsValid() const { return slot != kInvalidSlot; }
+        [[nodiscard]] bool operator==(const TimerHandle&) const = default;
+    };
+
+    struct TimerDesc
+    {
+        double        delaySeconds = 0.0;
+        double        periodSeconds = 0.0; // > 0 repeats
+        std::uint32_t channel = 0;         // groups expirations per consumer system
+        std::uint64_t userData = 0;        // e.g. an EntityID
+        TimerClock    clock = TimerClock::Scaled;
+    };
+
+    struct TimerExpiration
+    {
+        TimerHandle   handle;
+        std::uint64_t userData = 0;
+        std::uint32_t channel = 0;
+        std::uint32_t count = 1;      // periods elapsed this frame (repeating timers)
+        double        deadline = 0.0; // first deadline that was crossed
+    };
+
+    // Timers are registered once and kept in a min-heap per clock. Update() only
+    // pops what is due, so the per-frame cost scales with expirations rather
+    // than with live timers. Expirations are handed out in batches grouped by
+    // channel and stay valid until the next Update().
+    class TimerService
+    {
+    public:
+        TimerHandle Start(const TimerDesc& desc);
+        TimerHandle Start(double delaySeconds, std::uint32_t channel = 0, std::uint64_t userData = 0);
+
+        // Lazy: the heap entry is skipped when it surfaces
+        bool Cancel(TimerHandle handle);
+        void Clear();
+
+        [[nodiscard]] bool   IsActive(TimerHandle handle) const;
+        [[nodiscard]] double Remaining(TimerHandle handle) const; // 0 if inactive
+
+        // Advances both clocks from GameServices and collects everything due
+        void Update(const GameTime& time);
+
+        [[nodiscard]] std::span<const TimerExpiration> Expired() const { return m_expired; }
+        [[nodiscard]] std::span<const TimerExpiration> Expired(std::uint32_t channel) const;
+
+        [[nodiscard]] std::size_t ActiveCount() const { return m_activeCount; }
+        [[nodiscard]] double Now(TimerClock clock) const { return m_now[static_cast<int>(clock)]; }
+
+    private:
+        struct Slot
+        {
+            double        deadline = 0.0;
+            double        period = 0.0;
+            std::uint64_t userData = 0;
+            std::uint32_t channel = 0;
+            std::uint32_t generation = 0;
+            TimerClock    clock = TimerClock::Scaled;
+            bool          active = false;
+        };
+
+        struct HeapEntry
+        {
+            double        deadline = 0.0;
+            std::uint32_t slot = 0;
+            std::uint32_t generation = 0;
+        };
+
+        void Push(TimerClock clock, const HeapEntry& entry);
+        void Collect(TimerClock clock);
+        void Release(std::uint32_t slot);
+        void CompactIfStale(TimerClock clock);
+
+        static constexpr int kClockCount = static_cast<int>(TimerClock::Count);
+
+        std::vector<Slot>          m_slots;
+        std::vector<std::uint32_t> m_freeSlots;
+        std::vector<HeapEntry>     m_heaps[kClockCount];
+        std::size_t                m_stale[kClockCount]{};
+        double                     m_now[kClockCount]{};
+        std::size_t                m_activeCount = 0;
+
+        std::vector<TimerExpiration> m_expired;
+    };
+
+} // namespace KibakoEngine::Gameplay
@@ -1,4 +1,5 @@
 // Small helpers for tracking elapsed and countdown time
+// (many concurrent cooldowns: prefer Gameplay::TimerService)
 #pragma once
 
 #include <algorithm>
@@ -0,0 +1,116 @@
+// Structure-of-arrays particle emitters with SIMD update and direct batch output
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class JobSystem;
+    class SpriteBatch2D;
+    class Texture2D;
+
+    struct ParticleEmitterDesc
+    {
+        const Texture2D* texture = nullptr;      // nullptr = the batch's white texture
+        RectF            src{ 0.0f, 0.0f, 1.0f, 1.0f };
+        int              layer = 0;
+        BlendMode        blend = BlendMode::Alpha;
+
+        std::uint32_t capacity = 1024; // hard cap: spawns beyond it are dropped
+        float         rate = 0.0f;     // continuous spawns per second while emitting
+
+        float lifeMin = 1.0f;
+        float lifeMax = 1.0f;
+        float speedMin = 50.0f;
+        float speedMax = 100.0f;
+        float angle = 0.0f;            // radians, 0 = +x
+        float spread = 6.2831853f;     // full cone width in radians (default: all directions)
+        float spawnRadius = 0.0f;      // spawn within a disc around the emitter
+
+        DirectX::XMFLOAT2 gravity{ 0.0f, 0.0f };
+        float             drag = 0.0f; // velocity lost per second (fraction)
+
+        float  sizeStart = 8.0f;
+        float  sizeEnd = 8.0f;
+        Color4 colorStart = Color4::White();
+        Color4 colorEnd = Color4::Transparent();
+    };
+
+    // One pool per emitter, one array per attribute. Update() spawns, then
+    // runs the integration and fade kernels four particles at a time and
+    // swap-compacts the dead; Emit() writes the live quads straight into the
+    // batch as a single geometry command.
+    class ParticleEmitter2D
+    {
+    public:
+        explicit ParticleEmitter2D(const ParticleEmitterDesc& desc, std::uint32_t seed = 1u);
+
+        [[nodiscard]] const ParticleEmitterDesc& Desc() const { return m_desc; }
+
+        void SetPosition(const DirectX::XMFLOAT2& position) { m_position = position; }
+        [[nodiscard]] const DirectX::XMFLOAT2& Position() const { return m_position; }
+
+        // Rate-based spawning only; bursts and live particles are unaffected
+        void SetEmitting(bool emitting) { m_emitting = emitting; }
+        [[nodiscard]] bool IsEmitting() const { return m_emitting; }
+
+        // Spawns up to count particles on the next Update()
+        void Burst(std::uint32_t count) { m_pendingBurst += count; }
+        void Clear() { m_count = 0; }
+
+        void Update(float dt);
+        void Emit(SpriteBatch2D& batch) const;
+
+        [[nodiscard]] std::size_t AliveCount() const { return m_count; }
+
+    private:
+        void Spawn(std::uint32_t count);
+        void Integrate(float dt);
+        void Fade();
+        void Compact();
+
+        [[nodiscard]] float RandomUnit();
+
+        ParticleEmitterDesc m_desc;
+        DirectX::XMFLOAT2   m_position{ 0.0f, 0.0f };
+        bool                m_emitting = true;
+        std::uint32_t       m_pendingBurst = 0;
+        float               m_spawnAccumulator = 0.0f;
+        std::uint32_t       m_rng = 1u;
+
+        // Attribute pools, padded to a multiple of 4 so kernels never need a tail
+        std::size_t        m_count = 0;
+        std::vector<float> m_posX, m_posY;
+        std::vector<float> m_velX, m_velY;
+        std::vector<float> m_age, m_invLife;
+        std::vector<float> m_size;
+        std::vector<float> m_colR, m_colG, m_colB, m_colA;
+    };
+
+    // Owns emitters; updates them in parallel (one emitter per job chunk)
+    class ParticleSystem2D
+    {
+    public:
+        ParticleEmitter2D& CreateEmitter(const ParticleEmitterDesc& desc);
+        void DestroyEmitter(ParticleEmitter2D& emitter);
+        void Clear() { m_emitters.clear(); }
+
+        void Update(float dt, JobSystem* jobs = nullptr);
+        void Render(SpriteBatch2D& batch) const;
+
+        [[nodiscard]] std::size_t EmitterCount() const { return m_emitters.size(); }
+        [[nodiscard]] std::size_t AliveCount() const;
+
+    private:
+        std::vector<std::unique_ptr<ParticleEmitter2D>> m_emitters;
+        std::uint32_t m_nextSeed = 1u;
+    };
+
+} // namespace KibakoEngine
@@ -10,9 +10,11 @@ namespace KibakoEngine {
         void SetViewport(float width, float height);
         void SetPosition(float x, float y);
         void SetRotation(float radians);
+        void SetZoom(float zoom); // screen pixels per world unit (minimaps zoom out)
 
         [[nodiscard]] DirectX::XMFLOAT2 GetPosition() const { return { m_positionX, m_positionY }; }
         [[nodiscard]] float             GetRotation() const { return m_rotation; }
+        [[nodiscard]] float             GetZoom() const { return m_zoom; }
         [[nodiscard]] float             GetViewportWidth() const { return m_viewWidth; }
         [[nodiscard]] float             GetViewportHeight() const { return m_viewHeight; }
         [[nodiscard]] DirectX::XMFLOAT4X4 GetViewProjection() const { return m_viewProj; }
@@ -26,6 +28,7 @@ namespace KibakoEngine {
         float m_positionX = 0.0f;
         float m_positionY = 0.0f;
         float m_rotation = 0.0f;
+        float m_zoom = 1.0f;
 
         DirectX::XMFLOAT4X4 m_viewProj{};
         DirectX::XMFLOAT4X4 m_viewProjT{};
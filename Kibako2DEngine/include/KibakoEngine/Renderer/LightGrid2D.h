@@ -0,0 +1,158 @@
+// Tiled light culling for 2D point lights: screen tiles binned on the CPU, read per pixel by the sprite shader
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class Camera2D;
+    class JobSystem;
+
+    // A point light already in render-target pixels (see ProjectLight2D)
+    struct LightInstance2D
+    {
+        DirectX::XMFLOAT2 position{ 0.0f, 0.0f };
+        float             radius = 0.0f;            // no contribution at or past it
+        DirectX::XMFLOAT3 color{ 1.0f, 1.0f, 1.0f }; // intensity folded in
+    };
+
+    // GPU layout of one light (StructuredBuffer<Light>, 32 bytes)
+    struct PackedLight2D
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float radius = 0.0f;
+        float invRadius = 0.0f;
+        float r = 0.0f;
+        float g = 0.0f;
+        float b = 0.0f;
+        float padding = 0.0f;
+    };
+    static_assert(sizeof(PackedLight2D) == 32, "PackedLight2D must match the HLSL Light struct");
+
+    // Where a tile's indices start in LightGrid2D::TileLights() and how many there are
+    struct LightTileRange2D
+    {
+        std::uint32_t offset = 0;
+        std::uint32_t count = 0;
+    };
+
+    struct LightGridDesc
+    {
+        std::uint32_t tileSize = 32;          // pixels per tile side
+        std::uint32_t maxLightsPerTile = 64;  // bounds the per-pixel loop; extra lights are dropped
+    };
+
+    struct LightGridStats
+    {
+        std::uint32_t lights = 0;
+        std::uint32_t tiles = 0;
+        std::uint32_t entries = 0;        // tile-light pairs kept
+        std::uint32_t maxPerTile = 0;     // before the cap
+        std::uint32_t overflowTiles = 0;  // tiles that hit maxLightsPerTile
+    };
+
+    // Falloff shared by the HLSL shader and the CPU references: (1 - d^2/r^2)^2,
+    // smooth at the radius and zero past it
+    [[nodiscard]] inline float LightAttenuation2D(float dx, float dy, float invRadius)
+    {
+        const float nx = dx * invRadius;
+        const float ny = dy * invRadius;
+        float a = 1.0f - (nx * nx + ny * ny);
+        a = (a < 0.0f) ? 0.0f : (a > 1.0f ? 1.0f : a);
+        return a * a;
+    }
+
+    // World-space light seen through a camera whose view covers `viewport`
+    // (pixels of the render target)
+    [[nodiscard]] LightInstance2D ProjectLight2D(const Camera2D& camera, const RectF& viewport,
+        const DirectX::XMFLOAT2& worldPosition, float worldRadius, const DirectX::XMFLOAT3& color);
+
+    // Splits a pixel rectangle into square tiles and lists, per tile, the
+    // lights whose circle reaches it. Each row of tiles keeps the lights
+    // crossing its band, works out the columns each one spans (four lights
+    // per SSE step) and counting-sorts them into its tiles, so the cost
+    // follows the tile-light pairs rather than tiles x lights. Rows are
+    // binned in parallel and each writes its own lists, so the result does
+    // not depend on the thread count. The output is flat arrays ready to
+    // upload: lights, per-tile ranges (row-major), indices.
+    class LightGrid2D
+    {
+    public:
+        explicit LightGrid2D(const LightGridDesc& desc = {});
+
+        // `area` is the part of the render target the grid covers (usually the
+        // view's viewport). Lights with no radius or entirely outside are dropped.
+        void Build(std::span<const LightInstance2D> lights, const RectF& area, JobSystem* jobs = nullptr);
+        void Clear();
+
+        [[nodiscard]] const LightGridDesc& Desc() const { return m_desc; }
+        [[nodiscard]] const RectF& Area() const { return m_area; }
+        [[nodiscard]] std::uint32_t TilesX() const { return m_tilesX; }
+        [[nodiscard]] std::uint32_t TilesY() const { return m_tilesY; }
+
+        [[nodiscard]] std::span<const PackedLight2D> Lights() const { return m_lights; }
+        [[nodiscard]] std::span<const LightTileRange2D> TileRanges() const { return m_ranges; }
+        [[nodiscard]] std::span<const std::uint32_t> TileLights() const { return m_indices; }
+
+        // Light indices of the tile holding pixel (x, y); empty outside the grid
+        [[nodiscard]] std::span<const std::uint32_t> LightsAt(float x, float y) const;
+
+        [[nodiscard]] const LightGridStats& Stats() const { return m_stats; }
+
+    private:
+        struct RowBins
+        {
+            std::vector<std::uint32_t>    candidates; // lights overlapping the row's band
+            std::vector<float>            centerX;    // per candidate, padded to four
+            std::vector<float>            budget;     // radius^2 - (vertical gap)^2
+            std::vector<float>            firstCol;   // tile columns reached, as floats
+            std::vector<float>            lastCol;
+            std::vector<std::uint32_t>    tileCounts; // lights reaching each tile, before the cap
+            std::vector<std::uint32_t>    indices;    // every tile's list, back to back
+            std::vector<LightTileRange2D> ranges;     // offsets into `indices`
+            std::uint32_t                 maxPerTile = 0;
+            std::uint32_t                 overflowTiles = 0;
+        };
+
+        void BinRow(std::uint32_t row);
+
+        LightGridDesc m_desc;
+        RectF         m_area{};
+        std::uint32_t m_tilesX = 0;
+        std::uint32_t m_tilesY = 0;
+
+        std::vector<PackedLight2D> m_lights;
+
+        // Structure-of-arrays copy for the SSE test, padded to a multiple of
+        // four with lights that never pass
+        std::vector<float> m_posX;
+        std::vector<float> m_posY;
+        std::vector<float> m_radiusSq;
+        std::vector<float> m_minY;
+        std::vector<float> m_maxY;
+
+        std::vector<RowBins>          m_rows; // kept across builds for their storage
+        std::vector<LightTileRange2D> m_ranges;
+        std::vector<std::uint32_t>    m_indices;
+
+        LightGridStats m_stats;
+    };
+
+    // CPU copies of the sprite shader's lighting term at a pixel centre
+    // (SV_Position convention: integer pixel + 0.5). The grid version walks
+    // the tile lists exactly like the shader; the brute-force one loops over
+    // every light. Without overflow both agree, which is what tests check.
+    [[nodiscard]] DirectX::XMFLOAT3 ShadeLightGridReference(const LightGrid2D& grid,
+        const DirectX::XMFLOAT3& ambient, float x, float y);
+    [[nodiscard]] DirectX::XMFLOAT3 ShadeLightsBruteForce(std::span<const LightInstance2D> lights,
+        const DirectX::XMFLOAT3& ambient, float x, float y);
+
+} // namespace KibakoEngine
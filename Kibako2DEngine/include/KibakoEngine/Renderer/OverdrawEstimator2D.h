@@ -0,0 +1,56 @@
+// CPU estimate of the pixels a sorted 2D command list shades, with and without the depth-tested opaque pass
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    // One draw as the estimator sees it, in painter's order
+    struct OverdrawQuad2D
+    {
+        RectF         bounds{};                            // screen pixels
+        SpriteOpacity opacity = SpriteOpacity::Translucent;
+        bool          occluder = false;                    // opaque and covering all of bounds (unrotated quad)
+    };
+
+    struct OverdrawEstimate
+    {
+        std::uint32_t quads = 0;
+        std::uint32_t opaqueQuads = 0;  // opaque or alpha-tested
+        double        screenPixels = 0.0;
+        double        painterPixels = 0.0; // every quad blended back to front
+        double        depthPixels = 0.0;   // opaque quads front to back, hidden pixels rejected early
+
+        // Average layers shaded per screen pixel
+        [[nodiscard]] double PainterOverdraw() const { return screenPixels > 0.0 ? painterPixels / screenPixels : 0.0; }
+        [[nodiscard]] double DepthOverdraw() const { return screenPixels > 0.0 ? depthPixels / screenPixels : 0.0; }
+        // Share of the painter's shading the depth pass avoids, 0..1
+        [[nodiscard]] double Saving() const { return painterPixels > 0.0 ? 1.0 - depthPixels / painterPixels : 0.0; }
+    };
+
+    // Rasterises quad bounds onto a coarse grid of cells. A cell counts as
+    // hidden for a quad when an occluder painted later covers the whole cell,
+    // which is what the depth test rejects once opaque quads are drawn front
+    // to back. Partly covered cells are always shaded, so the saving is a
+    // lower bound; rotated or generated geometry never occludes.
+    class OverdrawEstimator2D
+    {
+    public:
+        explicit OverdrawEstimator2D(float cellSize = 8.0f);
+
+        const OverdrawEstimate& Estimate(std::span<const OverdrawQuad2D> painterOrder, const RectF& screen);
+
+        [[nodiscard]] const OverdrawEstimate& Last() const { return m_estimate; }
+        [[nodiscard]] float CellSize() const { return m_cellSize; }
+
+    private:
+        float                      m_cellSize = 8.0f;
+        std::vector<std::uint32_t> m_frontOccluder; // per cell: 1 + painter index of the latest full cover
+        OverdrawEstimate           m_estimate;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,55 @@
+// Backend-neutral description of one camera pass (split-screen, minimap, ...)
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "KibakoEngine/Renderer/Camera2D.h"
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class Texture2D;
+
+    inline constexpr std::uint32_t kAllRenderLayers = 0xFFFFFFFFu;
+
+    // Sprite layers map onto the 32 mask bits; layers outside [0, 31] are clamped
+    [[nodiscard]] constexpr std::uint32_t RenderLayerBit(int layer)
+    {
+        return 1u << static_cast<std::uint32_t>(layer < 0 ? 0 : (layer > 31 ? 31 : layer));
+    }
+
+    struct RenderView2D
+    {
+        std::string name;
+        Camera2D    camera;
+
+        // Pixel rectangle inside the target; empty means "whole target"
+        RectF viewport{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+        std::uint32_t layerMask = kAllRenderLayers;
+
+        // nullptr renders into the backbuffer (split-screen), otherwise into an
+        // offscreen Texture2D created with CreateRenderTarget (minimap, portals)
+        Texture2D* target = nullptr;
+
+        bool   clear = false;
+        Color4 clearColor = Color4::Black();
+
+        int  order = 0; // lower renders first
+        bool enabled = true;
+
+        // Sets the viewport and keeps the camera 1:1 with it
+        void SetViewport(const RectF& rect)
+        {
+            viewport = rect;
+            camera.SetViewport(rect.w, rect.h);
+        }
+
+        [[nodiscard]] bool AcceptsLayer(int layer) const
+        {
+            return (layerMask & RenderLayerBit(layer)) != 0u;
+        }
+    };
+
+} // namespace KibakoEngine
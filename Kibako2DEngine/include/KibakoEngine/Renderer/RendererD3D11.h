@@ -6,8 +6,13 @@
 #include <wrl/client.h>
 
 #include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
 
 #include "KibakoEngine/Renderer/Camera2D.h"
+#include "KibakoEngine/Renderer/RenderView2D.h"
+#include "KibakoEngine/Renderer/ShaderCache.h"
 #include "KibakoEngine/Renderer/SpriteBatch2D.h"
 
 struct HWND__;
@@ -17,6 +22,10 @@ namespace KibakoEngine {
 
     class RendererD3D11 {
     public:
+        // Where compiled shaders are kept between runs; set before Init (empty = memory only)
+        void SetShaderCacheDirectory(std::filesystem::path directory) { m_shaderCache.SetDirectory(std::move(directory)); }
+        [[nodiscard]] ShaderCache& Shaders() { return m_shaderCache; }
+
         bool Init(HWND hwnd, uint32_t width, uint32_t height);
         void Shutdown();
 
@@ -31,6 +40,20 @@ namespace KibakoEngine {
         [[nodiscard]] Camera2D& Camera() { return m_camera; }
         [[nodiscard]] SpriteBatch2D& Batch() { return m_batch; }
 
+        // ---- Extra views (split-screen, minimap, render-to-texture) ----------
+        // Rendered before the main camera pass, sorted by RenderView2D::order.
+        // Returned references are invalidated by AddView/RemoveView.
+        RenderView2D& AddView(std::string_view name);
+        void RemoveView(std::string_view name);
+        [[nodiscard]] RenderView2D* FindView(std::string_view name);
+        [[nodiscard]] std::vector<RenderView2D>& Views() { return m_views; }
+        [[nodiscard]] const std::vector<RenderView2D>& Views() const { return m_views; }
+
+        // Binds the view's target + viewport and clears it if requested
+        void BeginView(const RenderView2D& view);
+        // Restores the backbuffer and the fullscreen viewport for the main pass
+        void BindBackBuffer();
+
         // Backbuffer resolution (native 1:1)
         [[nodiscard]] uint32_t BackBufferWidth() const { return m_backBufferWidth; }
         [[nodiscard]] uint32_t BackBufferHeight() const { return m_backBufferHeight; }
@@ -48,11 +71,16 @@ namespace KibakoEngine {
         Microsoft::WRL::ComPtr<ID3D11DeviceContext>    m_context;
         Microsoft::WRL::ComPtr<IDXGISwapChain>         m_swapChain;
         Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_rtv;
+        Microsoft::WRL::ComPtr<ID3D11Texture2D>        m_depthBuffer;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_dsv;
         D3D_FEATURE_LEVEL m_featureLevel = D3D_FEATURE_LEVEL_11_0;
 
         Camera2D      m_camera;
+        ShaderCache   m_shaderCache;
         SpriteBatch2D m_batch;
 
+        std::vector<RenderView2D> m_views;
+
         uint32_t m_backBufferWidth = 0;
         uint32_t m_backBufferHeight = 0;
 
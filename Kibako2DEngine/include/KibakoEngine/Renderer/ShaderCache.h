@@ -0,0 +1,96 @@
+// Compiled shader bytecode cache keyed by source, defines and compiler; backend-agnostic
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace KibakoEngine {
+
+    struct ShaderDefine
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // Everything that decides the bytecode. Flags are the backend's own
+    // compile flags, hashed as they are.
+    struct ShaderDesc
+    {
+        std::string_view              source;
+        std::string_view              entryPoint = "main";
+        std::string_view              target;            // e.g. "vs_5_0"
+        std::span<const ShaderDefine> defines;
+        std::uint32_t                 flags = 0;
+        std::string_view              debugName;         // error messages only, not hashed
+    };
+
+    // Turns source into bytecode. The D3D11 renderer uses ShaderCompilerD3D11;
+    // anything else (a stub in tests, an offline tool) can plug in here.
+    class ShaderCompiler
+    {
+    public:
+        virtual ~ShaderCompiler() = default;
+
+        // False on failure, with the compiler's message in `errors`
+        virtual bool Compile(const ShaderDesc& desc, std::vector<std::uint8_t>& bytecode, std::string& errors) = 0;
+        // Part of every key: a new compiler never reuses an older one's blobs
+        [[nodiscard]] virtual std::string_view Version() const = 0;
+    };
+
+    struct ShaderCacheStats
+    {
+        std::uint32_t memoryHits = 0;
+        std::uint32_t diskHits = 0;
+        std::uint32_t compiles = 0;
+        std::uint32_t compileFailures = 0;
+        std::uint32_t rejectedFiles = 0;  // wrong format version, key or checksum; deleted
+        std::uint32_t writeFailures = 0;
+        double        compileMs = 0.0;
+        double        loadMs = 0.0;
+    };
+
+    // Looks bytecode up in memory (including blobs preloaded from the
+    // executable), then in `directory`, and only compiles on a miss, writing
+    // the result back. Keys hash the source, entry point, target, flags,
+    // defines and compiler version, so any change to them is a different
+    // entry and old files are simply never read again. Each file carries the
+    // key and a checksum of its bytes; a file that does not match is deleted
+    // and recompiled. An empty directory keeps the cache in memory only.
+    class ShaderCache
+    {
+    public:
+        explicit ShaderCache(std::filesystem::path directory = {});
+
+        void SetDirectory(std::filesystem::path directory) { m_directory = std::move(directory); }
+        [[nodiscard]] const std::filesystem::path& Directory() const { return m_directory; }
+
+        [[nodiscard]] static std::uint64_t MakeKey(const ShaderDesc& desc, std::string_view compilerVersion);
+        [[nodiscard]] std::filesystem::path FilePath(std::uint64_t key) const;
+
+        // Null when compiling fails (logged). The bytecode stays valid until Clear().
+        [[nodiscard]] const std::vector<std::uint8_t>* Get(const ShaderDesc& desc, ShaderCompiler& compiler);
+
+        // Bytecode embedded at build time, registered under MakeKey() before the first Get()
+        void Preload(std::uint64_t key, std::span<const std::uint8_t> bytecode);
+
+        // Drops the memory copies; files on disk stay
+        void Clear() { m_entries.clear(); }
+
+        [[nodiscard]] const ShaderCacheStats& Stats() const { return m_stats; }
+        void ResetStats() { m_stats = {}; }
+
+    private:
+        [[nodiscard]] bool LoadFile(std::uint64_t key, std::vector<std::uint8_t>& bytecode);
+        void SaveFile(std::uint64_t key, std::span<const std::uint8_t> bytecode);
+
+        std::filesystem::path                                        m_directory;
+        std::unordered_map<std::uint64_t, std::vector<std::uint8_t>> m_entries;
+        ShaderCacheStats                                             m_stats;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,22 @@
+// HLSL compilation through D3DCompile, for ShaderCache
+#pragma once
+
+#include <string>
+
+#include "KibakoEngine/Renderer/ShaderCache.h"
+
+namespace KibakoEngine {
+
+    class ShaderCompilerD3D11 final : public ShaderCompiler
+    {
+    public:
+        ShaderCompilerD3D11();
+
+        bool Compile(const ShaderDesc& desc, std::vector<std::uint8_t>& bytecode, std::string& errors) override;
+        [[nodiscard]] std::string_view Version() const override { return m_version; }
+
+    private:
+        std::string m_version; // header version plus the loaded DLL's file version
+    };
+
+} // namespace KibakoEngine
@@ -6,45 +6,91 @@
 
 #include <DirectXMath.h>
 
+#include <array>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
+#include "KibakoEngine/Renderer/OverdrawEstimator2D.h"
+#include "KibakoEngine/Renderer/SpriteBatchSort2D.h"
 #include "KibakoEngine/Renderer/SpriteTypes.h"
 #include "KibakoEngine/Renderer/Texture2D.h"
 
 namespace KibakoEngine {
 
+    class ShaderCache;
+    struct SpriteShapeDesc;
+    class SpriteLighting2D;
+
     struct SpriteBatchStats
     {
         std::uint32_t drawCalls = 0;
         std::uint32_t spritesSubmitted = 0; // counts only Push() sprite submissions
         std::uint32_t spritesCulled = 0;
+        // State binds issued by End(), the first range's included
+        std::uint32_t blendChanges = 0;
+        std::uint32_t textureChanges = 0;
+        std::uint32_t scissorChanges = 0;
+        std::uint32_t shaderChanges = 0;
+        std::uint32_t queueSorts = 0; // queues End() actually had to reorder
+        std::uint32_t opaqueItems = 0; // drawn front to back in the depth-tested pass
     };
 
     class SpriteBatch2D {
     public:
-        // Single vertex format shared by all 2D and UI geometry
+        // Single vertex format shared by all 2D and UI geometry. Submitters
+        // put the pixel shading in position.z, 0 for texture * color or
+        // kShadeDistanceField; End() adds the draw depth as a fraction below
+        // 0.5 when the opaque pass runs. One geometry submission has one
+        // shading: End() reads it from the first vertex to pick the pixel shader.
         struct Vertex {
             DirectX::XMFLOAT3 position;
             DirectX::XMFLOAT2 uv;
             DirectX::XMFLOAT4 color;
         };
 
-        // Lifetime management
-        [[nodiscard]] bool Init(ID3D11Device* device, ID3D11DeviceContext* context);
+        // Texture alpha is a signed distance field (0.5 on the edge), sampled
+        // bilinearly and anti-aliased; rgb comes from the vertex color only
+        static constexpr float kShadeDistanceField = 1.0f;
+
+        SpriteBatch2D();
+
+        // Lifetime management. Shader bytecode is looked up in `shaderCache`
+        // (compiled and stored on a miss); without one it is compiled every time.
+        [[nodiscard]] bool Init(ID3D11Device* device, ID3D11DeviceContext* context, ShaderCache* shaderCache = nullptr);
         void Shutdown();
 
         // Frame boundaries
         void Begin(const DirectX::XMFLOAT4X4& viewProjT);
         void End();
 
-        // Sprite submission helpers (positions are already in pixel space)
+        // Submissions go to the active queue (World after Begin). End() orders
+        // each queue by its own policy and draws the queues one after another
+        // in RenderQueue2D order, so layers only compare within a queue.
+        // Returns the previous queue so callers can restore it.
+        RenderQueue2D SetQueue(RenderQueue2D queue);
+        [[nodiscard]] RenderQueue2D ActiveQueue() const { return m_activeQueue; }
+
+        void SetQueueSortPolicy(RenderQueue2D queue, QueueSortPolicy policy);
+        [[nodiscard]] QueueSortPolicy GetQueueSortPolicy(RenderQueue2D queue) const;
+
+        // Preallocates a queue's command storage; each queue also keeps the
+        // capacity of its busiest frame
+        void ReserveQueue(RenderQueue2D queue, size_t spriteCount, size_t geometryCount);
+
+        // Sprite submission helpers (positions are already in pixel space).
+        // With the Layer policy commands are ordered by layer, then blend mode,
+        // so a layer mixing modes costs one state switch per mode rather than
+        // per sprite. Alpha-blended sprites at full color alpha whose texture
+        // IsOpaque() count as SpriteOpacity::Opaque without asking.
         void Push(const Texture2D& texture,
             const RectF& dst,
             const RectF& src,
             const Color4& color,
             float rotation = 0.0f,
-            int layer = 0);
+            int layer = 0,
+            BlendMode blend = BlendMode::Alpha,
+            SpriteOpacity opacity = SpriteOpacity::Translucent);
 
         // Raw geometry submission for UI
         // - texture can be nullptr to fall back to the built-in white texture
@@ -53,7 +99,8 @@ namespace KibakoEngine {
             const Vertex* vertices, size_t vertexCount,
             const std::uint32_t* indices, size_t indexCount,
             int layer = 0,
-            const RectF& clipRect = RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f));
+            const RectF& clipRect = RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f),
+            BlendMode blend = BlendMode::Alpha);
 
         // Zero-copy path for long-lived geometry (compiled UI meshes, static overlays)
         void PushGeometryView(const Texture2D* texture,
@@ -63,10 +110,51 @@ namespace KibakoEngine {
             size_t indexCount,
             int layer = 0,
             const RectF& clipRect = RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f),
-            DirectX::XMFLOAT2 translation = { 0.0f, 0.0f });
+            DirectX::XMFLOAT2 translation = { 0.0f, 0.0f },
+            BlendMode blend = BlendMode::Alpha);
+
+        // Writable geometry owned by the batch until End(): one command whose
+        // vertices/indices the caller fills in place (indices relative to its
+        // own vertices). The pointers stay valid until the next PushGeometryRaw()
+        // or AllocateGeometry(). Both are null outside Begin/End or for zero counts.
+        struct GeometryWriter {
+            Vertex*        vertices = nullptr;
+            std::uint32_t* indices = nullptr;
+        };
+        [[nodiscard]] GeometryWriter AllocateGeometry(const Texture2D* texture,
+            size_t vertexCount, size_t indexCount, int layer = 0, BlendMode blend = BlendMode::Alpha,
+            SpriteOpacity opacity = SpriteOpacity::Translucent);
+
+        // Nine-slice or tiled sprite (SpriteShapes2D.h) generated straight into
+        // one geometry command; texture can be nullptr for the white texture.
+        // SpriteDrawMode::Simple forwards to Push().
+        void PushSpriteShape(const Texture2D* texture, const SpriteShapeDesc& shape,
+            int layer = 0, BlendMode blend = BlendMode::Alpha,
+            SpriteOpacity opacity = SpriteOpacity::Translucent);
+
+        // Opaque and alpha-tested submissions (Alpha or Premultiplied blend,
+        // full alpha) are drawn first, front to back with depth writes, when
+        // the bound target has a depth buffer; translucent ones follow back to
+        // front with depth testing only, so the result matches painter's order
+        // while hidden pixels are rejected before shading. Without a depth
+        // buffer, or when disabled, everything is blended in painter's order.
+        void SetOpaquePass(bool enabled) { m_opaquePass = enabled; }
+        [[nodiscard]] bool OpaquePassEnabled() const { return m_opaquePass; }
+
+        // Estimates the overdraw of the next End() from its sorted command
+        // list (OverdrawEstimator2D), over the bound viewport
+        void RequestOverdrawEstimate() { m_overdrawRequested = true; }
+        [[nodiscard]] const OverdrawEstimate& LastOverdrawEstimate() const { return m_overdraw.Last(); }
+
+        // Per-pixel point lights for this Begin/End: commands on layers up to
+        // maxLitLayer are multiplied by the lights of their screen tile (plus
+        // ambient); higher layers (HUD, labels) and distance-field text stay
+        // unlit. Ignored until the lighting has been uploaded; cleared by End().
+        void SetLighting(const SpriteLighting2D* lighting, int maxLitLayer = std::numeric_limits<int>::max());
 
         void ResetStats() { m_stats = {}; }
         void RecordSpriteCulled() { ++m_stats.spritesCulled; }
+        void RecordSpritesCulled(std::uint32_t count) { m_stats.spritesCulled += count; }
         [[nodiscard]] const SpriteBatchStats& Stats() const { return m_stats; }
 
         [[nodiscard]] const Texture2D* DefaultWhiteTexture() const;
@@ -80,6 +168,9 @@ namespace KibakoEngine {
             Color4 color;
             float  rotation = 0.0f;
             int    layer = 0;
+            BlendMode blend = BlendMode::Alpha;
+            SpriteOpacity opacity = SpriteOpacity::Translucent;
+            std::uint32_t order = 0; // submission order within the queue
         };
 
         // Raw geometry command used by UI / Rml
@@ -89,78 +180,112 @@ namespace KibakoEngine {
             const std::uint32_t* indices = nullptr;
             size_t                   vertexCount = 0;
             size_t                   indexCount = 0;
-            std::vector<Vertex>      ownedVertices;
-            std::vector<std::uint32_t> ownedIndices;
+            // Copied/allocated geometry lives in the frame arena; pointers are
+            // resolved from these offsets in End() since the arena can regrow
+            bool                     inArena = false;
+            size_t                   arenaVertexOffset = 0;
+            size_t                   arenaIndexOffset = 0;
             bool hasTranslation = false;
             DirectX::XMFLOAT2 translation{ 0.0f, 0.0f };
             int layer = 0;
+            BlendMode blend = BlendMode::Alpha;
             bool hasClipRect = false;
             RectF clipRect{};
+            SpriteOpacity opacity = SpriteOpacity::Translucent;
+            std::uint32_t order = 0;
         };
 
-        struct CBVS {
-            DirectX::XMFLOAT4X4 viewProjT;
+        // Commands of one RenderQueue2D; the storage is kept across frames
+        struct QueueStorage {
+            QueueSortPolicy              policy = QueueSortPolicy::Layer;
+            size_t                       spriteReserveHint = 64;
+            size_t                       geometryReserveHint = 64;
+            std::vector<DrawCommand>     commands;         // sprite quads
+            std::vector<GeometryCommand> geometryCommands; // raw geometry
+            std::uint32_t                nextOrder = 0;
         };
 
-        // Final draw range consumed by DrawIndexed
-        struct DrawRange {
-            ID3D11ShaderResourceView* srv = nullptr;
-            int              layer = 0;
-            std::uint32_t    firstIndex = 0;
-            std::uint32_t    indexCount = 0;
-            bool             useScissor = false;
-            D3D11_RECT       scissorRect{ 0, 0, 0, 0 };
+        struct CBVS {
+            DirectX::XMFLOAT4X4 viewProjT;
         };
 
-        struct UnifiedCommand {
-            const Texture2D* texture = nullptr;
-            ID3D11ShaderResourceView* srv = nullptr;
-            int              layer = 0;
-            bool             isSprite = true;
-            size_t           index = 0;
+        // Mirrors CB_PS in the pixel shader (16-byte rows)
+        struct CBPS {
+            float         premultiply = 0.0f; // 1: the blend state expects rgb * a (Multiply)
+            float         lit = 0.0f;         // 1: apply the tiled lights
+            float         tileSize = 1.0f;
+            std::uint32_t tilesX = 0;
+            float         ambient[3] = { 1.0f, 1.0f, 1.0f };
+            std::uint32_t tilesY = 0;
+            float         gridOrigin[2] = {};
+            float         alphaCutoff = 0.0f; // AlphaTested ranges discard below it
+            float         padding = 0.0f;
         };
 
-        [[nodiscard]] bool CreateShaders(ID3D11Device* device);
+        [[nodiscard]] bool CreateShaders(ID3D11Device* device, ShaderCache* shaderCache);
         [[nodiscard]] bool CreateStates(ID3D11Device* device);
 
         [[nodiscard]] bool EnsureVertexCapacity(size_t vertexCount);
         [[nodiscard]] bool EnsureIndexCapacity(size_t indexCount);
 
         void UpdateVSConstants();
+        void UpdatePSConstants(float premultiply, const SpriteLighting2D* lighting, float alphaCutoff);
         void ClearFrameData();
 
+        [[nodiscard]] QueueStorage& ActiveStorage() { return m_queues[static_cast<size_t>(m_activeQueue)]; }
+        // Appends the queue's drawable commands to m_sortItems in submission order
+        void CollectQueueItems(std::uint8_t queueIndex, size_t& totalVertices, size_t& totalIndices);
+        // Screen bounds of the sorted items, in painter's order, through the estimator
+        void EstimateOverdraw();
+
         // GPU resources and fixed states
         ID3D11Device* m_device = nullptr;
         ID3D11DeviceContext* m_context = nullptr;
 
         Microsoft::WRL::ComPtr<ID3D11VertexShader>      m_vs;
         Microsoft::WRL::ComPtr<ID3D11PixelShader>       m_ps;
+        Microsoft::WRL::ComPtr<ID3D11PixelShader>       m_psDistanceField;
         Microsoft::WRL::ComPtr<ID3D11InputLayout>       m_inputLayout;
         Microsoft::WRL::ComPtr<ID3D11Buffer>            m_vertexBuffer;
         Microsoft::WRL::ComPtr<ID3D11Buffer>            m_indexBuffer;
         Microsoft::WRL::ComPtr<ID3D11Buffer>            m_cbVS;
+        Microsoft::WRL::ComPtr<ID3D11Buffer>            m_cbPS;
         Microsoft::WRL::ComPtr<ID3D11SamplerState>      m_samplerPoint;
-        Microsoft::WRL::ComPtr<ID3D11BlendState>        m_blendAlpha;
+        Microsoft::WRL::ComPtr<ID3D11SamplerState>      m_samplerLinear;
+        Microsoft::WRL::ComPtr<ID3D11BlendState>        m_blendStates[kBlendModeCount]; // by BlendMode
+        Microsoft::WRL::ComPtr<ID3D11BlendState>        m_blendOpaque;  // opaque pass: no blending
         Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_depthDisabled;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_depthWrite;   // opaque pass: LESS, writes
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_depthTest;    // translucent after it: LESS, no writes
         Microsoft::WRL::ComPtr<ID3D11RasterizerState>   m_rasterCullNone;
         Microsoft::WRL::ComPtr<ID3D11RasterizerState>   m_rasterCullNoneScissor;
 
-        // Logical commands collected during a frame
-        std::vector<DrawCommand>     m_commands;         // sprite quads
-        std::vector<GeometryCommand> m_geometryCommands; // raw geometry
+        // Logical commands collected during a frame, by RenderQueue2D
+        std::array<QueueStorage, kRenderQueueCount> m_queues;
+        RenderQueue2D m_activeQueue = RenderQueue2D::World;
 
-        // Batching helpers reused each frame
-        std::vector<UnifiedCommand>  m_unifiedCommands;
-        std::vector<DrawRange>       m_drawRanges;
+        // Frame arena behind PushGeometryRaw()/AllocateGeometry() (capacity kept)
+        std::vector<Vertex>        m_arenaVertices;
+        std::vector<std::uint32_t> m_arenaIndices;
 
-        size_t m_spriteReserveHint = 256;
-        size_t m_geometryReserveHint = 256;
+        // Batching helpers reused each frame; the queues' items are concatenated
+        std::vector<BatchSortItem>  m_sortItems;
+        std::vector<BatchSortItem>  m_passItems; // m_sortItems reordered for the opaque pass
+        std::vector<BatchDrawRange> m_drawRanges;
+
+        bool                        m_opaquePass = true;
+        bool                        m_overdrawRequested = false;
+        OverdrawEstimator2D         m_overdraw;
+        std::vector<OverdrawQuad2D> m_overdrawQuads;
 
         DirectX::XMFLOAT4X4 m_viewProjT{};
         size_t              m_vertexCapacity = 0; // number of vertices allocated
         size_t              m_indexCapacity = 0; // number of indices allocated
         bool                m_isDrawing = false;
 
+        const SpriteLighting2D* m_lighting = nullptr;
+        int                     m_maxLitLayer = std::numeric_limits<int>::max();
+
         SpriteBatchStats    m_stats{};
 
         Texture2D m_defaultWhite;
@@ -0,0 +1,118 @@
+// Device-independent command ordering and draw-range merging behind SpriteBatch2D::End
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+struct ID3D11ShaderResourceView;
+
+namespace KibakoEngine {
+
+    // Named command queues of SpriteBatch2D, in the order End() draws them
+    enum class RenderQueue2D : std::uint8_t
+    {
+        World,
+        WorldOverlay, // labels, markers, in-world HUD
+        Debug,        // collider outlines and other debug shapes
+        UI,           // RmlUI geometry, already in paint order
+    };
+    inline constexpr std::size_t kRenderQueueCount = 4;
+
+    // How one queue orders its items before the queues are concatenated
+    enum class QueueSortPolicy : std::uint8_t
+    {
+        None,         // submission order; the queue is never sorted
+        Layer,        // layer, blend group, then submission order
+        LayerTexture, // layer, blend group, then texture: fewest binds, overlap order within a group is lost
+        YSort,        // layer, then bottom edge (BatchSortItem::depth) ascending, for top-down overlap
+        BackToFront,  // layer, then strict submission order: blend groups and textures stay interleaved
+    };
+
+    // Pixel scissor rectangle, right/bottom exclusive
+    struct BatchScissor
+    {
+        std::int32_t left = 0;
+        std::int32_t top = 0;
+        std::int32_t right = 0;
+        std::int32_t bottom = 0;
+
+        bool operator==(const BatchScissor&) const = default;
+    };
+
+    // One submission as the sort sees it
+    struct BatchSortItem
+    {
+        std::uint64_t             key = 0;        // MakeBatchSortKey()
+        ID3D11ShaderResourceView* srv = nullptr;
+        std::uint32_t             command = 0;    // into the sprite or geometry list, by the key's kind
+        std::uint8_t              queue = 0;      // RenderQueue2D holding the command
+        std::uint32_t             order = 0;      // submission order within the queue
+        std::uint32_t             indexCount = 0;
+        float                     depth = 0.0f;   // YSort only: bottom edge in pixels
+        float                     drawDepth = 0.0f; // depth-tested pass: 0 nearest, set by BuildDepthPassOrder
+        SpriteOpacity             opacity = SpriteOpacity::Translucent;
+        bool                      distanceField = false; // drawn with the distance-field pixel shader
+        bool                      hasScissor = false;
+        BatchScissor              scissor{};
+    };
+
+    // Consecutive items drawn with one DrawIndexed
+    struct BatchDrawRange
+    {
+        ID3D11ShaderResourceView* srv = nullptr;
+        BlendMode                 blend = BlendMode::Alpha;
+        int                       layer = 0;
+        SpriteOpacity             opacity = SpriteOpacity::Translucent;
+        bool                      distanceField = false;
+        std::uint32_t             firstIndex = 0;
+        std::uint32_t             indexCount = 0;
+        bool                      useScissor = false;
+        BatchScissor              scissor{};
+    };
+
+    // State binds needed to replay the ranges in order; the first range
+    // binds its blend state, pixel shader and texture (and its scissor, if any).
+    // Blend counts state objects, not modes: every non-translucent range
+    // shares the opaque pass's blending-off state.
+    struct BatchStateChanges
+    {
+        std::uint32_t blend = 0;
+        std::uint32_t texture = 0;
+        std::uint32_t scissor = 0;
+        std::uint32_t shader = 0;
+    };
+
+    // Layer in the high 32 bits, then the blend mode, then sprites before
+    // geometry. Within a layer, blend groups draw in the order Alpha,
+    // Premultiplied, Multiply, Additive, so glows land on top of the shading
+    // they brighten.
+    [[nodiscard]] std::uint64_t MakeBatchSortKey(int layer, BlendMode blend, bool isGeometry);
+    [[nodiscard]] int BatchKeyLayer(std::uint64_t key);
+    [[nodiscard]] BlendMode BatchKeyBlend(std::uint64_t key);
+    [[nodiscard]] bool BatchKeyIsGeometry(std::uint64_t key);
+
+    // Orders one queue's items by its policy. Layer: by key, then scissor
+    // (unclipped first), then submission order, so equal keys keep painter's
+    // order. Every policy ends on submission order, so the result is
+    // deterministic. Skipped when already in order, and always for None.
+    // Returns true when the items were reordered.
+    bool SortBatchItems(std::span<BatchSortItem> items, QueueSortPolicy policy = QueueSortPolicy::Layer);
+
+    // Depth-tested draw order: opaque and alpha-tested items first, front to
+    // back (reverse painter's order) so each one rejects what it hides, then
+    // the translucent ones in painter's order. Every item gets a drawDepth
+    // from its place in `painterOrder`, later items nearer, so depth testing
+    // reproduces the painter's result. Returns how many items lead `out` with
+    // depth writes.
+    std::uint32_t BuildDepthPassOrder(std::span<BatchSortItem> painterOrder, std::vector<BatchSortItem>& out);
+
+    // Merges neighbours that share texture, blend mode, layer, opacity, pixel
+    // shader and scissor.
+    // Indices are laid out in item order, so firstIndex is the running sum.
+    BatchStateChanges BuildBatchDrawRanges(std::span<const BatchSortItem> items, std::vector<BatchDrawRange>& out);
+
+} // namespace KibakoEngine
@@ -0,0 +1,71 @@
+// GPU copy of a light grid, bound by SpriteBatch2D for per-pixel 2D point lights
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <d3d11.h>
+#include <wrl/client.h>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class LightGrid2D;
+
+    // Three structured buffers mirroring LightGrid2D (lights, per-tile
+    // ranges, tile light indices) plus the grid placement the shader needs
+    // to find a pixel's tile. Upload once per frame after the grid is built;
+    // the buffers grow as needed and are rewritten with WRITE_DISCARD.
+    class SpriteLighting2D
+    {
+    public:
+        [[nodiscard]] bool Init(ID3D11Device* device);
+        void Shutdown();
+
+        // Replaces the GPU copy. Until the first successful upload the
+        // batch draws unlit.
+        bool Upload(ID3D11DeviceContext* context, const LightGrid2D& grid, const Color4& ambient);
+
+        [[nodiscard]] bool IsReady() const { return m_ready; }
+
+        [[nodiscard]] const Color4& Ambient() const { return m_ambient; }
+        [[nodiscard]] float OriginX() const { return m_originX; }
+        [[nodiscard]] float OriginY() const { return m_originY; }
+        [[nodiscard]] float TileSize() const { return m_tileSize; }
+        [[nodiscard]] std::uint32_t TilesX() const { return m_tilesX; }
+        [[nodiscard]] std::uint32_t TilesY() const { return m_tilesY; }
+
+        // t1..t3 of the sprite pixel shader, in that order
+        [[nodiscard]] ID3D11ShaderResourceView* LightsSRV() const { return m_lights.srv.Get(); }
+        [[nodiscard]] ID3D11ShaderResourceView* TileRangesSRV() const { return m_ranges.srv.Get(); }
+        [[nodiscard]] ID3D11ShaderResourceView* TileLightsSRV() const { return m_indices.srv.Get(); }
+
+    private:
+        struct StructuredBuffer
+        {
+            Microsoft::WRL::ComPtr<ID3D11Buffer>             buffer;
+            Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+            std::size_t                                      capacity = 0; // elements
+        };
+
+        [[nodiscard]] bool Ensure(StructuredBuffer& target, std::size_t stride, std::size_t count, const char* name);
+        [[nodiscard]] bool Write(ID3D11DeviceContext* context, StructuredBuffer& target, std::size_t stride,
+            const void* data, std::size_t count, const char* name);
+
+        ID3D11Device* m_device = nullptr;
+
+        StructuredBuffer m_lights;
+        StructuredBuffer m_ranges;
+        StructuredBuffer m_indices;
+
+        Color4        m_ambient = Color4::White();
+        float         m_originX = 0.0f;
+        float         m_originY = 0.0f;
+        float         m_tileSize = 1.0f;
+        std::uint32_t m_tilesX = 0;
+        std::uint32_t m_tilesY = 0;
+        bool          m_ready = false;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,88 @@
+// Nine-slice and tiled-fill sprites generated in bulk into a single geometry block
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class Texture2D;
+
+    // Everything the generated geometry depends on, texture size aside
+    struct SpriteShapeDesc
+    {
+        SpriteDrawMode mode = SpriteDrawMode::NineSlice;
+        RectF  dst{ 0.0f, 0.0f, 0.0f, 0.0f };
+        RectF  src{ 0.0f, 0.0f, 1.0f, 1.0f }; // normalized, like Push()
+        Color4 color = Color4::White();
+        float  rotation = 0.0f;               // radians, around the centre of dst
+
+        // NineSlice: borders are drawn at slices * borderScale pixels, and
+        // shrunk together when dst is too small for both sides
+        SpriteSlices slices{};
+        float        borderScale = 1.0f;
+        bool         fillCenter = true;
+
+        // Tiled: pixels per repeat; 0 uses the source region's texel size
+        float tileWidth = 0.0f;
+        float tileHeight = 0.0f;
+
+        bool operator==(const SpriteShapeDesc&) const = default;
+    };
+
+    struct SpriteShapeCounts
+    {
+        std::size_t vertices = 0;
+        std::size_t indices = 0;
+    };
+
+    // Tiled fills stop growing past this many repeats per axis: the tiles
+    // stretch instead
+    inline constexpr std::uint32_t kMaxSpriteTilesPerAxis = 256;
+
+    // Exact sizes BuildSpriteShape() writes (zero for Simple or an empty dst).
+    // textureWidth/Height are the texels of the whole texture.
+    [[nodiscard]] SpriteShapeCounts CountSpriteShape(const SpriteShapeDesc& desc, float textureWidth, float textureHeight);
+
+    // Nine-slice shares a 4x4 vertex grid (16 vertices, 54 indices); tiles are
+    // separate quads since each repeat restarts the source region. Indices
+    // are relative to `vertices`.
+    void BuildSpriteShape(const SpriteShapeDesc& desc, float textureWidth, float textureHeight,
+        SpriteBatch2D::Vertex* vertices, std::uint32_t* indices);
+
+    // Retained geometry for shapes whose parameters rarely change (panels,
+    // frames, static backdrops): regenerated only when the description or
+    // the texture size differs from the last Update(). Keep dst at the
+    // origin and move the shape with Submit()'s translation to avoid
+    // rebuilding when it only moves.
+    class SpriteShapeMesh2D
+    {
+    public:
+        // True when the geometry was regenerated
+        bool Update(const SpriteShapeDesc& desc, const Texture2D* texture);
+        void Invalidate() { m_valid = false; }
+
+        // Zero-copy: the mesh must stay alive and unchanged until the batch's End()
+        void Submit(SpriteBatch2D& batch, int layer = 0, BlendMode blend = BlendMode::Alpha,
+            DirectX::XMFLOAT2 translation = { 0.0f, 0.0f }) const;
+
+        [[nodiscard]] std::size_t VertexCount() const { return m_vertices.size(); }
+        [[nodiscard]] std::size_t IndexCount() const { return m_indices.size(); }
+
+    private:
+        SpriteShapeDesc                    m_desc{};
+        const Texture2D*                   m_texture = nullptr;
+        float                              m_textureWidth = 0.0f;
+        float                              m_textureHeight = 0.0f;
+        bool                               m_valid = false;
+        std::vector<SpriteBatch2D::Vertex> m_vertices;
+        std::vector<std::uint32_t>         m_indices;
+    };
+
+} // namespace KibakoEngine
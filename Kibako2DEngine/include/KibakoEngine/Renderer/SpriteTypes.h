@@ -3,6 +3,9 @@
 
 #include <DirectXMath.h>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace KibakoEngine {
 
     struct RectF {
@@ -15,6 +18,8 @@ namespace KibakoEngine {
         {
             return RectF{ px, py, pw, ph };
         }
+
+        bool operator==(const RectF&) const = default;
     };
 
     struct Color4 {
@@ -26,6 +31,43 @@ namespace KibakoEngine {
         static Color4 White() { return { 1.0f, 1.0f, 1.0f, 1.0f }; }
         static Color4 Black() { return { 0.0f, 0.0f, 0.0f, 1.0f }; }
         static Color4 Transparent() { return { 1.0f, 1.0f, 1.0f, 0.0f }; }
+
+        bool operator==(const Color4&) const = default;
+    };
+
+    // How a submission is composited over what is already drawn
+    enum class BlendMode : std::uint8_t {
+        Alpha,         // straight alpha: src * a + dst * (1 - a)
+        Additive,      // src * a + dst (glows, sparks)
+        Multiply,      // dst * lerp(1, src, a) (shadows, tinting)
+        Premultiplied, // src + dst * (1 - a): rgb (texture and color) already multiplied by alpha
+    };
+    inline constexpr std::size_t kBlendModeCount = 4;
+
+    // Coverage class of a submission. Opaque and alpha-tested ones can be drawn
+    // front to back with depth writes when the target has a depth buffer, so
+    // the pixels they hide are rejected before shading (SpriteBatch2D).
+    enum class SpriteOpacity : std::uint8_t {
+        Translucent, // blended back to front (opaque textures are promoted automatically)
+        Opaque,      // every covered pixel is fully opaque
+        AlphaTested, // texels under half alpha are discarded, the rest treated as opaque
+    };
+
+    // How a sprite fills its destination rectangle
+    enum class SpriteDrawMode : std::uint8_t {
+        Simple,    // one stretched quad (SpriteBatch2D::Push)
+        NineSlice, // corners keep their size, edges stretch along one axis, the centre along both
+        Tiled,     // the source region repeats across dst; the last row and column are cut
+    };
+
+    // Nine-slice borders, in texels of the source region
+    struct SpriteSlices {
+        float left = 0.0f;
+        float top = 0.0f;
+        float right = 0.0f;
+        float bottom = 0.0f;
+
+        bool operator==(const SpriteSlices&) const = default;
     };
 
     struct SpriteInstance {
@@ -34,6 +76,7 @@ namespace KibakoEngine {
         Color4 color;
         float  rotation = 0.0f;
         int    layer = 0;
+        BlendMode blend = BlendMode::Alpha;
     };
 
 } // namespace KibakoEngine
@@ -21,18 +21,40 @@ namespace KibakoEngine {
                               std::uint8_t g,
                               std::uint8_t b,
                               std::uint8_t a = 255);
+        // Blank RGBA8 texture (transparent) whose texels are rewritten with UpdateRegion
+        bool CreateUpdatable(ID3D11Device* device, int width, int height);
+        // Copies a width x height block of RGBA8 texels (rowPitch bytes apart)
+        // to (x, y). Only for textures made by CreateUpdatable.
+        void UpdateRegion(ID3D11DeviceContext* context,
+                          int x,
+                          int y,
+                          int width,
+                          int height,
+                          const std::uint8_t* pixels,
+                          int rowPitch);
+        // Offscreen color target that can also be sampled (render-to-texture views)
+        bool CreateRenderTarget(ID3D11Device* device, int width, int height);
         void Reset();
 
         [[nodiscard]] int Width() const { return m_width; }
         [[nodiscard]] int Height() const { return m_height; }
         [[nodiscard]] ID3D11ShaderResourceView* GetSRV() const { return m_srv.Get(); }
+        [[nodiscard]] ID3D11RenderTargetView* GetRTV() const { return m_rtv.Get(); }
         [[nodiscard]] bool IsValid() const { return m_srv != nullptr; }
 
+        // True when every texel has full alpha; found when the pixels are
+        // uploaded, false for updatable textures and render targets
+        [[nodiscard]] bool IsOpaque() const { return m_opaque; }
+        void SetOpaque(bool opaque) { m_opaque = opaque; }
+
     private:
         Microsoft::WRL::ComPtr<ID3D11Texture2D>        m_texture;
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_srv;
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView>   m_rtv; // only for render targets
         int m_width = 0;
         int m_height = 0;
+        bool m_updatable = false;
+        bool m_opaque = false;
     };
 
 } // namespace KibakoEngine
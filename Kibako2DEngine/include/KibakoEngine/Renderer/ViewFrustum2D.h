@@ -0,0 +1,47 @@
+// World-space view volume of a 2D camera (rotation aware) and overlap helpers
+#pragma once
+
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class Camera2D;
+
+    // Rectangle rotated around its center (cos/sin cached once)
+    struct OrientedRect2D
+    {
+        DirectX::XMFLOAT2 center{ 0.0f, 0.0f };
+        DirectX::XMFLOAT2 halfExtents{ 0.0f, 0.0f };
+        float cosR = 1.0f;
+        float sinR = 0.0f;
+
+        [[nodiscard]] static OrientedRect2D FromRotation(DirectX::XMFLOAT2 center,
+            DirectX::XMFLOAT2 halfExtents,
+            float radians);
+
+        [[nodiscard]] bool IsAxisAligned() const { return sinR == 0.0f; }
+
+        // Tight axis-aligned box around the rotated rectangle
+        [[nodiscard]] RectF BoundingRect() const;
+    };
+
+    [[nodiscard]] bool Overlaps(const RectF& a, const RectF& b);
+
+    // Exact separating-axis test (4 axes)
+    [[nodiscard]] bool Overlaps(const OrientedRect2D& a, const OrientedRect2D& b);
+
+    struct ViewFrustum2D
+    {
+        OrientedRect2D view;   // exact visible area
+        RectF          bounds; // AABB of the visible area (used for broadphase)
+
+        [[nodiscard]] static ViewFrustum2D FromCamera(const Camera2D& camera);
+        [[nodiscard]] static ViewFrustum2D FromRect(const RectF& rect);
+
+        // Broadphase against bounds, exact test only when either box is rotated
+        [[nodiscard]] bool Intersects(const OrientedRect2D& box) const;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,101 @@
+// Type-erased, aligned component array driven by per-type function pointers
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace KibakoEngine {
+
+    // Component type IDs double as bit indices in EntitySignature::components
+    using ComponentTypeId = std::uint32_t;
+    inline constexpr ComponentTypeId kMaxComponentTypes = 64;
+
+    // Hands out IDs in first-use order (0, 1, 2, ...). IDs past the limit are
+    // logged as errors in every build and get no signature bit (ComponentBit).
+    [[nodiscard]] ComponentTypeId AllocateComponentTypeId();
+
+    // Signature bit of a component type; 0 for IDs past kMaxComponentTypes
+    [[nodiscard]] constexpr std::uint64_t ComponentBit(ComponentTypeId id)
+    {
+        return (id < kMaxComponentTypes) ? (std::uint64_t{ 1 } << id) : 0;
+    }
+
+    // One ID per component type for the lifetime of the program
+    template<typename T>
+    [[nodiscard]] ComponentTypeId ComponentType()
+    {
+        static const ComponentTypeId id = AllocateComponentTypeId();
+        return id;
+    }
+
+    // What a column needs to manage values it cannot name
+    struct ComponentTypeInfo
+    {
+        std::size_t size = 0;
+        std::size_t alignment = 0;
+
+        // dst is uninitialised storage; src is left moved-from (still alive)
+        void (*moveConstruct)(void* dst, void* src) = nullptr;
+        void (*destroy)(void* value) = nullptr;
+        void (*swap)(void* a, void* b) = nullptr;
+    };
+
+    template<typename T>
+    [[nodiscard]] const ComponentTypeInfo& TypeInfoOf()
+    {
+        static const ComponentTypeInfo info{
+            sizeof(T),
+            alignof(T),
+            [](void* dst, void* src) { ::new (dst) T(std::move(*static_cast<T*>(src))); },
+            [](void* value) { static_cast<T*>(value)->~T(); },
+            [](void* a, void* b) { using std::swap; swap(*static_cast<T*>(a), *static_cast<T*>(b)); },
+        };
+        return info;
+    }
+
+    // Contiguous storage for one component type. Elements are only ever
+    // relocated (move-construct + destroy), so any movable type works.
+    class ComponentColumn
+    {
+    public:
+        explicit ComponentColumn(const ComponentTypeInfo& info);
+        ~ComponentColumn();
+
+        ComponentColumn(const ComponentColumn&) = delete;
+        ComponentColumn& operator=(const ComponentColumn&) = delete;
+
+        [[nodiscard]] const ComponentTypeInfo& Info() const { return *m_info; }
+        [[nodiscard]] std::size_t Size() const { return m_size; }
+        [[nodiscard]] std::size_t Capacity() const { return m_capacity; }
+
+        [[nodiscard]] void* At(std::size_t index) { return m_data + index * m_info->size; }
+        [[nodiscard]] const void* At(std::size_t index) const { return m_data + index * m_info->size; }
+        [[nodiscard]] void* Data() { return m_data; }
+        [[nodiscard]] const void* Data() const { return m_data; }
+
+        void Reserve(std::size_t capacity);
+
+        // Uninitialised slot at the end; construct into it, then CommitBack()
+        [[nodiscard]] void* PrepareBack();
+        void CommitBack() { ++m_size; }
+
+        // Moves the last element into `index` (destroying what was there)
+        void SwapRemove(std::size_t index);
+        // Destroys `dst`, then move-constructs `src` into it (src stays moved-from)
+        void Relocate(std::size_t dst, std::size_t src);
+        // Exchanges two live elements in place
+        void Swap(std::size_t a, std::size_t b) { m_info->swap(At(a), At(b)); }
+        // Destroys every element from `size` on
+        void Truncate(std::size_t size);
+        void Clear() { Truncate(0); }
+
+    private:
+        const ComponentTypeInfo* m_info = nullptr;
+        std::byte*  m_data = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;
+    };
+
+} // namespace KibakoEngine
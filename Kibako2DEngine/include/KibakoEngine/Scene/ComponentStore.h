@@ -1,114 +1,374 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <span>
 #include <vector>
 #include <unordered_map>
 #include <utility>
 #include <cstddef>
 #include <cstdint>
 
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Scene/ComponentColumn.h"
+
 namespace KibakoEngine {
 
     using EntityID = std::uint32_t;
 
+    // Monotonic change stamps, shared by every store of a scene so ticks can be
+    // compared across component types. Each stamp is unique: remember Now()
+    // after processing, and everything stamped later compares greater.
+    class ChangeClock
+    {
+    public:
+        [[nodiscard]] std::uint64_t Now() const { return m_value.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t Next() { return m_value.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    private:
+        std::atomic<std::uint64_t> m_value{ 0 };
+    };
+
+    // Lets a store keep its owner's per-entity component masks in sync
+    struct ComponentMaskSink
+    {
+        void* owner = nullptr;
+        void (*update)(void* owner, EntityID id, ComponentTypeId type, bool present) = nullptr;
+    };
+
     // Sparse-set style store:
-    // - Dense arrays for fast iteration
+    // - Dense type-erased column for fast iteration
     // - Sparse map for O(1) lookup/removal
-    template<typename T>
-    class ComponentStore
+    // - Per-slot added/changed stamps for "changed since tick" iteration
+    // - Enabled components partitioned into the dense prefix [0, EnabledCount())
+    //
+    // Everything that does not need to name T (removal, stamps, lookup) lives
+    // here, so a scene can manage stores of any registered type uniformly.
+    class ComponentStoreBase
     {
     public:
-        void Reserve(std::size_t count)
-        {
-            m_dense.reserve(count);
-            m_denseEntities.reserve(count);
-            m_sparse.reserve(count);
-        }
+        virtual ~ComponentStoreBase();
+
+        ComponentStoreBase(const ComponentStoreBase&) = delete;
+        ComponentStoreBase& operator=(const ComponentStoreBase&) = delete;
+
+        [[nodiscard]] ComponentTypeId TypeId() const { return m_typeId; }
+
+        // Stores without a shared clock stamp from a private counter
+        void SetClock(ChangeClock* clock) { m_clock = clock; }
+        [[nodiscard]] std::uint64_t ChangeTick() const { return m_clock ? m_clock->Now() : m_localTick; }
+
+        void SetMaskSink(const ComponentMaskSink& sink) { m_maskSink = sink; }
+
+        void Reserve(std::size_t count);
 
         bool Has(EntityID id) const
         {
             return m_sparse.contains(id);
         }
 
+        // Dense slot of the entity's component, kNoSlot if it has none
+        static constexpr std::size_t kNoSlot = static_cast<std::size_t>(-1);
+        [[nodiscard]] std::size_t IndexOf(EntityID id) const
+        {
+            auto it = m_sparse.find(id);
+            return (it == m_sparse.end()) ? kNoSlot : it->second;
+        }
+
+        // Bumped whenever existing components change slot (removal, compaction,
+        // partition swaps, Clear). Appends into a store with nothing disabled
+        // keep every slot, so caches of slot indices survive them.
+        [[nodiscard]] std::uint64_t LayoutVersion() const { return m_layoutVersion; }
+
+        // New components start enabled. Disabling swaps the component across the
+        // partition boundary instead of flagging it, so loops over the enabled
+        // prefix never test a per-item flag (slots move: see LayoutVersion()).
+        void SetEnabled(EntityID id, bool enabled);
+        [[nodiscard]] bool IsEnabled(EntityID id) const
+        {
+            auto it = m_sparse.find(id);
+            return it != m_sparse.end() && it->second < m_enabledCount;
+        }
+        [[nodiscard]] std::size_t EnabledCount() const { return m_enabledCount; }
+        [[nodiscard]] std::span<const EntityID> EnabledEntities() const { return { m_denseEntities.data(), m_enabledCount }; }
+
+        // Swaps the entity's component into dense slot `slot` (for external
+        // reordering). Fails if it has none or the swap would cross the partition.
+        bool MoveToSlot(EntityID id, std::size_t slot);
+
+        void Remove(EntityID id);
+
+        // Removes every component whose entity matches pred(id) in one compaction
+        // pass (keeps the order of the survivors, sparse entries fixed once each)
+        template<typename Pred>
+        std::size_t RemoveIf(Pred&& pred)
+        {
+            const std::size_t count = Size();
+
+            // Order-preserving, so the enabled prefix stays a prefix
+            std::size_t write = 0;
+            std::size_t enabled = 0;
+            for (std::size_t read = 0; read < count; ++read)
+            {
+                const EntityID id = m_denseEntities[read];
+                if (pred(id))
+                {
+                    m_sparse.erase(id);
+                    NotifyMask(id, false);
+                    continue;
+                }
+
+                if (read < m_enabledCount)
+                    ++enabled;
+
+                if (write != read)
+                {
+                    m_column.Relocate(write, read);
+                    m_denseEntities[write] = id;
+                    m_addedTicks[write] = m_addedTicks[read];
+                    m_changedTicks[write] = m_changedTicks[read];
+                    m_sparse[id] = write;
+                }
+                ++write;
+            }
+
+            if (write != count)
+                ++m_layoutVersion;
+
+            m_enabledCount = enabled;
+            m_column.Truncate(write);
+            m_denseEntities.resize(write);
+            m_addedTicks.resize(write);
+            m_changedTicks.resize(write);
+            return count - write;
+        }
+
+        void Clear();
+
+        std::size_t Size() const { return m_denseEntities.size(); }
+
+        // Owner of each dense slot, in iteration order
+        [[nodiscard]] std::span<const EntityID> Entities() const { return m_denseEntities; }
+
+        void MarkChanged(EntityID id)
+        {
+            auto it = m_sparse.find(id);
+            if (it != m_sparse.end())
+                m_changedTicks[it->second] = NextStamp();
+        }
+
+        // MarkChanged() for a dense slot already looked up (IndexOf(), cached slots)
+        void MarkChangedAt(std::size_t slot)
+        {
+            m_changedTicks[slot] = NextStamp();
+        }
+
+        // 0 if the entity has no component
+        [[nodiscard]] std::uint64_t ChangedTick(EntityID id) const
+        {
+            auto it = m_sparse.find(id);
+            return (it == m_sparse.end()) ? 0 : m_changedTicks[it->second];
+        }
+
+    protected:
+        ComponentStoreBase(ComponentTypeId typeId, const ComponentTypeInfo& info);
+
+        std::uint64_t NextStamp() { return m_clock ? m_clock->Next() : ++m_localTick; }
+
+        // Bookkeeping for a value just constructed into m_column.PrepareBack().
+        // Returns its final slot (moved in front of any disabled components).
+        std::size_t CommitAdd(EntityID id, std::uint64_t stamp);
+        // Room for `extra` more components without per-element regrowth
+        void Grow(std::size_t extra);
+
+        // Slot-level moves that keep the column, owners, stamps and sparse map in step
+        void MoveSlot(std::size_t dst, std::size_t src);
+        void SwapSlots(std::size_t a, std::size_t b);
+
+        void NotifyMask(EntityID id, bool present)
+        {
+            if (m_maskSink.update)
+                m_maskSink.update(m_maskSink.owner, id, m_typeId, present);
+        }
+
+        ComponentColumn m_column;
+        std::vector<EntityID> m_denseEntities;
+        std::vector<std::uint64_t> m_addedTicks;   // parallel to the column
+        std::vector<std::uint64_t> m_changedTicks; // parallel to the column, >= added
+        std::unordered_map<EntityID, std::size_t> m_sparse;
+
+        ComponentTypeId   m_typeId = 0;
+        ChangeClock*      m_clock = nullptr;
+        std::uint64_t     m_localTick = 0;
+        ComponentMaskSink m_maskSink;
+        std::uint64_t     m_layoutVersion = 0;
+        std::size_t       m_enabledCount = 0;
+    };
+
+    // Typed view over the column. Writes through TryGet()/ForEach() are not
+    // tracked: call MarkChanged() after editing in place, or edit through Patch().
+    template<typename T>
+    class ComponentStore final : public ComponentStoreBase
+    {
+    public:
+        ComponentStore()
+            : ComponentStoreBase(ComponentType<T>(), TypeInfoOf<T>())
+        {
+        }
+
         // Adds component if missing, returns existing otherwise.
         T& Add(EntityID id, const T& value = T{})
         {
-            const auto [it, inserted] = m_sparse.try_emplace(id, m_dense.size());
+            const auto [it, inserted] = m_sparse.try_emplace(id, Size());
             if (!inserted)
-                return m_dense[it->second];
+                return Dense()[it->second];
+
+            if (Size() == m_column.Capacity())
+            {
+                // value may live in this store: copy it before the column regrows
+                T copy(value);
+                ::new (m_column.PrepareBack()) T(std::move(copy));
+            }
+            else
+            {
+                ::new (m_column.PrepareBack()) T(value);
+            }
+            return Dense()[CommitAdd(id, NextStamp())];
+        }
+
+        // Bulk Add: values holds one entry per id, or a single value for all.
+        // Reserves once and shares one stamp; existing components are kept as-is.
+        std::size_t AddMany(std::span<const EntityID> ids, std::span<const T> values)
+        {
+            KBK_ASSERT(values.size() == ids.size() || values.size() == 1, "AddMany: value count mismatch");
+            if (ids.empty() || values.empty())
+                return 0;
 
-            m_dense.push_back(value);
-            m_denseEntities.push_back(id);
-            return m_dense.back();
+            Grow(ids.size());
+
+            const std::uint64_t stamp = NextStamp();
+            const std::size_t first = Size();
+            for (std::size_t i = 0; i < ids.size(); ++i)
+            {
+                const auto [it, inserted] = m_sparse.try_emplace(ids[i], Size());
+                if (!inserted)
+                    continue;
+
+                ::new (m_column.PrepareBack()) T(values[values.size() == 1 ? 0 : i]);
+                CommitAdd(ids[i], stamp);
+            }
+            return Size() - first;
         }
 
-        T* TryGet(EntityID id)
+        // fn(T&) on the component, stamped as changed. False if missing.
+        template<typename Fn>
+        bool Patch(EntityID id, Fn&& fn)
         {
             auto it = m_sparse.find(id);
             if (it == m_sparse.end())
-                return nullptr;
-            return &m_dense[it->second];
+                return false;
+
+            fn(Dense()[it->second]);
+            m_changedTicks[it->second] = NextStamp();
+            return true;
         }
 
-        const T* TryGet(EntityID id) const
+        T* TryGet(EntityID id)
         {
             auto it = m_sparse.find(id);
             if (it == m_sparse.end())
                 return nullptr;
-            return &m_dense[it->second];
+            return &Dense()[it->second];
         }
 
-        void Remove(EntityID id)
+        const T* TryGet(EntityID id) const
         {
             auto it = m_sparse.find(id);
             if (it == m_sparse.end())
-                return;
+                return nullptr;
+            return &Dense()[it->second];
+        }
 
-            const std::size_t index = it->second;
-            const std::size_t last = m_dense.size() - 1;
+        // Dense values, parallel to Entities()
+        [[nodiscard]] std::span<T> Values() { return { Dense(), Size() }; }
+        [[nodiscard]] std::span<const T> Values() const { return { Dense(), Size() }; }
 
-            if (index != last)
-            {
-                // Move last into removed slot (swap-remove)
-                m_dense[index] = std::move(m_dense[last]);
-                m_denseEntities[index] = m_denseEntities[last];
+        // Enabled prefix only, parallel to EnabledEntities()
+        [[nodiscard]] std::span<T> EnabledValues() { return { Dense(), m_enabledCount }; }
+        [[nodiscard]] std::span<const T> EnabledValues() const { return { Dense(), m_enabledCount }; }
 
-                // Fix sparse index of moved entity
-                const EntityID movedId = m_denseEntities[index];
-                m_sparse[movedId] = index;
-            }
+        template<typename Fn>
+        void ForEach(Fn&& fn)
+        {
+            T* dense = Dense();
+            for (std::size_t i = 0; i < Size(); ++i)
+                fn(m_denseEntities[i], dense[i]);
+        }
 
-            m_dense.pop_back();
-            m_denseEntities.pop_back();
-            m_sparse.erase(it);
+        template<typename Fn>
+        void ForEach(Fn&& fn) const
+        {
+            const T* dense = Dense();
+            for (std::size_t i = 0; i < Size(); ++i)
+                fn(m_denseEntities[i], dense[i]);
         }
 
-        void Clear()
+        template<typename Fn>
+        void ForEachEnabled(Fn&& fn)
         {
-            m_dense.clear();
-            m_denseEntities.clear();
-            m_sparse.clear();
+            T* dense = Dense();
+            for (std::size_t i = 0; i < m_enabledCount; ++i)
+                fn(m_denseEntities[i], dense[i]);
         }
 
-        std::size_t Size() const { return m_dense.size(); }
+        template<typename Fn>
+        void ForEachEnabled(Fn&& fn) const
+        {
+            const T* dense = Dense();
+            for (std::size_t i = 0; i < m_enabledCount; ++i)
+                fn(m_denseEntities[i], dense[i]);
+        }
 
+        // Components stamped (added or changed) after sinceTick.
+        // A linear scan over the stamps only; the components are not touched.
         template<typename Fn>
-        void ForEach(Fn&& fn)
+        void ForEachChanged(std::uint64_t sinceTick, Fn&& fn)
         {
-            for (std::size_t i = 0; i < m_dense.size(); ++i)
-                fn(m_denseEntities[i], m_dense[i]);
+            T* dense = Dense();
+            for (std::size_t i = 0; i < m_changedTicks.size(); ++i)
+            {
+                if (m_changedTicks[i] > sinceTick)
+                    fn(m_denseEntities[i], dense[i]);
+            }
         }
 
         template<typename Fn>
-        void ForEach(Fn&& fn) const
+        void ForEachChanged(std::uint64_t sinceTick, Fn&& fn) const
+        {
+            const T* dense = Dense();
+            for (std::size_t i = 0; i < m_changedTicks.size(); ++i)
+            {
+                if (m_changedTicks[i] > sinceTick)
+                    fn(m_denseEntities[i], dense[i]);
+            }
+        }
+
+        // Components added after sinceTick (removals are not tracked)
+        template<typename Fn>
+        void ForEachAdded(std::uint64_t sinceTick, Fn&& fn) const
         {
-            for (std::size_t i = 0; i < m_dense.size(); ++i)
-                fn(m_denseEntities[i], m_dense[i]);
+            const T* dense = Dense();
+            for (std::size_t i = 0; i < m_addedTicks.size(); ++i)
+            {
+                if (m_addedTicks[i] > sinceTick)
+                    fn(m_denseEntities[i], dense[i]);
+            }
         }
 
     private:
-        std::vector<T> m_dense;
-        std::vector<EntityID> m_denseEntities;
-        std::unordered_map<EntityID, std::size_t> m_sparse;
+        T* Dense() { return static_cast<T*>(m_column.Data()); }
+        const T* Dense() const { return static_cast<const T*>(m_column.Data()); }
     };
 
-} // namespace KibakoEngine
\ No newline at end of file
+} // namespace KibakoEngine
@@ -0,0 +1,123 @@
+// Deferred structural changes for a Scene2D, applied in one batch at a sync point
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "KibakoEngine/Core/JobSystem.h"
+#include "KibakoEngine/Scene/Scene2D.h"
+
+namespace KibakoEngine {
+
+    // Lets systems create/destroy entities and add/remove components while they
+    // iterate Entities() or a ComponentStore; nothing touches the scene until
+    // Playback().
+    //
+    // Each thread records into its own stream (JobSystem::CurrentThreadIndex()),
+    // so recording from parallel jobs takes no lock. Record from the main thread
+    // or from JobSystem jobs only, and never while Playback()/Discard() runs.
+    //
+    // Playback order: creations (by ID), then edits in record order per thread,
+    // then every destruction as one DestroyEntities() batch. Edits aimed at
+    // entities destroyed by the same playback are dropped.
+    class EntityCommandBuffer2D
+    {
+    public:
+        explicit EntityCommandBuffer2D(Scene2D& scene);
+
+        EntityCommandBuffer2D(const EntityCommandBuffer2D&) = delete;
+        EntityCommandBuffer2D& operator=(const EntityCommandBuffer2D&) = delete;
+
+        // The ID is reserved immediately and can be used by later commands
+        [[nodiscard]] EntityID CreateEntity(const Transform2D& transform = {}, bool active = true);
+        void DestroyEntity(EntityID id);
+
+        void SetTransform(EntityID id, const Transform2D& transform);
+        void SetActive(EntityID id, bool active);
+        void SetParent(EntityID child, EntityID parent, bool keepWorld = false);
+
+        void AddSprite(EntityID id, SpriteRenderer2D sprite);
+        void RemoveSprite(EntityID id);
+
+        void AddName(EntityID id, std::string name);
+
+        void AddScript(EntityID id, ScriptComponent script);
+        void RemoveScript(EntityID id);
+
+        void AddCircleCollider(EntityID id, float radius, bool active = true);
+        void AddAABBCollider(EntityID id, float halfW, float halfH, bool active = true);
+        void RemoveCollider(EntityID id);
+
+        // Main thread only (reads every stream)
+        [[nodiscard]] bool Empty() const { return CommandCount() == 0; }
+        [[nodiscard]] std::size_t CommandCount() const;
+
+        void Playback();
+        // Drops everything recorded; reserved IDs are simply never used
+        void Discard();
+
+        [[nodiscard]] Scene2D& Scene() { return *m_scene; }
+
+    private:
+        enum class CommandType : std::uint8_t
+        {
+            Create,
+            Destroy,
+            SetTransform,
+            SetActive,
+            SetParent,
+            AddSprite,
+            RemoveSprite,
+            AddName,
+            AddScript,
+            RemoveScript,
+            AddCircleCollider,
+            AddAABBCollider,
+            RemoveCollider,
+        };
+
+        struct Command
+        {
+            CommandType   type = CommandType::Create;
+            bool          flag = false;
+            EntityID      id = 0;
+            EntityID      other = 0;   // SetParent: parent
+            std::uint32_t payload = 0; // index into the stream's payload array
+            float         a = 0.0f;
+            float         b = 0.0f;
+        };
+
+        // Non-trivial payloads live next to the commands so Command stays small
+        struct Stream
+        {
+            std::vector<Command>          commands;
+            std::vector<Transform2D>      transforms;
+            std::vector<SpriteRenderer2D> sprites;
+            std::vector<std::string>      names;
+            std::vector<ScriptComponent>  scripts;
+
+            void Clear();
+        };
+
+        Stream& LocalStream();
+        Command& Push(Stream& stream, CommandType type, EntityID id);
+
+        void ApplyEdit(Stream& stream, const Command& cmd);
+        [[nodiscard]] bool IsDestroyed(EntityID id) const;
+
+        Scene2D* m_scene = nullptr;
+
+        // Allocated by the owning thread on first use
+        std::array<std::unique_ptr<Stream>, JobSystem::kMaxThreads> m_streams;
+
+        // Playback scratch (kept for its capacity)
+        std::vector<EntityID>                                 m_destroyed;
+        std::vector<std::pair<const Stream*, const Command*>> m_creates;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,126 @@
+// Persistent entity query with incrementally maintained membership
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Scene/Scene2D.h"
+
+namespace KibakoEngine {
+
+    // Created with Scene2D::CreateQuery and owned by the scene.
+    //
+    // Membership is never rescanned: the scene reports every signature,
+    // enable/disable and create/destroy change that flips an entity in or out,
+    // and the query merges those into its sorted member list the next time it
+    // is read.
+    //
+    // ForEach<Ts...> walks cached entity/component slot indices, so a frame
+    // without structural changes does no hash lookups at all. The slots are
+    // recomputed only after the membership changes or one of the stores (or the
+    // entity array) compacts.
+    //
+    // Do not create/destroy entities or add/remove components from inside
+    // ForEach; record them in an EntityCommandBuffer2D instead.
+    class EntityQuery2D
+    {
+    public:
+        EntityQuery2D(const EntityQuery2D&) = delete;
+        EntityQuery2D& operator=(const EntityQuery2D&) = delete;
+
+        [[nodiscard]] const SignatureQuery& Filter() const { return m_filter; }
+        [[nodiscard]] bool ActiveOnly() const { return m_activeOnly; }
+
+        // Sorted by EntityID
+        [[nodiscard]] std::span<const EntityID> Entities()
+        {
+            Flush();
+            return m_members;
+        }
+
+        [[nodiscard]] std::size_t Size()
+        {
+            Flush();
+            return m_members.size();
+        }
+
+        // fn(Entity2D&, Ts&...). Every T must be a component in the filter's With<>;
+        // otherwise the walk is skipped and an error is logged.
+        template<typename... Ts, typename Fn>
+        void ForEach(Fn&& fn)
+        {
+            Flush();
+            if (m_members.empty())
+                return;
+
+            RefreshEntitySlots();
+            if (!(RequireComponent(ComponentType<Ts>()) && ...))
+                return;
+            Walk<Ts...>(fn, std::index_sequence_for<Ts...>{});
+        }
+
+    private:
+        friend class Scene2D;
+
+        struct SlotCache
+        {
+            ComponentTypeId            type = 0;
+            bool                       valid = false;
+            std::uint64_t              layoutVersion = 0;
+            std::uint64_t              membersVersion = 0;
+            std::vector<std::uint32_t> slots; // parallel to m_members
+        };
+
+        EntityQuery2D(Scene2D& scene, const SignatureQuery& filter, bool activeOnly);
+
+        // sig == nullptr: the entity does not exist
+        [[nodiscard]] bool Wants(const EntitySignature* sig, bool active) const
+        {
+            return sig && (active || !m_activeOnly) && m_filter.Matches(*sig);
+        }
+
+        void MarkDirty(EntityID id) { m_dirty.push_back(id); }
+        void Rebuild();
+        void Flush();
+
+        void RefreshEntitySlots();
+        // False when type is not guaranteed by the filter (nothing to walk safely)
+        [[nodiscard]] bool RequireComponent(ComponentTypeId type);
+        [[nodiscard]] const std::uint32_t* ComponentSlots(ComponentTypeId type) const;
+
+        template<typename... Ts, typename Fn, std::size_t... I>
+        void Walk(Fn& fn, std::index_sequence<I...>)
+        {
+            Entity2D* entities = m_scene->m_entities.data();
+            const std::uint32_t* entitySlots = m_entitySlots.slots.data();
+
+            // Resolved once per walk; the caches were refreshed beforehand
+            [[maybe_unused]] const std::tuple<Ts*...> values{ m_scene->Store<Ts>().Values().data()... };
+            [[maybe_unused]] const std::uint32_t* slots[sizeof...(Ts) + 1] = {
+                ComponentSlots(ComponentType<Ts>())..., nullptr };
+
+            const std::size_t count = m_members.size();
+            for (std::size_t i = 0; i < count; ++i)
+                fn(entities[entitySlots[i]], std::get<I>(values)[slots[I][i]]...);
+        }
+
+        Scene2D*       m_scene = nullptr;
+        SignatureQuery m_filter;
+        bool           m_activeOnly = true;
+
+        std::vector<EntityID> m_members; // sorted
+        std::vector<EntityID> m_dirty;   // may have flipped since the last Flush
+        std::vector<EntityID> m_mergeScratch;
+        std::uint64_t         m_membersVersion = 1;
+
+        SlotCache              m_entitySlots;
+        std::vector<SlotCache> m_componentSlots;
+        bool                   m_reportedMisuse = false;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,93 @@
+// Packed per-entity component/tag bitsets and the queries that filter them
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "KibakoEngine/Scene/ComponentColumn.h"
+
+namespace KibakoEngine {
+
+    // Tag types are empty structs (struct Enemy {};). They have no storage at
+    // all and only exist as a bit in the entity's signature.
+    using TagTypeId = std::uint32_t;
+    inline constexpr TagTypeId kMaxTagTypes = 64;
+
+    template<typename T>
+    inline constexpr bool kIsTag = std::is_empty_v<T>;
+
+    // IDs past kMaxTagTypes are logged as errors in every build and get no bit
+    [[nodiscard]] TagTypeId AllocateTagTypeId();
+
+    [[nodiscard]] constexpr std::uint64_t TagBit(TagTypeId id)
+    {
+        return (id < kMaxTagTypes) ? (std::uint64_t{ 1 } << id) : 0;
+    }
+
+    template<typename T>
+    [[nodiscard]] TagTypeId TagType()
+    {
+        static_assert(kIsTag<T>, "Tags must be empty types");
+        static const TagTypeId id = AllocateTagTypeId();
+        return id;
+    }
+
+    // Bit ComponentType<T>() / TagType<T>() is set while the entity has a T
+    struct EntitySignature
+    {
+        std::uint64_t components = 0;
+        std::uint64_t tags = 0;
+    };
+
+    // "Has all of X, none of Y" over components and tags alike:
+    //   SignatureQuery{}.With<SpriteRenderer2D, Static>().Without<Enemy>()
+    // Requiring a type past the ID limits matches nothing (no entity can show it).
+    struct SignatureQuery
+    {
+        EntitySignature all;
+        EntitySignature none;
+        bool            satisfiable = true;
+
+        template<typename... Ts>
+        SignatureQuery& With()
+        {
+            ((satisfiable = Set<Ts>(all) && satisfiable), ...);
+            return *this;
+        }
+
+        template<typename... Ts>
+        SignatureQuery& Without()
+        {
+            (static_cast<void>(Set<Ts>(none)), ...);
+            return *this;
+        }
+
+        // Branch-free so scans over a packed signature array vectorise
+        [[nodiscard]] bool Matches(const EntitySignature& sig) const
+        {
+            const std::uint64_t miss =
+                ((sig.components & all.components) ^ all.components) |
+                ((sig.tags & all.tags) ^ all.tags) |
+                (sig.components & none.components) |
+                (sig.tags & none.tags);
+            return (miss == 0) & satisfiable;
+        }
+
+    private:
+        // False when T has no bit to set
+        template<typename T>
+        static bool Set(EntitySignature& sig)
+        {
+            std::uint64_t bit = 0;
+            if constexpr (kIsTag<T>) {
+                bit = TagBit(TagType<T>());
+                sig.tags |= bit;
+            } else {
+                bit = ComponentBit(ComponentType<T>());
+                sig.components |= bit;
+            }
+            return bit != 0;
+        }
+    };
+
+} // namespace KibakoEngine
@@ -1,11 +1,16 @@
 // Lightweight 2D scene container with component stores (Phase 3A)
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <span>
 #include <vector>
 #include <string>
 #include <deque>
+#include <memory>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <variant>
 
 #include <DirectXMath.h>
@@ -15,18 +20,25 @@
 #include "KibakoEngine/Renderer/Texture2D.h"
 #include "KibakoEngine/Collision/Collision2D.h"
 #include "KibakoEngine/Scene/ComponentStore.h"
+#include "KibakoEngine/Scene/EntitySignature.h"
+#include "KibakoEngine/Scene/SceneVisibility2D.h"
+#include "KibakoEngine/Scene/SpatialGrid2D.h"
+#include "KibakoEngine/Scene/SpriteAnimation2D.h"
+#include "KibakoEngine/Scene/Tilemap2D.h"
+#include "KibakoEngine/Scene/Transform2D.h"
+#include "KibakoEngine/Scene/TransformHierarchy2D.h"
 
 namespace KibakoEngine {
 
     class SpriteBatch2D;
     class AssetManager;
-
-    struct Transform2D
-    {
-        DirectX::XMFLOAT2 position{ 0.0f, 0.0f };
-        float             rotation = 0.0f;
-        DirectX::XMFLOAT2 scale{ 1.0f, 1.0f };
-    };
+    class JobSystem;
+    class EntityQuery2D;
+    struct GameTime;
+    struct ViewFrustum2D;
+    struct RenderView2D;
+    class Camera2D;
+    struct LightInstance2D;
 
     // ---- Components ---------------------------------------------------------
 
@@ -42,6 +54,25 @@ namespace KibakoEngine {
         RectF  src{ 0.0f, 0.0f, 1.0f, 1.0f };
         Color4 color = Color4::White();
         int    layer = 0;
+        BlendMode blend = BlendMode::Alpha; // "blend": "alpha"|"additive"|"multiply"|"premultiplied"
+        // "opacity": "translucent"|"opaque"|"alphaTested"; opaque textures are promoted anyway
+        SpriteOpacity opacity = SpriteOpacity::Translucent;
+
+        // "mode": "simple"|"nineSlice"|"tiled", "slices": [left, top, right, bottom]
+        // in source texels, "tileSize": [w, h] in pixels (0 = source texel size)
+        SpriteDrawMode    mode = SpriteDrawMode::Simple;
+        SpriteSlices      slices{};
+        DirectX::XMFLOAT2 tileSize{ 0.0f, 0.0f };
+    };
+
+    // Point light at the entity's world position, binned per screen tile by
+    // LightGrid2D. Scene files: "light": { "color", "intensity", "radius", "enabled" }.
+    struct PointLight2D
+    {
+        Color4 color = Color4::White(); // alpha unused
+        float  intensity = 1.0f;
+        float  radius = 128.0f;         // world units
+        bool   enabled = true;
     };
 
     struct NameComponent
@@ -63,9 +94,19 @@ namespace KibakoEngine {
     struct Entity2D
     {
         EntityID id = 0;
-        bool     active = true;
+        bool     active = true; // read-only mirror of the partition: use Scene2D::SetActive
+
+        // Local transform. Written only through Scene2D (SetTransform,
+        // PatchTransform), which keeps the hierarchy and culling bounds in step.
+        [[nodiscard]] const Transform2D& Transform() const { return m_transform; }
 
-        Transform2D transform;
+        // Stamp of the last transform edit reported through SetTransform/MarkTransformDirty
+        std::uint64_t changeTick = 0;
+
+    private:
+        friend class Scene2D;
+
+        Transform2D m_transform;
     };
 
     // ---- Scene --------------------------------------------------------------
@@ -73,23 +114,115 @@ namespace KibakoEngine {
     class Scene2D
     {
     public:
-        Scene2D() = default;
+        Scene2D();
+        ~Scene2D();
 
         [[nodiscard]] Entity2D& CreateEntity();
         [[nodiscard]] Entity2D& CreateEntityWithID(EntityID forcedId);
 
+        // Bulk creation for waves/bullet patterns: contiguous IDs written to outIds,
+        // storage reserved once, one revision bump. transforms holds one entry per
+        // entity, a single entry for all, or nothing (identity).
+        void CreateEntities(std::size_t count, std::span<EntityID> outIds,
+            std::span<const Transform2D> transforms = {});
+
         void DestroyEntity(EntityID id);
+        // Batched destroy. Large batches compact every store and fix the lookup
+        // tables up once instead of one swap-remove per entity and store; small
+        // ones (under 1/16 of the entities) fall back to DestroyEntity each.
+        void DestroyEntities(std::span<const EntityID> ids);
         void Clear();
 
+        // Thread-safe: hands out an ID for a CreateEntityWithID() that happens later
+        // (see EntityCommandBuffer2D)
+        [[nodiscard]] EntityID ReserveEntityID();
+
         [[nodiscard]] Entity2D* FindEntity(EntityID id);
         [[nodiscard]] const Entity2D* FindEntity(EntityID id) const;
 
         [[nodiscard]] Entity2D* FindByName(const std::string& name);
         [[nodiscard]] const Entity2D* FindByName(const std::string& name) const;
 
+        // Active entities come first: [0, ActiveCount()) is active, the rest is not
         std::vector<Entity2D>& Entities() { return m_entities; }
         const std::vector<Entity2D>& Entities() const { return m_entities; }
 
+        [[nodiscard]] std::span<Entity2D> ActiveEntities() { return { m_entities.data(), m_activeCount }; }
+        [[nodiscard]] std::span<const Entity2D> ActiveEntities() const { return { m_entities.data(), m_activeCount }; }
+        [[nodiscard]] std::size_t ActiveCount() const { return m_activeCount; }
+
+        // Swaps the entity across the active/inactive boundary (so Entities()
+        // order and Entity2D pointers change) and keeps cached queries in step.
+        // Never write Entity2D::active directly.
+        void SetActive(EntityID id, bool active);
+
+        // ---- Transforms -----------------------------------------------------
+
+        // Both mark the entity dirty, so the hierarchy and the culling index follow
+        void SetTransform(EntityID id, const Transform2D& transform);
+
+        // fn(Transform2D&) on the local transform. False if the entity does not exist.
+        template<typename Fn>
+        bool PatchTransform(EntityID id, Fn&& fn)
+        {
+            Entity2D* entity = FindEntity(id);
+            if (!entity)
+                return false;
+
+            fn(entity->m_transform);
+            MarkTransformDirty(id);
+            return true;
+        }
+
+        // Sprite edits are picked up from the sprite store's change stamps (Patch(),
+        // MarkChanged(), TryGetSprite()); this re-stamps an entity by hand
+        void MarkTransformDirty(EntityID id);
+
+        // ---- Change detection -----------------------------------------------
+
+        // Entities and all component stores stamp from one clock. Remember
+        // ChangeTick() after processing, pass it back as sinceTick next time.
+        [[nodiscard]] std::uint64_t ChangeTick() const { return m_changeClock.Now(); }
+
+        // Local transform edits (creation counts as one). Parented entities whose
+        // parent moved are reported by Hierarchy().Changed() instead.
+        template<typename Fn>
+        void ForEachTransformChanged(std::uint64_t sinceTick, Fn&& fn) const
+        {
+            for (const Entity2D& entity : m_entities) {
+                if (entity.changeTick > sinceTick)
+                    fn(entity);
+            }
+        }
+
+        // ---- Hierarchy ------------------------------------------------------
+
+        // Entity2D::Transform() is relative to the parent. keepWorld rewrites the
+        // child's local transform so it does not jump when (re)parented.
+        bool SetParent(EntityID child, EntityID parent, bool keepWorld = false);
+        [[nodiscard]] EntityID GetParent(EntityID id) const;
+
+        // Propagates dirty subtrees; Render() does it lazily on one thread,
+        // call this with a JobSystem to spread large hierarchies over workers.
+        // Also settles the lazy state behind WorldTransform() and the culling
+        // bounds, so concurrent readers afterwards touch nothing shared.
+        void UpdateTransforms(JobSystem* jobs = nullptr);
+
+        [[nodiscard]] Transform2D WorldTransform(EntityID id) const;
+        [[nodiscard]] const TransformHierarchy2D& Hierarchy() const { return m_hierarchy; }
+
+        // ---- Spatial reordering ---------------------------------------------
+
+        // Incremental pass that sorts the active entities by the Morton code of
+        // their world position (quantised to cellSize), then every store's
+        // enabled components into the same order, so world neighbours are also
+        // memory neighbours. Each call does at most `budget` steps; a new pass
+        // starts once the previous one is done. Returns true when a pass ends.
+        // Sprites sharing a layer draw in storage order, so their overlap
+        // order can change while this runs.
+        bool ReorderSpatially(std::size_t budget, float cellSize = 64.0f);
+        [[nodiscard]] bool IsReorderingSpatially() const { return m_reorder.running; }
+
         // ---- Component stores access ---------------------------------------
 
         ComponentStore<SpriteRenderer2D>& Sprites() { return m_sprites; }
@@ -102,27 +235,170 @@ namespace KibakoEngine {
         const ComponentStore<NameComponent>& Names() const { return m_names; }
         const ComponentStore<ScriptComponent>& Scripts() const { return m_scripts; }
 
+        // ---- Component registry ---------------------------------------------
+
+        // Store for any component type; game types are registered on first use
+        // and get the same dense storage, change ticks and cleanup as built-ins.
+        template<typename T>
+        ComponentStore<T>& Store()
+        {
+            static_assert(!kIsTag<T>, "Empty types are tags: use AddTag/RemoveTag");
+
+            const ComponentTypeId type = ComponentType<T>();
+            if (type >= m_storeTable.size() || !m_storeTable[type]) {
+                auto store = std::make_unique<ComponentStore<T>>();
+                RegisterStore(*store);
+                m_customStores.push_back(std::move(store));
+            }
+            return static_cast<ComponentStore<T>&>(*m_storeTable[type]);
+        }
+
+        // nullptr if no T was ever stored in this scene
+        template<typename T>
+        const ComponentStore<T>* TryStore() const
+        {
+            const ComponentTypeId type = ComponentType<T>();
+            if (type >= m_storeTable.size() || !m_storeTable[type])
+                return nullptr;
+            return static_cast<const ComponentStore<T>*>(m_storeTable[type]);
+        }
+
+        // ---- Signatures & tags -----------------------------------------------
+
+        // One packed signature per entity, parallel to Entities(): components are
+        // kept in sync by the stores, tags only exist here.
+        [[nodiscard]] std::span<const EntitySignature> Signatures() const { return m_signatures; }
+        [[nodiscard]] EntitySignature Signature(EntityID id) const;
+        [[nodiscard]] bool Matches(EntityID id, const SignatureQuery& query) const;
+
+        // One lookup for any mix of component and tag types
+        template<typename... Ts>
+        [[nodiscard]] bool Has(EntityID id) const { return Matches(id, SignatureQuery{}.With<Ts...>()); }
+
+        template<typename T>
+        void AddTag(EntityID id) { SetTag(id, TagType<T>(), true); }
+        template<typename T>
+        void RemoveTag(EntityID id) { SetTag(id, TagType<T>(), false); }
+
+        // ---- Cached queries -------------------------------------------------
+
+        // Persistent, incrementally maintained match list (see EntityQuery2D).
+        // The scene owns it; the reference stays valid until DestroyQuery/~Scene2D.
+        EntityQuery2D& CreateQuery(const SignatureQuery& filter, bool activeOnly = true);
+        void DestroyQuery(EntityQuery2D& query);
+
+        // fn(Entity2D&) for every entity whose signature matches, in scene order
+        template<typename Fn>
+        void ForEachMatching(const SignatureQuery& query, Fn&& fn)
+        {
+            for (std::size_t i = 0; i < m_signatures.size(); ++i) {
+                if (query.Matches(m_signatures[i]))
+                    fn(m_entities[i]);
+            }
+        }
+
+        template<typename Fn>
+        void ForEachMatching(const SignatureQuery& query, Fn&& fn) const
+        {
+            for (std::size_t i = 0; i < m_signatures.size(); ++i) {
+                if (query.Matches(m_signatures[i]))
+                    fn(m_entities[i]);
+            }
+        }
+
         // ---- Component helpers ---------------------------------------------
 
         SpriteRenderer2D& AddSprite(EntityID id);
+        // Stamps the sprite as changed: edits through the pointer reach culling
         SpriteRenderer2D* TryGetSprite(EntityID id);
         const SpriteRenderer2D* TryGetSprite(EntityID id) const;
+        void RemoveSprite(EntityID id);
 
         NameComponent& AddName(EntityID id, const std::string& name = {});
         NameComponent* TryGetName(EntityID id);
         const NameComponent* TryGetName(EntityID id) const;
 
+        // Stored in Store<SpriteAnimator2D>(); drives the entity's sprite src
+        SpriteAnimator2D& AddAnimator(EntityID id, AnimationClipId clip);
+        SpriteAnimator2D* TryGetAnimator(EntityID id);
+        const SpriteAnimator2D* TryGetAnimator(EntityID id) const;
+        void RemoveAnimator(EntityID id);
+
+        // Stored in Store<TilemapComponent2D>(); one map (layer) per entity
+        TilemapComponent2D& AddTilemap(EntityID id);
+        TilemapComponent2D* TryGetTilemap(EntityID id);
+        const TilemapComponent2D* TryGetTilemap(EntityID id) const;
+        void RemoveTilemap(EntityID id);
+
+        // Stored in Store<PointLight2D>()
+        PointLight2D& AddLight(EntityID id);
+        PointLight2D* TryGetLight(EntityID id);
+        const PointLight2D* TryGetLight(EntityID id) const;
+        void RemoveLight(EntityID id);
+
         ScriptComponent& AddScript(EntityID id);
         ScriptComponent* TryGetScript(EntityID id);
         const ScriptComponent* TryGetScript(EntityID id) const;
+        void RemoveScript(EntityID id);
 
         CircleCollider2D* AddCircleCollider(EntityID id, float radius, bool active = true);
         AABBCollider2D* AddAABBCollider(EntityID id, float halfW, float halfH, bool active = true);
+        // Flips the shape's flag and moves the component across the enabled
+        // partition of Collisions(), so ForEachEnabled() skips it without a test
+        void SetColliderActive(EntityID id, bool active);
+        void RemoveCollider(EntityID id);
+
+        // ---- Bulk component helpers -----------------------------------------
+
+        // values: one per id or a single shared value. Entities that already have
+        // the component keep it. Returns how many components were added.
+        template<typename T>
+        std::size_t AddComponents(std::span<const EntityID> ids, std::span<const T> values)
+        {
+            const std::size_t added = Store<T>().AddMany(ids, values);
+
+            if constexpr (std::is_same_v<T, SpriteRenderer2D>) {
+                if (m_spatialIndexInUse)
+                    m_boundsDirty.insert(m_boundsDirty.end(), ids.begin(), ids.end());
+            }
+            else if constexpr (std::is_same_v<T, NameComponent>) {
+                for (EntityID id : ids) {
+                    const NameComponent* n = m_names.TryGet(id);
+                    if (n && !n->name.empty())
+                        m_nameLookup[n->name] = id;
+                }
+                BumpRevision();
+            }
+            return added;
+        }
+
+        std::size_t AddCircleColliders(std::span<const EntityID> ids, float radius, bool active = true);
 
         // ---- Runtime --------------------------------------------------------
 
         void Update(float dt);
+
+        // One pass over every animator (jobs spreads it over the workers): each
+        // advances by the scaled delta of `time`, or the raw one if unscaledTime,
+        // and only sprites whose frame changed get their src rewritten
+        void UpdateAnimations(const GameTime& time, JobSystem* jobs = nullptr);
+
+        // Clips referenced by SpriteAnimator2D::clip. Clips added in code are
+        // kept by Clear(); those a scene file loads through its "animations"
+        // list of clip files belong to the scene and are removed with it.
+        [[nodiscard]] AnimationLibrary2D& AnimationClips() { return m_animationClips; }
+        [[nodiscard]] const AnimationLibrary2D& AnimationClips() const { return m_animationClips; }
         void Render(SpriteBatch2D& batch, const RectF* visibleRect = nullptr) const;
+        // Rotation-aware culling: spatial index query on the view AABB, then exact OBB test
+        void Render(SpriteBatch2D& batch, const ViewFrustum2D& frustum) const;
+
+        // Multi-view: one culling pass per view, sprites seen by several views are
+        // extracted once. Replay each view with SceneVisibility2D::Submit.
+        void ExtractVisible(std::span<const RenderView2D> views, SceneVisibility2D& out) const;
+        // Enabled lights of active entities, projected into the pixels of
+        // `viewport` through `camera` and appended to `out` (LightGrid2D input)
+        void CollectLights(const Camera2D& camera, const RectF& viewport, std::vector<LightInstance2D>& out) const;
+
         void SetCollisionDebugEnabled(bool enabled);
         [[nodiscard]] bool IsCollisionDebugEnabled() const;
 
@@ -132,11 +408,76 @@ namespace KibakoEngine {
         [[nodiscard]] std::uint64_t Revision() const { return m_revision; }
 
     private:
+        friend class EntityQuery2D;
+
+        // Sorted by id: storage order changes (spatial reordering, the active
+        // partition) must not reorder same-layer sprites
+        struct VisibleSprite
+        {
+            EntityID                id = 0;
+            std::size_t             entityIndex = 0;
+            const SpriteRenderer2D* sprite = nullptr;
+        };
+
+        // Active entities in EntityID order. Storage moves only refresh the
+        // slots (no sort); the ids are re-sorted when the active set changes.
+        struct ActiveIdOrder
+        {
+            std::vector<EntityID>      ids;
+            std::vector<std::uint32_t> slots; // parallel to ids
+            std::uint64_t              layoutVersion = 0;
+            bool                       valid = false;
+        };
+
         void BumpRevision();
+        void RegisterStore(ComponentStoreBase& store);
+        static void OnComponentMaskChanged(void* owner, EntityID id, ComponentTypeId type, bool present);
+        void SetTag(EntityID id, TagTypeId tag, bool present);
+        // Tells every query whose membership flips; nullptr = entity does not exist
+        void NotifyQueries(EntityID id, const EntitySignature* before, bool beforeActive,
+            const EntitySignature* after, bool afterActive);
         void RemoveEntityAtSwapIndex(std::size_t index);
-
-        EntityID m_nextID = 1;
+        void SwapEntitySlots(std::size_t a, std::size_t b);
+        // Re-roots the children of the given (sorted) entities, keeping their world placement
+        void DetachChildrenOf(std::span<const EntityID> sortedIds);
+        void ForgetName(EntityID id);
+
+        // World transform of the entity in storage slot `slot`: the hierarchy's
+        // SoA arrays for parented entities (through m_worldNodes, no hashing)
+        [[nodiscard]] Transform2D WorldAt(std::size_t slot) const;
+        void RefreshWorldNodes() const;
+        void SyncHierarchy(JobSystem* jobs) const;
+        void FlushDirtyBounds() const;
+        // Queues a sprite for FlushDirtyBounds; a no-op until a culled path uses the index
+        void QueueBoundsUpdate(EntityID id) const;
+#if KBK_DEBUG_BUILD
+        // Recomputes a few indexed sprites' bounds per flush and asserts they
+        // match the grid: catches in-place dst edits that skipped the stamp
+        void ValidateSampledBounds() const;
+#endif
+        // Fills m_visibleScratch (EntityID order), returns how many indexed sprites were culled
+        std::uint32_t CollectVisible(const ViewFrustum2D& frustum, std::uint32_t layerMask) const;
+        void RefreshActiveIdOrder() const;
+        // Puts m_visibleScratch in EntityID order: sorts a small list, picks a
+        // large one out of the cached id order
+        void OrderVisibleByEntityID() const;
+        void RenderCollisionDebug(SpriteBatch2D& batch) const;
+        // Tilemaps of active entities; area == nullptr draws every chunk
+        void RenderTilemaps(SpriteBatch2D& batch, const RectF* area) const;
+        void BeginSpatialReorder(float cellSize);
+        // Entity cache lines a walk in Morton order jumps to, per 1000 entities
+        [[nodiscard]] float EstimateSpatialLineJumps() const;
+
+        std::atomic<EntityID> m_nextID{ 1 };
+        ChangeClock           m_changeClock;
         std::vector<Entity2D> m_entities;
+        std::vector<EntitySignature> m_signatures; // parallel to m_entities
+        // Parallel to m_entities: hierarchy node of each entity (kNoNode when
+        // unparented), refreshed when the hierarchy's layout version moves
+        mutable std::vector<std::uint32_t> m_worldNodes;
+        mutable std::uint64_t              m_worldNodesVersion = ~std::uint64_t{ 0 };
+        std::size_t m_activeCount = 0;             // m_entities[0, m_activeCount) are active
+        std::uint64_t m_entityLayoutVersion = 0;   // bumped when entities change slot
         std::unordered_map<EntityID, std::size_t> m_entityIndex;
 
         ComponentStore<SpriteRenderer2D>      m_sprites;
@@ -144,12 +485,63 @@ namespace KibakoEngine {
         ComponentStore<NameComponent>        m_names;
         ComponentStore<ScriptComponent>      m_scripts;
 
+        // Indexed by ComponentTypeId; built-ins point at the members above
+        std::vector<ComponentStoreBase*>                 m_storeTable;
+        std::vector<std::unique_ptr<ComponentStoreBase>> m_customStores;
+
+        std::vector<std::unique_ptr<EntityQuery2D>> m_queries;
+
+        AnimationLibrary2D           m_animationClips;
+        std::vector<AnimationClipId> m_sceneClips; // loaded by LoadFromFile, removed by Clear()
+
+        // Sprite slot of each animator's entity (parallel to the animator store),
+        // rebuilt when either store's layout or size changes
+        struct AnimationSpriteSlots
+        {
+            std::vector<std::uint32_t> slots;
+            std::uint64_t animatorLayout = 0;
+            std::uint64_t spriteLayout = 0;
+            std::size_t   animatorCount = 0;
+            std::size_t   spriteCount = 0;
+            bool          valid = false;
+        };
+        AnimationSpriteSlots m_animationSlots;
+
+        // ReorderSpatially() progress, carried across calls
+        struct SpatialReorder
+        {
+            std::vector<std::pair<std::uint64_t, EntityID>> keyed; // Morton code, entity
+            std::vector<EntityID> order;  // target order of the active entities
+            std::size_t cursor = 0;       // next entry of order / next entity (store phase)
+            std::size_t slot = 0;         // next dense slot to fill
+            std::size_t store = 0;        // m_storeTable index in the store phase
+            float       jumpsBefore = 0.0f;
+            bool        running = false;
+            bool        storePhase = false;
+        };
+        SpatialReorder m_reorder;
+
         std::deque<CircleCollider2D> m_circlePool;
         std::deque<AABBCollider2D>   m_aabbPool;
         std::unordered_map<std::string, EntityID> m_nameLookup;
 
+        // World transforms of parented entities (propagated lazily, hence mutable)
+        mutable TransformHierarchy2D m_hierarchy;
+
+        // Culling cache: refreshed lazily from Render(), hence mutable
+        mutable SpatialGrid2D              m_spatialIndex;
+        mutable std::vector<EntityID>      m_boundsDirty;
+        mutable bool                       m_spatialIndexInUse = false; // set by the first FlushDirtyBounds
+        mutable std::uint64_t              m_boundsStamp = 0; // sprite stamps up to here are in the index
+        mutable std::vector<VisibleSprite> m_visibleScratch;
+        mutable ActiveIdOrder              m_activeIdOrder;
+        mutable std::vector<const SpriteRenderer2D*> m_visibleBySlot; // OrderVisibleByEntityID scratch
+        mutable std::vector<std::uint32_t> m_extractSlots; // entity index -> extracted sprite
+        mutable std::vector<std::size_t>   m_extractTouched;
+
 #if KBK_DEBUG_BUILD
         bool m_collisionDebugEnabled = false;
+        mutable std::size_t m_boundsCheckCursor = 0; // next slot ValidateSampledBounds() looks at
 #endif
 
         std::uint64_t m_revision = 1;
@@ -0,0 +1,80 @@
+// Shared culling/extraction result for several render views
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class SpriteBatch2D;
+    class Texture2D;
+    class TilemapComponent2D;
+
+    // Draw-ready copy of a sprite (world-space quad, resolved texture)
+    struct ExtractedSprite2D
+    {
+        const Texture2D* texture = nullptr;
+        RectF  dst{};
+        RectF  src{};
+        Color4 color{};
+        float  rotation = 0.0f;
+        int    layer = 0;
+        BlendMode blend = BlendMode::Alpha;
+        SpriteOpacity opacity = SpriteOpacity::Translucent;
+
+        // Non-Simple modes are generated by SpriteBatch2D::PushSpriteShape
+        SpriteDrawMode    mode = SpriteDrawMode::Simple;
+        SpriteSlices      slices{};
+        DirectX::XMFLOAT2 tileSize{ 0.0f, 0.0f };
+    };
+
+    // Pushes one extracted sprite, as a quad or as its nine-slice/tiled shape
+    void SubmitExtractedSprite(SpriteBatch2D& batch, const ExtractedSprite2D& sprite);
+
+    // Tilemap overlapping a view: chunks are picked and drawn from the map's
+    // own mesh cache on Submit, so the component must outlive the replay
+    struct ExtractedTilemap2D
+    {
+        const TilemapComponent2D* tilemap = nullptr;
+        DirectX::XMFLOAT2 origin{ 0.0f, 0.0f };
+        RectF area{};
+    };
+
+    // Filled by Scene2D::ExtractVisible: every sprite visible in at least one view
+    // is extracted exactly once, each view keeps indices into that shared list.
+    // Pure CPU data, so it can be produced and inspected without a device.
+    class SceneVisibility2D
+    {
+    public:
+        void Reset(std::size_t viewCount);
+
+        [[nodiscard]] std::size_t ViewCount() const { return m_views.size(); }
+
+        [[nodiscard]] const std::vector<ExtractedSprite2D>& Sprites() const { return m_sprites; }
+        [[nodiscard]] const std::vector<std::uint32_t>& ViewSprites(std::size_t viewIndex) const { return m_views[viewIndex].sprites; }
+        [[nodiscard]] const std::vector<ExtractedTilemap2D>& ViewTilemaps(std::size_t viewIndex) const { return m_views[viewIndex].tilemaps; }
+        [[nodiscard]] std::uint32_t CulledCount(std::size_t viewIndex) const { return m_views[viewIndex].culled; }
+
+        // Pushes the tilemaps, then the sprites of one view (extraction order == scene order)
+        void Submit(SpriteBatch2D& batch, std::size_t viewIndex) const;
+
+    private:
+        friend class Scene2D;
+
+        struct ViewList
+        {
+            std::vector<std::uint32_t> sprites;
+            std::vector<ExtractedTilemap2D> tilemaps;
+            std::uint32_t culled = 0;
+        };
+
+        std::vector<ExtractedSprite2D> m_sprites;
+        std::vector<ViewList>          m_views;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,150 @@
+// Loose uniform grid of entity bounds used for visibility queries
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+#include "KibakoEngine/Scene/ComponentStore.h"
+
+namespace KibakoEngine {
+
+    // Loose grid:
+    // - each item lives in exactly one cell (the one containing its center)
+    // - queries expand by half a cell so items overlapping a neighbour are still found
+    // - items larger than a cell go to an "oversized" list that every query visits
+    // Moving an item only touches the grid when it changes cell.
+    class SpatialGrid2D
+    {
+    public:
+        explicit SpatialGrid2D(float cellSize = 256.0f);
+
+        void SetCellSize(float cellSize); // rebuilds existing items
+        [[nodiscard]] float CellSize() const { return m_cellSize; }
+
+        // Inserts or updates the bounds of an item
+        void Update(EntityID id, const RectF& bounds);
+        void Remove(EntityID id);
+        void Clear();
+
+        [[nodiscard]] bool Contains(EntityID id) const { return m_itemIndex.contains(id); }
+        [[nodiscard]] std::size_t Size() const { return m_items.size(); }
+
+        // Bounds last passed to Update(); false if the item is not in the grid
+        [[nodiscard]] bool TryGetBounds(EntityID id, RectF& out) const
+        {
+            const auto it = m_itemIndex.find(id);
+            if (it == m_itemIndex.end())
+                return false;
+            out = m_items[it->second].bounds;
+            return true;
+        }
+
+        // fn(EntityID id, const RectF& bounds) for every item whose bounds overlap area.
+        // Cost is proportional to the cells covered by area, not to Size().
+        template<typename Fn>
+        void Query(const RectF& area, Fn&& fn) const
+        {
+            const float margin = m_cellSize * 0.5f;
+            const std::int32_t x0 = CellCoord(area.x - margin);
+            const std::int32_t y0 = CellCoord(area.y - margin);
+            const std::int32_t x1 = CellCoord(area.x + area.w + margin);
+            const std::int32_t y1 = CellCoord(area.y + area.h + margin);
+
+            const auto visit = [&](std::uint32_t itemIndex) {
+                const Item& item = m_items[itemIndex];
+                if (item.bounds.x < (area.x + area.w) && (item.bounds.x + item.bounds.w) > area.x &&
+                    item.bounds.y < (area.y + area.h) && (item.bounds.y + item.bounds.h) > area.y) {
+                    fn(item.id, item.bounds);
+                }
+                };
+
+            // Very large areas: walking the occupied cells is cheaper than the range
+            const std::int64_t rangeCells =
+                (static_cast<std::int64_t>(x1) - x0 + 1) * (static_cast<std::int64_t>(y1) - y0 + 1);
+
+            if (rangeCells > static_cast<std::int64_t>(m_cells.size())) {
+                for (const auto& [key, cell] : m_cells) {
+                    const std::int32_t cx = KeyX(key);
+                    const std::int32_t cy = KeyY(key);
+                    if (cx < x0 || cx > x1 || cy < y0 || cy > y1)
+                        continue;
+                    for (std::uint32_t itemIndex : cell)
+                        visit(itemIndex);
+                }
+            }
+            else {
+                for (std::int32_t cy = y0; cy <= y1; ++cy) {
+                    for (std::int32_t cx = x0; cx <= x1; ++cx) {
+                        const auto it = m_cells.find(MakeKey(cx, cy));
+                        if (it == m_cells.end())
+                            continue;
+                        for (std::uint32_t itemIndex : it->second)
+                            visit(itemIndex);
+                    }
+                }
+            }
+
+            for (std::uint32_t itemIndex : m_oversized)
+                visit(itemIndex);
+        }
+
+    private:
+        // Cell coordinates stay well inside int32, so the float cast is defined
+        static constexpr float kMaxCellCoord = 1.0e9f;
+
+        // Where an item is filed: a cell key, or the oversized list. Every key is
+        // a valid cell, so the oversized case is a flag rather than a reserved key.
+        struct Placement
+        {
+            std::uint64_t cell = 0;
+            bool          oversized = false;
+
+            bool operator==(const Placement&) const = default;
+        };
+
+        struct Item
+        {
+            EntityID      id = 0;
+            RectF         bounds{};
+            Placement     placement{};
+            std::uint32_t slot = 0; // position inside the cell (or oversized) list
+        };
+
+        [[nodiscard]] std::int32_t CellCoord(float v) const
+        {
+            float cell = std::floor(v * m_invCellSize);
+            if (std::isnan(cell))
+                cell = 0.0f;
+            return static_cast<std::int32_t>(std::clamp(cell, -kMaxCellCoord, kMaxCellCoord));
+        }
+
+        [[nodiscard]] static std::uint64_t MakeKey(std::int32_t x, std::int32_t y)
+        {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) |
+                static_cast<std::uint32_t>(y);
+        }
+
+        [[nodiscard]] static std::int32_t KeyX(std::uint64_t key) { return static_cast<std::int32_t>(key >> 32); }
+        [[nodiscard]] static std::int32_t KeyY(std::uint64_t key) { return static_cast<std::int32_t>(key & 0xFFFFFFFFull); }
+
+        [[nodiscard]] Placement PlacementFor(const RectF& bounds) const;
+        [[nodiscard]] std::vector<std::uint32_t>& ListFor(const Placement& placement);
+
+        void Link(std::uint32_t itemIndex);
+        void Unlink(std::uint32_t itemIndex);
+
+        float m_cellSize = 256.0f;
+        float m_invCellSize = 1.0f / 256.0f;
+
+        std::vector<Item> m_items;
+        std::unordered_map<EntityID, std::uint32_t> m_itemIndex;
+        std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells;
+        std::vector<std::uint32_t> m_oversized;
+    };
+
+} // namespace KibakoEngine
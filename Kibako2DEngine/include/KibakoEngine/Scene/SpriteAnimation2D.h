@@ -0,0 +1,112 @@
+// Flipbook clips shared by every animated sprite, plus the compact per-entity playback state
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    using AnimationClipId = std::uint32_t;
+    inline constexpr AnimationClipId kInvalidAnimationClip = 0xFFFFFFFFu;
+    inline constexpr std::uint16_t   kNoAnimationFrame = 0xFFFF;
+
+    enum class AnimationLoop : std::uint8_t
+    {
+        Once,     // holds the last frame (the first one when playing backwards), then stops
+        Loop,
+        PingPong, // forwards then backwards; the end frames are shown once per turn
+    };
+
+    struct AnimationFrame2D
+    {
+        RectF src{ 0.0f, 0.0f, 1.0f, 1.0f };
+        float duration = 0.1f; // seconds, > 0
+    };
+
+    // Playback state, 16 bytes, in its own dense store next to the sprites.
+    // Scene2D::UpdateAnimations writes the sprite's src only when `frame` changes:
+    // after editing clip or time by hand, set frame = kNoAnimationFrame (Play()
+    // does) so the current frame is written again.
+    struct SpriteAnimator2D
+    {
+        AnimationClipId clip = kInvalidAnimationClip;
+        float           time = 0.0f;   // seconds into the clip (wrapped for looping clips)
+        float           speed = 1.0f;  // playback rate, negative plays backwards
+        std::uint16_t   frame = kNoAnimationFrame;
+        bool            playing = true;
+        bool            unscaledTime = false; // follow raw time: ignores time scale and pause
+
+        void Play(AnimationClipId newClip, float startTime = 0.0f)
+        {
+            clip = newClip;
+            time = startTime;
+            frame = kNoAnimationFrame;
+            playing = true;
+        }
+    };
+
+    // Clip definitions, stored once and referenced by id. Frames of every clip
+    // sit back to back in two flat arrays (source rects, cumulative end times),
+    // so evaluating a frame is a short binary search in one cache line or two.
+    class AnimationLibrary2D
+    {
+    public:
+        // A clip with the same name is replaced in place, so its id stays valid.
+        // Its frames reuse the old range when they fit; ranges left unused are
+        // compacted away once they outnumber the live frames.
+        AnimationClipId Add(std::string_view name, std::span<const AnimationFrame2D> frames,
+            AnimationLoop loop = AnimationLoop::Loop);
+
+        // The id stops resolving (Advance returns nullptr) and may be handed
+        // out again by a later Add
+        void Remove(AnimationClipId clip);
+
+        [[nodiscard]] AnimationClipId Find(std::string_view name) const;
+        [[nodiscard]] std::size_t ClipCount() const { return m_clips.size() - m_freeIds.size(); }
+        [[nodiscard]] float Duration(AnimationClipId clip) const;
+        [[nodiscard]] std::size_t FrameCount(AnimationClipId clip) const;
+
+        // Clip asset file: { "clips": [ { "name", "loop": "once"|"loop"|"pingpong",
+        // "frames": [ { "src": [x, y, w, h], "duration" } ] } ] }, or a "grid"
+        // { "columns", "rows", "first", "count", "fps" } instead of "frames" for
+        // uniform sheets. Returns how many clips were added; their ids are
+        // appended to `added` if given.
+        std::size_t LoadFromFile(const char* path, std::vector<AnimationClipId>* added = nullptr);
+
+        // Invalidates every id
+        void Clear();
+
+        // Advances the state by dt seconds (state.speed applied). Returns the
+        // source rect to write when the displayed frame changed, else nullptr.
+        // Const and touches only `state`: safe to call from several threads.
+        [[nodiscard]] const RectF* Advance(SpriteAnimator2D& state, float dt) const;
+
+    private:
+        // Removed clips have no name and no frames
+        struct Clip
+        {
+            std::string   name;
+            std::uint32_t firstFrame = 0;
+            std::uint16_t frameCount = 0;
+            AnimationLoop loop = AnimationLoop::Loop;
+            float         duration = 0.0f;
+        };
+
+        std::vector<Clip>  m_clips;
+        std::vector<RectF> m_frameSrc; // every clip's frames, back to back
+        std::vector<float> m_frameEnd; // parallel: end time within its clip
+        std::unordered_map<std::string, AnimationClipId> m_byName;
+        std::vector<AnimationClipId> m_freeIds;    // removed clips, reused by Add
+        std::size_t                  m_deadFrames = 0; // entries no clip points at
+
+        void CompactFrames();
+    };
+
+} // namespace KibakoEngine
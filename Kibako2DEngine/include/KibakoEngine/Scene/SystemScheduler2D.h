@@ -0,0 +1,153 @@
+// Frame systems with declared component access, run concurrently when they do not conflict
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "KibakoEngine/Scene/ComponentColumn.h"
+#include "KibakoEngine/Scene/EntityCommandBuffer2D.h"
+#include "KibakoEngine/Scene/EntitySignature.h"
+#include "KibakoEngine/Scene/Scene2D.h"
+#include "KibakoEngine/Scene/Transform2D.h"
+
+namespace KibakoEngine {
+
+    class JobSystem;
+
+    // What a system touches. Component types map to their ComponentType<T>()
+    // bit; Transform2D stands for Entity2D::Transform(). Writing it also
+    // declares a SpriteRenderer2D write, since SetTransform/MarkTransformDirty
+    // re-stamp the entity's sprite. The scheduler runs
+    // Scene2D::UpdateTransforms() before a wave that follows transform or
+    // sprite writers, so transform readers sharing a wave never propagate.
+    //
+    // Structural edits (create/destroy, add/remove components, SetActive, tags)
+    // are shared scene state: record them into SystemContext::commands, or
+    // declare Exclusive() to run alone.
+    struct SystemAccess
+    {
+        std::uint64_t reads = 0;
+        std::uint64_t writes = 0;
+        bool readsTransforms = false;
+        bool writesTransforms = false;
+        bool exclusive = false;
+
+        template<typename... Ts>
+        SystemAccess& Read()
+        {
+            (Mark<Ts>(false), ...);
+            return *this;
+        }
+
+        template<typename... Ts>
+        SystemAccess& Write()
+        {
+            (Mark<Ts>(true), ...);
+            return *this;
+        }
+
+        SystemAccess& Exclusive()
+        {
+            exclusive = true;
+            return *this;
+        }
+
+        // Write/write or read/write overlap on any component (or transforms)
+        [[nodiscard]] bool ConflictsWith(const SystemAccess& other) const
+        {
+            if (exclusive || other.exclusive)
+                return true;
+            if ((writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0)
+                return true;
+            return (writesTransforms && (other.readsTransforms || other.writesTransforms)) ||
+                (other.writesTransforms && readsTransforms);
+        }
+
+    private:
+        template<typename T>
+        void Mark(bool write)
+        {
+            if constexpr (std::is_same_v<T, Transform2D>) {
+                (write ? writesTransforms : readsTransforms) = true;
+                if (write)
+                    writes |= ComponentBit(ComponentType<SpriteRenderer2D>());
+            }
+            else {
+                static_assert(!kIsTag<T>, "Tags change only through structural edits: read them freely, write with Exclusive()");
+                const std::uint64_t bit = ComponentBit(ComponentType<T>());
+                (write ? writes : reads) |= bit;
+                // A type without a bit cannot be checked for conflicts: run alone
+                exclusive = exclusive || bit == 0;
+            }
+        }
+    };
+
+    struct SystemContext
+    {
+        Scene2D&               scene;
+        EntityCommandBuffer2D& commands; // played back once every system has run
+        float                  dt = 0.0f;
+    };
+
+    using SystemFn = std::function<void(SystemContext&)>;
+
+    // Systems are grouped into waves: each system goes one wave after the
+    // latest earlier-registered system it conflicts with (the levels of the
+    // conflict DAG), so conflicting systems keep their registration order and
+    // everything within a wave can run at once. A wave of several systems is
+    // spread over the JobSystem, one system per chunk; a wave of one runs on
+    // the calling thread, so that system can still ParallelFor internally.
+    //
+    // Each run is timed in the Profiler as "System.<name>".
+    class SystemScheduler2D
+    {
+    public:
+        explicit SystemScheduler2D(Scene2D& scene);
+
+        SystemScheduler2D(const SystemScheduler2D&) = delete;
+        SystemScheduler2D& operator=(const SystemScheduler2D&) = delete;
+
+        // Not from inside Run(). Names are unique: a duplicate replaces the earlier system in place
+        void Add(std::string name, const SystemAccess& access, SystemFn fn);
+        bool Remove(std::string_view name);
+        void SetEnabled(std::string_view name, bool enabled);
+
+        // Runs every enabled system (jobs == nullptr runs the waves serially),
+        // then plays the command buffer back
+        void Run(float dt, JobSystem* jobs = nullptr);
+
+        [[nodiscard]] std::size_t SystemCount() const { return m_systems.size(); }
+        [[nodiscard]] std::size_t WaveCount();
+
+        [[nodiscard]] EntityCommandBuffer2D& Commands() { return m_commands; }
+
+    private:
+        struct System
+        {
+            std::string  name;
+            const char*  profileName = nullptr; // interned, outlives queued profiler samples
+            SystemAccess access;
+            SystemFn     fn;
+            bool         enabled = true;
+        };
+
+        [[nodiscard]] System* Find(std::string_view name);
+        void BuildWaves();
+        void RunSystem(System& system, float dt);
+
+        Scene2D*              m_scene = nullptr;
+        EntityCommandBuffer2D m_commands;
+        std::vector<System>   m_systems;
+
+        // Rebuilt when the system set changes: indices grouped by wave
+        std::vector<std::uint32_t> m_order;
+        std::vector<std::uint32_t> m_waveStarts; // into m_order, plus an end sentinel
+        bool                       m_wavesDirty = true;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,117 @@
+// Chunked tile grid component with cached chunk meshes and tile-range culling
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+
+namespace KibakoEngine {
+
+    class Texture2D;
+
+    using TileIndex = std::uint16_t;
+    inline constexpr TileIndex kEmptyTile = 0xFFFF;
+
+    // Grid of atlas cell indices drawn at the owning entity's world position
+    // (map space, +y down; rotation and scale are not applied). The atlas is
+    // split into atlasColumns x atlasRows equal cells numbered row-major from
+    // the top-left.
+    //
+    // The grid is cut into kChunkSize x kChunkSize chunks. A chunk's quads are
+    // built the first time it is drawn after one of its tiles changed, then
+    // submitted from that cache with PushGeometryView. Render() only walks the
+    // chunks under the requested area, so the cost follows the view, not the
+    // map size; meshes of chunks that scrolled out are dropped beyond
+    // MeshBudget().
+    class TilemapComponent2D
+    {
+    public:
+        static constexpr std::int32_t kChunkSize = 32;
+
+        std::string textureId;
+        std::string texturePath;
+        bool        textureSRGB = true;
+
+        Texture2D* texture = nullptr;
+        int        layer = 0;
+
+        // Clears every tile to kEmptyTile
+        void Resize(std::int32_t width, std::int32_t height);
+        void SetTileSize(float width, float height);
+        void SetAtlasGrid(std::int32_t columns, std::int32_t rows);
+        void SetColor(const Color4& color);
+
+        // Out-of-range coordinates are ignored / read as kEmptyTile
+        void SetTile(std::int32_t x, std::int32_t y, TileIndex tile);
+        [[nodiscard]] TileIndex GetTile(std::int32_t x, std::int32_t y) const;
+        // Clipped to the map
+        void Fill(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, TileIndex tile);
+        // Row-major, Width() * Height() entries
+        void SetTiles(std::span<const TileIndex> tiles);
+
+        [[nodiscard]] std::int32_t Width() const { return m_width; }
+        [[nodiscard]] std::int32_t Height() const { return m_height; }
+        [[nodiscard]] float TileWidth() const { return m_tileWidth; }
+        [[nodiscard]] float TileHeight() const { return m_tileHeight; }
+        [[nodiscard]] std::int32_t AtlasColumns() const { return m_atlasColumns; }
+        [[nodiscard]] std::int32_t AtlasRows() const { return m_atlasRows; }
+        [[nodiscard]] const Color4& Color() const { return m_color; }
+        [[nodiscard]] std::span<const TileIndex> Tiles() const { return m_tiles; }
+
+        // Map-space area covered by the grid
+        [[nodiscard]] RectF LocalBounds() const;
+
+        // Draws the chunks overlapping worldArea (nullptr = every chunk) with
+        // the map placed at origin. Returns how many chunks were submitted.
+        // The batch references the cached meshes until its End(): no tile
+        // edits in between, and one Render() per map per Begin/End.
+        std::size_t Render(SpriteBatch2D& batch, DirectX::XMFLOAT2 origin, const RectF* worldArea = nullptr) const;
+
+        // Cached chunk meshes kept once they leave the view (0 = unlimited)
+        void SetMeshBudget(std::size_t chunks) { m_meshBudget = chunks; }
+        [[nodiscard]] std::size_t MeshBudget() const { return m_meshBudget; }
+        [[nodiscard]] std::size_t CachedMeshCount() const { return m_cachedChunks.size(); }
+        // Drops every chunk mesh; they are rebuilt on demand
+        void ReleaseMeshes();
+
+    private:
+        struct Chunk
+        {
+            std::vector<SpriteBatch2D::Vertex> vertices; // 4 per non-empty tile, map space
+            std::uint64_t lastDrawn = 0;                 // Render() stamp
+            bool dirty = true;                           // vertices out of date
+            bool cached = false;                         // listed in m_cachedChunks
+        };
+
+        void MarkTileDirty(std::int32_t x, std::int32_t y);
+        void MarkAllDirty();
+        void BuildChunk(std::int32_t cx, std::int32_t cy) const;
+        void TrimMeshes() const;
+
+        std::int32_t m_width = 0;
+        std::int32_t m_height = 0;
+        std::int32_t m_chunksX = 0;
+        std::int32_t m_chunksY = 0;
+        float        m_tileWidth = 32.0f;
+        float        m_tileHeight = 32.0f;
+        std::int32_t m_atlasColumns = 1;
+        std::int32_t m_atlasRows = 1;
+        Color4       m_color = Color4::White();
+
+        std::vector<TileIndex> m_tiles; // row-major
+
+        // Mesh cache, filled lazily from Render(), hence mutable
+        mutable std::vector<Chunk>         m_chunks; // row-major by chunk
+        mutable std::vector<std::uint32_t> m_cachedChunks;
+        mutable std::uint64_t              m_renderStamp = 0;
+        std::size_t                        m_meshBudget = 128;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,15 @@
+// Local position/rotation/scale of a 2D entity
+#pragma once
+
+#include <DirectXMath.h>
+
+namespace KibakoEngine {
+
+    struct Transform2D
+    {
+        DirectX::XMFLOAT2 position{ 0.0f, 0.0f };
+        float             rotation = 0.0f;
+        DirectX::XMFLOAT2 scale{ 1.0f, 1.0f };
+    };
+
+} // namespace KibakoEngine
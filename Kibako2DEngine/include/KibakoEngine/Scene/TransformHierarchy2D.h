@@ -0,0 +1,135 @@
+// Parent/child transform tree with depth-sorted SoA world transforms
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "KibakoEngine/Scene/ComponentStore.h"
+#include "KibakoEngine/Scene/Transform2D.h"
+
+namespace KibakoEngine {
+
+    class JobSystem;
+
+    // world = parent * local (scale, then rotate, then translate by the parent)
+    [[nodiscard]] Transform2D CombineTransforms(const Transform2D& parentWorld, const Transform2D& local);
+    // Inverse of CombineTransforms: local that yields `world` under `parentWorld`
+    [[nodiscard]] Transform2D RelativeTransform(const Transform2D& parentWorld, const Transform2D& world);
+
+    // Nodes are stored breadth-first: every depth is one contiguous range, parents
+    // come before children and siblings are contiguous. Reparenting only flags the
+    // layout; it is rebuilt once in the next Propagate().
+    //
+    // Propagate() visits dirty nodes level by level and expands to their children,
+    // so untouched subtrees cost nothing. Each level can run on a JobSystem.
+    class TransformHierarchy2D
+    {
+    public:
+        static constexpr std::uint32_t kNoNode = 0xFFFFFFFFu;
+
+        // Adds a root node if missing, otherwise just updates its local transform
+        void Attach(EntityID id, const Transform2D& local);
+        void Remove(EntityID id);
+        void Clear();
+
+        // parent == 0 makes the node a root. Fails on cycles or unknown nodes.
+        bool SetParent(EntityID child, EntityID parent);
+        [[nodiscard]] EntityID GetParent(EntityID id) const;
+
+        // Marks the node (and implicitly its subtree) for propagation
+        void SetLocal(EntityID id, const Transform2D& local);
+
+        void Propagate(JobSystem* jobs = nullptr);
+        [[nodiscard]] bool NeedsPropagate() const { return m_layoutDirty || !m_dirty.empty(); }
+
+        // Entities whose world transform was recomputed by the last Propagate()
+        [[nodiscard]] std::span<const EntityID> Changed() const { return m_changed; }
+
+        [[nodiscard]] bool Empty() const { return m_nodeIndex.empty(); }
+        [[nodiscard]] bool Contains(EntityID id) const { return m_nodeIndex.contains(id); }
+        [[nodiscard]] std::size_t NodeCount() const { return m_nodeIndex.size(); }
+
+        // Valid after Propagate(); kNoNode if the entity is not part of the tree
+        [[nodiscard]] std::uint32_t NodeIndex(EntityID id) const;
+        [[nodiscard]] bool TryGetWorld(EntityID id, Transform2D& out) const;
+        [[nodiscard]] Transform2D World(std::uint32_t node) const;
+
+        // Bumped whenever node indices may change (nodes added, removed, relaid
+        // out), so callers can cache NodeIndex() results between bumps
+        [[nodiscard]] std::uint64_t LayoutVersion() const { return m_layoutVersion; }
+
+        // Calls fn(childId) for each direct child
+        template <typename Fn>
+        void ForEachChild(EntityID id, Fn&& fn) const
+        {
+            const std::uint32_t node = NodeIndex(id);
+            if (node == kNoNode)
+                return;
+
+            if (!m_layoutDirty) {
+                const std::uint32_t first = m_firstChild[node];
+                for (std::uint32_t i = first; i < first + m_childCount[node]; ++i)
+                    fn(m_entity[i]);
+                return;
+            }
+
+            for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(m_parent.size()); ++i) {
+                if (m_parent[i] == node && m_entity[i] != 0)
+                    fn(m_entity[i]);
+            }
+        }
+
+        // ---- SoA access (node order, see DepthRange) ----------------------
+
+        [[nodiscard]] std::size_t DepthCount() const { return m_depthStart.empty() ? 0 : m_depthStart.size() - 1; }
+        [[nodiscard]] std::pair<std::uint32_t, std::uint32_t> DepthRange(std::size_t depth) const
+        {
+            return { m_depthStart[depth], m_depthStart[depth + 1] };
+        }
+
+        [[nodiscard]] std::span<const EntityID> NodeEntities() const { return m_entity; }
+        [[nodiscard]] std::span<const float> WorldX() const { return m_worldX; }
+        [[nodiscard]] std::span<const float> WorldY() const { return m_worldY; }
+        [[nodiscard]] std::span<const float> WorldRotation() const { return m_worldRot; }
+        [[nodiscard]] std::span<const float> WorldScaleX() const { return m_worldSX; }
+        [[nodiscard]] std::span<const float> WorldScaleY() const { return m_worldSY; }
+
+    private:
+        std::uint32_t AddNode(EntityID id, const Transform2D& local);
+        void RebuildLayout();
+        void ComputeRange(const std::uint32_t* nodes, std::size_t count);
+        void ComputeNode(std::uint32_t node);
+        [[nodiscard]] std::size_t DepthOf(std::uint32_t node) const;
+
+        // Identity / structure (m_entity == 0 marks a removed node until the next rebuild)
+        std::vector<EntityID>      m_entity;
+        std::vector<std::uint32_t> m_parent;
+        std::vector<std::uint32_t> m_firstChild;
+        std::vector<std::uint32_t> m_childCount;
+        std::vector<std::uint32_t> m_depthStart; // depth d = [m_depthStart[d], m_depthStart[d + 1])
+
+        // Local transforms
+        std::vector<float> m_localX, m_localY, m_localRot, m_localSX, m_localSY;
+
+        // Cached world transforms (+ rotation basis reused by children)
+        std::vector<float> m_worldX, m_worldY, m_worldRot, m_worldSX, m_worldSY;
+        std::vector<float> m_worldCos, m_worldSin;
+
+        std::unordered_map<EntityID, std::uint32_t> m_nodeIndex;
+
+        // Propagation state
+        std::vector<std::uint32_t>              m_dirty;
+        std::vector<std::uint8_t>               m_queued;
+        std::vector<std::vector<std::uint32_t>> m_levelWork;
+        std::vector<std::uint32_t>              m_allNodes; // identity list for full passes
+        std::vector<EntityID>                   m_changed;
+        std::uint64_t                           m_layoutVersion = 0;
+        bool m_layoutDirty = false;
+        bool m_fullDirty = false;
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,124 @@
+// Distance-field glyph cache: CPU generation into fixed-cell atlas pages with LRU page eviction
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <d3d11.h>
+
+#include "KibakoEngine/Renderer/Texture2D.h"
+#include "KibakoEngine/Text/GlyphSource2D.h"
+
+namespace KibakoEngine {
+
+    struct GlyphAtlasDesc
+    {
+        int         pageSize = 512;  // texels per side
+        int         cellSize = 40;   // one glyph per cell, margin included
+        int         spread = 4;      // distance-field range in texels, each side of the edge
+        std::size_t maxPages = 4;
+    };
+
+    // A cached glyph. Quad and advance are in em, relative to the pen at the
+    // top of the line; the quad covers the whole cell, margin included.
+    struct AtlasGlyph
+    {
+        float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;
+        float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+        float advance = 0.0f;
+        std::uint16_t page = 0;
+        bool hasQuad = false;  // false for blanks (space): advance only
+    };
+
+    struct GlyphAtlasStats
+    {
+        std::uint64_t glyphsGenerated = 0;
+        std::uint64_t pagesEvicted = 0;
+        std::uint64_t acquireFailures = 0; // every page was in use this frame
+    };
+
+    // Writes a cellSize x cellSize distance field (one byte per texel, 128 on
+    // the outline, +-spread texels mapped to 255/0) of the bitmap placed at
+    // (spread, spread) and scaled to texelsPerEm. Exact Euclidean distances
+    // (two separable squared-distance passes), so it is cheap enough to run
+    // when a glyph is first used.
+    void BuildGlyphDistanceField(const GlyphBitmap& glyph, int cellSize, int spread, float texelsPerEm,
+        std::uint8_t* out);
+
+    // Glyphs are generated the first time they are asked for and packed into
+    // fixed-size cells of up to maxPages pages. When every page is full, the
+    // least recently used page not touched this frame is emptied and reused;
+    // glyphs on it are regenerated if they come back.
+    //
+    // Acquire() only touches CPU memory; Upload() creates the page textures
+    // and copies the new cells, and must run before the frame's glyphs draw.
+    class GlyphAtlas2D
+    {
+    public:
+        explicit GlyphAtlas2D(const GlyphSource2D& source, const GlyphAtlasDesc& desc = {});
+
+        GlyphAtlas2D(const GlyphAtlas2D&) = delete;
+        GlyphAtlas2D& operator=(const GlyphAtlas2D&) = delete;
+
+        // nullptr when the font lacks the glyph or no page can take it. Marks
+        // the glyph's page used this frame, so the pointer and its cell stay
+        // valid at least until NextFrame().
+        [[nodiscard]] const AtlasGlyph* Acquire(char32_t codepoint);
+
+        // Pages used since the last call become evictable again
+        void NextFrame() { ++m_frame; }
+
+        void Upload(ID3D11Device* device, ID3D11DeviceContext* context);
+        // Drops every glyph and page texture; glyphs are regenerated on demand
+        void Clear();
+
+        [[nodiscard]] const Texture2D* PageTexture(std::size_t page) const;
+        [[nodiscard]] std::size_t PageCount() const { return m_pages.size(); }
+        [[nodiscard]] std::size_t GlyphCount() const { return m_glyphs.size(); }
+        [[nodiscard]] std::size_t PendingUploads() const { return m_pending.size(); }
+        [[nodiscard]] float LineHeight() const { return m_source.LineHeight(); }
+        [[nodiscard]] const GlyphAtlasStats& Stats() const { return m_stats; }
+
+    private:
+        struct Page
+        {
+            Texture2D             texture;
+            std::uint32_t         usedCells = 0;
+            std::uint64_t         lastUsed = 0;
+            std::vector<char32_t> glyphs;
+        };
+
+        struct PendingCell
+        {
+            std::uint16_t page = 0;
+            std::uint32_t cell = 0;
+            std::size_t   offset = 0; // into m_staging, cellSize^2 RGBA texels
+        };
+
+        [[nodiscard]] bool AllocateCell(std::uint16_t& page, std::uint32_t& cell);
+        void EvictPage(std::uint16_t page);
+
+        const GlyphSource2D& m_source;
+        GlyphAtlasDesc       m_desc;
+        std::uint32_t        m_cellsPerRow = 0;
+        std::uint32_t        m_cellsPerPage = 0;
+        float                m_texelsPerEm = 0.0f;
+
+        std::vector<Page>                         m_pages; // reserved to maxPages: textures never move
+        std::unordered_map<char32_t, AtlasGlyph>  m_glyphs;
+        static constexpr std::size_t              kDirectGlyphs = 128;
+        const AtlasGlyph*                         m_direct[kDirectGlyphs] = {}; // ASCII fast path into m_glyphs
+
+        std::vector<PendingCell>  m_pending;
+        std::vector<std::uint8_t> m_staging;
+        GlyphBitmap               m_bitmap;   // scratch
+        std::vector<std::uint8_t> m_field;    // scratch
+
+        std::uint64_t   m_frame = 1;
+        std::uint64_t   m_lastFailureFrame = 0;
+        GlyphAtlasStats m_stats;
+    };
+
+} // namespace KibakoEngine
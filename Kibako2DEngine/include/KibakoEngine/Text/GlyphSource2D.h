@@ -0,0 +1,46 @@
+// Glyph outlines as coverage bitmaps, plus the built-in 8x8 ASCII font
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace KibakoEngine {
+
+    // One glyph as handed to the distance-field generator. Metrics are in
+    // em (1.0 = the font size), relative to the pen at the top of the line,
+    // +y down.
+    struct GlyphBitmap
+    {
+        int width = 0;                       // texels in coverage
+        int height = 0;
+        std::vector<std::uint8_t> coverage;  // row-major, >= 128 counts as inside
+
+        float boxX = 0.0f;                   // where the bitmap sits
+        float boxY = 0.0f;
+        float boxWidth = 1.0f;
+        float boxHeight = 1.0f;
+        float advance = 1.0f;                // pen step to the next glyph
+    };
+
+    class GlyphSource2D
+    {
+    public:
+        virtual ~GlyphSource2D() = default;
+
+        // False when the font has no glyph for the codepoint
+        virtual bool Rasterize(char32_t codepoint, GlyphBitmap& out) const = 0;
+        // Baseline-to-baseline distance in em
+        [[nodiscard]] virtual float LineHeight() const = 0;
+    };
+
+    // Monospaced 8x8 bitmap font covering printable ASCII (0x20-0x7E), built
+    // in so text works without any font asset. Its blocky outlines stay
+    // sharp at any size once turned into a distance field.
+    class BuiltinGlyphSource8x8 final : public GlyphSource2D
+    {
+    public:
+        bool Rasterize(char32_t codepoint, GlyphBitmap& out) const override;
+        [[nodiscard]] float LineHeight() const override { return 1.25f; }
+    };
+
+} // namespace KibakoEngine
@@ -0,0 +1,122 @@
+// World-space distance-field text: run layout and glyph quads written straight into the sprite batch
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <d3d11.h>
+#include <DirectXMath.h>
+
+#include "KibakoEngine/Renderer/SpriteTypes.h"
+#include "KibakoEngine/Text/GlyphAtlas2D.h"
+#include "KibakoEngine/Text/GlyphSource2D.h"
+
+namespace KibakoEngine {
+
+    class SpriteBatch2D;
+
+    enum class TextAlign : std::uint8_t
+    {
+        Left,
+        Center,
+        Right,
+    };
+
+    struct TextStyle
+    {
+        float     size = 16.0f; // pixels per em
+        Color4    color = Color4::White();
+        TextAlign align = TextAlign::Left;
+        int       layer = 0;
+        BlendMode blend = BlendMode::Alpha;
+    };
+
+    struct TextRendererStats
+    {
+        std::uint32_t labels = 0;
+        std::uint32_t glyphs = 0;      // quads written
+        std::uint32_t submissions = 0; // AllocateGeometry calls (one per page, layer and blend mode)
+    };
+
+    // Immediate-mode labels for damage numbers, names and debug text that
+    // live in the world rather than in an RmlUi document. DrawLabel() lays a
+    // UTF-8 run out (per-line alignment, '\n' breaks, no kerning) and queues
+    // one compact record per glyph; Flush() uploads glyphs that are new to
+    // the atlas and expands the records into quads inside the batch, one
+    // geometry command per atlas page and layer.
+    class TextRenderer2D
+    {
+    public:
+        // Without a source, the built-in 8x8 ASCII font is used. The source
+        // must outlive the renderer.
+        explicit TextRenderer2D(const GlyphAtlasDesc& desc = {}, const GlyphSource2D* source = nullptr);
+
+        TextRenderer2D(const TextRenderer2D&) = delete;
+        TextRenderer2D& operator=(const TextRenderer2D&) = delete;
+
+        // Needed for Flush() to create and fill the atlas textures
+        void Init(ID3D11Device* device, ID3D11DeviceContext* context);
+        void Shutdown();
+
+        // position is the top-left of the first line for Left alignment,
+        // its top-centre for Center and top-right for Right
+        void DrawLabel(std::string_view utf8, const DirectX::XMFLOAT2& position, const TextStyle& style = {});
+
+        // Size of the run's box in pixels at the given size
+        [[nodiscard]] DirectX::XMFLOAT2 Measure(std::string_view utf8, float size);
+
+        // Between the batch's Begin and End. Empties the queue.
+        void Flush(SpriteBatch2D& batch);
+        // Drops queued labels without drawing them
+        void Clear();
+
+        [[nodiscard]] GlyphAtlas2D& Atlas() { return m_atlas; }
+        [[nodiscard]] const GlyphAtlas2D& Atlas() const { return m_atlas; }
+        [[nodiscard]] std::size_t QueuedGlyphs() const;
+        [[nodiscard]] const TextRendererStats& Stats() const { return m_stats; }
+
+    private:
+        struct GlyphQuad
+        {
+            float  x0, y0, x1, y1;
+            float  u0, v0, u1, v1;
+            Color4 color;
+        };
+
+        struct Bucket
+        {
+            std::uint16_t          page = 0;
+            int                    layer = 0;
+            BlendMode              blend = BlendMode::Alpha;
+            std::vector<GlyphQuad> quads;
+        };
+
+        [[nodiscard]] Bucket& BucketFor(std::uint16_t page, int layer, BlendMode blend);
+        void EndLine(float lineWidth, float anchorX, TextAlign align);
+
+        BuiltinGlyphSource8x8 m_builtinSource;
+        GlyphAtlas2D          m_atlas;
+
+        ID3D11Device*        m_device = nullptr;
+        ID3D11DeviceContext* m_context = nullptr;
+
+        // Few buckets in practice (pages x layers x blend modes): searched linearly,
+        // last hit first. Kept across frames so their storage is reused.
+        std::vector<Bucket> m_buckets;
+        std::size_t         m_lastBucket = 0;
+
+        // Quads of the line being laid out, aligned once its width is known
+        struct LineGlyph
+        {
+            std::uint32_t bucket;
+            std::uint32_t quad;
+        };
+        std::vector<LineGlyph> m_line;
+
+        std::uint32_t     m_queuedLabels = 0;
+        TextRendererStats m_stats;
+    };
+
+} // namespace KibakoEngine
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <random>
 #include <type_traits>
 #include <numbers>
@@ -39,6 +40,21 @@ namespace KibakoEngine::Math {
         return radians * (180.0f / Pi);
     }
 
+    // Interleaves the bits of x and y (x in the even bits): nearby cells get
+    // nearby codes, so sorting by it gives a Z-order space-filling curve
+    [[nodiscard]] constexpr std::uint64_t MortonEncode2D(std::uint32_t x, std::uint32_t y)
+    {
+        const auto spread = [](std::uint64_t v) {
+            v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+            v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+            v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+            };
+        return spread(x) | (spread(y) << 1);
+    }
+
     // Wrap for floats: [min, max)
     [[nodiscard]] inline float Wrap(float value, float minValue, float maxValue)
     {
@@ -67,7 +83,7 @@ namespace KibakoEngine::Math {
             return engine;
         }
 
-        [[nodiscard]] inline void Seed(uint32_t seed)
+        inline void Seed(std::uint32_t seed)
         {
             Engine().seed(seed);
         }
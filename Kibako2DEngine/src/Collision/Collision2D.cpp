@@ -1,6 +1,6 @@
 // Simple overlap tests for 2D circle and AABB colliders
 #include "KibakoEngine/Collision/Collision2D.h"
-#include "KibakoEngine/Scene/Scene2D.h"
+#include "KibakoEngine/Scene/Transform2D.h"
 
 namespace KibakoEngine {
 
@@ -128,7 +128,7 @@ namespace KibakoEngine {
         KBK_PROFILE_SCOPE("CreateWindow");
 
         SDL_SetMainReady();
-        if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) != 0) {
             KbkError(kLogChannel, "SDL_Init failed: %s", SDL_GetError());
             return false;
         }
@@ -177,6 +177,7 @@ namespace KibakoEngine {
             m_window = nullptr;
         }
 
+        m_input.Shutdown();
         SDL_StopTextInput();
         SDL_Quit();
 
@@ -279,6 +280,7 @@ namespace KibakoEngine {
         m_pendingHeight = m_height;
         KbkLog(kLogChannel, "Drawable size: %dx%d", m_width, m_height);
 
+        m_renderer.SetShaderCacheDirectory(m_executableDir / "shadercache");
         if (!m_renderer.Init(m_hwnd,
             static_cast<std::uint32_t>(m_width),
             static_cast<std::uint32_t>(m_height))) {
@@ -290,6 +292,7 @@ namespace KibakoEngine {
         KbkLog(kLogChannel, "AssetManager initialized");
 
         GameServices::Init();
+        m_jobs.Init();
 
         const bool enableUiDebugger =
 #ifndef NDEBUG
@@ -331,6 +334,8 @@ namespace KibakoEngine {
 #endif
 
         m_assets.Shutdown();
+        m_timers.Clear();
+        m_jobs.Shutdown();
         GameServices::Shutdown();
         m_ui.Shutdown();
 
@@ -396,18 +401,87 @@ namespace KibakoEngine {
                 break;
             }
 
-            m_input.HandleEvent(evt);
-            m_ui.ProcessSDLEvent(evt);
+            // Live input is ignored while a recording drives the frame
+            if (!m_playingInput) {
+                m_input.HandleEvent(evt);
+                m_ui.ProcessSDLEvent(evt);
+            }
 
             if (HasBreakpointRequest())
                 return false;
         }
 
-        m_input.AfterEvents();
+        if (!UpdateInputSource())
+            return false;
+
         ApplyPendingResize();
         return true;
     }
 
+    bool Application::UpdateInputSource()
+    {
+        m_frameDelta = m_time.DeltaSeconds();
+
+        if (m_playingInput) {
+            InputFrame frame;
+            double recordedDelta = 0.0;
+            if (!m_inputPlayback.Next(frame, recordedDelta)) {
+                KbkLog(kLogChannel, "Input playback finished (%u frames)", m_inputPlayback.FrameIndex());
+                m_playingInput = false;
+                if (m_quitWhenPlaybackEnds)
+                    return false;
+
+                m_input.AfterEvents();
+            }
+            else {
+                m_input.ApplyFrame(frame);
+                m_frameDelta = recordedDelta;
+            }
+        }
+        else {
+            m_input.AfterEvents();
+        }
+
+        if (m_fixedFrameDelta > 0.0)
+            m_frameDelta = m_fixedFrameDelta;
+
+        if (m_inputRecorder.IsRecording())
+            m_inputRecorder.Record(m_input.CaptureFrame(), m_frameDelta);
+
+        return true;
+    }
+
+    void Application::StartInputRecording()
+    {
+        m_inputRecorder.Begin();
+        KbkLog(kLogChannel, "Input recording started");
+    }
+
+    bool Application::StopInputRecording(const std::filesystem::path& path)
+    {
+        if (!m_inputRecorder.IsRecording())
+            return false;
+
+        m_inputRecorder.End();
+        return m_inputRecorder.SaveToFile(path);
+    }
+
+    bool Application::StartInputPlayback(const std::filesystem::path& path, bool quitWhenFinished)
+    {
+        if (!m_inputPlayback.LoadFromFile(path))
+            return false;
+
+        m_playingInput = true;
+        m_quitWhenPlaybackEnds = quitWhenFinished;
+        return true;
+    }
+
+    void Application::StopInputPlayback()
+    {
+        m_playingInput = false;
+        m_inputPlayback.Unload();
+    }
+
     void Application::ApplyPendingResize()
     {
         if (!m_hasPendingResize)
@@ -496,11 +570,12 @@ namespace KibakoEngine {
 
             KBK_PROFILE_FRAME("Frame");
 
-            double rawDt = m_time.DeltaSeconds();
+            double rawDt = m_frameDelta;
             if (rawDt < 0.0) rawDt = 0.0;
             if (rawDt > kMaxFrameDt) rawDt = kMaxFrameDt;
 
             GameServices::Update(rawDt);
+            m_timers.Update(GameServices::GetTime());
 
             const double scaledDt = GameServices::GetScaledDeltaTime();
             accumulator += scaledDt;
@@ -533,6 +608,8 @@ namespace KibakoEngine {
             BeginFrame(clearColor);
 
             SpriteBatch2D& batch = m_renderer.Batch();
+            RenderViews(batch);
+
             batch.Begin(m_renderer.Camera().GetViewProjectionT());
 
             for (Layer* layer : m_layers) {
@@ -561,6 +638,45 @@ namespace KibakoEngine {
         }
     }
 
+    void Application::RenderViews(SpriteBatch2D& batch)
+    {
+        const std::vector<RenderView2D>& views = m_renderer.Views();
+        if (views.empty())
+            return;
+
+        KBK_PROFILE_SCOPE("RenderViews");
+
+        // Shared culling/extraction for every view before any pass is drawn
+        for (Layer* layer : m_layers) {
+            if (layer)
+                layer->OnPrepareViews(views);
+        }
+
+        m_viewOrder.resize(views.size());
+        for (std::size_t i = 0; i < views.size(); ++i)
+            m_viewOrder[i] = i;
+        std::stable_sort(m_viewOrder.begin(), m_viewOrder.end(),
+            [&](std::size_t a, std::size_t b) { return views[a].order < views[b].order; });
+
+        for (std::size_t viewIndex : m_viewOrder) {
+            const RenderView2D& view = views[viewIndex];
+            if (!view.enabled)
+                continue;
+
+            m_renderer.BeginView(view);
+            batch.Begin(view.camera.GetViewProjectionT());
+
+            for (Layer* layer : m_layers) {
+                if (layer)
+                    layer->OnRenderView(batch, viewIndex, view);
+            }
+
+            batch.End();
+        }
+
+        m_renderer.BindBackBuffer();
+    }
+
 #if KBK_DEBUG_BUILD
     void Application::SetEditorScene(Scene2D* scene)
     {
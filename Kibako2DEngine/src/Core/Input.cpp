@@ -1,17 +1,35 @@
 // Tracks keyboard/mouse input across frames using SDL + Input Actions
 #include "KibakoEngine/Core/Input.h"
 
+#include "KibakoEngine/Core/Log.h"
+
 #include <algorithm>
-#include <cstring>
+#include <iterator>
 
 namespace KibakoEngine {
 
-    Input::Input()
+    namespace
     {
-        std::fill(m_prevKeyboard.begin(), m_prevKeyboard.end(), static_cast<uint8_t>(0));
-        m_keyboard = nullptr;
+        constexpr const char* kLogChannel = "Input";
+
+        constexpr uint32_t kBitsPerWord = 64u;
+
+        float NormalizeAxis(int16_t value)
+        {
+            // SDL axes are [-32768, 32767]; clamp so both halves reach exactly 1
+            const float v = static_cast<float>(value) / static_cast<float>(SDL_JOYSTICK_AXIS_MAX);
+            return std::clamp(v, -1.0f, 1.0f);
+        }
+
+        const std::string& EmptyName()
+        {
+            static const std::string empty;
+            return empty;
+        }
     }
 
+    Input::Input() = default;
+
     void Input::BeginFrame()
     {
         m_wheelX = 0;
@@ -20,11 +38,9 @@ namespace KibakoEngine {
 
         m_prevMouseButtons = m_mouseButtons;
 
-        // Snapshot pointer for this frame (SDL updates this state when events are pumped)
-        m_keyboard = SDL_GetKeyboardState(nullptr);
-
         // IMPORTANT:
-        // Don't UpdateActions() here. It must happen AFTER SDL events are pumped.
+        // Don't snapshot the keyboard or UpdateActions() here. SDL only updates its
+        // keyboard state when events are pumped, so both happen in AfterEvents().
     }
 
     void Input::HandleEvent(const SDL_Event& e)
@@ -56,6 +72,29 @@ namespace KibakoEngine {
             }
             break;
 
+        case SDL_CONTROLLERDEVICEADDED:
+            OpenController(e.cdevice.which);
+            break;
+
+        case SDL_CONTROLLERDEVICEREMOVED:
+            CloseController(e.cdevice.which);
+            break;
+
+        case SDL_CONTROLLERBUTTONDOWN:
+            if (e.cbutton.button < SDL_CONTROLLER_BUTTON_MAX)
+                m_padButtons |= (1u << e.cbutton.button);
+            break;
+
+        case SDL_CONTROLLERBUTTONUP:
+            if (e.cbutton.button < SDL_CONTROLLER_BUTTON_MAX)
+                m_padButtons &= ~(1u << e.cbutton.button);
+            break;
+
+        case SDL_CONTROLLERAXISMOTION:
+            if (e.caxis.axis < SDL_CONTROLLER_AXIS_MAX)
+                m_padAxes[e.caxis.axis] = NormalizeAxis(e.caxis.value);
+            break;
+
         default:
             break;
         }
@@ -63,16 +102,68 @@ namespace KibakoEngine {
 
     void Input::AfterEvents()
     {
-        // Now SDL has processed the events, so keyboard state is up-to-date
+        // Now SDL has processed the events: pack its byte-per-key array once,
+        // every key/action query afterwards works on bits.
+        int numKeys = 0;
+        const uint8_t* keyboard = SDL_GetKeyboardState(&numKeys);
+        const int count = std::min(numKeys, static_cast<int>(SDL_NUM_SCANCODES));
+
+        m_keys.reset();
+        if (keyboard) {
+            for (int i = 0; i < count; ++i) {
+                if (keyboard[i] != 0u)
+                    m_keys.set(static_cast<std::size_t>(i));
+            }
+        }
+
         UpdateActions();
     }
 
     void Input::EndFrame()
     {
-        // Store current keyboard snapshot as previous for next frame
-        if (m_keyboard) {
-            std::memcpy(m_prevKeyboard.data(), m_keyboard, m_prevKeyboard.size());
-        }
+        // Store current snapshots as previous for next frame
+        m_prevKeys = m_keys;
+        m_actionPrevDown = m_actionDown;
+    }
+
+    void Input::Shutdown()
+    {
+        for (SDL_GameController* controller : m_controllers)
+            SDL_GameControllerClose(controller);
+        m_controllers.clear();
+
+        m_padButtons = 0;
+        std::fill(std::begin(m_padAxes), std::end(m_padAxes), 0.0f);
+    }
+
+    InputFrame Input::CaptureFrame() const
+    {
+        InputFrame frame;
+        frame.keys = m_keys;
+        frame.mouseX = m_mouseX;
+        frame.mouseY = m_mouseY;
+        frame.mouseButtons = m_mouseButtons;
+        frame.wheelX = m_wheelX;
+        frame.wheelY = m_wheelY;
+        frame.textChar = m_textChar;
+        frame.padButtons = m_padButtons;
+        std::copy(std::begin(m_padAxes), std::end(m_padAxes), std::begin(frame.padAxes));
+        return frame;
+    }
+
+    void Input::ApplyFrame(const InputFrame& frame)
+    {
+        m_keys = frame.keys;
+        m_mouseX = frame.mouseX;
+        m_mouseY = frame.mouseY;
+        m_mouseButtons = frame.mouseButtons;
+        m_wheelX = frame.wheelX;
+        m_wheelY = frame.wheelY;
+        m_textChar = frame.textChar;
+        m_padButtons = frame.padButtons;
+        std::copy(std::begin(frame.padAxes), std::end(frame.padAxes), std::begin(m_padAxes));
+
+        UpdateActions();
     }
 
     // ------------------------------------------------------------
@@ -81,21 +172,20 @@ namespace KibakoEngine {
 
     bool Input::KeyDown(SDL_Scancode scancode) const
     {
-        return m_keyboard && (m_keyboard[scancode] != 0);
+        const auto index = static_cast<std::size_t>(scancode);
+        return index < m_keys.size() && m_keys.test(index);
     }
 
     bool Input::KeyPressed(SDL_Scancode scancode) const
     {
-        const uint8_t now = m_keyboard ? m_keyboard[scancode] : 0;
-        const uint8_t prev = m_prevKeyboard[scancode];
-        return (now != 0u) && (prev == 0u);
+        const auto index = static_cast<std::size_t>(scancode);
+        return index < m_keys.size() && m_keys.test(index) && !m_prevKeys.test(index);
     }
 
     bool Input::KeyReleased(SDL_Scancode scancode) const
     {
-        const uint8_t now = m_keyboard ? m_keyboard[scancode] : 0;
-        const uint8_t prev = m_prevKeyboard[scancode];
-        return (now == 0u) && (prev != 0u);
+        const auto index = static_cast<std::size_t>(scancode);
+        return index < m_keys.size() && !m_keys.test(index) && m_prevKeys.test(index);
     }
 
     // ------------------------------------------------------------
@@ -119,85 +209,272 @@ namespace KibakoEngine {
         return ((m_mouseButtons & mask) == 0u) && ((m_prevMouseButtons & mask) != 0u);
     }
 
+    // ------------------------------------------------------------
+    // Gamepad
+    // ------------------------------------------------------------
+
+    bool Input::GamepadButtonDown(SDL_GameControllerButton button) const
+    {
+        if (button < 0 || button >= SDL_CONTROLLER_BUTTON_MAX)
+            return false;
+        return (m_padButtons & (1u << button)) != 0u;
+    }
+
+    float Input::GamepadAxis(SDL_GameControllerAxis axis) const
+    {
+        if (axis < 0 || axis >= SDL_CONTROLLER_AXIS_MAX)
+            return 0.0f;
+        return m_padAxes[axis];
+    }
+
+    void Input::OpenController(int deviceIndex)
+    {
+        SDL_GameController* controller = SDL_GameControllerOpen(deviceIndex);
+        if (!controller) {
+            KbkWarn(kLogChannel, "SDL_GameControllerOpen failed: %s", SDL_GetError());
+            return;
+        }
+
+        // SDL reports already-attached devices again after init; keep one handle each
+        if (std::find(m_controllers.begin(), m_controllers.end(), controller) == m_controllers.end()) {
+            m_controllers.push_back(controller);
+            KbkLog(kLogChannel, "Game controller connected (%zu active)", m_controllers.size());
+        }
+        else {
+            SDL_GameControllerClose(controller);
+        }
+    }
+
+    void Input::CloseController(SDL_JoystickID instanceId)
+    {
+        SDL_GameController* controller = SDL_GameControllerFromInstanceID(instanceId);
+        auto it = std::find(m_controllers.begin(), m_controllers.end(), controller);
+        if (!controller || it == m_controllers.end())
+            return;
+
+        SDL_GameControllerClose(controller);
+        m_controllers.erase(it);
+
+        // Merged state: drop everything so no button/axis stays stuck
+        m_padButtons = 0;
+        std::fill(std::begin(m_padAxes), std::end(m_padAxes), 0.0f);
+
+        KbkLog(kLogChannel, "Game controller disconnected (%zu active)", m_controllers.size());
+    }
+
     // ------------------------------------------------------------
     // Actions
     // ------------------------------------------------------------
 
-    void Input::BindAction(std::string action, SDL_Scancode scancode)
+    ActionId Input::RegisterAction(std::string_view action)
     {
-        auto& st = m_actions[std::move(action)];
+        if (auto it = m_actionLookup.find(action); it != m_actionLookup.end())
+            return ActionId{ it->second };
+
+        const auto index = static_cast<uint32_t>(m_bindings.size());
+        m_actionLookup.emplace(std::string(action), index);
 
-        // Avoid duplicates
-        if (std::find(st.bindings.begin(), st.bindings.end(), scancode) == st.bindings.end()) {
-            st.bindings.push_back(scancode);
+        ActionBindings& bindings = m_bindings.emplace_back();
+        bindings.name = std::string(action);
+
+        const std::size_t words = (m_bindings.size() + kBitsPerWord - 1) / kBitsPerWord;
+        m_actionDown.resize(words, 0u);
+        m_actionPrevDown.resize(words, 0u);
+        m_actionValues.push_back(0.0f);
+
+        return ActionId{ index };
+    }
+
+    ActionId Input::FindAction(std::string_view action) const
+    {
+        auto it = m_actionLookup.find(action);
+        return (it != m_actionLookup.end()) ? ActionId{ it->second } : ActionId{};
+    }
+
+    const std::string& Input::ActionName(ActionId id) const
+    {
+        return (id.index < m_bindings.size()) ? m_bindings[id.index].name : EmptyName();
+    }
+
+    ActionId Input::BindAction(std::string_view action, SDL_Scancode scancode)
+    {
+        const ActionId id = RegisterAction(action);
+        if (static_cast<std::size_t>(scancode) < SDL_NUM_SCANCODES)
+            m_bindings[id.index].anyKeys.set(static_cast<std::size_t>(scancode));
+        return id;
+    }
+
+    ActionId Input::BindChord(std::string_view action, std::initializer_list<SDL_Scancode> keys)
+    {
+        const ActionId id = RegisterAction(action);
+
+        KeyboardBits chord;
+        for (SDL_Scancode sc : keys) {
+            if (static_cast<std::size_t>(sc) < SDL_NUM_SCANCODES)
+                chord.set(static_cast<std::size_t>(sc));
         }
+
+        if (chord.none())
+            return id;
+
+        // A one-key chord is just a regular binding
+        if (chord.count() == 1u) {
+            m_bindings[id.index].anyKeys |= chord;
+            return id;
+        }
+
+        auto& chords = m_bindings[id.index].chords;
+        if (std::find(chords.begin(), chords.end(), chord) == chords.end())
+            chords.push_back(chord);
+        return id;
     }
 
-    void Input::ClearActionBindings(std::string_view action)
+    ActionId Input::BindGamepadButton(std::string_view action, SDL_GameControllerButton button)
+    {
+        const ActionId id = RegisterAction(action);
+        if (button >= 0 && button < SDL_CONTROLLER_BUTTON_MAX)
+            m_bindings[id.index].padButtons |= (1u << button);
+        return id;
+    }
+
+    ActionId Input::BindGamepadAxis(std::string_view action,
+        SDL_GameControllerAxis axis,
+        float direction,
+        float threshold)
     {
-        auto it = m_actions.find(action);
-        if (it == m_actions.end())
+        const ActionId id = RegisterAction(action);
+        if (axis < 0 || axis >= SDL_CONTROLLER_AXIS_MAX)
+            return id;
+
+        AxisBinding binding;
+        binding.axis = axis;
+        binding.direction = (direction < 0.0f) ? -1.0f : 1.0f;
+        binding.threshold = std::clamp(threshold, 0.0f, 0.99f);
+
+        auto& axes = m_bindings[id.index].axes;
+        for (AxisBinding& existing : axes) {
+            if (existing.axis == binding.axis && existing.direction == binding.direction) {
+                existing.threshold = binding.threshold;
+                return id;
+            }
+        }
+        axes.push_back(binding);
+        return id;
+    }
+
+    void Input::ClearActionBindings(ActionId id)
+    {
+        if (id.index >= m_bindings.size())
             return;
 
-        it->second.bindings.clear();
-        it->second.down = false;
-        it->second.pressed = false;
-        it->second.released = false;
+        ActionBindings& bindings = m_bindings[id.index];
+        bindings.anyKeys.reset();
+        bindings.chords.clear();
+        bindings.padButtons = 0;
+        bindings.axes.clear();
+
+        const uint64_t mask = ~(uint64_t{ 1 } << (id.index % kBitsPerWord));
+        m_actionDown[id.index / kBitsPerWord] &= mask;
+        m_actionPrevDown[id.index / kBitsPerWord] &= mask;
+        m_actionValues[id.index] = 0.0f;
+    }
+
+    void Input::ClearActionBindings(std::string_view action)
+    {
+        ClearActionBindings(FindAction(action));
     }
 
     void Input::ClearAllActionBindings()
     {
-        m_actions.clear();
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_bindings.size()); ++i)
+            ClearActionBindings(ActionId{ i });
+    }
+
+    bool Input::TestActionBit(const std::vector<uint64_t>& bits, ActionId id) const
+    {
+        if (id.index >= m_bindings.size())
+            return false;
+        return (bits[id.index / kBitsPerWord] >> (id.index % kBitsPerWord)) & 1u;
+    }
+
+    bool Input::ActionDown(ActionId id) const
+    {
+        return TestActionBit(m_actionDown, id);
+    }
+
+    bool Input::ActionPressed(ActionId id) const
+    {
+        return TestActionBit(m_actionDown, id) && !TestActionBit(m_actionPrevDown, id);
+    }
+
+    bool Input::ActionReleased(ActionId id) const
+    {
+        return !TestActionBit(m_actionDown, id) && TestActionBit(m_actionPrevDown, id);
+    }
+
+    float Input::ActionValue(ActionId id) const
+    {
+        return (id.index < m_actionValues.size()) ? m_actionValues[id.index] : 0.0f;
+    }
+
+    float Input::ActionAxis1D(ActionId negativeAction, ActionId positiveAction) const
+    {
+        return ActionValue(positiveAction) - ActionValue(negativeAction);
     }
 
     bool Input::ActionDown(std::string_view action) const
     {
-        auto it = m_actions.find(action);
-        return (it != m_actions.end()) ? it->second.down : false;
+        return ActionDown(FindAction(action));
     }
 
     bool Input::ActionPressed(std::string_view action) const
     {
-        auto it = m_actions.find(action);
-        return (it != m_actions.end()) ? it->second.pressed : false;
+        return ActionPressed(FindAction(action));
     }
 
     bool Input::ActionReleased(std::string_view action) const
     {
-        auto it = m_actions.find(action);
-        return (it != m_actions.end()) ? it->second.released : false;
+        return ActionReleased(FindAction(action));
     }
 
     float Input::ActionAxis1D(std::string_view negativeAction,
         std::string_view positiveAction) const
     {
-        const bool neg = ActionDown(negativeAction);
-        const bool pos = ActionDown(positiveAction);
-
-        if (neg == pos)
-            return 0.0f;
-        return pos ? 1.0f : -1.0f;
+        return ActionAxis1D(FindAction(negativeAction), FindAction(positiveAction));
     }
 
     void Input::UpdateActions()
     {
-        // Compute action state from current/previous keyboard snapshots
-        for (auto& entry : m_actions) {
-            auto& st = entry.second;
-            bool nowDown = false;
-            bool prevDown = false;
-
-            for (SDL_Scancode sc : st.bindings) {
-                const bool n = (m_keyboard && (m_keyboard[sc] != 0));
-                const bool p = (m_prevKeyboard[sc] != 0);
-                nowDown |= n;
-                prevDown |= p;
+        // Recompute every action from the packed snapshot; pressed/released are
+        // derived on query from the current/previous bit words.
+        std::fill(m_actionDown.begin(), m_actionDown.end(), uint64_t{ 0 });
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_bindings.size()); ++i) {
+            const ActionBindings& bindings = m_bindings[i];
+
+            bool down = (m_keys & bindings.anyKeys).any() ||
+                (m_padButtons & bindings.padButtons) != 0u;
+
+            for (std::size_t c = 0; !down && c < bindings.chords.size(); ++c) {
+                const KeyboardBits& chord = bindings.chords[c];
+                down = (m_keys & chord) == chord;
+            }
+
+            float value = down ? 1.0f : 0.0f;
+            for (const AxisBinding& axis : bindings.axes) {
+                const float deflection = m_padAxes[axis.axis] * axis.direction;
+                if (deflection <= axis.threshold)
+                    continue;
+
+                // Rescale past the threshold so the value still starts at 0
+                down = true;
+                value = std::max(value, (deflection - axis.threshold) / (1.0f - axis.threshold));
             }
 
-            st.down = nowDown;
-            st.pressed = (nowDown && !prevDown);
-            st.released = (!nowDown && prevDown);
+            if (down)
+                m_actionDown[i / kBitsPerWord] |= (uint64_t{ 1 } << (i % kBitsPerWord));
+            m_actionValues[i] = std::min(value, 1.0f);
         }
     }
 
-} // namespace KibakoEngine
\ No newline at end of file
+} // namespace KibakoEngine
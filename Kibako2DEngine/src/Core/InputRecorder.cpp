@@ -0,0 +1,362 @@
+// Delta-encoded input capture and deterministic playback
+#include "KibakoEngine/Core/InputRecorder.h"
+
+#include "KibakoEngine/Core/Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "InputRec";
+
+        constexpr std::uint8_t  kMagic[4] = { 'K', 'B', 'K', 'I' };
+        constexpr std::uint32_t kVersion = 1;
+        constexpr std::size_t   kHeaderSize = 12; // magic + version + frame count
+
+        enum FrameFlags : std::uint8_t
+        {
+            kFlagDelta = 1u << 0,
+            kFlagKeys = 1u << 1,
+            kFlagMouse = 1u << 2,
+            kFlagButtons = 1u << 3,
+            kFlagWheel = 1u << 4,
+            kFlagText = 1u << 5,
+            kFlagPadButtons = 1u << 6,
+            kFlagPadAxes = 1u << 7,
+        };
+
+        static_assert(SDL_CONTROLLER_AXIS_MAX <= 8, "Axis mask is stored in one byte");
+
+        void WriteVarint(std::vector<std::uint8_t>& out, std::uint32_t value)
+        {
+            while (value >= 0x80u) {
+                out.push_back(static_cast<std::uint8_t>(value | 0x80u));
+                value >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        void WriteZigZag(std::vector<std::uint8_t>& out, std::int32_t value)
+        {
+            WriteVarint(out, (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31));
+        }
+
+        void WriteU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+
+        // Bounds-checked reader; any overrun marks the stream as corrupt
+        struct StreamReader
+        {
+            const std::vector<std::uint8_t>& data;
+            std::size_t& cursor;
+            bool ok = true;
+
+            std::uint8_t Byte()
+            {
+                if (cursor >= data.size()) {
+                    ok = false;
+                    return 0;
+                }
+                return data[cursor++];
+            }
+
+            std::uint32_t Varint()
+            {
+                std::uint32_t value = 0;
+                for (int shift = 0; shift < 35; shift += 7) {
+                    const std::uint8_t b = Byte();
+                    value |= static_cast<std::uint32_t>(b & 0x7Fu) << shift;
+                    if ((b & 0x80u) == 0u || !ok)
+                        return value;
+                }
+                ok = false;
+                return 0;
+            }
+
+            std::int32_t ZigZag()
+            {
+                const std::uint32_t v = Varint();
+                return static_cast<std::int32_t>((v >> 1) ^ (~(v & 1u) + 1u));
+            }
+        };
+
+        // Axes are stored on SDL's int16 scale so replays are bit-exact
+        std::int32_t QuantizeAxis(float value)
+        {
+            return static_cast<std::int32_t>(std::lround(value * static_cast<float>(SDL_JOYSTICK_AXIS_MAX)));
+        }
+
+        float DequantizeAxis(std::int32_t value)
+        {
+            const float v = static_cast<float>(value) / static_cast<float>(SDL_JOYSTICK_AXIS_MAX);
+            return std::clamp(v, -1.0f, 1.0f);
+        }
+
+        std::uint32_t ToMicros(double seconds)
+        {
+            if (seconds <= 0.0)
+                return 0;
+            return static_cast<std::uint32_t>(std::llround(std::min(seconds, 3600.0) * 1000000.0));
+        }
+    }
+
+    // ------------------------------------------------------------
+    // InputRecorder
+    // ------------------------------------------------------------
+
+    void InputRecorder::Begin()
+    {
+        m_stream.clear();
+        m_previous = InputFrame{};
+        m_previousDeltaMicros = 0;
+        m_frameCount = 0;
+        m_recording = true;
+    }
+
+    void InputRecorder::End()
+    {
+        m_recording = false;
+    }
+
+    void InputRecorder::Record(const InputFrame& frame, double deltaSeconds)
+    {
+        if (!m_recording)
+            return;
+
+        const std::size_t flagsOffset = m_stream.size();
+        m_stream.push_back(0);
+        std::uint8_t flags = 0;
+
+        const std::uint32_t deltaMicros = ToMicros(deltaSeconds);
+        if (deltaMicros != m_previousDeltaMicros) {
+            flags |= kFlagDelta;
+            WriteVarint(m_stream, deltaMicros);
+            m_previousDeltaMicros = deltaMicros;
+        }
+
+        const KeyboardBits toggled = frame.keys ^ m_previous.keys;
+        if (toggled.any()) {
+            flags |= kFlagKeys;
+            WriteVarint(m_stream, static_cast<std::uint32_t>(toggled.count()));
+
+            std::uint32_t last = 0;
+            for (std::uint32_t sc = 0; sc < static_cast<std::uint32_t>(toggled.size()); ++sc) {
+                if (!toggled.test(sc))
+                    continue;
+                WriteVarint(m_stream, sc - last);
+                last = sc;
+            }
+        }
+
+        if (frame.mouseX != m_previous.mouseX || frame.mouseY != m_previous.mouseY) {
+            flags |= kFlagMouse;
+            WriteZigZag(m_stream, frame.mouseX - m_previous.mouseX);
+            WriteZigZag(m_stream, frame.mouseY - m_previous.mouseY);
+        }
+
+        if (frame.mouseButtons != m_previous.mouseButtons) {
+            flags |= kFlagButtons;
+            WriteVarint(m_stream, frame.mouseButtons);
+        }
+
+        // Wheel and text are per-frame impulses, stored whenever non-zero
+        if (frame.wheelX != 0 || frame.wheelY != 0) {
+            flags |= kFlagWheel;
+            WriteZigZag(m_stream, frame.wheelX);
+            WriteZigZag(m_stream, frame.wheelY);
+        }
+
+        if (frame.textChar != 0u) {
+            flags |= kFlagText;
+            WriteVarint(m_stream, frame.textChar);
+        }
+
+        if (frame.padButtons != m_previous.padButtons) {
+            flags |= kFlagPadButtons;
+            WriteVarint(m_stream, frame.padButtons);
+        }
+
+        std::uint8_t axisMask = 0;
+        for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; ++a) {
+            if (QuantizeAxis(frame.padAxes[a]) != QuantizeAxis(m_previous.padAxes[a]))
+                axisMask |= static_cast<std::uint8_t>(1u << a);
+        }
+        if (axisMask != 0u) {
+            flags |= kFlagPadAxes;
+            m_stream.push_back(axisMask);
+            for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; ++a) {
+                if ((axisMask & (1u << a)) != 0u)
+                    WriteZigZag(m_stream, QuantizeAxis(frame.padAxes[a]) - QuantizeAxis(m_previous.padAxes[a]));
+            }
+        }
+
+        m_stream[flagsOffset] = flags;
+        m_previous = frame;
+        ++m_frameCount;
+    }
+
+    bool InputRecorder::SaveToFile(const std::filesystem::path& path) const
+    {
+        std::vector<std::uint8_t> header;
+        header.reserve(kHeaderSize);
+        header.insert(header.end(), std::begin(kMagic), std::end(kMagic));
+        WriteU32(header, kVersion);
+        WriteU32(header, m_frameCount);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            KbkError(kLogChannel, "Cannot open input recording for writing: %s", path.string().c_str());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(m_stream.data()), static_cast<std::streamsize>(m_stream.size()));
+        if (!file) {
+            KbkError(kLogChannel, "Failed to write input recording: %s", path.string().c_str());
+            return false;
+        }
+
+        KbkLog(kLogChannel, "Saved %u frames (%zu bytes) to %s",
+            m_frameCount, m_stream.size() + header.size(), path.string().c_str());
+        return true;
+    }
+
+    // ------------------------------------------------------------
+    // InputPlayback
+    // ------------------------------------------------------------
+
+    bool InputPlayback::LoadFromFile(const std::filesystem::path& path)
+    {
+        Unload();
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            KbkError(kLogChannel, "Cannot open input recording: %s", path.string().c_str());
+            return false;
+        }
+
+        std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.size() < kHeaderSize || !std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin())) {
+            KbkError(kLogChannel, "Not an input recording: %s", path.string().c_str());
+            return false;
+        }
+
+        auto readU32 = [&](std::size_t offset) {
+            std::uint32_t value = 0;
+            for (int i = 0; i < 4; ++i)
+                value |= static_cast<std::uint32_t>(bytes[offset + i]) << (i * 8);
+            return value;
+        };
+
+        const std::uint32_t version = readU32(4);
+        if (version != kVersion) {
+            KbkError(kLogChannel, "Unsupported input recording version %u: %s", version, path.string().c_str());
+            return false;
+        }
+
+        LoadFromMemory(std::span<const std::uint8_t>(bytes).subspan(kHeaderSize), readU32(8));
+        KbkLog(kLogChannel, "Loaded %u frames from %s", m_frameCount, path.string().c_str());
+        return true;
+    }
+
+    void InputPlayback::LoadFromMemory(std::span<const std::uint8_t> stream, std::uint32_t frameCount)
+    {
+        m_stream.assign(stream.begin(), stream.end());
+        m_frameCount = frameCount;
+        m_loaded = true;
+        Rewind();
+    }
+
+    void InputPlayback::Unload()
+    {
+        m_stream.clear();
+        m_frameCount = 0;
+        m_loaded = false;
+        Rewind();
+    }
+
+    void InputPlayback::Rewind()
+    {
+        m_cursor = 0;
+        m_current = InputFrame{};
+        m_deltaMicros = 0;
+        m_frameIndex = 0;
+    }
+
+    bool InputPlayback::Next(InputFrame& outFrame, double& outDeltaSeconds)
+    {
+        if (!m_loaded || IsFinished())
+            return false;
+
+        StreamReader in{ m_stream, m_cursor };
+        const std::uint8_t flags = in.Byte();
+
+        // Impulses only live for the frame that carries them
+        m_current.wheelX = 0;
+        m_current.wheelY = 0;
+        m_current.textChar = 0;
+
+        if (flags & kFlagDelta)
+            m_deltaMicros = in.Varint();
+
+        if (flags & kFlagKeys) {
+            const std::uint32_t count = in.Varint();
+            std::uint32_t sc = 0;
+            for (std::uint32_t i = 0; i < count && in.ok; ++i) {
+                sc += in.Varint();
+                if (sc >= m_current.keys.size()) {
+                    in.ok = false;
+                    break;
+                }
+                m_current.keys.flip(sc);
+            }
+        }
+
+        if (flags & kFlagMouse) {
+            m_current.mouseX += in.ZigZag();
+            m_current.mouseY += in.ZigZag();
+        }
+
+        if (flags & kFlagButtons)
+            m_current.mouseButtons = in.Varint();
+
+        if (flags & kFlagWheel) {
+            m_current.wheelX = in.ZigZag();
+            m_current.wheelY = in.ZigZag();
+        }
+
+        if (flags & kFlagText)
+            m_current.textChar = in.Varint();
+
+        if (flags & kFlagPadButtons)
+            m_current.padButtons = in.Varint();
+
+        if (flags & kFlagPadAxes) {
+            const std::uint8_t axisMask = in.Byte();
+            for (int a = 0; a < SDL_CONTROLLER_AXIS_MAX; ++a) {
+                if ((axisMask & (1u << a)) != 0u)
+                    m_current.padAxes[a] = DequantizeAxis(QuantizeAxis(m_current.padAxes[a]) + in.ZigZag());
+            }
+        }
+
+        if (!in.ok) {
+            KbkError(kLogChannel, "Input recording is corrupt at frame %u", m_frameIndex);
+            m_frameIndex = m_frameCount;
+            return false;
+        }
+
+        ++m_frameIndex;
+        outFrame = m_current;
+        outDeltaSeconds = static_cast<double>(m_deltaMicros) / 1000000.0;
+        return true;
+    }
+
+} // namespace KibakoEngine
@@ -0,0 +1,149 @@
+// Worker pool with chunked, caller-assisted parallel loops
+#include "KibakoEngine/Core/JobSystem.h"
+
+#include "KibakoEngine/Core/Log.h"
+
+#include <algorithm>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Jobs";
+
+        // A few chunks per thread keeps the load balanced without tiny chunks
+        constexpr std::size_t kChunksPerThread = 4;
+
+        thread_local bool t_insideJob = false;
+        thread_local std::uint32_t t_threadIndex = 0;
+    }
+
+    JobSystem::~JobSystem()
+    {
+        Shutdown();
+    }
+
+    void JobSystem::Init(std::uint32_t workerCount)
+    {
+        if (!m_workers.empty())
+            return;
+
+        if (workerCount == 0) {
+            const std::uint32_t hw = std::thread::hardware_concurrency();
+            workerCount = (hw > 1) ? hw - 1 : 0;
+        }
+        workerCount = std::min(workerCount, kMaxThreads - 1);
+
+        m_stop = false;
+        m_workers.reserve(workerCount);
+        for (std::uint32_t i = 0; i < workerCount; ++i)
+            m_workers.emplace_back([this, i]() { WorkerLoop(i + 1); });
+
+        KbkLog(kLogChannel, "JobSystem started with %u worker(s)", workerCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (m_workers.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (std::thread& worker : m_workers)
+            worker.join();
+        m_workers.clear();
+
+        KbkLog(kLogChannel, "JobSystem stopped");
+    }
+
+    std::uint32_t JobSystem::CurrentThreadIndex()
+    {
+        return t_threadIndex;
+    }
+
+    void JobSystem::Dispatch(std::size_t count, std::size_t minChunk, RangeFn fn, void* ctx)
+    {
+        if (count == 0)
+            return;
+
+        minChunk = std::max<std::size_t>(minChunk, 1);
+
+        if (m_workers.empty() || t_insideJob || count <= minChunk) {
+            fn(ctx, 0, count);
+            return;
+        }
+
+        std::lock_guard<std::mutex> dispatchLock(m_dispatchMutex);
+
+        const std::size_t threads = m_workers.size() + 1;
+        const std::size_t chunkCount = std::clamp<std::size_t>(count / minChunk, 1, threads * kChunksPerThread);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_fn = fn;
+            m_ctx = ctx;
+            m_count = count;
+            m_chunkCount = chunkCount;
+            m_chunkSize = (count + chunkCount - 1) / chunkCount;
+            m_nextChunk.store(0, std::memory_order_relaxed);
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        t_insideJob = true;
+        RunChunks();
+        t_insideJob = false;
+
+        // Workers only join while m_fn is set, so once none is busy the job is over
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+        m_fn = nullptr;
+        m_ctx = nullptr;
+    }
+
+    void JobSystem::RunChunks()
+    {
+        for (;;) {
+            const std::size_t chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= m_chunkCount)
+                return;
+
+            const std::size_t begin = chunk * m_chunkSize;
+            const std::size_t end = std::min(begin + m_chunkSize, m_count);
+            if (begin < end)
+                m_fn(m_ctx, begin, end);
+        }
+    }
+
+    void JobSystem::WorkerLoop(std::uint32_t threadIndex)
+    {
+        t_insideJob = true;
+        t_threadIndex = threadIndex;
+
+        std::uint64_t seenGeneration = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (;;) {
+            m_wake.wait(lock, [&]() {
+                return m_stop || (m_fn != nullptr && m_generation != seenGeneration);
+                });
+            if (m_stop)
+                return;
+
+            seenGeneration = m_generation;
+            ++m_busyWorkers;
+            lock.unlock();
+
+            RunChunks();
+
+            lock.lock();
+            if (--m_busyWorkers == 0)
+                m_done.notify_all();
+        }
+    }
+
+} // namespace KibakoEngine
@@ -16,6 +16,7 @@ namespace KibakoEngine::Profiler {
     {
         using Clock = std::chrono::steady_clock;
 
+        // Milliseconds for scoped events, raw values for counters
         struct SampleData
         {
             double totalMs = 0.0;
@@ -36,6 +37,21 @@ namespace KibakoEngine::Profiler {
             return s_samples;
         }
 
+        // Counters are rare (a few per frame at most): recorded under the lock directly
+        std::unordered_map<std::string, SampleData>& Counters()
+        {
+            static std::unordered_map<std::string, SampleData> s_counters;
+            return s_counters;
+        }
+
+        void AccumulateSample(SampleData& sample, double value)
+        {
+            sample.totalMs += value;
+            sample.maxMs = std::max(sample.maxMs, value);
+            sample.minMs = std::min(sample.minMs, value);
+            sample.hits += 1;
+        }
+
         std::uint32_t& FrameCounter()
         {
             static std::uint32_t s_frames = 0;
@@ -59,13 +75,8 @@ namespace KibakoEngine::Profiler {
                 return;
 
             auto& samples = Samples();
-            for (const PendingSample& pending : t_pendingSamples) {
-                auto& sample = samples[pending.name ? pending.name : "<null>"];
-                sample.totalMs += pending.ms;
-                sample.maxMs = std::max(sample.maxMs, pending.ms);
-                sample.minMs = std::min(sample.minMs, pending.ms);
-                sample.hits += 1;
-            }
+            for (const PendingSample& pending : t_pendingSamples)
+                AccumulateSample(samples[pending.name ? pending.name : "<null>"], pending.ms);
             t_pendingSamples.clear();
         }
     } // namespace
@@ -88,6 +99,12 @@ namespace KibakoEngine::Profiler {
         }
     }
 
+    void RecordCounter(const char* name, double value)
+    {
+        std::lock_guard<std::mutex> guard(ProfilerMutex());
+        AccumulateSample(Counters()[name ? name : "<null>"], value);
+    }
+
     void BeginFrame()
     {
         bool flushNow = false;
@@ -106,13 +123,12 @@ namespace KibakoEngine::Profiler {
     void Flush()
     {
         std::unordered_map<std::string, SampleData> snapshot;
+        std::unordered_map<std::string, SampleData> counters;
         {
             std::lock_guard<std::mutex> guard(ProfilerMutex());
             FlushPendingSamplesLocked();
-            auto& samples = Samples();
-            if (samples.empty())
-                return;
-            snapshot.swap(samples);
+            snapshot.swap(Samples());
+            counters.swap(Counters());
         }
 
         for (auto& [name, data] : snapshot) {
@@ -122,6 +138,14 @@ namespace KibakoEngine::Profiler {
             KbkTrace("Profile", "%s -> avg %.3f ms (min %.3f / max %.3f) across %u samples",
                      name.c_str(), avg, data.minMs, data.maxMs, data.hits);
         }
+
+        for (auto& [name, data] : counters) {
+            if (data.hits == 0)
+                continue;
+            const double avg = data.totalMs / static_cast<double>(data.hits);
+            KbkTrace("Profile", "%s -> avg %.3f (min %.3f / max %.3f) across %u samples",
+                     name.c_str(), avg, data.minMs, data.maxMs, data.hits);
+        }
     }
 
 } // namespace KibakoEngine::Profiler
@@ -0,0 +1,224 @@
+// Min-heap timer scheduler with lazy cancellation and batched expirations
+#include "KibakoEngine/Gameplay/TimerService.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KibakoEngine::Gameplay {
+
+    namespace
+    {
+        // Smallest accepted period: avoids degenerate "fire every frame forever" loops
+        constexpr double kMinPeriod = 1.0e-4;
+
+        // Stale heap entries are only purged once they dominate the heap
+        constexpr std::size_t kCompactThreshold = 64;
+
+        // std heap algorithms build a max-heap, so invert for earliest-first
+        struct LaterDeadline
+        {
+            template <typename T>
+            bool operator()(const T& a, const T& b) const noexcept
+            {
+                if (a.deadline != b.deadline)
+                    return a.deadline > b.deadline;
+                return a.slot > b.slot; // deterministic order for equal deadlines
+            }
+        };
+    }
+
+    TimerHandle TimerService::Start(const TimerDesc& desc)
+    {
+        KBK_ASSERT(desc.clock != TimerClock::Count, "Invalid timer clock");
+
+        std::uint32_t slotIndex = 0;
+        if (!m_freeSlots.empty()) {
+            slotIndex = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else {
+            slotIndex = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        const int clock = static_cast<int>(desc.clock);
+
+        Slot& slot = m_slots[slotIndex];
+        slot.deadline = m_now[clock] + std::max(desc.delaySeconds, 0.0);
+        slot.period = (desc.periodSeconds > 0.0) ? std::max(desc.periodSeconds, kMinPeriod) : 0.0;
+        slot.userData = desc.userData;
+        slot.channel = desc.channel;
+        slot.clock = desc.clock;
+        slot.active = true;
+        ++m_activeCount;
+
+        Push(desc.clock, HeapEntry{ slot.deadline, slotIndex, slot.generation });
+        return TimerHandle{ slotIndex, slot.generation };
+    }
+
+    TimerHandle TimerService::Start(double delaySeconds, std::uint32_t channel, std::uint64_t userData)
+    {
+        TimerDesc desc;
+        desc.delaySeconds = delaySeconds;
+        desc.channel = channel;
+        desc.userData = userData;
+        return Start(desc);
+    }
+
+    bool TimerService::Cancel(TimerHandle handle)
+    {
+        if (!IsActive(handle))
+            return false;
+
+        const TimerClock clock = m_slots[handle.slot].clock;
+        Release(handle.slot);
+
+        ++m_stale[static_cast<int>(clock)];
+        CompactIfStale(clock);
+        return true;
+    }
+
+    void TimerService::Clear()
+    {
+        // Keep the slots (with bumped generations) so outstanding handles stay invalid
+        for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(m_slots.size()); ++i) {
+            if (m_slots[i].active)
+                Release(i);
+        }
+
+        for (int c = 0; c < kClockCount; ++c) {
+            m_heaps[c].clear();
+            m_stale[c] = 0;
+        }
+        m_expired.clear();
+    }
+
+    bool TimerService::IsActive(TimerHandle handle) const
+    {
+        if (handle.slot >= m_slots.size())
+            return false;
+
+        const Slot& slot = m_slots[handle.slot];
+        return slot.active && slot.generation == handle.generation;
+    }
+
+    double TimerService::Remaining(TimerHandle handle) const
+    {
+        if (!IsActive(handle))
+            return 0.0;
+
+        const Slot& slot = m_slots[handle.slot];
+        return std::max(slot.deadline - m_now[static_cast<int>(slot.clock)], 0.0);
+    }
+
+    void TimerService::Update(const GameTime& time)
+    {
+        KBK_PROFILE_SCOPE("TimerService");
+
+        m_expired.clear();
+
+        // Scaled time does not advance while paused, so gameplay timers freeze for free
+        m_now[static_cast<int>(TimerClock::Scaled)] = time.totalScaledSeconds;
+        m_now[static_cast<int>(TimerClock::Raw)] = time.totalRawSeconds;
+
+        Collect(TimerClock::Scaled);
+        Collect(TimerClock::Raw);
+
+        // One contiguous batch per channel, deadline order inside a batch
+        std::sort(m_expired.begin(), m_expired.end(),
+            [](const TimerExpiration& a, const TimerExpiration& b) {
+                if (a.channel != b.channel)
+                    return a.channel < b.channel;
+                if (a.deadline != b.deadline)
+                    return a.deadline < b.deadline;
+                return a.handle.slot < b.handle.slot;
+            });
+    }
+
+    std::span<const TimerExpiration> TimerService::Expired(std::uint32_t channel) const
+    {
+        const auto first = std::lower_bound(m_expired.begin(), m_expired.end(), channel,
+            [](const TimerExpiration& e, std::uint32_t c) { return e.channel < c; });
+        const auto last = std::upper_bound(first, m_expired.end(), channel,
+            [](std::uint32_t c, const TimerExpiration& e) { return c < e.channel; });
+
+        return std::span<const TimerExpiration>(m_expired).subspan(
+            static_cast<std::size_t>(first - m_expired.begin()),
+            static_cast<std::size_t>(last - first));
+    }
+
+    void TimerService::Push(TimerClock clock, const HeapEntry& entry)
+    {
+        std::vector<HeapEntry>& heap = m_heaps[static_cast<int>(clock)];
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), LaterDeadline{});
+    }
+
+    void TimerService::Collect(TimerClock clock)
+    {
+        const int c = static_cast<int>(clock);
+        std::vector<HeapEntry>& heap = m_heaps[c];
+        const double now = m_now[c];
+
+        while (!heap.empty() && heap.front().deadline <= now) {
+            std::pop_heap(heap.begin(), heap.end(), LaterDeadline{});
+            const HeapEntry entry = heap.back();
+            heap.pop_back();
+
+            Slot& slot = m_slots[entry.slot];
+            if (!slot.active || slot.generation != entry.generation) {
+                --m_stale[c];
+                continue;
+            }
+
+            TimerExpiration& expiration = m_expired.emplace_back();
+            expiration.handle = TimerHandle{ entry.slot, entry.generation };
+            expiration.userData = slot.userData;
+            expiration.channel = slot.channel;
+            expiration.deadline = slot.deadline;
+
+            if (slot.period > 0.0) {
+                // Catch up in one step after a long frame instead of looping
+                const double periods = std::floor((now - slot.deadline) / slot.period) + 1.0;
+                expiration.count = static_cast<std::uint32_t>(std::min(periods, 4294967295.0));
+
+                slot.deadline += periods * slot.period;
+                Push(clock, HeapEntry{ slot.deadline, entry.slot, entry.generation });
+            }
+            else {
+                Release(entry.slot);
+            }
+        }
+    }
+
+    void TimerService::Release(std::uint32_t slotIndex)
+    {
+        Slot& slot = m_slots[slotIndex];
+        slot.active = false;
+        ++slot.generation;
+        m_freeSlots.push_back(slotIndex);
+
+        KBK_ASSERT(m_activeCount > 0, "TimerService active count underflow");
+        --m_activeCount;
+    }
+
+    void TimerService::CompactIfStale(TimerClock clock)
+    {
+        const int c = static_cast<int>(clock);
+        std::vector<HeapEntry>& heap = m_heaps[c];
+
+        if (m_stale[c] < kCompactThreshold || m_stale[c] * 2 < heap.size())
+            return;
+
+        std::erase_if(heap, [this](const HeapEntry& entry) {
+            const Slot& slot = m_slots[entry.slot];
+            return !slot.active || slot.generation != entry.generation;
+        });
+        std::make_heap(heap.begin(), heap.end(), LaterDeadline{});
+        m_stale[c] = 0;
+    }
+
+} // namespace KibakoEngine::Gameplay
@@ -0,0 +1,280 @@
+// SoA particle pools: spawn, SSE integrate/fade kernels, swap compaction, batch output
+#include "KibakoEngine/Particles/ParticleSystem2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/JobSystem.h"
+#include "KibakoEngine/Core/Profiler.h"
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#    define KBK_PARTICLES_SSE 1
+#    include <xmmintrin.h>
+#else
+#    define KBK_PARTICLES_SSE 0
+#endif
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr std::size_t RoundUp4(std::size_t n) { return (n + 3u) & ~std::size_t{ 3u }; }
+
+        float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+    }
+
+    ParticleEmitter2D::ParticleEmitter2D(const ParticleEmitterDesc& desc, std::uint32_t seed)
+        : m_desc(desc)
+        , m_rng(seed ? seed : 1u)
+    {
+        // The pools never grow: capacity is the emitter's budget
+        const std::size_t padded = RoundUp4(std::max<std::uint32_t>(desc.capacity, 1u));
+        for (std::vector<float>* pool : { &m_posX, &m_posY, &m_velX, &m_velY, &m_age, &m_invLife,
+                 &m_size, &m_colR, &m_colG, &m_colB, &m_colA }) {
+            pool->assign(padded, 0.0f);
+        }
+    }
+
+    float ParticleEmitter2D::RandomUnit()
+    {
+        // xorshift32: cheap and deterministic per emitter
+        m_rng ^= m_rng << 13;
+        m_rng ^= m_rng >> 17;
+        m_rng ^= m_rng << 5;
+        return static_cast<float>(m_rng >> 8) * (1.0f / 16777216.0f);
+    }
+
+    void ParticleEmitter2D::Update(float dt)
+    {
+        Integrate(dt);
+        Compact();
+
+        std::uint32_t spawns = m_pendingBurst;
+        m_pendingBurst = 0;
+        if (m_emitting && m_desc.rate > 0.0f) {
+            m_spawnAccumulator += m_desc.rate * dt;
+            const float whole = std::floor(m_spawnAccumulator);
+            m_spawnAccumulator -= whole;
+            spawns += static_cast<std::uint32_t>(whole);
+        }
+        Spawn(spawns);
+
+        Fade();
+    }
+
+    void ParticleEmitter2D::Spawn(std::uint32_t count)
+    {
+        const std::size_t room = m_desc.capacity - std::min<std::size_t>(m_count, m_desc.capacity);
+        const std::size_t spawns = std::min<std::size_t>(count, room);
+
+        for (std::size_t n = 0; n < spawns; ++n) {
+            const std::size_t i = m_count++;
+
+            const float dir = m_desc.angle + (RandomUnit() - 0.5f) * m_desc.spread;
+            const float speed = Lerp(m_desc.speedMin, m_desc.speedMax, RandomUnit());
+            const float life = Lerp(m_desc.lifeMin, m_desc.lifeMax, RandomUnit());
+
+            float offsetX = 0.0f;
+            float offsetY = 0.0f;
+            if (m_desc.spawnRadius > 0.0f) {
+                // sqrt keeps the disc uniformly filled
+                const float r = m_desc.spawnRadius * std::sqrt(RandomUnit());
+                const float a = RandomUnit() * 6.2831853f;
+                offsetX = r * std::cos(a);
+                offsetY = r * std::sin(a);
+            }
+
+            m_posX[i] = m_position.x + offsetX;
+            m_posY[i] = m_position.y + offsetY;
+            m_velX[i] = std::cos(dir) * speed;
+            m_velY[i] = std::sin(dir) * speed;
+            m_age[i] = 0.0f;
+            m_invLife[i] = (life > 0.0f) ? 1.0f / life : 1.0e9f;
+        }
+    }
+
+    void ParticleEmitter2D::Integrate(float dt)
+    {
+        // Padding slots are integrated too: they are never read back as live
+        const std::size_t n = RoundUp4(m_count);
+        const float damping = std::max(0.0f, 1.0f - m_desc.drag * dt);
+        const float gx = m_desc.gravity.x * dt;
+        const float gy = m_desc.gravity.y * dt;
+
+#if KBK_PARTICLES_SSE
+        const __m128 vDt = _mm_set1_ps(dt);
+        const __m128 vGx = _mm_set1_ps(gx);
+        const __m128 vGy = _mm_set1_ps(gy);
+        const __m128 vDamp = _mm_set1_ps(damping);
+
+        for (std::size_t i = 0; i < n; i += 4) {
+            const __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&m_velX[i]), vGx), vDamp);
+            const __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&m_velY[i]), vGy), vDamp);
+            _mm_storeu_ps(&m_velX[i], vx);
+            _mm_storeu_ps(&m_velY[i], vy);
+            _mm_storeu_ps(&m_posX[i], _mm_add_ps(_mm_loadu_ps(&m_posX[i]), _mm_mul_ps(vx, vDt)));
+            _mm_storeu_ps(&m_posY[i], _mm_add_ps(_mm_loadu_ps(&m_posY[i]), _mm_mul_ps(vy, vDt)));
+            _mm_storeu_ps(&m_age[i], _mm_add_ps(_mm_loadu_ps(&m_age[i]), vDt));
+        }
+#else
+        for (std::size_t i = 0; i < n; ++i) {
+            m_velX[i] = (m_velX[i] + gx) * damping;
+            m_velY[i] = (m_velY[i] + gy) * damping;
+            m_posX[i] += m_velX[i] * dt;
+            m_posY[i] += m_velY[i] * dt;
+            m_age[i] += dt;
+        }
+#endif
+    }
+
+    void ParticleEmitter2D::Fade()
+    {
+        const std::size_t n = RoundUp4(m_count);
+        const ParticleEmitterDesc& d = m_desc;
+
+#if KBK_PARTICLES_SSE
+        const __m128 vOne = _mm_set1_ps(1.0f);
+        const __m128 s0 = _mm_set1_ps(d.sizeStart);
+        const __m128 sD = _mm_set1_ps(d.sizeEnd - d.sizeStart);
+        const __m128 r0 = _mm_set1_ps(d.colorStart.r);
+        const __m128 rD = _mm_set1_ps(d.colorEnd.r - d.colorStart.r);
+        const __m128 g0 = _mm_set1_ps(d.colorStart.g);
+        const __m128 gD = _mm_set1_ps(d.colorEnd.g - d.colorStart.g);
+        const __m128 b0 = _mm_set1_ps(d.colorStart.b);
+        const __m128 bD = _mm_set1_ps(d.colorEnd.b - d.colorStart.b);
+        const __m128 a0 = _mm_set1_ps(d.colorStart.a);
+        const __m128 aD = _mm_set1_ps(d.colorEnd.a - d.colorStart.a);
+
+        for (std::size_t i = 0; i < n; i += 4) {
+            const __m128 t = _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(&m_age[i]), _mm_loadu_ps(&m_invLife[i])), vOne);
+            _mm_storeu_ps(&m_size[i], _mm_add_ps(s0, _mm_mul_ps(sD, t)));
+            _mm_storeu_ps(&m_colR[i], _mm_add_ps(r0, _mm_mul_ps(rD, t)));
+            _mm_storeu_ps(&m_colG[i], _mm_add_ps(g0, _mm_mul_ps(gD, t)));
+            _mm_storeu_ps(&m_colB[i], _mm_add_ps(b0, _mm_mul_ps(bD, t)));
+            _mm_storeu_ps(&m_colA[i], _mm_add_ps(a0, _mm_mul_ps(aD, t)));
+        }
+#else
+        for (std::size_t i = 0; i < n; ++i) {
+            const float t = std::min(m_age[i] * m_invLife[i], 1.0f);
+            m_size[i] = Lerp(d.sizeStart, d.sizeEnd, t);
+            m_colR[i] = Lerp(d.colorStart.r, d.colorEnd.r, t);
+            m_colG[i] = Lerp(d.colorStart.g, d.colorEnd.g, t);
+            m_colB[i] = Lerp(d.colorStart.b, d.colorEnd.b, t);
+            m_colA[i] = Lerp(d.colorStart.a, d.colorEnd.a, t);
+        }
+#endif
+    }
+
+    void ParticleEmitter2D::Compact()
+    {
+        // Swap-remove: draw order within an emitter is not meaningful
+        std::size_t i = 0;
+        while (i < m_count) {
+            if (m_age[i] * m_invLife[i] < 1.0f) {
+                ++i;
+                continue;
+            }
+
+            const std::size_t last = --m_count;
+            m_posX[i] = m_posX[last];
+            m_posY[i] = m_posY[last];
+            m_velX[i] = m_velX[last];
+            m_velY[i] = m_velY[last];
+            m_age[i] = m_age[last];
+            m_invLife[i] = m_invLife[last];
+        }
+    }
+
+    void ParticleEmitter2D::Emit(SpriteBatch2D& batch) const
+    {
+        if (m_count == 0)
+            return;
+
+        const SpriteBatch2D::GeometryWriter out =
+            batch.AllocateGeometry(m_desc.texture, m_count * 4, m_count * 6, m_desc.layer, m_desc.blend);
+        if (!out.vertices)
+            return;
+
+        const float u0 = m_desc.src.x;
+        const float v0 = m_desc.src.y;
+        const float u1 = m_desc.src.x + m_desc.src.w;
+        const float v1 = m_desc.src.y + m_desc.src.h;
+
+        SpriteBatch2D::Vertex* v = out.vertices;
+        std::uint32_t* idx = out.indices;
+        for (std::size_t i = 0; i < m_count; ++i) {
+            const float half = m_size[i] * 0.5f;
+            const float left = m_posX[i] - half;
+            const float right = m_posX[i] + half;
+            const float top = m_posY[i] - half;
+            const float bottom = m_posY[i] + half;
+            const DirectX::XMFLOAT4 color{ m_colR[i], m_colG[i], m_colB[i], m_colA[i] };
+
+            v[0] = { { left,  top,    0.0f }, { u0, v0 }, color };
+            v[1] = { { right, top,    0.0f }, { u1, v0 }, color };
+            v[2] = { { right, bottom, 0.0f }, { u1, v1 }, color };
+            v[3] = { { left,  bottom, 0.0f }, { u0, v1 }, color };
+            v += 4;
+
+            const std::uint32_t base = static_cast<std::uint32_t>(i * 4);
+            idx[0] = base;
+            idx[1] = base + 1;
+            idx[2] = base + 2;
+            idx[3] = base;
+            idx[4] = base + 2;
+            idx[5] = base + 3;
+            idx += 6;
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
+    ParticleEmitter2D& ParticleSystem2D::CreateEmitter(const ParticleEmitterDesc& desc)
+    {
+        // Distinct seeds so identical emitters do not spray in lockstep
+        m_nextSeed = m_nextSeed * 1664525u + 1013904223u;
+        m_emitters.push_back(std::make_unique<ParticleEmitter2D>(desc, m_nextSeed));
+        return *m_emitters.back();
+    }
+
+    void ParticleSystem2D::DestroyEmitter(ParticleEmitter2D& emitter)
+    {
+        std::erase_if(m_emitters, [&emitter](const std::unique_ptr<ParticleEmitter2D>& e) { return e.get() == &emitter; });
+    }
+
+    void ParticleSystem2D::Update(float dt, JobSystem* jobs)
+    {
+        KBK_PROFILE_SCOPE("ParticleSystem2D.Update");
+
+        if (!jobs) {
+            for (const std::unique_ptr<ParticleEmitter2D>& emitter : m_emitters)
+                emitter->Update(dt);
+            return;
+        }
+
+        // Emitters share nothing, so each one is an independent chunk
+        jobs->ParallelFor(m_emitters.size(), 1, [this, dt](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i)
+                m_emitters[i]->Update(dt);
+            });
+    }
+
+    void ParticleSystem2D::Render(SpriteBatch2D& batch) const
+    {
+        KBK_PROFILE_SCOPE("ParticleSystem2D.Render");
+
+        for (const std::unique_ptr<ParticleEmitter2D>& emitter : m_emitters)
+            emitter->Emit(batch);
+    }
+
+    std::size_t ParticleSystem2D::AliveCount() const
+    {
+        std::size_t alive = 0;
+        for (const std::unique_ptr<ParticleEmitter2D>& emitter : m_emitters)
+            alive += emitter->AliveCount();
+        return alive;
+    }
+
+} // namespace KibakoEngine
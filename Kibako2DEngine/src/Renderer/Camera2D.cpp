@@ -33,6 +33,16 @@ namespace KibakoEngine {
         }
     }
 
+    void Camera2D::SetZoom(float zoom)
+    {
+        if (zoom <= 0.0f)
+            zoom = 1.0f;
+        if (zoom != m_zoom) {
+            m_zoom = zoom;
+            UpdateMatrix();
+        }
+    }
+
     void Camera2D::UpdateMatrix()
     {
         // 1 unit = 1 pixel in screen space.
@@ -43,7 +53,8 @@ namespace KibakoEngine {
 
         const XMMATRIX translate = XMMatrixTranslation(-m_positionX, -m_positionY, 0.0f);
         const XMMATRIX rotate = XMMatrixRotationZ(-m_rotation);
-        const XMMATRIX view = rotate * translate;
+        const XMMATRIX scale = XMMatrixScaling(m_zoom, m_zoom, 1.0f);
+        const XMMATRIX view = rotate * translate * scale;
         const XMMATRIX vp = view * proj;
 
         XMStoreFloat4x4(&m_viewProj, vp);
@@ -0,0 +1,323 @@
+// Light binning into screen tiles (SSE, one row per job) and the CPU lighting references
+#include "KibakoEngine/Renderer/LightGrid2D.h"
+
+#include "KibakoEngine/Core/JobSystem.h"
+#include "KibakoEngine/Core/Profiler.h"
+#include "KibakoEngine/Renderer/Camera2D.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#    define KBK_LIGHTS_SSE 1
+#    include <xmmintrin.h>
+#else
+#    define KBK_LIGHTS_SSE 0
+#endif
+
+namespace KibakoEngine {
+
+    using namespace DirectX;
+
+    namespace
+    {
+        // Culling radius slightly larger than the shaded one, so rounding in
+        // the box test never drops a light that still lights a pixel
+        constexpr float kCullScale = 1.0001f;
+        constexpr float kCullBias = 0.01f;
+
+        constexpr std::size_t kRowsPerJob = 2;
+
+        std::size_t PaddedCount(std::size_t count)
+        {
+            return (count + 3) & ~static_cast<std::size_t>(3);
+        }
+    }
+
+    LightInstance2D ProjectLight2D(const Camera2D& camera, const RectF& viewport,
+        const XMFLOAT2& worldPosition, float worldRadius, const XMFLOAT3& color)
+    {
+        // Row-vector transform of (x, y, 0, 1); w stays 1 for the orthographic camera
+        const XMFLOAT4X4 m = camera.GetViewProjection();
+        const float x = worldPosition.x;
+        const float y = worldPosition.y;
+        const float ndcX = x * m.m[0][0] + y * m.m[1][0] + m.m[3][0];
+        const float ndcY = x * m.m[0][1] + y * m.m[1][1] + m.m[3][1];
+
+        // The camera keeps one world unit at `zoom` pixels of its own viewport
+        const float pixelsPerUnit = camera.GetZoom() * (viewport.w / camera.GetViewportWidth());
+
+        LightInstance2D light;
+        light.position.x = viewport.x + (ndcX * 0.5f + 0.5f) * viewport.w;
+        light.position.y = viewport.y + (0.5f - ndcY * 0.5f) * viewport.h;
+        light.radius = worldRadius * pixelsPerUnit;
+        light.color = color;
+        return light;
+    }
+
+    LightGrid2D::LightGrid2D(const LightGridDesc& desc)
+        : m_desc(desc)
+    {
+        m_desc.tileSize = std::max(m_desc.tileSize, 1u);
+        m_desc.maxLightsPerTile = std::max(m_desc.maxLightsPerTile, 1u);
+    }
+
+    void LightGrid2D::Clear()
+    {
+        m_tilesX = 0;
+        m_tilesY = 0;
+        m_lights.clear();
+        m_posX.clear();
+        m_posY.clear();
+        m_radiusSq.clear();
+        m_minY.clear();
+        m_maxY.clear();
+        m_ranges.clear();
+        m_indices.clear();
+        m_stats = {};
+    }
+
+    void LightGrid2D::Build(std::span<const LightInstance2D> lights, const RectF& area, JobSystem* jobs)
+    {
+        KBK_PROFILE_SCOPE("LightGridBuild");
+
+        Clear();
+        m_area = area;
+        if (!(area.w > 0.0f) || !(area.h > 0.0f))
+            return;
+
+        const float tile = static_cast<float>(m_desc.tileSize);
+        m_tilesX = static_cast<std::uint32_t>(std::ceil(area.w / tile));
+        m_tilesY = static_cast<std::uint32_t>(std::ceil(area.h / tile));
+
+        const float right = area.x + area.w;
+        const float bottom = area.y + area.h;
+        for (const LightInstance2D& light : lights) {
+            const float r = light.radius;
+            if (!(r > 0.0f))
+                continue;
+            const float x = light.position.x;
+            const float y = light.position.y;
+            if (x + r < area.x || x - r > right || y + r < area.y || y - r > bottom)
+                continue;
+
+            const float cull = r * kCullScale + kCullBias;
+            m_lights.push_back({ x, y, r, 1.0f / r, light.color.x, light.color.y, light.color.z, 0.0f });
+            m_posX.push_back(x);
+            m_posY.push_back(y);
+            m_radiusSq.push_back(cull * cull);
+            m_minY.push_back(y - cull);
+            m_maxY.push_back(y + cull);
+        }
+
+        // Padding lights: empty band, negative radius
+        const std::size_t padded = PaddedCount(m_lights.size());
+        m_posX.resize(padded, 0.0f);
+        m_posY.resize(padded, 0.0f);
+        m_radiusSq.resize(padded, -1.0f);
+        m_minY.resize(padded, std::numeric_limits<float>::max());
+        m_maxY.resize(padded, -std::numeric_limits<float>::max());
+
+        m_rows.resize(m_tilesY);
+        const auto binRows = [this](std::size_t begin, std::size_t end) {
+            for (std::size_t row = begin; row < end; ++row)
+                BinRow(static_cast<std::uint32_t>(row));
+        };
+        if (jobs && m_tilesY > kRowsPerJob)
+            jobs->ParallelFor(m_tilesY, kRowsPerJob, binRows);
+        else
+            binRows(0, m_tilesY);
+
+        // Rows back to back, in row order whatever thread binned them
+        std::size_t total = 0;
+        for (std::uint32_t row = 0; row < m_tilesY; ++row)
+            total += m_rows[row].indices.size();
+        m_indices.reserve(total);
+        m_ranges.reserve(static_cast<std::size_t>(m_tilesX) * m_tilesY);
+
+        for (std::uint32_t row = 0; row < m_tilesY; ++row) {
+            const RowBins& bins = m_rows[row];
+            const std::uint32_t base = static_cast<std::uint32_t>(m_indices.size());
+            m_indices.insert(m_indices.end(), bins.indices.begin(), bins.indices.end());
+            for (const LightTileRange2D& range : bins.ranges)
+                m_ranges.push_back({ base + range.offset, range.count });
+
+            m_stats.maxPerTile = std::max(m_stats.maxPerTile, bins.maxPerTile);
+            m_stats.overflowTiles += bins.overflowTiles;
+        }
+
+        m_stats.lights = static_cast<std::uint32_t>(m_lights.size());
+        m_stats.tiles = m_tilesX * m_tilesY;
+        m_stats.entries = static_cast<std::uint32_t>(m_indices.size());
+
+        KBK_PROFILE_COUNTER("Lights.Visible", m_stats.lights);
+        KBK_PROFILE_COUNTER("Lights.TileEntries", m_stats.entries);
+    }
+
+    void LightGrid2D::BinRow(std::uint32_t row)
+    {
+        RowBins& bins = m_rows[row];
+        bins.candidates.clear();
+        bins.indices.clear();
+        bins.ranges.clear();
+        bins.maxPerTile = 0;
+        bins.overflowTiles = 0;
+
+        const float tile = static_cast<float>(m_desc.tileSize);
+        const float y0 = m_area.y + static_cast<float>(row) * tile;
+        const float y1 = std::min(y0 + tile, m_area.y + m_area.h);
+        const std::size_t padded = m_posX.size();
+
+        // 1. Lights whose vertical extent meets the band
+#if KBK_LIGHTS_SSE
+        const __m128 vy0 = _mm_set1_ps(y0);
+        const __m128 vy1 = _mm_set1_ps(y1);
+        for (std::size_t i = 0; i < padded; i += 4) {
+            const __m128 hit = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&m_minY[i]), vy1),
+                _mm_cmpge_ps(_mm_loadu_ps(&m_maxY[i]), vy0));
+            for (unsigned bits = static_cast<unsigned>(_mm_movemask_ps(hit)); bits != 0; bits &= bits - 1)
+                bins.candidates.push_back(static_cast<std::uint32_t>(i) + static_cast<std::uint32_t>(std::countr_zero(bits)));
+        }
+#else
+        for (std::size_t i = 0; i < padded; ++i)
+            if (m_minY[i] <= y1 && m_maxY[i] >= y0)
+                bins.candidates.push_back(static_cast<std::uint32_t>(i));
+#endif
+
+        // 2. Columns each candidate reaches: within the band, the circle is
+        //    at most sqrt(r^2 - gap^2) wide on either side of its centre.
+        //    Spans may be one tile generous at their ends; lights there add
+        //    exactly zero, so the shading is unchanged.
+        const std::size_t count = bins.candidates.size();
+        const std::size_t countPadded = PaddedCount(count);
+        std::vector<float>& centerX = bins.centerX;
+        std::vector<float>& budget = bins.budget;
+        std::vector<float>& firstCol = bins.firstCol;
+        std::vector<float>& lastCol = bins.lastCol;
+        centerX.assign(countPadded, 0.0f);
+        budget.assign(countPadded, -1.0f);
+        firstCol.resize(countPadded);
+        lastCol.resize(countPadded);
+        for (std::size_t c = 0; c < count; ++c) {
+            const std::uint32_t i = bins.candidates[c];
+            const float py = m_posY[i];
+            const float dy = std::max(std::max(y0 - py, py - y1), 0.0f);
+            centerX[c] = m_posX[i];
+            budget[c] = m_radiusSq[i] - dy * dy;
+        }
+
+        const float invTile = 1.0f / tile;
+        const float maxCol = static_cast<float>(m_tilesX - 1);
+#if KBK_LIGHTS_SSE
+        const __m128 vOrigin = _mm_set1_ps(m_area.x);
+        const __m128 vInvTile = _mm_set1_ps(invTile);
+        const __m128 vZero = _mm_setzero_ps();
+        const __m128 vMaxCol = _mm_set1_ps(maxCol);
+        for (std::size_t c = 0; c < countPadded; c += 4) {
+            const __m128 b = _mm_loadu_ps(&budget[c]);
+            const __m128 half = _mm_sqrt_ps(_mm_max_ps(b, vZero));
+            const __m128 local = _mm_sub_ps(_mm_loadu_ps(&centerX[c]), vOrigin);
+            const __m128 lo = _mm_mul_ps(_mm_sub_ps(local, half), vInvTile);
+            const __m128 hi = _mm_mul_ps(_mm_add_ps(local, half), vInvTile);
+            // Out of reach (negative budget) becomes an empty span: first > last
+            const __m128 reach = _mm_cmpge_ps(b, vZero);
+            _mm_storeu_ps(&firstCol[c], _mm_or_ps(_mm_and_ps(reach, _mm_max_ps(lo, vZero)),
+                _mm_andnot_ps(reach, _mm_set1_ps(maxCol + 1.0f))));
+            _mm_storeu_ps(&lastCol[c], _mm_min_ps(hi, vMaxCol));
+        }
+#else
+        for (std::size_t c = 0; c < countPadded; ++c) {
+            const float half = std::sqrt(std::max(budget[c], 0.0f));
+            const float local = centerX[c] - m_area.x;
+            firstCol[c] = (budget[c] >= 0.0f) ? std::max((local - half) * invTile, 0.0f) : maxCol + 1.0f;
+            lastCol[c] = std::min((local + half) * invTile, maxCol);
+        }
+#endif
+
+        // 3. Counting sort into the row's tiles: lights stay in index order
+        //    within each tile, and each tile keeps at most `cap` of them
+        const std::uint32_t cap = m_desc.maxLightsPerTile;
+        std::vector<std::uint32_t>& tileCounts = bins.tileCounts;
+        tileCounts.assign(m_tilesX, 0u);
+
+        const auto span = [&](std::size_t c, std::int32_t& first, std::int32_t& last) {
+            first = static_cast<std::int32_t>(firstCol[c]); // >= 0: truncation is floor
+            last = (lastCol[c] < 0.0f) ? -1 : static_cast<std::int32_t>(lastCol[c]);
+        };
+
+        for (std::size_t c = 0; c < count; ++c) {
+            std::int32_t first = 0;
+            std::int32_t last = 0;
+            span(c, first, last);
+            for (std::int32_t col = first; col <= last; ++col)
+                ++tileCounts[static_cast<std::size_t>(col)];
+        }
+
+        bins.ranges.resize(m_tilesX);
+        std::uint32_t offset = 0;
+        for (std::uint32_t col = 0; col < m_tilesX; ++col) {
+            const std::uint32_t found = tileCounts[col];
+            const std::uint32_t kept = std::min(found, cap);
+            bins.ranges[col] = { offset, 0 };
+            offset += kept;
+            bins.maxPerTile = std::max(bins.maxPerTile, found);
+            if (found > cap)
+                ++bins.overflowTiles;
+        }
+
+        bins.indices.resize(offset);
+        for (std::size_t c = 0; c < count; ++c) {
+            std::int32_t first = 0;
+            std::int32_t last = 0;
+            span(c, first, last);
+            for (std::int32_t col = first; col <= last; ++col) {
+                LightTileRange2D& range = bins.ranges[static_cast<std::size_t>(col)];
+                if (range.count < cap)
+                    bins.indices[range.offset + range.count++] = bins.candidates[c];
+            }
+        }
+    }
+
+    std::span<const std::uint32_t> LightGrid2D::LightsAt(float x, float y) const
+    {
+        const float tile = static_cast<float>(m_desc.tileSize);
+        const float fx = std::floor((x - m_area.x) / tile);
+        const float fy = std::floor((y - m_area.y) / tile);
+        if (!(fx >= 0.0f) || !(fy >= 0.0f) || fx >= static_cast<float>(m_tilesX) || fy >= static_cast<float>(m_tilesY))
+            return {};
+
+        const LightTileRange2D& range = m_ranges[static_cast<std::size_t>(fy) * m_tilesX + static_cast<std::size_t>(fx)];
+        return std::span<const std::uint32_t>(m_indices).subspan(range.offset, range.count);
+    }
+
+    XMFLOAT3 ShadeLightGridReference(const LightGrid2D& grid, const XMFLOAT3& ambient, float x, float y)
+    {
+        XMFLOAT3 sum = ambient;
+        const std::span<const PackedLight2D> lights = grid.Lights();
+        for (const std::uint32_t index : grid.LightsAt(x, y)) {
+            const PackedLight2D& light = lights[index];
+            const float a = LightAttenuation2D(x - light.x, y - light.y, light.invRadius);
+            sum.x += light.r * a;
+            sum.y += light.g * a;
+            sum.z += light.b * a;
+        }
+        return sum;
+    }
+
+    XMFLOAT3 ShadeLightsBruteForce(std::span<const LightInstance2D> lights, const XMFLOAT3& ambient, float x, float y)
+    {
+        XMFLOAT3 sum = ambient;
+        for (const LightInstance2D& light : lights) {
+            if (!(light.radius > 0.0f))
+                continue;
+            const float a = LightAttenuation2D(x - light.position.x, y - light.position.y, 1.0f / light.radius);
+            sum.x += light.color.x * a;
+            sum.y += light.color.y * a;
+            sum.z += light.color.z * a;
+        }
+        return sum;
+    }
+
+} // namespace KibakoEngine
@@ -0,0 +1,127 @@
+// Coarse-grid overdraw estimate for painter's order versus the depth-tested opaque pass
+#include "KibakoEngine/Renderer/OverdrawEstimator2D.h"
+
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        struct ClippedRect
+        {
+            float left = 0.0f;
+            float top = 0.0f;
+            float right = 0.0f;
+            float bottom = 0.0f;
+
+            [[nodiscard]] bool Empty() const { return right <= left || bottom <= top; }
+            [[nodiscard]] float Area() const { return (right - left) * (bottom - top); }
+        };
+
+        ClippedRect Clip(const RectF& r, const RectF& screen)
+        {
+            ClippedRect c;
+            c.left = std::max(r.x, screen.x);
+            c.top = std::max(r.y, screen.y);
+            c.right = std::min(r.x + r.w, screen.x + screen.w);
+            c.bottom = std::min(r.y + r.h, screen.y + screen.h);
+            return c;
+        }
+
+        // Cells [first, last) entirely inside [lo, hi) along one axis; the
+        // last cell may be cut by the screen edge and counts when hi reaches it
+        void FullCells(float lo, float hi, float origin, float extent, float cell, std::uint32_t count,
+            std::uint32_t& first, std::uint32_t& last)
+        {
+            const float firstF = std::ceil((lo - origin) / cell);
+            const float lastF = (hi >= origin + extent) ? static_cast<float>(count) : std::floor((hi - origin) / cell);
+            first = static_cast<std::uint32_t>(std::clamp(firstF, 0.0f, static_cast<float>(count)));
+            last = static_cast<std::uint32_t>(std::clamp(lastF, 0.0f, static_cast<float>(count)));
+        }
+
+        // Cells [first, last) touched by [lo, hi)
+        void TouchedCells(float lo, float hi, float origin, float cell, std::uint32_t count,
+            std::uint32_t& first, std::uint32_t& last)
+        {
+            const float firstF = std::floor((lo - origin) / cell);
+            const float lastF = std::ceil((hi - origin) / cell);
+            first = static_cast<std::uint32_t>(std::clamp(firstF, 0.0f, static_cast<float>(count)));
+            last = static_cast<std::uint32_t>(std::clamp(lastF, 0.0f, static_cast<float>(count)));
+        }
+    }
+
+    OverdrawEstimator2D::OverdrawEstimator2D(float cellSize)
+        : m_cellSize(cellSize > 0.0f ? cellSize : 8.0f)
+    {
+    }
+
+    const OverdrawEstimate& OverdrawEstimator2D::Estimate(std::span<const OverdrawQuad2D> painterOrder, const RectF& screen)
+    {
+        KBK_PROFILE_SCOPE("OverdrawEstimate");
+
+        m_estimate = {};
+        if (!(screen.w > 0.0f) || !(screen.h > 0.0f))
+            return m_estimate;
+
+        const float cell = m_cellSize;
+        const auto cols = static_cast<std::uint32_t>(std::ceil(screen.w / cell));
+        const auto rows = static_cast<std::uint32_t>(std::ceil(screen.h / cell));
+        m_frontOccluder.assign(static_cast<std::size_t>(cols) * rows, 0u);
+
+        // Latest occluder over each cell: whatever was painted before it there is hidden
+        for (std::size_t i = 0; i < painterOrder.size(); ++i) {
+            const OverdrawQuad2D& q = painterOrder[i];
+            if (!q.occluder || q.opacity == SpriteOpacity::Translucent)
+                continue;
+            const ClippedRect r = Clip(q.bounds, screen);
+            if (r.Empty())
+                continue;
+
+            std::uint32_t c0 = 0, c1 = 0, r0 = 0, r1 = 0;
+            FullCells(r.left, r.right, screen.x, screen.w, cell, cols, c0, c1);
+            FullCells(r.top, r.bottom, screen.y, screen.h, cell, rows, r0, r1);
+            const auto paint = static_cast<std::uint32_t>(i + 1);
+            for (std::uint32_t y = r0; y < r1; ++y) {
+                std::uint32_t* row = m_frontOccluder.data() + static_cast<std::size_t>(y) * cols;
+                for (std::uint32_t x = c0; x < c1; ++x)
+                    row[x] = paint;
+            }
+        }
+
+        for (std::size_t i = 0; i < painterOrder.size(); ++i) {
+            const OverdrawQuad2D& q = painterOrder[i];
+            ++m_estimate.quads;
+            if (q.opacity != SpriteOpacity::Translucent)
+                ++m_estimate.opaqueQuads;
+
+            const ClippedRect r = Clip(q.bounds, screen);
+            if (r.Empty())
+                continue;
+            m_estimate.painterPixels += r.Area();
+
+            std::uint32_t c0 = 0, c1 = 0, r0 = 0, r1 = 0;
+            TouchedCells(r.left, r.right, screen.x, cell, cols, c0, c1);
+            TouchedCells(r.top, r.bottom, screen.y, cell, rows, r0, r1);
+            const auto paint = static_cast<std::uint32_t>(i + 1);
+            for (std::uint32_t y = r0; y < r1; ++y) {
+                const float cellTop = screen.y + static_cast<float>(y) * cell;
+                const float h = std::min(r.bottom, cellTop + cell) - std::max(r.top, cellTop);
+                const std::uint32_t* row = m_frontOccluder.data() + static_cast<std::size_t>(y) * cols;
+                for (std::uint32_t x = c0; x < c1; ++x) {
+                    if (row[x] > paint)
+                        continue; // an opaque quad in front already wrote this cell's depth
+                    const float cellLeft = screen.x + static_cast<float>(x) * cell;
+                    const float w = std::min(r.right, cellLeft + cell) - std::max(r.left, cellLeft);
+                    m_estimate.depthPixels += static_cast<double>(w) * static_cast<double>(h);
+                }
+            }
+        }
+
+        m_estimate.screenPixels = static_cast<double>(screen.w) * static_cast<double>(screen.h);
+        return m_estimate;
+    }
+
+} // namespace KibakoEngine
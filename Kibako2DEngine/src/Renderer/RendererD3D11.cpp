@@ -14,9 +14,12 @@
 #include "KibakoEngine/Core/Profiler.h"
 
 #include <windows.h>
+#include <d3d11_1.h>
 #include <dxgi.h>
 
+#include <algorithm>
 #include <iterator>
+#include <string>
 
 #ifdef _MSC_VER
 #    pragma comment(lib, "d3d11.lib")
@@ -45,7 +48,7 @@ namespace KibakoEngine {
         // Backbuffer is now our canonical resolution (1:1 rendering).
         UpdateViewport(width, height);
 
-        if (!m_batch.Init(m_device.Get(), m_context.Get())) {
+        if (!m_batch.Init(m_device.Get(), m_context.Get(), &m_shaderCache)) {
             KbkError(kLogChannel, "SpriteBatch2D initialization failed");
             return false;
         }
@@ -62,8 +65,11 @@ namespace KibakoEngine {
         KBK_PROFILE_SCOPE("RendererShutdown");
 
         m_batch.Shutdown();
+        m_views.clear();
         if (m_context)
             m_context->ClearState();
+        m_dsv.Reset();
+        m_depthBuffer.Reset();
         m_rtv.Reset();
         m_swapChain.Reset();
         m_context.Reset();
@@ -85,7 +91,7 @@ namespace KibakoEngine {
         };
 
         ID3D11RenderTargetView* rtv = m_rtv.Get();
-        m_context->OMSetRenderTargets(1, &rtv, nullptr);
+        m_context->OMSetRenderTargets(1, &rtv, m_dsv.Get());
 
         // Fullscreen viewport in backbuffer space (1:1 rendering).
         m_context->RSSetViewports(1, &m_viewport);
@@ -93,6 +99,87 @@ namespace KibakoEngine {
         m_context->ClearRenderTargetView(m_rtv.Get(), color);
     }
 
+    RenderView2D& RendererD3D11::AddView(std::string_view name)
+    {
+        if (RenderView2D* existing = FindView(name))
+            return *existing;
+
+        RenderView2D& view = m_views.emplace_back();
+        view.name = std::string(name);
+        view.SetViewport(RectF::FromXYWH(0.0f, 0.0f,
+            static_cast<float>(m_backBufferWidth),
+            static_cast<float>(m_backBufferHeight)));
+        return view;
+    }
+
+    void RendererD3D11::RemoveView(std::string_view name)
+    {
+        const auto it = std::find_if(m_views.begin(), m_views.end(),
+            [&](const RenderView2D& v) { return v.name == name; });
+        if (it != m_views.end())
+            m_views.erase(it);
+    }
+
+    RenderView2D* RendererD3D11::FindView(std::string_view name)
+    {
+        for (RenderView2D& view : m_views) {
+            if (view.name == name)
+                return &view;
+        }
+        return nullptr;
+    }
+
+    void RendererD3D11::BeginView(const RenderView2D& view)
+    {
+        KBK_PROFILE_SCOPE("RendererBeginView");
+
+        ID3D11RenderTargetView* rtv = view.target ? view.target->GetRTV() : m_rtv.Get();
+        if (!rtv) {
+            KbkWarn(kLogChannel, "View '%s' has no render target view", view.name.c_str());
+            return;
+        }
+
+        const float targetW = view.target ? static_cast<float>(view.target->Width()) : static_cast<float>(m_backBufferWidth);
+        const float targetH = view.target ? static_cast<float>(view.target->Height()) : static_cast<float>(m_backBufferHeight);
+
+        D3D11_VIEWPORT vp{};
+        const bool fullTarget = view.viewport.w <= 0.0f || view.viewport.h <= 0.0f;
+        vp.TopLeftX = fullTarget ? 0.0f : view.viewport.x;
+        vp.TopLeftY = fullTarget ? 0.0f : view.viewport.y;
+        vp.Width = fullTarget ? targetW : view.viewport.w;
+        vp.Height = fullTarget ? targetH : view.viewport.h;
+        vp.MinDepth = 0.0f;
+        vp.MaxDepth = 1.0f;
+
+        // Render textures have no depth buffer: SpriteBatch2D skips its opaque pass there
+        m_context->OMSetRenderTargets(1, &rtv, view.target ? nullptr : m_dsv.Get());
+        m_context->RSSetViewports(1, &vp);
+
+        if (view.clear) {
+            const float color[4] = { view.clearColor.r, view.clearColor.g, view.clearColor.b, view.clearColor.a };
+            if (view.target || fullTarget) {
+                m_context->ClearRenderTargetView(rtv, color);
+            }
+            else {
+                // Split-screen: only clear this view's rectangle
+                Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1;
+                if (SUCCEEDED(m_context.As(&context1)) && context1) {
+                    const D3D11_RECT rect{
+                        static_cast<LONG>(vp.TopLeftX), static_cast<LONG>(vp.TopLeftY),
+                        static_cast<LONG>(vp.TopLeftX + vp.Width), static_cast<LONG>(vp.TopLeftY + vp.Height) };
+                    context1->ClearView(rtv, color, &rect, 1);
+                }
+            }
+        }
+    }
+
+    void RendererD3D11::BindBackBuffer()
+    {
+        ID3D11RenderTargetView* rtv = m_rtv.Get();
+        m_context->OMSetRenderTargets(1, &rtv, m_dsv.Get());
+        m_context->RSSetViewports(1, &m_viewport);
+    }
+
     void RendererD3D11::EndFrame(bool waitForVSync)
     {
         KBK_PROFILE_SCOPE("RendererEndFrame");
@@ -118,6 +205,8 @@ namespace KibakoEngine {
             return;
 
         m_context->OMSetRenderTargets(0, nullptr, nullptr);
+        m_dsv.Reset();
+        m_depthBuffer.Reset();
         m_rtv.Reset();
 
         const HRESULT hr = m_swapChain->ResizeBuffers(
@@ -246,6 +335,28 @@ namespace KibakoEngine {
             return false;
         }
 
+        // Depth for SpriteBatch2D's opaque pass, cleared by the batch itself
+        D3D11_TEXTURE2D_DESC depthDesc{};
+        depthDesc.Width = width;
+        depthDesc.Height = height;
+        depthDesc.MipLevels = 1;
+        depthDesc.ArraySize = 1;
+        depthDesc.Format = DXGI_FORMAT_D32_FLOAT;
+        depthDesc.SampleDesc.Count = 1;
+        depthDesc.Usage = D3D11_USAGE_DEFAULT;
+        depthDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+        hr = m_device->CreateTexture2D(&depthDesc, nullptr, m_depthBuffer.GetAddressOf());
+        if (SUCCEEDED(hr))
+            hr = m_device->CreateDepthStencilView(m_depthBuffer.Get(), nullptr, m_dsv.GetAddressOf());
+        if (FAILED(hr)) {
+            // Not fatal: sprites fall back to blending everything in painter's order
+            KbkWarn(kLogChannel,
+                "Depth buffer creation failed: 0x%08X",
+                static_cast<unsigned>(hr));
+            m_depthBuffer.Reset();
+            m_dsv.Reset();
+        }
+
         m_backBufferWidth = width;
         m_backBufferHeight = height;
 
@@ -0,0 +1,209 @@
+// Shader bytecode lookup in memory and on disk, compiling only on a miss
+#include "KibakoEngine/Renderer/ShaderCache.h"
+
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "ShaderCache";
+
+        // File layout: magic, format version, key, bytecode size, bytecode
+        // checksum (all little-endian), then the bytecode
+        constexpr std::uint8_t  kMagic[4] = { 'K', 'B', 'K', 'S' };
+        constexpr std::uint32_t kVersion = 1;
+        constexpr std::size_t   kHeaderSize = 28;
+
+        constexpr std::uint64_t kFnvOffset = 14695981039346656037ull;
+        constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+
+        std::uint64_t HashBytes(std::uint64_t hash, const void* data, std::size_t size)
+        {
+            const auto* bytes = static_cast<const std::uint8_t*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= kFnvPrime;
+            }
+            return hash;
+        }
+
+        // Length first, so "ab" + "c" and "a" + "bc" hash apart
+        std::uint64_t HashField(std::uint64_t hash, std::string_view text)
+        {
+            const std::uint64_t length = text.size();
+            hash = HashBytes(hash, &length, sizeof(length));
+            return HashBytes(hash, text.data(), text.size());
+        }
+
+        void WriteU32(std::vector<std::uint8_t>& out, std::uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+
+        void WriteU64(std::vector<std::uint8_t>& out, std::uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+
+        std::uint64_t ReadLE(const std::vector<std::uint8_t>& bytes, std::size_t offset, int size)
+        {
+            std::uint64_t value = 0;
+            for (int i = 0; i < size; ++i)
+                value |= static_cast<std::uint64_t>(bytes[offset + static_cast<std::size_t>(i)]) << (i * 8);
+            return value;
+        }
+
+        double ElapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    ShaderCache::ShaderCache(std::filesystem::path directory)
+        : m_directory(std::move(directory))
+    {
+    }
+
+    std::uint64_t ShaderCache::MakeKey(const ShaderDesc& desc, std::string_view compilerVersion)
+    {
+        std::uint64_t hash = kFnvOffset;
+        hash = HashField(hash, compilerVersion);
+        hash = HashField(hash, desc.target);
+        hash = HashField(hash, desc.entryPoint);
+        hash = HashBytes(hash, &desc.flags, sizeof(desc.flags));
+        for (const ShaderDefine& define : desc.defines) {
+            hash = HashField(hash, define.name);
+            hash = HashField(hash, define.value);
+        }
+        return HashField(hash, desc.source);
+    }
+
+    std::filesystem::path ShaderCache::FilePath(std::uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.kbks", static_cast<unsigned long long>(key));
+        return m_directory / name;
+    }
+
+    const std::vector<std::uint8_t>* ShaderCache::Get(const ShaderDesc& desc, ShaderCompiler& compiler)
+    {
+        KBK_PROFILE_SCOPE("ShaderCacheGet");
+
+        const std::uint64_t key = MakeKey(desc, compiler.Version());
+        if (const auto it = m_entries.find(key); it != m_entries.end()) {
+            ++m_stats.memoryHits;
+            return &it->second;
+        }
+
+        std::vector<std::uint8_t> bytecode;
+        if (!m_directory.empty()) {
+            const auto start = std::chrono::steady_clock::now();
+            const bool loaded = LoadFile(key, bytecode);
+            m_stats.loadMs += ElapsedMs(start);
+            if (loaded) {
+                ++m_stats.diskHits;
+                return &m_entries.emplace(key, std::move(bytecode)).first->second;
+            }
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::string errors;
+        const bool compiled = compiler.Compile(desc, bytecode, errors);
+        m_stats.compileMs += ElapsedMs(start);
+        if (!compiled) {
+            ++m_stats.compileFailures;
+            KbkError(kLogChannel, "%.*s (%.*s) failed to compile: %s",
+                static_cast<int>(desc.debugName.size()), desc.debugName.data(),
+                static_cast<int>(desc.target.size()), desc.target.data(), errors.c_str());
+            return nullptr;
+        }
+        ++m_stats.compiles;
+
+        if (!m_directory.empty())
+            SaveFile(key, bytecode);
+        return &m_entries.emplace(key, std::move(bytecode)).first->second;
+    }
+
+    void ShaderCache::Preload(std::uint64_t key, std::span<const std::uint8_t> bytecode)
+    {
+        m_entries[key].assign(bytecode.begin(), bytecode.end());
+    }
+
+    bool ShaderCache::LoadFile(std::uint64_t key, std::vector<std::uint8_t>& bytecode)
+    {
+        const std::filesystem::path path = FilePath(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        const bool valid = bytes.size() >= kHeaderSize &&
+            std::equal(std::begin(kMagic), std::end(kMagic), bytes.begin()) &&
+            ReadLE(bytes, 4, 4) == kVersion &&
+            ReadLE(bytes, 8, 8) == key &&
+            ReadLE(bytes, 16, 4) == bytes.size() - kHeaderSize &&
+            ReadLE(bytes, 20, 8) == HashBytes(kFnvOffset, bytes.data() + kHeaderSize, bytes.size() - kHeaderSize);
+        if (!valid) {
+            ++m_stats.rejectedFiles;
+            KbkWarn(kLogChannel, "Discarding stale or corrupt %s", path.string().c_str());
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            return false;
+        }
+
+        bytecode.assign(bytes.begin() + static_cast<std::ptrdiff_t>(kHeaderSize), bytes.end());
+        return true;
+    }
+
+    void ShaderCache::SaveFile(std::uint64_t key, std::span<const std::uint8_t> bytecode)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+
+        std::vector<std::uint8_t> header;
+        header.reserve(kHeaderSize);
+        header.insert(header.end(), std::begin(kMagic), std::end(kMagic));
+        WriteU32(header, kVersion);
+        WriteU64(header, key);
+        WriteU32(header, static_cast<std::uint32_t>(bytecode.size()));
+        WriteU64(header, HashBytes(kFnvOffset, bytecode.data(), bytecode.size()));
+
+        // Written aside and renamed, so a crash never leaves a torn file under the real name
+        const std::filesystem::path path = FilePath(key);
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+            file.write(reinterpret_cast<const char*>(bytecode.data()), static_cast<std::streamsize>(bytecode.size()));
+            if (!file) {
+                ++m_stats.writeFailures;
+                KbkWarn(kLogChannel, "Cannot write %s", temporary.string().c_str());
+                file.close();
+                std::filesystem::remove(temporary, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporary, path, ec);
+        if (ec) {
+            ++m_stats.writeFailures;
+            KbkWarn(kLogChannel, "Cannot store %s: %s", path.string().c_str(), ec.message().c_str());
+            std::filesystem::remove(temporary, ec);
+        }
+    }
+
+} // namespace KibakoEngine
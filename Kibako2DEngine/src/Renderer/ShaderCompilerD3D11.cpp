@@ -0,0 +1,112 @@
+// D3DCompile behind the backend-agnostic ShaderCompiler interface
+#ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#endif
+
+#ifndef NOMINMAX
+#    define NOMINMAX
+#endif
+
+#include "KibakoEngine/Renderer/ShaderCompilerD3D11.h"
+
+#include <windows.h>
+#include <d3dcompiler.h>
+#include <wrl/client.h>
+
+#include <vector>
+
+#ifdef _MSC_VER
+#    pragma comment(lib, "d3dcompiler.lib")
+#    pragma comment(lib, "version.lib")
+#endif
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        // File version of the d3dcompiler DLL actually serving D3DCompile, e.g.
+        // "10.0.22621.755". The DLL is updated by Windows / the SDK redist while
+        // D3D_COMPILER_VERSION stays 47, so only this tells two builds apart.
+        // Empty if the version resource cannot be read.
+        std::string LoadedCompilerFileVersion()
+        {
+            HMODULE module = nullptr;
+            if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                    reinterpret_cast<LPCWSTR>(&D3DCompile), &module)) {
+                return {};
+            }
+
+            wchar_t path[MAX_PATH] = {};
+            if (GetModuleFileNameW(module, path, MAX_PATH) == 0)
+                return {};
+
+            DWORD ignored = 0;
+            const DWORD size = GetFileVersionInfoSizeW(path, &ignored);
+            if (size == 0)
+                return {};
+            std::vector<std::uint8_t> info(size);
+            if (!GetFileVersionInfoW(path, 0, size, info.data()))
+                return {};
+
+            VS_FIXEDFILEINFO* fixed = nullptr;
+            UINT fixedSize = 0;
+            if (!VerQueryValueW(info.data(), L"\\", reinterpret_cast<void**>(&fixed), &fixedSize) ||
+                !fixed || fixedSize < sizeof(VS_FIXEDFILEINFO)) {
+                return {};
+            }
+
+            return std::to_string(HIWORD(fixed->dwFileVersionMS)) + "." +
+                std::to_string(LOWORD(fixed->dwFileVersionMS)) + "." +
+                std::to_string(HIWORD(fixed->dwFileVersionLS)) + "." +
+                std::to_string(LOWORD(fixed->dwFileVersionLS));
+        }
+    }
+
+    ShaderCompilerD3D11::ShaderCompilerD3D11()
+        : m_version("d3dcompiler_" + std::to_string(D3D_COMPILER_VERSION))
+    {
+        const std::string fileVersion = LoadedCompilerFileVersion();
+        if (!fileVersion.empty())
+            m_version += "/" + fileVersion;
+    }
+
+    bool ShaderCompilerD3D11::Compile(const ShaderDesc& desc, std::vector<std::uint8_t>& bytecode, std::string& errors)
+    {
+        // D3DCompile wants null-terminated strings
+        const std::string entryPoint(desc.entryPoint);
+        const std::string target(desc.target);
+        const std::string debugName(desc.debugName);
+
+        std::vector<std::string> defineText;
+        defineText.reserve(desc.defines.size() * 2);
+        for (const ShaderDefine& define : desc.defines) {
+            defineText.emplace_back(define.name);
+            defineText.emplace_back(define.value);
+        }
+        std::vector<D3D_SHADER_MACRO> macros;
+        macros.reserve(desc.defines.size() + 1);
+        for (std::size_t i = 0; i < defineText.size(); i += 2)
+            macros.push_back({ defineText[i].c_str(), defineText[i + 1].c_str() });
+        macros.push_back({ nullptr, nullptr });
+
+        Microsoft::WRL::ComPtr<ID3DBlob> blob;
+        Microsoft::WRL::ComPtr<ID3DBlob> messages;
+        const HRESULT hr = D3DCompile(
+            desc.source.data(), desc.source.size(),
+            debugName.empty() ? nullptr : debugName.c_str(), macros.data(), nullptr,
+            entryPoint.c_str(), target.c_str(),
+            desc.flags, 0,
+            blob.GetAddressOf(), messages.GetAddressOf());
+        if (FAILED(hr)) {
+            errors = messages
+                ? std::string(static_cast<const char*>(messages->GetBufferPointer()), messages->GetBufferSize())
+                : "D3DCompile failed";
+            return false;
+        }
+
+        const auto* data = static_cast<const std::uint8_t*>(blob->GetBufferPointer());
+        bytecode.assign(data, data + blob->GetBufferSize());
+        return true;
+    }
+
+} // namespace KibakoEngine
@@ -4,12 +4,17 @@
 #include "KibakoEngine/Core/Debug.h"
 #include "KibakoEngine/Core/Log.h"
 #include "KibakoEngine/Core/Profiler.h"
+#include "KibakoEngine/Renderer/ShaderCompilerD3D11.h"
+#include "KibakoEngine/Renderer/SpriteLighting2D.h"
+#include "KibakoEngine/Renderer/SpriteShapes2D.h"
 
 #include <d3dcompiler.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <span>
 
 using namespace DirectX;
 
@@ -17,6 +22,33 @@ namespace KibakoEngine {
 
     namespace {
         constexpr const char* kLogChannel = "SpriteBatch";
+
+        // The draw depth rides in the fraction of position.z under the shading mode
+        constexpr float kDepthToVertexZ = 0.5f;
+        constexpr float kAlphaTestCutoff = 0.5f;
+
+        // Only straight or premultiplied alpha at full opacity is a plain
+        // overwrite; anything else stays blended. Sprites whose texture is
+        // entirely opaque are promoted (geometry passes no texture: its
+        // vertex colors are unknown here).
+        SpriteOpacity ResolveOpacity(SpriteOpacity requested, BlendMode blend, float alpha, const Texture2D* promoteTexture)
+        {
+            if ((blend != BlendMode::Alpha && blend != BlendMode::Premultiplied) || alpha < 1.0f)
+                return SpriteOpacity::Translucent;
+            if (requested == SpriteOpacity::Translucent && promoteTexture && promoteTexture->IsOpaque())
+                return SpriteOpacity::Opaque;
+            return requested;
+        }
+    }
+
+    SpriteBatch2D::SpriteBatch2D()
+    {
+        QueueStorage& world = m_queues[static_cast<size_t>(RenderQueue2D::World)];
+        world.spriteReserveHint = 256;
+        world.geometryReserveHint = 256;
+
+        // Rml geometry arrives in paint order; sorting it could only break it
+        m_queues[static_cast<size_t>(RenderQueue2D::UI)].policy = QueueSortPolicy::None;
     }
 
     const Texture2D* SpriteBatch2D::DefaultWhiteTexture() const
@@ -24,7 +56,7 @@ namespace KibakoEngine {
         return m_defaultWhite.IsValid() ? &m_defaultWhite : nullptr;
     }
 
-    bool SpriteBatch2D::Init(ID3D11Device* device, ID3D11DeviceContext* context)
+    bool SpriteBatch2D::Init(ID3D11Device* device, ID3D11DeviceContext* context, ShaderCache* shaderCache)
     {
         KBK_PROFILE_SCOPE("SpriteBatchInit");
 
@@ -33,7 +65,7 @@ namespace KibakoEngine {
         m_device = device;
         m_context = context;
 
-        if (!CreateShaders(device)) {
+        if (!CreateShaders(device, shaderCache)) {
             KbkError(kLogChannel, "Failed to create shaders");
             return false;
         }
@@ -63,12 +95,19 @@ namespace KibakoEngine {
         m_vertexBuffer.Reset();
         m_indexBuffer.Reset();
         m_cbVS.Reset();
+        m_cbPS.Reset();
         m_vs.Reset();
         m_ps.Reset();
+        m_psDistanceField.Reset();
         m_inputLayout.Reset();
         m_samplerPoint.Reset();
-        m_blendAlpha.Reset();
+        m_samplerLinear.Reset();
+        for (auto& state : m_blendStates)
+            state.Reset();
+        m_blendOpaque.Reset();
         m_depthDisabled.Reset();
+        m_depthWrite.Reset();
+        m_depthTest.Reset();
         m_rasterCullNone.Reset();
         m_rasterCullNoneScissor.Reset();
 
@@ -80,9 +119,14 @@ namespace KibakoEngine {
 
     void SpriteBatch2D::ClearFrameData()
     {
-        m_commands.clear();
-        m_geometryCommands.clear();
-        m_unifiedCommands.clear();
+        for (QueueStorage& queue : m_queues) {
+            queue.commands.clear();
+            queue.geometryCommands.clear();
+            queue.nextOrder = 0;
+        }
+        m_arenaVertices.clear();
+        m_arenaIndices.clear();
+        m_sortItems.clear();
         m_drawRanges.clear();
     }
 
@@ -95,12 +139,19 @@ namespace KibakoEngine {
         KBK_ASSERT(!m_isDrawing, "SpriteBatch2D::Begin without End");
         m_isDrawing = true;
         m_viewProjT = viewProjT;
+        m_lighting = nullptr;
 
-        m_commands.clear();
-        m_geometryCommands.clear();
+        m_activeQueue = RenderQueue2D::World;
 
-        m_commands.reserve(m_spriteReserveHint);
-        m_geometryCommands.reserve(m_geometryReserveHint);
+        for (QueueStorage& queue : m_queues) {
+            queue.commands.clear();
+            queue.geometryCommands.clear();
+            queue.nextOrder = 0;
+            queue.commands.reserve(queue.spriteReserveHint);
+            queue.geometryCommands.reserve(queue.geometryReserveHint);
+        }
+        m_arenaVertices.clear();
+        m_arenaIndices.clear();
     }
 
     void SpriteBatch2D::End()
@@ -110,65 +161,42 @@ namespace KibakoEngine {
         KBK_ASSERT(m_isDrawing, "SpriteBatch2D::End without Begin");
         m_isDrawing = false;
 
-        // Merge sprite and geometry commands into a unified list
-        using Unified = UnifiedCommand;
-        m_unifiedCommands.clear();
-        m_unifiedCommands.reserve(m_commands.size() + m_geometryCommands.size());
-
-        size_t totalVertices = 0;
-        size_t totalIndices = 0;
-
-        for (size_t i = 0; i < m_commands.size(); ++i) {
-            const auto& c = m_commands[i];
-            if (c.texture == nullptr || c.texture->GetSRV() == nullptr)
-                continue;
-            m_unifiedCommands.push_back({ c.texture, c.texture->GetSRV(), c.layer, true, i });
-            totalVertices += 4;
-            totalIndices += 6;
-        }
+        const SpriteLighting2D* lighting = (m_lighting && m_lighting->IsReady()) ? m_lighting : nullptr;
+        m_lighting = nullptr;
 
-        for (size_t i = 0; i < m_geometryCommands.size(); ++i) {
-            const auto& g = m_geometryCommands[i];
-            if (g.vertices == nullptr || g.indices == nullptr ||
-                g.vertexCount == 0 || g.indexCount == 0 ||
-                g.texture == nullptr || g.texture->GetSRV() == nullptr) {
-                continue;
-            }
-            m_unifiedCommands.push_back({ g.texture, g.texture->GetSRV(), g.layer, false, i });
-            totalVertices += g.vertexCount;
-            totalIndices += g.indexCount;
-        }
+        const bool estimateOverdraw = m_overdrawRequested;
+        m_overdrawRequested = false;
 
-        if (m_unifiedCommands.empty())
-            return;
+        // The opaque pass needs a depth buffer on the bound target (render-to-texture views have none)
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthTarget;
+        if (m_opaquePass)
+            m_context->OMGetRenderTargets(0, nullptr, depthTarget.GetAddressOf());
 
-        const auto cmdLess = [this](const Unified& a, const Unified& b) {
-            if (a.layer != b.layer)
-                return a.layer < b.layer;
+        // One sort item per drawable command; layer, blend mode and kind are in the key.
+        // Each queue is ordered on its own, then the queues follow each other.
+        size_t itemCapacity = 0;
+        for (const QueueStorage& queue : m_queues)
+            itemCapacity += queue.commands.size() + queue.geometryCommands.size();
+        m_sortItems.clear();
+        m_sortItems.reserve(itemCapacity);
 
-            if (a.isSprite != b.isSprite)
-                return a.isSprite;
+        size_t totalVertices = 0;
+        size_t totalIndices = 0;
 
-            if (!a.isSprite) {
-                const auto& ga = m_geometryCommands[a.index];
-                const auto& gb = m_geometryCommands[b.index];
-                if (ga.hasClipRect != gb.hasClipRect)
-                    return !ga.hasClipRect;
+        for (size_t q = 0; q < kRenderQueueCount; ++q) {
+            const size_t first = m_sortItems.size();
+            CollectQueueItems(static_cast<std::uint8_t>(q), totalVertices, totalIndices);
 
-                if (ga.hasClipRect) {
-                    if (ga.clipRect.x != gb.clipRect.x) return ga.clipRect.x < gb.clipRect.x;
-                    if (ga.clipRect.y != gb.clipRect.y) return ga.clipRect.y < gb.clipRect.y;
-                    if (ga.clipRect.w != gb.clipRect.w) return ga.clipRect.w < gb.clipRect.w;
-                    if (ga.clipRect.h != gb.clipRect.h) return ga.clipRect.h < gb.clipRect.h;
-                }
-            }
+            const std::span<BatchSortItem> items(m_sortItems.data() + first, m_sortItems.size() - first);
+            if (SortBatchItems(items, m_queues[q].policy))
+                ++m_stats.queueSorts;
+        }
 
-            return a.index < b.index;
-            };
+        if (estimateOverdraw)
+            EstimateOverdraw();
 
-        if (!std::is_sorted(m_unifiedCommands.begin(), m_unifiedCommands.end(), cmdLess)) {
-            std::stable_sort(m_unifiedCommands.begin(), m_unifiedCommands.end(), cmdLess);
-        }
+        if (m_sortItems.empty())
+            return;
 
         if (totalVertices == 0 || totalIndices == 0)
             return;
@@ -176,6 +204,29 @@ namespace KibakoEngine {
         if (!EnsureVertexCapacity(totalVertices) || !EnsureIndexCapacity(totalIndices))
             return;
 
+        // Opaque items move to the front, reversed; without the pass they blend like the rest
+        bool depthPass = false;
+        if (depthTarget) {
+            const std::uint32_t opaqueCount = BuildDepthPassOrder(m_sortItems, m_passItems);
+            if (opaqueCount > 0) {
+                m_sortItems.swap(m_passItems);
+                m_stats.opaqueItems = opaqueCount;
+                depthPass = true;
+                m_context->ClearDepthStencilView(depthTarget.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+            }
+        }
+        if (!depthPass) {
+            for (BatchSortItem& item : m_sortItems)
+                item.opacity = SpriteOpacity::Translucent;
+        }
+
+        // Ranges only depend on the sorted items: the buffers below are filled in the same order
+        const BatchStateChanges changes = BuildBatchDrawRanges(m_sortItems, m_drawRanges);
+        m_stats.blendChanges += changes.blend;
+        m_stats.textureChanges += changes.texture;
+        m_stats.scissorChanges += changes.scissor;
+        m_stats.shaderChanges += changes.shader;
+
         UpdateVSConstants();
 
         D3D11_MAPPED_SUBRESOURCE mappedVB{};
@@ -196,20 +247,15 @@ namespace KibakoEngine {
         Vertex* vertexOut = static_cast<Vertex*>(mappedVB.pData);
         std::uint32_t* indexOut = static_cast<std::uint32_t*>(mappedIB.pData);
 
-        // Build the final GPU buffers and draw ranges
-        m_drawRanges.clear();
-        m_drawRanges.reserve(m_unifiedCommands.size());
-
+        // Build the final GPU buffers
         size_t currentVertexBase = 0;
         size_t currentIndexBase = 0;
-        bool   haveRange = false;
-        DrawRange currentRange{};
 
-        for (const Unified& u : m_unifiedCommands) {
-            const std::uint32_t cmdFirstIndex = static_cast<std::uint32_t>(currentIndexBase);
-
-            if (u.isSprite) {
-                const DrawCommand& cmd = m_commands[u.index];
+        for (const BatchSortItem& item : m_sortItems) {
+            const QueueStorage& queue = m_queues[item.queue];
+            const float z = depthPass ? item.drawDepth * kDepthToVertexZ : 0.0f;
+            if (!BatchKeyIsGeometry(item.key)) {
+                const DrawCommand& cmd = queue.commands[item.command];
 
                 const float left = cmd.dst.x;
                 const float top = cmd.dst.y;
@@ -245,10 +291,10 @@ namespace KibakoEngine {
 
                 Vertex* v = vertexOut + currentVertexBase;
 
-                v[0] = Vertex{ { corners[0].x, corners[0].y, 0.0f }, { u0, v0 }, color };
-                v[1] = Vertex{ { corners[1].x, corners[1].y, 0.0f }, { u1, v0 }, color };
-                v[2] = Vertex{ { corners[2].x, corners[2].y, 0.0f }, { u1, v1 }, color };
-                v[3] = Vertex{ { corners[3].x, corners[3].y, 0.0f }, { u0, v1 }, color };
+                v[0] = Vertex{ { corners[0].x, corners[0].y, z }, { u0, v0 }, color };
+                v[1] = Vertex{ { corners[1].x, corners[1].y, z }, { u1, v0 }, color };
+                v[2] = Vertex{ { corners[2].x, corners[2].y, z }, { u1, v1 }, color };
+                v[3] = Vertex{ { corners[3].x, corners[3].y, z }, { u0, v1 }, color };
 
                 std::uint32_t* idx = indexOut + currentIndexBase;
                 const std::uint32_t base = static_cast<std::uint32_t>(currentVertexBase);
@@ -264,14 +310,15 @@ namespace KibakoEngine {
                 currentIndexBase += 6;
             }
             else {
-                const GeometryCommand& geo = m_geometryCommands[u.index];
+                const GeometryCommand& geo = queue.geometryCommands[item.command];
                 Vertex* outVertices = vertexOut + currentVertexBase;
 
-                if (geo.hasTranslation) {
+                if (geo.hasTranslation || depthPass) {
                     for (size_t i = 0; i < geo.vertexCount; ++i) {
                         outVertices[i] = geo.vertices[i];
                         outVertices[i].position.x += geo.translation.x;
                         outVertices[i].position.y += geo.translation.y;
+                        outVertices[i].position.z += z;
                     }
                 }
                 else {
@@ -292,57 +339,8 @@ namespace KibakoEngine {
                 currentVertexBase += geo.vertexCount;
                 currentIndexBase += geo.indexCount;
             }
-
-            const std::uint32_t cmdIndexCount =
-                static_cast<std::uint32_t>(currentIndexBase - cmdFirstIndex);
-
-            bool cmdUseScissor = false;
-            D3D11_RECT cmdScissor{ 0, 0, 0, 0 };
-            if (!u.isSprite) {
-                const GeometryCommand& geo = m_geometryCommands[u.index];
-                if (geo.hasClipRect) {
-                    cmdUseScissor = true;
-                    cmdScissor.left = static_cast<LONG>(geo.clipRect.x);
-                    cmdScissor.top = static_cast<LONG>(geo.clipRect.y);
-                    cmdScissor.right = static_cast<LONG>(geo.clipRect.x + geo.clipRect.w);
-                    cmdScissor.bottom = static_cast<LONG>(geo.clipRect.y + geo.clipRect.h);
-                }
-            }
-
-            // Merge contiguous commands that share layer, texture and scissor state
-            if (!haveRange) {
-                haveRange = true;
-                currentRange.srv = u.srv;
-                currentRange.layer = u.layer;
-                currentRange.firstIndex = cmdFirstIndex;
-                currentRange.indexCount = cmdIndexCount;
-                currentRange.useScissor = cmdUseScissor;
-                currentRange.scissorRect = cmdScissor;
-            }
-            else if (u.srv == currentRange.srv &&
-                u.layer == currentRange.layer &&
-                cmdUseScissor == currentRange.useScissor &&
-                (!cmdUseScissor || (
-                    cmdScissor.left == currentRange.scissorRect.left &&
-                    cmdScissor.top == currentRange.scissorRect.top &&
-                    cmdScissor.right == currentRange.scissorRect.right &&
-                    cmdScissor.bottom == currentRange.scissorRect.bottom))) {
-                currentRange.indexCount += cmdIndexCount;
-            }
-            else {
-                m_drawRanges.push_back(currentRange);
-                currentRange.srv = u.srv;
-                currentRange.layer = u.layer;
-                currentRange.firstIndex = cmdFirstIndex;
-                currentRange.indexCount = cmdIndexCount;
-                currentRange.useScissor = cmdUseScissor;
-                currentRange.scissorRect = cmdScissor;
-            }
         }
 
-        if (haveRange)
-            m_drawRanges.push_back(currentRange);
-
         m_context->Unmap(m_vertexBuffer.Get(), 0);
         m_context->Unmap(m_indexBuffer.Get(), 0);
 
@@ -358,28 +356,72 @@ namespace KibakoEngine {
 
         ID3D11Buffer* cbs[] = { m_cbVS.Get() };
         m_context->VSSetConstantBuffers(0, 1, cbs);
+        ID3D11Buffer* psCbs[] = { m_cbPS.Get() };
+        m_context->PSSetConstantBuffers(0, 1, psCbs);
 
         m_context->VSSetShader(m_vs.Get(), nullptr, 0);
-        m_context->PSSetShader(m_ps.Get(), nullptr, 0);
 
-        const float blendFactor[4] = { 0.f, 0.f, 0.f, 0.f };
-        m_context->OMSetBlendState(m_blendAlpha.Get(), blendFactor, 0xFFFFFFFFu);
-        m_context->OMSetDepthStencilState(m_depthDisabled.Get(), 0);
         m_context->RSSetState(m_rasterCullNone.Get());
 
-        ID3D11SamplerState* sampler = m_samplerPoint.Get();
-        m_context->PSSetSamplers(0, 1, &sampler);
+        ID3D11SamplerState* samplers[] = { m_samplerPoint.Get(), m_samplerLinear.Get() };
+        m_context->PSSetSamplers(0, 2, samplers);
+
+        if (lighting) {
+            ID3D11ShaderResourceView* lightSrvs[] = {
+                lighting->LightsSRV(), lighting->TileRangesSRV(), lighting->TileLightsSRV()
+            };
+            m_context->PSSetShaderResources(1, 3, lightSrvs);
+        }
 
+        const float blendFactor[4] = { 0.f, 0.f, 0.f, 0.f };
+        ID3D11BlendState* boundBlend = nullptr;
+        ID3D11DepthStencilState* boundDepth = nullptr;
+        float boundPremultiply = -1.0f;
+        int boundLit = -1;
+        float boundCutoff = -1.0f;
         bool currentRasterScissor = false;
         ID3D11ShaderResourceView* boundSrv = nullptr;
+        ID3D11PixelShader* boundPs = nullptr;
+
+        for (const BatchDrawRange& range : m_drawRanges) {
+            ID3D11PixelShader* ps = range.distanceField ? m_psDistanceField.Get() : m_ps.Get();
+            if (ps != boundPs) {
+                m_context->PSSetShader(ps, nullptr, 0);
+                boundPs = ps;
+            }
+
+            const bool opaque = range.opacity != SpriteOpacity::Translucent;
+
+            ID3D11BlendState* blendState = opaque ? m_blendOpaque.Get() : m_blendStates[static_cast<size_t>(range.blend)].Get();
+            if (blendState != boundBlend) {
+                m_context->OMSetBlendState(blendState, blendFactor, 0xFFFFFFFFu);
+                boundBlend = blendState;
+            }
+
+            ID3D11DepthStencilState* depthState = !depthPass ? m_depthDisabled.Get()
+                : (opaque ? m_depthWrite.Get() : m_depthTest.Get());
+            if (depthState != boundDepth) {
+                m_context->OMSetDepthStencilState(depthState, 0);
+                boundDepth = depthState;
+            }
+
+            const float premultiply = (range.blend == BlendMode::Multiply) ? 1.0f : 0.0f;
+            const int lit = (lighting && range.layer <= m_maxLitLayer) ? 1 : 0;
+            const float cutoff = (range.opacity == SpriteOpacity::AlphaTested) ? kAlphaTestCutoff : 0.0f;
+            if (premultiply != boundPremultiply || lit != boundLit || cutoff != boundCutoff) {
+                UpdatePSConstants(premultiply, lit ? lighting : nullptr, cutoff);
+                boundPremultiply = premultiply;
+                boundLit = lit;
+                boundCutoff = cutoff;
+            }
 
-        for (const DrawRange& range : m_drawRanges) {
             if (range.useScissor) {
                 if (!currentRasterScissor) {
                     m_context->RSSetState(m_rasterCullNoneScissor.Get());
                     currentRasterScissor = true;
                 }
-                m_context->RSSetScissorRects(1, &range.scissorRect);
+                const D3D11_RECT rect{ range.scissor.left, range.scissor.top, range.scissor.right, range.scissor.bottom };
+                m_context->RSSetScissorRects(1, &rect);
             }
             else {
                 if (currentRasterScissor) {
@@ -399,11 +441,186 @@ namespace KibakoEngine {
             m_stats.drawCalls++;
         }
 
-        ID3D11ShaderResourceView* nullSrv = nullptr;
-        m_context->PSSetShaderResources(0, 1, &nullSrv);
+        ID3D11ShaderResourceView* nullSrvs[4] = {};
+        m_context->PSSetShaderResources(0, lighting ? 4 : 1, nullSrvs);
+
+        for (QueueStorage& queue : m_queues) {
+            queue.spriteReserveHint = std::max(queue.spriteReserveHint, queue.commands.size());
+            queue.geometryReserveHint = std::max(queue.geometryReserveHint, queue.geometryCommands.size());
+        }
+    }
+
+    void SpriteBatch2D::CollectQueueItems(std::uint8_t queueIndex, size_t& totalVertices, size_t& totalIndices)
+    {
+        QueueStorage& queue = m_queues[queueIndex];
+        const bool needsDepth = queue.policy == QueueSortPolicy::YSort;
+
+        // Sprites and geometry are stored apart; merging them by submission
+        // order gives the None policy its order without sorting
+        size_t s = 0;
+        size_t g = 0;
+        while (s < queue.commands.size() || g < queue.geometryCommands.size()) {
+            const bool takeSprite = g == queue.geometryCommands.size() ||
+                (s < queue.commands.size() && queue.commands[s].order < queue.geometryCommands[g].order);
+
+            if (takeSprite) {
+                const DrawCommand& c = queue.commands[s];
+                const size_t commandIndex = s++;
+                if (c.texture == nullptr || c.texture->GetSRV() == nullptr)
+                    continue;
+
+                BatchSortItem item;
+                item.key = MakeBatchSortKey(c.layer, c.blend, false);
+                item.srv = c.texture->GetSRV();
+                item.command = static_cast<std::uint32_t>(commandIndex);
+                item.queue = queueIndex;
+                item.order = c.order;
+                item.opacity = ResolveOpacity(c.opacity, c.blend, c.color.a, c.texture);
+                item.indexCount = 6;
+                if (needsDepth)
+                    item.depth = c.dst.y + c.dst.h;
+                m_sortItems.push_back(item);
+                totalVertices += 4;
+                totalIndices += 6;
+                continue;
+            }
+
+            GeometryCommand& geo = queue.geometryCommands[g];
+            const size_t commandIndex = g++;
+            if (geo.inArena) {
+                geo.vertices = m_arenaVertices.data() + geo.arenaVertexOffset;
+                geo.indices = m_arenaIndices.data() + geo.arenaIndexOffset;
+            }
+            if (geo.vertices == nullptr || geo.indices == nullptr ||
+                geo.vertexCount == 0 || geo.indexCount == 0 ||
+                geo.texture == nullptr || geo.texture->GetSRV() == nullptr) {
+                continue;
+            }
+
+            BatchSortItem item;
+            item.key = MakeBatchSortKey(geo.layer, geo.blend, true);
+            item.srv = geo.texture->GetSRV();
+            item.command = static_cast<std::uint32_t>(commandIndex);
+            item.queue = queueIndex;
+            item.order = geo.order;
+            item.opacity = ResolveOpacity(geo.opacity, geo.blend, 1.0f, nullptr);
+            item.distanceField = geo.vertices[0].position.z >= kShadeDistanceField;
+            item.indexCount = static_cast<std::uint32_t>(geo.indexCount);
+            if (geo.hasClipRect) {
+                item.hasScissor = true;
+                item.scissor.left = static_cast<std::int32_t>(geo.clipRect.x);
+                item.scissor.top = static_cast<std::int32_t>(geo.clipRect.y);
+                item.scissor.right = static_cast<std::int32_t>(geo.clipRect.x + geo.clipRect.w);
+                item.scissor.bottom = static_cast<std::int32_t>(geo.clipRect.y + geo.clipRect.h);
+            }
+            if (needsDepth) {
+                // Lowest vertex, the geometry's equivalent of a sprite's bottom edge
+                float bottom = geo.vertices[0].position.y;
+                for (size_t i = 1; i < geo.vertexCount; ++i)
+                    bottom = std::max(bottom, geo.vertices[i].position.y);
+                item.depth = bottom + (geo.hasTranslation ? geo.translation.y : 0.0f);
+            }
+            m_sortItems.push_back(item);
+            totalVertices += geo.vertexCount;
+            totalIndices += geo.indexCount;
+        }
+    }
+
+    void SpriteBatch2D::EstimateOverdraw()
+    {
+        // Viewport pixels through the row-vector transform the vertex shader applies
+        // (m_viewProjT is transposed); w stays 1 for the orthographic camera
+        UINT viewportCount = 1;
+        D3D11_VIEWPORT viewport{};
+        m_context->RSGetViewports(&viewportCount, &viewport);
+        const RectF screen = RectF::FromXYWH(viewport.TopLeftX, viewport.TopLeftY, viewport.Width, viewport.Height);
+
+        const XMFLOAT4X4& m = m_viewProjT;
+        const auto toScreen = [&](float x, float y) {
+            const float ndcX = x * m.m[0][0] + y * m.m[0][1] + m.m[0][3];
+            const float ndcY = x * m.m[1][0] + y * m.m[1][1] + m.m[1][3];
+            return XMFLOAT2{ screen.x + (ndcX * 0.5f + 0.5f) * screen.w, screen.y + (0.5f - ndcY * 0.5f) * screen.h };
+        };
+
+        m_overdrawQuads.clear();
+        m_overdrawQuads.reserve(m_sortItems.size());
+        for (const BatchSortItem& item : m_sortItems) {
+            const QueueStorage& queue = m_queues[item.queue];
+
+            float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+            const auto extend = [&](const XMFLOAT2& p, bool first) {
+                minX = first ? p.x : std::min(minX, p.x);
+                minY = first ? p.y : std::min(minY, p.y);
+                maxX = first ? p.x : std::max(maxX, p.x);
+                maxY = first ? p.y : std::max(maxY, p.y);
+            };
 
-        m_spriteReserveHint = std::max(m_spriteReserveHint, m_commands.size());
-        m_geometryReserveHint = std::max(m_geometryReserveHint, m_geometryCommands.size());
+            bool axisAligned = false;
+            if (!BatchKeyIsGeometry(item.key)) {
+                const DrawCommand& cmd = queue.commands[item.command];
+                const float cx = cmd.dst.x + cmd.dst.w * 0.5f;
+                const float cy = cmd.dst.y + cmd.dst.h * 0.5f;
+                const float cs = std::cos(cmd.rotation);
+                const float sn = std::sin(cmd.rotation);
+                const float hx[4] = { -0.5f, 0.5f, 0.5f, -0.5f };
+                const float hy[4] = { -0.5f, -0.5f, 0.5f, 0.5f };
+                for (int c = 0; c < 4; ++c) {
+                    const float dx = hx[c] * cmd.dst.w;
+                    const float dy = hy[c] * cmd.dst.h;
+                    extend(toScreen(cx + dx * cs - dy * sn, cy + dx * sn + dy * cs), c == 0);
+                }
+                axisAligned = std::fabs(cmd.rotation) <= 0.0001f;
+            }
+            else {
+                const GeometryCommand& geo = queue.geometryCommands[item.command];
+                for (size_t i = 0; i < geo.vertexCount; ++i)
+                    extend(toScreen(geo.vertices[i].position.x + geo.translation.x,
+                        geo.vertices[i].position.y + geo.translation.y), i == 0);
+            }
+
+            OverdrawQuad2D quad;
+            quad.bounds = RectF::FromXYWH(minX, minY, maxX - minX, maxY - minY);
+            quad.opacity = item.opacity;
+            quad.occluder = axisAligned && item.opacity == SpriteOpacity::Opaque;
+            m_overdrawQuads.push_back(quad);
+        }
+
+        m_overdraw.Estimate(m_overdrawQuads, screen);
+    }
+
+    RenderQueue2D SpriteBatch2D::SetQueue(RenderQueue2D queue)
+    {
+        KBK_ASSERT(static_cast<size_t>(queue) < kRenderQueueCount, "SpriteBatch2D::SetQueue: unknown queue");
+        const RenderQueue2D previous = m_activeQueue;
+        if (static_cast<size_t>(queue) < kRenderQueueCount)
+            m_activeQueue = queue;
+        return previous;
+    }
+
+    void SpriteBatch2D::SetQueueSortPolicy(RenderQueue2D queue, QueueSortPolicy policy)
+    {
+        KBK_ASSERT(static_cast<size_t>(queue) < kRenderQueueCount, "SpriteBatch2D::SetQueueSortPolicy: unknown queue");
+        if (static_cast<size_t>(queue) < kRenderQueueCount)
+            m_queues[static_cast<size_t>(queue)].policy = policy;
+    }
+
+    QueueSortPolicy SpriteBatch2D::GetQueueSortPolicy(RenderQueue2D queue) const
+    {
+        if (static_cast<size_t>(queue) >= kRenderQueueCount)
+            return QueueSortPolicy::Layer;
+        return m_queues[static_cast<size_t>(queue)].policy;
+    }
+
+    void SpriteBatch2D::ReserveQueue(RenderQueue2D queue, size_t spriteCount, size_t geometryCount)
+    {
+        if (static_cast<size_t>(queue) >= kRenderQueueCount)
+            return;
+
+        QueueStorage& storage = m_queues[static_cast<size_t>(queue)];
+        storage.spriteReserveHint = std::max(storage.spriteReserveHint, spriteCount);
+        storage.geometryReserveHint = std::max(storage.geometryReserveHint, geometryCount);
+        storage.commands.reserve(storage.spriteReserveHint);
+        storage.geometryCommands.reserve(storage.geometryReserveHint);
     }
 
     void SpriteBatch2D::Push(const Texture2D& texture,
@@ -411,7 +628,9 @@ namespace KibakoEngine {
         const RectF& src,
         const Color4& color,
         float rotation,
-        int layer)
+        int layer,
+        BlendMode blend,
+        SpriteOpacity opacity)
     {
 #if KBK_DEBUG_BUILD
         KBK_ASSERT(m_isDrawing, "SpriteBatch2D::Push called outside Begin/End");
@@ -419,7 +638,8 @@ namespace KibakoEngine {
         if (!m_isDrawing)
             return;
 
-        m_commands.push_back({ &texture, dst, src, color, rotation, layer });
+        QueueStorage& queue = ActiveStorage();
+        queue.commands.push_back({ &texture, dst, src, color, rotation, layer, blend, opacity, queue.nextOrder++ });
         m_stats.spritesSubmitted++;
     }
 
@@ -427,7 +647,8 @@ namespace KibakoEngine {
         const Vertex* vertices, size_t vertexCount,
         const std::uint32_t* indices, size_t indexCount,
         int layer,
-        const RectF& clipRect)
+        const RectF& clipRect,
+        BlendMode blend)
     {
 #if KBK_DEBUG_BUILD
         KBK_ASSERT(m_isDrawing, "SpriteBatch2D::PushGeometryRaw called outside Begin/End");
@@ -441,15 +662,76 @@ namespace KibakoEngine {
         GeometryCommand cmd;
         cmd.texture = texture ? texture : DefaultWhiteTexture();
         cmd.layer = layer;
+        cmd.blend = blend;
         cmd.hasClipRect = clipRect.w > 0.0f && clipRect.h > 0.0f;
         cmd.clipRect = clipRect;
-        cmd.ownedVertices.assign(vertices, vertices + vertexCount);
-        cmd.ownedIndices.assign(indices, indices + indexCount);
-        cmd.vertices = cmd.ownedVertices.data();
-        cmd.indices = cmd.ownedIndices.data();
-        cmd.vertexCount = cmd.ownedVertices.size();
-        cmd.indexCount = cmd.ownedIndices.size();
-        m_geometryCommands.push_back(std::move(cmd));
+        cmd.inArena = true;
+        cmd.arenaVertexOffset = m_arenaVertices.size();
+        cmd.arenaIndexOffset = m_arenaIndices.size();
+        cmd.vertexCount = vertexCount;
+        cmd.indexCount = indexCount;
+        m_arenaVertices.insert(m_arenaVertices.end(), vertices, vertices + vertexCount);
+        m_arenaIndices.insert(m_arenaIndices.end(), indices, indices + indexCount);
+        QueueStorage& queue = ActiveStorage();
+        cmd.order = queue.nextOrder++;
+        queue.geometryCommands.push_back(std::move(cmd));
+    }
+
+    SpriteBatch2D::GeometryWriter SpriteBatch2D::AllocateGeometry(const Texture2D* texture,
+        size_t vertexCount, size_t indexCount, int layer, BlendMode blend, SpriteOpacity opacity)
+    {
+#if KBK_DEBUG_BUILD
+        KBK_ASSERT(m_isDrawing, "SpriteBatch2D::AllocateGeometry called outside Begin/End");
+#endif
+        if (!m_isDrawing || vertexCount == 0 || indexCount == 0)
+            return {};
+
+        GeometryCommand cmd;
+        cmd.texture = texture ? texture : DefaultWhiteTexture();
+        cmd.layer = layer;
+        cmd.blend = blend;
+        cmd.opacity = opacity;
+        cmd.inArena = true;
+        cmd.arenaVertexOffset = m_arenaVertices.size();
+        cmd.arenaIndexOffset = m_arenaIndices.size();
+        cmd.vertexCount = vertexCount;
+        cmd.indexCount = indexCount;
+        QueueStorage& queue = ActiveStorage();
+        cmd.order = queue.nextOrder++;
+        queue.geometryCommands.push_back(std::move(cmd));
+
+        // Contents are unspecified for the caller, which overwrites every element
+        m_arenaVertices.resize(m_arenaVertices.size() + vertexCount);
+        m_arenaIndices.resize(m_arenaIndices.size() + indexCount);
+
+        GeometryWriter writer;
+        writer.vertices = m_arenaVertices.data() + (m_arenaVertices.size() - vertexCount);
+        writer.indices = m_arenaIndices.data() + (m_arenaIndices.size() - indexCount);
+        return writer;
+    }
+
+    void SpriteBatch2D::PushSpriteShape(const Texture2D* texture, const SpriteShapeDesc& shape,
+        int layer, BlendMode blend, SpriteOpacity opacity)
+    {
+        if (shape.mode == SpriteDrawMode::Simple) {
+            if (const Texture2D* tex = texture ? texture : DefaultWhiteTexture())
+                Push(*tex, shape.dst, shape.src, shape.color, shape.rotation, layer, blend, opacity);
+            return;
+        }
+
+        const Texture2D* tex = texture ? texture : DefaultWhiteTexture();
+        const float width = tex ? static_cast<float>(tex->Width()) : 1.0f;
+        const float height = tex ? static_cast<float>(tex->Height()) : 1.0f;
+
+        const SpriteShapeCounts counts = CountSpriteShape(shape, width, height);
+        // The shape's vertices all carry shape.color, so an opaque texture promotes it like a sprite
+        const SpriteOpacity shapeOpacity = (opacity == SpriteOpacity::Translucent && tex && tex->IsOpaque() && shape.color.a >= 1.0f)
+            ? SpriteOpacity::Opaque : opacity;
+        const GeometryWriter out = AllocateGeometry(tex, counts.vertices, counts.indices, layer, blend, shapeOpacity);
+        if (out.vertices == nullptr)
+            return;
+
+        BuildSpriteShape(shape, width, height, out.vertices, out.indices);
     }
 
     void SpriteBatch2D::PushGeometryView(const Texture2D* texture,
@@ -459,7 +741,8 @@ namespace KibakoEngine {
         size_t indexCount,
         int layer,
         const RectF& clipRect,
-        XMFLOAT2 translation)
+        XMFLOAT2 translation,
+        BlendMode blend)
     {
 #if KBK_DEBUG_BUILD
         KBK_ASSERT(m_isDrawing, "SpriteBatch2D::PushGeometryView called outside Begin/End");
@@ -477,18 +760,21 @@ namespace KibakoEngine {
         cmd.vertexCount = vertexCount;
         cmd.indexCount = indexCount;
         cmd.layer = layer;
+        cmd.blend = blend;
         cmd.hasClipRect = clipRect.w > 0.0f && clipRect.h > 0.0f;
         cmd.clipRect = clipRect;
         cmd.hasTranslation = std::fabs(translation.x) > 0.0f || std::fabs(translation.y) > 0.0f;
         cmd.translation = translation;
-        m_geometryCommands.push_back(std::move(cmd));
+        QueueStorage& queue = ActiveStorage();
+        cmd.order = queue.nextOrder++;
+        queue.geometryCommands.push_back(std::move(cmd));
     }
 
     //===========================
     //  GPU resources / states
     //===========================
 
-    bool SpriteBatch2D::CreateShaders(ID3D11Device* device)
+    bool SpriteBatch2D::CreateShaders(ID3D11Device* device, ShaderCache* shaderCache)
     {
         KBK_PROFILE_SCOPE("CreateBatchShaders");
 
@@ -512,10 +798,15 @@ struct VSOutput
     float4 color    : COLOR0;
 };
 
+// position.z: the whole part is the shading mode (see SpriteBatch2D::kShadeDistanceField,
+// applied by picking the pixel shader per range), the fraction the draw depth of the
+// opaque pass, halved
 VSOutput main(VSInput input)
 {
     VSOutput output;
-    output.position = mul(float4(input.position, 1.0f), gViewProj);
+    float mode = floor(input.position.z);
+    output.position = mul(float4(input.position.xy, 0.0f, 1.0f), gViewProj);
+    output.position.z = (input.position.z - mode) * 2.0f * output.position.w;
     output.texcoord = input.texcoord;
     output.color    = input.color;
     return output;
@@ -523,54 +814,116 @@ VSOutput main(VSInput input)
 )";
 
         static constexpr const char* PS_SOURCE = R"(
+cbuffer CB_PS : register(b0)
+{
+    float  gPremultiply; // 1 when the blend state expects rgb * a (Multiply)
+    float  gLit;         // 1 when the tiled lights below apply
+    float  gTileSize;
+    uint   gTilesX;
+    float3 gAmbient;
+    uint   gTilesY;
+    float2 gGridOrigin;  // render-target pixels
+    float  gAlphaCutoff; // alpha-tested ranges discard below it
+};
+
+struct Light
+{
+    float2 position;
+    float  radius;
+    float  invRadius;
+    float3 color;
+    float  padding;
+};
+
 Texture2D gTexture : register(t0);
+StructuredBuffer<Light> gLights : register(t1);
+StructuredBuffer<uint2> gTileRanges : register(t2); // offset, count per tile
+StructuredBuffer<uint>  gTileLights : register(t3);
 SamplerState gSampler : register(s0);
+SamplerState gLinearSampler : register(s1);
+
+// Kept in step with ShadeLightGridReference (LightGrid2D.cpp)
+float3 TileLighting(float2 pixel)
+{
+    float3 sum = gAmbient;
+    int2 tile = int2(floor((pixel - gGridOrigin) / gTileSize));
+    if (tile.x >= 0 && tile.y >= 0 && tile.x < int(gTilesX) && tile.y < int(gTilesY)) {
+        uint2 range = gTileRanges[uint(tile.y) * gTilesX + uint(tile.x)];
+        for (uint i = 0; i < range.y; ++i) {
+            Light light = gLights[gTileLights[range.x + i]];
+            float2 d = (pixel - light.position) * light.invRadius;
+            float a = saturate(1.0f - dot(d, d));
+            sum += light.color * (a * a);
+        }
+    }
+    return sum;
+}
 
+// Built twice: plain texture * color (lit), and with KBK_DISTANCE_FIELD for
+// glyph ranges, so sprites never pay for the second sample and the smooth step
 float4 main(float4 position : SV_Position,
             float2 texcoord : TEXCOORD0,
             float4 color    : COLOR0) : SV_Target
 {
+#if KBK_DISTANCE_FIELD
+    // Distance field in alpha, 0.5 on the edge: one pixel wide smooth step
+    float dist = gTexture.Sample(gLinearSampler, texcoord).a;
+    float width = max(fwidth(dist), 1e-4f);
+    float4 result = float4(color.rgb, color.a * smoothstep(0.5f - width, 0.5f + width, dist));
+    if (result.a < gAlphaCutoff)
+        discard;
+#else
     float4 texColor = gTexture.Sample(gSampler, texcoord);
-    return float4(texColor.rgb * color.rgb, texColor.a * color.a);
+    float4 result = texColor * color;
+    if (result.a < gAlphaCutoff)
+        discard;
+    if (gLit > 0.5f)
+        result.rgb *= TileLighting(position.xy);
+#endif
+    result.rgb *= lerp(1.0f, result.a, gPremultiply);
+    return result;
 }
 )";
 
-        Microsoft::WRL::ComPtr<ID3DBlob> vsBlob;
-        Microsoft::WRL::ComPtr<ID3DBlob> psBlob;
-        Microsoft::WRL::ComPtr<ID3DBlob> errors;
-
-        HRESULT hr = D3DCompile(
-            VS_SOURCE, std::strlen(VS_SOURCE),
-            nullptr, nullptr, nullptr,
-            "main", "vs_5_0",
-            D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
-            vsBlob.GetAddressOf(), errors.GetAddressOf());
-        if (FAILED(hr)) {
-            if (errors) {
-                KbkError(kLogChannel, "VS compile error: %s",
-                    static_cast<const char*>(errors->GetBufferPointer()));
-            }
+        // Bytecode comes from the cache; D3DCompile only runs on a miss. Without
+        // a cache (no directory to keep it in) this one compiles every time.
+        const auto start = std::chrono::steady_clock::now();
+        ShaderCache localCache;
+        ShaderCache& cache = shaderCache ? *shaderCache : localCache;
+        const ShaderCacheStats before = cache.Stats();
+        ShaderCompilerD3D11 compiler;
+
+        ShaderDesc vsDesc;
+        vsDesc.source = VS_SOURCE;
+        vsDesc.target = "vs_5_0";
+        vsDesc.flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+        vsDesc.debugName = "SpriteBatch2D VS";
+        const std::vector<std::uint8_t>* vsBytecode = cache.Get(vsDesc, compiler);
+
+        ShaderDesc psDesc = vsDesc;
+        psDesc.source = PS_SOURCE;
+        psDesc.target = "ps_5_0";
+        psDesc.debugName = "SpriteBatch2D PS";
+        const std::vector<std::uint8_t>* psBytecode = cache.Get(psDesc, compiler);
+
+        static constexpr ShaderDefine kDistanceFieldDefines[] = { { "KBK_DISTANCE_FIELD", "1" } };
+        ShaderDesc psDistanceFieldDesc = psDesc;
+        psDistanceFieldDesc.defines = kDistanceFieldDefines;
+        psDistanceFieldDesc.debugName = "SpriteBatch2D PS (distance field)";
+        const std::vector<std::uint8_t>* psDistanceFieldBytecode = cache.Get(psDistanceFieldDesc, compiler);
+
+        if (!vsBytecode || !psBytecode || !psDistanceFieldBytecode)
             return false;
-        }
 
-        errors.Reset();
-        hr = D3DCompile(
-            PS_SOURCE, std::strlen(PS_SOURCE),
-            nullptr, nullptr, nullptr,
-            "main", "ps_5_0",
-            D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
-            psBlob.GetAddressOf(), errors.GetAddressOf());
-        if (FAILED(hr)) {
-            if (errors) {
-                KbkError(kLogChannel, "PS compile error: %s",
-                    static_cast<const char*>(errors->GetBufferPointer()));
-            }
-            return false;
-        }
+        const ShaderCacheStats& after = cache.Stats();
+        KbkLog(kLogChannel, "Shaders ready in %.2f ms (%u compiled, %u from cache)",
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+            after.compiles - before.compiles,
+            (after.memoryHits - before.memoryHits) + (after.diskHits - before.diskHits));
 
-        hr = device->CreateVertexShader(
-            vsBlob->GetBufferPointer(),
-            vsBlob->GetBufferSize(),
+        HRESULT hr = device->CreateVertexShader(
+            vsBytecode->data(),
+            vsBytecode->size(),
             nullptr,
             m_vs.GetAddressOf());
         if (FAILED(hr)) {
@@ -579,8 +932,8 @@ float4 main(float4 position : SV_Position,
         }
 
         hr = device->CreatePixelShader(
-            psBlob->GetBufferPointer(),
-            psBlob->GetBufferSize(),
+            psBytecode->data(),
+            psBytecode->size(),
             nullptr,
             m_ps.GetAddressOf());
         if (FAILED(hr)) {
@@ -588,6 +941,16 @@ float4 main(float4 position : SV_Position,
             return false;
         }
 
+        hr = device->CreatePixelShader(
+            psDistanceFieldBytecode->data(),
+            psDistanceFieldBytecode->size(),
+            nullptr,
+            m_psDistanceField.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreatePixelShader (distance field) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
         // Describe the vertex input layout
         D3D11_INPUT_ELEMENT_DESC layout[] = {
             { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,
@@ -600,8 +963,8 @@ float4 main(float4 position : SV_Position,
 
         hr = device->CreateInputLayout(
             layout, ARRAYSIZE(layout),
-            vsBlob->GetBufferPointer(),
-            vsBlob->GetBufferSize(),
+            vsBytecode->data(),
+            vsBytecode->size(),
             m_inputLayout.GetAddressOf());
         if (FAILED(hr)) {
             KbkError(kLogChannel, "CreateInputLayout failed: 0x%08X", static_cast<unsigned>(hr));
@@ -621,6 +984,13 @@ float4 main(float4 position : SV_Position,
             return false;
         }
 
+        cbDesc.ByteWidth = sizeof(CBPS);
+        hr = device->CreateBuffer(&cbDesc, nullptr, m_cbPS.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateBuffer (CB_PS) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
         return true;
     }
 
@@ -641,21 +1011,54 @@ float4 main(float4 position : SV_Position,
             return false;
         }
 
-        // Standard alpha blending for sprites
-        D3D11_BLEND_DESC blend{};
-        blend.AlphaToCoverageEnable = FALSE;
-        blend.IndependentBlendEnable = FALSE;
-        blend.RenderTarget[0].BlendEnable = TRUE;
-        blend.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
-        blend.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
-        blend.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-        blend.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
-        blend.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
-        blend.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-        blend.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-        hr = device->CreateBlendState(&blend, m_blendAlpha.GetAddressOf());
+        // Bilinear twin for distance-field glyphs
+        samp.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        hr = device->CreateSamplerState(&samp, m_samplerLinear.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateSamplerState (linear) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        // One blend state per BlendMode; the alpha channel accumulates coverage
+        struct BlendFactors {
+            D3D11_BLEND src;
+            D3D11_BLEND dst;
+            D3D11_BLEND srcAlpha;
+            D3D11_BLEND dstAlpha;
+        };
+        static constexpr BlendFactors kBlendFactors[kBlendModeCount] = {
+            { D3D11_BLEND_SRC_ALPHA, D3D11_BLEND_INV_SRC_ALPHA, D3D11_BLEND_ONE,  D3D11_BLEND_INV_SRC_ALPHA }, // Alpha
+            { D3D11_BLEND_SRC_ALPHA, D3D11_BLEND_ONE,           D3D11_BLEND_ZERO, D3D11_BLEND_ONE },           // Additive
+            { D3D11_BLEND_DEST_COLOR, D3D11_BLEND_INV_SRC_ALPHA, D3D11_BLEND_ZERO, D3D11_BLEND_ONE },          // Multiply (rgb * a from the PS)
+            { D3D11_BLEND_ONE,       D3D11_BLEND_INV_SRC_ALPHA, D3D11_BLEND_ONE,  D3D11_BLEND_INV_SRC_ALPHA }, // Premultiplied
+        };
+
+        for (size_t i = 0; i < kBlendModeCount; ++i) {
+            D3D11_BLEND_DESC blend{};
+            blend.AlphaToCoverageEnable = FALSE;
+            blend.IndependentBlendEnable = FALSE;
+            blend.RenderTarget[0].BlendEnable = TRUE;
+            blend.RenderTarget[0].SrcBlend = kBlendFactors[i].src;
+            blend.RenderTarget[0].DestBlend = kBlendFactors[i].dst;
+            blend.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+            blend.RenderTarget[0].SrcBlendAlpha = kBlendFactors[i].srcAlpha;
+            blend.RenderTarget[0].DestBlendAlpha = kBlendFactors[i].dstAlpha;
+            blend.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+            blend.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+            hr = device->CreateBlendState(&blend, m_blendStates[i].GetAddressOf());
+            if (FAILED(hr)) {
+                KbkError(kLogChannel, "CreateBlendState (mode %zu) failed: 0x%08X", i, static_cast<unsigned>(hr));
+                return false;
+            }
+        }
+
+        // Opaque pass: texels overwrite what is behind them
+        D3D11_BLEND_DESC opaqueBlend{};
+        opaqueBlend.RenderTarget[0].BlendEnable = FALSE;
+        opaqueBlend.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+        hr = device->CreateBlendState(&opaqueBlend, m_blendOpaque.GetAddressOf());
         if (FAILED(hr)) {
-            KbkError(kLogChannel, "CreateBlendState failed: 0x%08X", static_cast<unsigned>(hr));
+            KbkError(kLogChannel, "CreateBlendState (opaque) failed: 0x%08X", static_cast<unsigned>(hr));
             return false;
         }
 
@@ -670,6 +1073,23 @@ float4 main(float4 position : SV_Position,
             return false;
         }
 
+        // Opaque pass front to back, then translucent draws tested against it
+        depth.DepthEnable = TRUE;
+        depth.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+        depth.DepthFunc = D3D11_COMPARISON_LESS;
+        hr = device->CreateDepthStencilState(&depth, m_depthWrite.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateDepthStencilState (write) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        depth.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+        hr = device->CreateDepthStencilState(&depth, m_depthTest.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateDepthStencilState (test) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
         // Disable back-face culling for screen-aligned quads
         D3D11_RASTERIZER_DESC rast{};
         rast.FillMode = D3D11_FILL_SOLID;
@@ -766,4 +1186,40 @@ float4 main(float4 position : SV_Position,
         m_context->Unmap(m_cbVS.Get(), 0);
     }
 
+    void SpriteBatch2D::SetLighting(const SpriteLighting2D* lighting, int maxLitLayer)
+    {
+        KBK_ASSERT(m_isDrawing, "SpriteBatch2D::SetLighting called outside Begin/End");
+        m_lighting = lighting;
+        m_maxLitLayer = maxLitLayer;
+    }
+
+    void SpriteBatch2D::UpdatePSConstants(float premultiply, const SpriteLighting2D* lighting, float alphaCutoff)
+    {
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        const HRESULT hr = m_context->Map(m_cbPS.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CB_PS map failed: 0x%08X", static_cast<unsigned>(hr));
+            return;
+        }
+
+        CBPS constants;
+        constants.premultiply = premultiply;
+        constants.alphaCutoff = alphaCutoff;
+        if (lighting) {
+            const Color4& ambient = lighting->Ambient();
+            constants.lit = 1.0f;
+            constants.tileSize = lighting->TileSize();
+            constants.tilesX = lighting->TilesX();
+            constants.tilesY = lighting->TilesY();
+            constants.ambient[0] = ambient.r;
+            constants.ambient[1] = ambient.g;
+            constants.ambient[2] = ambient.b;
+            constants.gridOrigin[0] = lighting->OriginX();
+            constants.gridOrigin[1] = lighting->OriginY();
+        }
+        std::memcpy(mapped.pData, &constants, sizeof(constants));
+
+        m_context->Unmap(m_cbPS.Get(), 0);
+    }
+
 } // namespace KibakoEngine
\ No newline at end of file
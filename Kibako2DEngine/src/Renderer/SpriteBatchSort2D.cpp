@@ -0,0 +1,240 @@
+// Sort keys, ordering and draw-range merging for SpriteBatch2D
+#include "KibakoEngine/Renderer/SpriteBatchSort2D.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr unsigned kBlendShift = 30;
+        constexpr std::uint64_t kGeometryBit = 1ull << 29;
+
+        // Draw order of the blend groups within a layer
+        constexpr std::uint32_t kBlendRank[kBlendModeCount] = {
+            0, // Alpha
+            3, // Additive
+            2, // Multiply
+            1, // Premultiplied
+        };
+        constexpr BlendMode kRankBlend[kBlendModeCount] = {
+            BlendMode::Alpha,
+            BlendMode::Premultiplied,
+            BlendMode::Multiply,
+            BlendMode::Additive,
+        };
+
+        bool ScissorLess(const BatchScissor& a, const BatchScissor& b)
+        {
+            if (a.left != b.left) return a.left < b.left;
+            if (a.top != b.top) return a.top < b.top;
+            if (a.right != b.right) return a.right < b.right;
+            return a.bottom < b.bottom;
+        }
+
+        std::uint32_t KeyLayerBits(std::uint64_t key)
+        {
+            return static_cast<std::uint32_t>(key >> 32);
+        }
+
+        // Unclipped first, then by rectangle: <0, 0 or >0 like a three-way compare
+        int CompareScissor(const BatchSortItem& a, const BatchSortItem& b)
+        {
+            if (a.hasScissor != b.hasScissor)
+                return a.hasScissor ? 1 : -1;
+            if (!a.hasScissor || a.scissor == b.scissor)
+                return 0;
+            return ScissorLess(a.scissor, b.scissor) ? -1 : 1;
+        }
+
+        bool LayerLess(const BatchSortItem& a, const BatchSortItem& b)
+        {
+            if (a.key != b.key)
+                return a.key < b.key;
+
+            if (const int scissor = CompareScissor(a, b); scissor != 0)
+                return scissor < 0;
+
+            return a.order < b.order;
+        }
+
+        bool LayerTextureLess(const BatchSortItem& a, const BatchSortItem& b)
+        {
+            // Layer and blend rank first, so the blend groups keep their order
+            const std::uint64_t groupA = a.key >> kBlendShift;
+            const std::uint64_t groupB = b.key >> kBlendShift;
+            if (groupA != groupB)
+                return groupA < groupB;
+            if (a.srv != b.srv)
+                return std::less<ID3D11ShaderResourceView*>{}(a.srv, b.srv);
+            if (a.key != b.key)
+                return a.key < b.key;
+
+            if (const int scissor = CompareScissor(a, b); scissor != 0)
+                return scissor < 0;
+
+            return a.order < b.order;
+        }
+
+        bool YSortLess(const BatchSortItem& a, const BatchSortItem& b)
+        {
+            if (KeyLayerBits(a.key) != KeyLayerBits(b.key))
+                return KeyLayerBits(a.key) < KeyLayerBits(b.key);
+            if (a.depth != b.depth)
+                return a.depth < b.depth;
+            return a.order < b.order;
+        }
+
+        bool BackToFrontLess(const BatchSortItem& a, const BatchSortItem& b)
+        {
+            if (KeyLayerBits(a.key) != KeyLayerBits(b.key))
+                return KeyLayerBits(a.key) < KeyLayerBits(b.key);
+            return a.order < b.order;
+        }
+
+        template<typename Less>
+        bool SortWith(std::span<BatchSortItem> items, Less less)
+        {
+            if (std::is_sorted(items.begin(), items.end(), less))
+                return false;
+            std::sort(items.begin(), items.end(), less);
+            return true;
+        }
+
+        bool SameState(const BatchDrawRange& range, const BatchSortItem& item, BlendMode blend, int layer)
+        {
+            return range.srv == item.srv &&
+                range.blend == blend &&
+                range.layer == layer &&
+                range.opacity == item.opacity &&
+                range.distanceField == item.distanceField &&
+                range.useScissor == item.hasScissor &&
+                (!item.hasScissor || range.scissor == item.scissor);
+        }
+
+        // Opaque and alpha-tested ranges all draw with blending off, whatever
+        // their blend mode: one state object, so no rebind between them
+        bool SameBlendState(const BatchDrawRange& range, const BatchSortItem& item, BlendMode blend)
+        {
+            const bool opaque = item.opacity != SpriteOpacity::Translucent;
+            const bool rangeOpaque = range.opacity != SpriteOpacity::Translucent;
+            return opaque == rangeOpaque && (opaque || range.blend == blend);
+        }
+    }
+
+    std::uint64_t MakeBatchSortKey(int layer, BlendMode blend, bool isGeometry)
+    {
+        // Bias the layer so negative layers order below positive ones as unsigned
+        const std::uint32_t biasedLayer = static_cast<std::uint32_t>(layer) ^ 0x80000000u;
+        const std::size_t blendIndex = std::min(static_cast<std::size_t>(blend), kBlendModeCount - 1);
+
+        std::uint64_t key = static_cast<std::uint64_t>(biasedLayer) << 32;
+        key |= static_cast<std::uint64_t>(kBlendRank[blendIndex]) << kBlendShift;
+        if (isGeometry)
+            key |= kGeometryBit;
+        return key;
+    }
+
+    int BatchKeyLayer(std::uint64_t key)
+    {
+        return static_cast<int>(static_cast<std::uint32_t>(key >> 32) ^ 0x80000000u);
+    }
+
+    BlendMode BatchKeyBlend(std::uint64_t key)
+    {
+        return kRankBlend[(key >> kBlendShift) & 3u];
+    }
+
+    bool BatchKeyIsGeometry(std::uint64_t key)
+    {
+        return (key & kGeometryBit) != 0;
+    }
+
+    bool SortBatchItems(std::span<BatchSortItem> items, QueueSortPolicy policy)
+    {
+        // Ties are broken by submission order, so a plain sort is deterministic
+        switch (policy) {
+        case QueueSortPolicy::None:
+            return false;
+        case QueueSortPolicy::LayerTexture:
+            return SortWith(items, LayerTextureLess);
+        case QueueSortPolicy::YSort:
+            return SortWith(items, YSortLess);
+        case QueueSortPolicy::BackToFront:
+            return SortWith(items, BackToFrontLess);
+        case QueueSortPolicy::Layer:
+        default:
+            return SortWith(items, LayerLess);
+        }
+    }
+
+    std::uint32_t BuildDepthPassOrder(std::span<BatchSortItem> painterOrder, std::vector<BatchSortItem>& out)
+    {
+        out.clear();
+        out.reserve(painterOrder.size());
+
+        // Strictly inside (0, 1): depth 1 is the clear value, which LESS never passes
+        const double step = 1.0 / static_cast<double>(painterOrder.size() + 1);
+        for (std::size_t i = 0; i < painterOrder.size(); ++i)
+            painterOrder[i].drawDepth = static_cast<float>(1.0 - static_cast<double>(i + 1) * step);
+
+        for (std::size_t i = painterOrder.size(); i-- > 0;) {
+            if (painterOrder[i].opacity != SpriteOpacity::Translucent)
+                out.push_back(painterOrder[i]);
+        }
+        const auto opaqueCount = static_cast<std::uint32_t>(out.size());
+
+        for (const BatchSortItem& item : painterOrder) {
+            if (item.opacity == SpriteOpacity::Translucent)
+                out.push_back(item);
+        }
+        return opaqueCount;
+    }
+
+    BatchStateChanges BuildBatchDrawRanges(std::span<const BatchSortItem> items, std::vector<BatchDrawRange>& out)
+    {
+        out.clear();
+        BatchStateChanges changes;
+
+        std::uint32_t firstIndex = 0;
+        for (const BatchSortItem& item : items) {
+            const BlendMode blend = BatchKeyBlend(item.key);
+            const int layer = BatchKeyLayer(item.key);
+
+            if (!out.empty() && SameState(out.back(), item, blend, layer)) {
+                out.back().indexCount += item.indexCount;
+                firstIndex += item.indexCount;
+                continue;
+            }
+
+            const BatchDrawRange* previous = out.empty() ? nullptr : &out.back();
+            if (!previous || !SameBlendState(*previous, item, blend))
+                ++changes.blend;
+            if (!previous || previous->srv != item.srv)
+                ++changes.texture;
+            if (!previous || previous->distanceField != item.distanceField)
+                ++changes.shader;
+            if (previous ? (previous->useScissor != item.hasScissor || (item.hasScissor && !(previous->scissor == item.scissor)))
+                         : item.hasScissor)
+                ++changes.scissor;
+
+            BatchDrawRange range;
+            range.srv = item.srv;
+            range.blend = blend;
+            range.layer = layer;
+            range.opacity = item.opacity;
+            range.distanceField = item.distanceField;
+            range.firstIndex = firstIndex;
+            range.indexCount = item.indexCount;
+            range.useScissor = item.hasScissor;
+            range.scissor = item.scissor;
+            out.push_back(range);
+
+            firstIndex += item.indexCount;
+        }
+
+        return changes;
+    }
+
+} // namespace KibakoEngine
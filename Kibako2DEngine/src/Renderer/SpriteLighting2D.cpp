@@ -0,0 +1,125 @@
+// Structured-buffer upload of the tiled light lists
+#include "KibakoEngine/Renderer/SpriteLighting2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+#include "KibakoEngine/Renderer/LightGrid2D.h"
+
+#include <cstring>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Lighting";
+        constexpr std::size_t kMinElements = 256;
+    }
+
+    bool SpriteLighting2D::Init(ID3D11Device* device)
+    {
+        KBK_ASSERT(device != nullptr, "SpriteLighting2D::Init requires device");
+        m_device = device;
+        m_ready = false;
+        return m_device != nullptr;
+    }
+
+    void SpriteLighting2D::Shutdown()
+    {
+        m_lights = {};
+        m_ranges = {};
+        m_indices = {};
+        m_device = nullptr;
+        m_ready = false;
+    }
+
+    bool SpriteLighting2D::Ensure(StructuredBuffer& target, std::size_t stride, std::size_t count, const char* name)
+    {
+        if (count <= target.capacity && target.buffer)
+            return true;
+
+        std::size_t newCapacity = target.capacity == 0 ? kMinElements : target.capacity;
+        while (newCapacity < count)
+            newCapacity *= 2;
+
+        D3D11_BUFFER_DESC desc{};
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        desc.StructureByteStride = static_cast<UINT>(stride);
+        desc.ByteWidth = static_cast<UINT>(newCapacity * stride);
+
+        Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+        HRESULT hr = m_device->CreateBuffer(&desc, nullptr, buffer.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateBuffer (%s) failed: 0x%08X", name, static_cast<unsigned>(hr));
+            return false;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.FirstElement = 0;
+        srvDesc.Buffer.NumElements = static_cast<UINT>(newCapacity);
+
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+        hr = m_device->CreateShaderResourceView(buffer.Get(), &srvDesc, srv.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateShaderResourceView (%s) failed: 0x%08X", name, static_cast<unsigned>(hr));
+            return false;
+        }
+
+        target.buffer = buffer;
+        target.srv = srv;
+        target.capacity = newCapacity;
+        return true;
+    }
+
+    bool SpriteLighting2D::Write(ID3D11DeviceContext* context, StructuredBuffer& target, std::size_t stride,
+        const void* data, std::size_t count, const char* name)
+    {
+        if (!Ensure(target, stride, count, name))
+            return false;
+        if (count == 0)
+            return true;
+
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        const HRESULT hr = context->Map(target.buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "%s map failed: 0x%08X", name, static_cast<unsigned>(hr));
+            return false;
+        }
+        std::memcpy(mapped.pData, data, count * stride);
+        context->Unmap(target.buffer.Get(), 0);
+        return true;
+    }
+
+    bool SpriteLighting2D::Upload(ID3D11DeviceContext* context, const LightGrid2D& grid, const Color4& ambient)
+    {
+        KBK_PROFILE_SCOPE("LightingUpload");
+
+        m_ready = false;
+        if (m_device == nullptr || context == nullptr)
+            return false;
+
+        const auto lights = grid.Lights();
+        const auto ranges = grid.TileRanges();
+        const auto indices = grid.TileLights();
+        if (!Write(context, m_lights, sizeof(PackedLight2D), lights.data(), lights.size(), "Lights") ||
+            !Write(context, m_ranges, sizeof(LightTileRange2D), ranges.data(), ranges.size(), "TileRanges") ||
+            !Write(context, m_indices, sizeof(std::uint32_t), indices.data(), indices.size(), "TileLights")) {
+            return false;
+        }
+
+        m_ambient = ambient;
+        m_originX = grid.Area().x;
+        m_originY = grid.Area().y;
+        m_tileSize = static_cast<float>(grid.Desc().tileSize);
+        m_tilesX = grid.TilesX();
+        m_tilesY = grid.TilesY();
+        m_ready = true;
+        return true;
+    }
+
+} // namespace KibakoEngine
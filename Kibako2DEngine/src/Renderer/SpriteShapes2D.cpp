@@ -0,0 +1,251 @@
+// Vertex generation for nine-slice and tiled sprites, plus the retained mesh cache
+#include "KibakoEngine/Renderer/SpriteShapes2D.h"
+
+#include "KibakoEngine/Renderer/Texture2D.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KibakoEngine {
+
+    using namespace DirectX;
+
+    namespace
+    {
+        constexpr float kRotationEpsilon = 0.0001f; // same threshold as SpriteBatch2D
+        constexpr float kTileEpsilon = 1.0e-4f;     // a fill this close to whole tiles gets no sliver
+
+        bool HasArea(const SpriteShapeDesc& desc)
+        {
+            return desc.dst.w > 0.0f && desc.dst.h > 0.0f;
+        }
+
+        // Rotation around the centre of dst, shared by every vertex of a shape
+        struct ShapeTransform
+        {
+            float cx = 0.0f;
+            float cy = 0.0f;
+            float cs = 1.0f;
+            float sn = 0.0f;
+            bool  rotated = false;
+
+            explicit ShapeTransform(const SpriteShapeDesc& desc)
+            {
+                rotated = std::fabs(desc.rotation) > kRotationEpsilon;
+                if (rotated) {
+                    cx = desc.dst.x + desc.dst.w * 0.5f;
+                    cy = desc.dst.y + desc.dst.h * 0.5f;
+                    cs = std::cos(desc.rotation);
+                    sn = std::sin(desc.rotation);
+                }
+            }
+
+            [[nodiscard]] XMFLOAT3 Apply(float x, float y) const
+            {
+                if (!rotated)
+                    return { x, y, 0.0f };
+                const float dx = x - cx;
+                const float dy = y - cy;
+                return { cx + dx * cs - dy * sn, cy + dx * sn + dy * cs, 0.0f };
+            }
+        };
+
+        // Border sizes in pixels (a, b) and as fractions of the source region
+        // (fa, fb) along one axis; both pairs shrink to fit when they overlap
+        struct SliceAxis
+        {
+            float a = 0.0f, b = 0.0f;
+            float fa = 0.0f, fb = 0.0f;
+        };
+
+        SliceAxis FitSlices(float sliceA, float sliceB, float scale, float extent, float srcTexels)
+        {
+            SliceAxis axis;
+            axis.a = std::max(sliceA, 0.0f) * scale;
+            axis.b = std::max(sliceB, 0.0f) * scale;
+            const float sum = axis.a + axis.b;
+            if (sum > extent && sum > 0.0f) {
+                const float k = extent / sum;
+                axis.a *= k;
+                axis.b *= k;
+            }
+
+            if (srcTexels > 0.0f) {
+                axis.fa = std::max(sliceA, 0.0f) / srcTexels;
+                axis.fb = std::max(sliceB, 0.0f) / srcTexels;
+                const float fsum = axis.fa + axis.fb;
+                if (fsum > 1.0f) {
+                    axis.fa /= fsum;
+                    axis.fb /= fsum;
+                }
+            }
+            return axis;
+        }
+
+        struct TileAxis
+        {
+            std::uint32_t count = 0;
+            float         size = 0.0f; // pixels per repeat
+        };
+
+        TileAxis FitTiles(float tileSize, float extent, float srcTexels)
+        {
+            TileAxis axis;
+            axis.size = (tileSize > 0.0f) ? tileSize : srcTexels;
+            if (!(axis.size > 0.0f))
+                axis.size = extent;
+
+            const float repeats = std::ceil(extent / axis.size - kTileEpsilon);
+            if (repeats > static_cast<float>(kMaxSpriteTilesPerAxis)) {
+                axis.count = kMaxSpriteTilesPerAxis;
+                axis.size = extent / static_cast<float>(kMaxSpriteTilesPerAxis);
+            }
+            else {
+                axis.count = static_cast<std::uint32_t>(std::max(repeats, 1.0f));
+            }
+            return axis;
+        }
+
+        void BuildNineSlice(const SpriteShapeDesc& desc, float textureWidth, float textureHeight,
+            SpriteBatch2D::Vertex* vertices, std::uint32_t* indices)
+        {
+            const RectF& d = desc.dst;
+            const RectF& s = desc.src;
+            const SliceAxis h = FitSlices(desc.slices.left, desc.slices.right, desc.borderScale, d.w, std::fabs(s.w) * textureWidth);
+            const SliceAxis v = FitSlices(desc.slices.top, desc.slices.bottom, desc.borderScale, d.h, std::fabs(s.h) * textureHeight);
+
+            const float xs[4] = { d.x, d.x + h.a, d.x + d.w - h.b, d.x + d.w };
+            const float ys[4] = { d.y, d.y + v.a, d.y + d.h - v.b, d.y + d.h };
+            // Fractions of src.w/h keep flipped (negative) source regions working
+            const float us[4] = { s.x, s.x + s.w * h.fa, s.x + s.w * (1.0f - h.fb), s.x + s.w };
+            const float vs[4] = { s.y, s.y + s.h * v.fa, s.y + s.h * (1.0f - v.fb), s.y + s.h };
+
+            const ShapeTransform xf(desc);
+            const XMFLOAT4 color{ desc.color.r, desc.color.g, desc.color.b, desc.color.a };
+            for (int row = 0; row < 4; ++row)
+                for (int col = 0; col < 4; ++col)
+                    vertices[row * 4 + col] = { xf.Apply(xs[col], ys[row]), { us[col], vs[row] }, color };
+
+            for (std::uint32_t row = 0; row < 3; ++row) {
+                for (std::uint32_t col = 0; col < 3; ++col) {
+                    if (row == 1 && col == 1 && !desc.fillCenter)
+                        continue;
+                    const std::uint32_t tl = row * 4 + col;
+                    indices[0] = tl;
+                    indices[1] = tl + 1;
+                    indices[2] = tl + 5;
+                    indices[3] = tl;
+                    indices[4] = tl + 5;
+                    indices[5] = tl + 4;
+                    indices += 6;
+                }
+            }
+        }
+
+        void BuildTiled(const SpriteShapeDesc& desc, float textureWidth, float textureHeight,
+            SpriteBatch2D::Vertex* vertices, std::uint32_t* indices)
+        {
+            const RectF& d = desc.dst;
+            const RectF& s = desc.src;
+            const TileAxis cols = FitTiles(desc.tileWidth, d.w, std::fabs(s.w) * textureWidth);
+            const TileAxis rows = FitTiles(desc.tileHeight, d.h, std::fabs(s.h) * textureHeight);
+
+            const ShapeTransform xf(desc);
+            const XMFLOAT4 color{ desc.color.r, desc.color.g, desc.color.b, desc.color.a };
+            const float right = d.x + d.w;
+            const float bottom = d.y + d.h;
+
+            std::uint32_t base = 0;
+            for (std::uint32_t row = 0; row < rows.count; ++row) {
+                const float y0 = d.y + static_cast<float>(row) * rows.size;
+                const float y1 = std::min(y0 + rows.size, bottom);
+                const float v1 = s.y + s.h * ((y1 - y0) / rows.size);
+
+                for (std::uint32_t col = 0; col < cols.count; ++col) {
+                    const float x0 = d.x + static_cast<float>(col) * cols.size;
+                    const float x1 = std::min(x0 + cols.size, right);
+                    const float u1 = s.x + s.w * ((x1 - x0) / cols.size);
+
+                    vertices[0] = { xf.Apply(x0, y0), { s.x, s.y }, color };
+                    vertices[1] = { xf.Apply(x1, y0), { u1, s.y }, color };
+                    vertices[2] = { xf.Apply(x1, y1), { u1, v1 }, color };
+                    vertices[3] = { xf.Apply(x0, y1), { s.x, v1 }, color };
+                    vertices += 4;
+
+                    indices[0] = base;
+                    indices[1] = base + 1;
+                    indices[2] = base + 2;
+                    indices[3] = base;
+                    indices[4] = base + 2;
+                    indices[5] = base + 3;
+                    indices += 6;
+                    base += 4;
+                }
+            }
+        }
+    }
+
+    SpriteShapeCounts CountSpriteShape(const SpriteShapeDesc& desc, float textureWidth, float textureHeight)
+    {
+        if (!HasArea(desc))
+            return {};
+
+        switch (desc.mode) {
+        case SpriteDrawMode::NineSlice:
+            return { 16, desc.fillCenter ? 54u : 48u };
+        case SpriteDrawMode::Tiled: {
+            const TileAxis cols = FitTiles(desc.tileWidth, desc.dst.w, std::fabs(desc.src.w) * textureWidth);
+            const TileAxis rows = FitTiles(desc.tileHeight, desc.dst.h, std::fabs(desc.src.h) * textureHeight);
+            const std::size_t tiles = static_cast<std::size_t>(cols.count) * rows.count;
+            return { tiles * 4, tiles * 6 };
+        }
+        case SpriteDrawMode::Simple:
+            break;
+        }
+        return {};
+    }
+
+    void BuildSpriteShape(const SpriteShapeDesc& desc, float textureWidth, float textureHeight,
+        SpriteBatch2D::Vertex* vertices, std::uint32_t* indices)
+    {
+        if (!HasArea(desc) || vertices == nullptr || indices == nullptr)
+            return;
+
+        if (desc.mode == SpriteDrawMode::NineSlice)
+            BuildNineSlice(desc, textureWidth, textureHeight, vertices, indices);
+        else if (desc.mode == SpriteDrawMode::Tiled)
+            BuildTiled(desc, textureWidth, textureHeight, vertices, indices);
+    }
+
+    bool SpriteShapeMesh2D::Update(const SpriteShapeDesc& desc, const Texture2D* texture)
+    {
+        const float width = texture ? static_cast<float>(texture->Width()) : 1.0f;
+        const float height = texture ? static_cast<float>(texture->Height()) : 1.0f;
+
+        m_texture = texture;
+        if (m_valid && desc == m_desc && width == m_textureWidth && height == m_textureHeight)
+            return false;
+
+        m_desc = desc;
+        m_textureWidth = width;
+        m_textureHeight = height;
+        m_valid = true;
+
+        const SpriteShapeCounts counts = CountSpriteShape(desc, width, height);
+        m_vertices.resize(counts.vertices);
+        m_indices.resize(counts.indices);
+        if (counts.vertices > 0)
+            BuildSpriteShape(desc, width, height, m_vertices.data(), m_indices.data());
+        return true;
+    }
+
+    void SpriteShapeMesh2D::Submit(SpriteBatch2D& batch, int layer, BlendMode blend, XMFLOAT2 translation) const
+    {
+        if (m_vertices.empty())
+            return;
+
+        batch.PushGeometryView(m_texture, m_vertices.data(), m_vertices.size(), m_indices.data(), m_indices.size(),
+            layer, RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f), translation, blend);
+    }
+
+} // namespace KibakoEngine
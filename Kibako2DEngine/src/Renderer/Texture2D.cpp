@@ -6,6 +6,7 @@
 #include "KibakoEngine/Core/Profiler.h"
 
 #include <cstdint>
+#include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "nothings/stb_image.h"
@@ -15,14 +16,27 @@ namespace KibakoEngine {
     namespace
     {
         constexpr const char* kLogChannel = "Texture";
+
+        bool AllTexelsOpaque(const std::uint8_t* rgba, int width, int height)
+        {
+            const std::size_t count = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+            for (std::size_t i = 0; i < count; ++i) {
+                if (rgba[i * 4 + 3] != 255)
+                    return false;
+            }
+            return true;
+        }
     }
 
     void Texture2D::Reset()
     {
+        m_rtv.Reset();
         m_srv.Reset();
         m_texture.Reset();
         m_width = 0;
         m_height = 0;
+        m_updatable = false;
+        m_opaque = false;
     }
 
     bool Texture2D::CreateSolidColor(ID3D11Device* device,
@@ -73,6 +87,7 @@ namespace KibakoEngine {
         m_srv = srv;
         m_width = 1;
         m_height = 1;
+        m_opaque = a == 255;
         return true;
     }
 
@@ -120,6 +135,133 @@ namespace KibakoEngine {
         m_srv = srv;
         m_width = width;
         m_height = height;
+        m_opaque = AllTexelsOpaque(pixels, width, height);
+        return true;
+    }
+
+    bool Texture2D::CreateUpdatable(ID3D11Device* device, int width, int height)
+    {
+        KBK_PROFILE_SCOPE("TextureCreateUpdatable");
+
+        KBK_ASSERT(device != nullptr, "Texture2D::CreateUpdatable requires a valid device");
+        Reset();
+
+        if (width <= 0 || height <= 0) {
+            KbkError(kLogChannel, "CreateUpdatable: invalid size %dx%d", width, height);
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC desc{};
+        desc.Width = static_cast<UINT>(width);
+        desc.Height = static_cast<UINT>(height);
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_DEFAULT; // written with UpdateSubresource
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        const std::vector<std::uint8_t> blank(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4u, 0);
+        D3D11_SUBRESOURCE_DATA data{};
+        data.pSysMem = blank.data();
+        data.SysMemPitch = static_cast<UINT>(width * 4);
+
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+        HRESULT hr = device->CreateTexture2D(&desc, &data, texture.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateTexture2D (updatable) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+        hr = device->CreateShaderResourceView(texture.Get(), nullptr, srv.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateShaderResourceView (updatable) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        m_texture = texture;
+        m_srv = srv;
+        m_width = width;
+        m_height = height;
+        m_updatable = true;
+        return true;
+    }
+
+    void Texture2D::UpdateRegion(ID3D11DeviceContext* context,
+        int x,
+        int y,
+        int width,
+        int height,
+        const std::uint8_t* pixels,
+        int rowPitch)
+    {
+        KBK_ASSERT(context != nullptr, "Texture2D::UpdateRegion requires a valid context");
+        KBK_ASSERT(m_updatable, "Texture2D::UpdateRegion needs a texture made by CreateUpdatable");
+        if (!m_updatable || pixels == nullptr || width <= 0 || height <= 0)
+            return;
+
+        KBK_ASSERT(x >= 0 && y >= 0 && x + width <= m_width && y + height <= m_height,
+            "Texture2D::UpdateRegion: region outside the texture");
+
+        D3D11_BOX box{};
+        box.left = static_cast<UINT>(x);
+        box.top = static_cast<UINT>(y);
+        box.front = 0;
+        box.right = static_cast<UINT>(x + width);
+        box.bottom = static_cast<UINT>(y + height);
+        box.back = 1;
+        context->UpdateSubresource(m_texture.Get(), 0, &box, pixels, static_cast<UINT>(rowPitch), 0);
+    }
+
+    bool Texture2D::CreateRenderTarget(ID3D11Device* device, int width, int height)
+    {
+        KBK_PROFILE_SCOPE("TextureCreateRenderTarget");
+
+        KBK_ASSERT(device != nullptr, "Texture2D::CreateRenderTarget requires a valid device");
+        Reset();
+
+        if (width <= 0 || height <= 0) {
+            KbkError(kLogChannel, "CreateRenderTarget: invalid size %dx%d", width, height);
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC desc{};
+        desc.Width = static_cast<UINT>(width);
+        desc.Height = static_cast<UINT>(height);
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
+        HRESULT hr = device->CreateTexture2D(&desc, nullptr, texture.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateTexture2D (render target) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv;
+        hr = device->CreateShaderResourceView(texture.Get(), nullptr, srv.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateShaderResourceView (render target) failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> rtv;
+        hr = device->CreateRenderTargetView(texture.Get(), nullptr, rtv.GetAddressOf());
+        if (FAILED(hr)) {
+            KbkError(kLogChannel, "CreateRenderTargetView failed: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+
+        m_texture = texture;
+        m_srv = srv;
+        m_rtv = rtv;
+        m_width = width;
+        m_height = height;
         return true;
     }
 
@@ -156,6 +298,8 @@ namespace KibakoEngine {
         data.pSysMem = pixels;
         data.SysMemPitch = static_cast<UINT>(width * 4);
 
+        const bool opaque = AllTexelsOpaque(pixels, width, height);
+
         Microsoft::WRL::ComPtr<ID3D11Texture2D> texture;
         HRESULT hr = device->CreateTexture2D(&desc, &data, texture.GetAddressOf());
         stbi_image_free(pixels);
@@ -175,6 +319,7 @@ namespace KibakoEngine {
         m_srv = srv;
         m_width = width;
         m_height = height;
+        m_opaque = opaque;
         KbkLog(kLogChannel, "Loaded %s (%dx%d)", path.c_str(), m_width, m_height);
         return true;
     }
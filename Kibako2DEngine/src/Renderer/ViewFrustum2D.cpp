@@ -0,0 +1,120 @@
+// Builds rotated camera bounds and performs 2D box overlap tests
+#include "KibakoEngine/Renderer/ViewFrustum2D.h"
+
+#include "KibakoEngine/Renderer/Camera2D.h"
+
+#include <cmath>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr float kRotationEpsilon = 0.0001f;
+
+        // Projected radius of a box onto a unit axis
+        float ProjectRadius(const OrientedRect2D& box, float axisX, float axisY)
+        {
+            const float ux = box.cosR;
+            const float uy = box.sinR;
+            const float vx = -box.sinR;
+            const float vy = box.cosR;
+
+            return box.halfExtents.x * std::fabs(ux * axisX + uy * axisY) +
+                box.halfExtents.y * std::fabs(vx * axisX + vy * axisY);
+        }
+
+        bool SeparatedOnAxis(const OrientedRect2D& a, const OrientedRect2D& b,
+            float dx, float dy, float axisX, float axisY)
+        {
+            const float distance = std::fabs(dx * axisX + dy * axisY);
+            return distance > ProjectRadius(a, axisX, axisY) + ProjectRadius(b, axisX, axisY);
+        }
+    }
+
+    OrientedRect2D OrientedRect2D::FromRotation(DirectX::XMFLOAT2 center,
+        DirectX::XMFLOAT2 halfExtents,
+        float radians)
+    {
+        OrientedRect2D box;
+        box.center = center;
+        box.halfExtents = halfExtents;
+
+        // Same threshold as SpriteBatch2D: tiny angles are drawn unrotated
+        if (std::fabs(radians) > kRotationEpsilon) {
+            box.cosR = std::cos(radians);
+            box.sinR = std::sin(radians);
+        }
+        return box;
+    }
+
+    RectF OrientedRect2D::BoundingRect() const
+    {
+        const float ac = std::fabs(cosR);
+        const float as = std::fabs(sinR);
+        const float hx = halfExtents.x * ac + halfExtents.y * as;
+        const float hy = halfExtents.x * as + halfExtents.y * ac;
+        return RectF::FromXYWH(center.x - hx, center.y - hy, hx * 2.0f, hy * 2.0f);
+    }
+
+    bool Overlaps(const RectF& a, const RectF& b)
+    {
+        return a.x < (b.x + b.w) &&
+            (a.x + a.w) > b.x &&
+            a.y < (b.y + b.h) &&
+            (a.y + a.h) > b.y;
+    }
+
+    bool Overlaps(const OrientedRect2D& a, const OrientedRect2D& b)
+    {
+        const float dx = b.center.x - a.center.x;
+        const float dy = b.center.y - a.center.y;
+
+        if (SeparatedOnAxis(a, b, dx, dy, a.cosR, a.sinR))   return false;
+        if (SeparatedOnAxis(a, b, dx, dy, -a.sinR, a.cosR))  return false;
+        if (SeparatedOnAxis(a, b, dx, dy, b.cosR, b.sinR))   return false;
+        if (SeparatedOnAxis(a, b, dx, dy, -b.sinR, b.cosR))  return false;
+        return true;
+    }
+
+    ViewFrustum2D ViewFrustum2D::FromCamera(const Camera2D& camera)
+    {
+        // Camera2D maps world -> screen as (R(-rotation) * p - position) * zoom,
+        // so the visible screen rectangle [0,w]x[0,h] maps back through R(rotation).
+        const DirectX::XMFLOAT2 position = camera.GetPosition();
+        const float invZoom = 1.0f / camera.GetZoom();
+        const float halfW = camera.GetViewportWidth() * 0.5f * invZoom;
+        const float halfH = camera.GetViewportHeight() * 0.5f * invZoom;
+
+        const float lx = position.x + halfW;
+        const float ly = position.y + halfH;
+
+        ViewFrustum2D frustum;
+        frustum.view = OrientedRect2D::FromRotation({ lx, ly }, { halfW, halfH }, camera.GetRotation());
+
+        const OrientedRect2D& v = frustum.view;
+        frustum.view.center = { lx * v.cosR - ly * v.sinR, lx * v.sinR + ly * v.cosR };
+        frustum.bounds = frustum.view.BoundingRect();
+        return frustum;
+    }
+
+    ViewFrustum2D ViewFrustum2D::FromRect(const RectF& rect)
+    {
+        ViewFrustum2D frustum;
+        frustum.view.halfExtents = { rect.w * 0.5f, rect.h * 0.5f };
+        frustum.view.center = { rect.x + frustum.view.halfExtents.x, rect.y + frustum.view.halfExtents.y };
+        frustum.bounds = rect;
+        return frustum;
+    }
+
+    bool ViewFrustum2D::Intersects(const OrientedRect2D& box) const
+    {
+        if (!Overlaps(bounds, box.BoundingRect()))
+            return false;
+
+        if (view.IsAxisAligned() && box.IsAxisAligned())
+            return true;
+
+        return Overlaps(view, box);
+    }
+
+} // namespace KibakoEngine
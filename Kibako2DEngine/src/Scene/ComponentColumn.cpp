@@ -0,0 +1,104 @@
+// Aligned raw storage and relocation for type-erased component columns
+#include "KibakoEngine/Scene/ComponentColumn.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/Log.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Components";
+
+        std::atomic<ComponentTypeId> g_nextComponentType{ 0 };
+
+        constexpr std::size_t kMinCapacity = 16;
+
+        std::byte* Allocate(std::size_t bytes, std::size_t alignment)
+        {
+            return static_cast<std::byte*>(::operator new(bytes, std::align_val_t{ alignment }));
+        }
+
+        void Free(std::byte* data, std::size_t alignment)
+        {
+            ::operator delete(data, std::align_val_t{ alignment });
+        }
+    }
+
+    ComponentTypeId AllocateComponentTypeId()
+    {
+        const ComponentTypeId id = g_nextComponentType.fetch_add(1, std::memory_order_relaxed);
+        if (id >= kMaxComponentTypes) {
+            KbkError(kLogChannel, "Component type #%u exceeds kMaxComponentTypes (%u): it has no signature bit, "
+                "queries and systems cannot filter on it", id, kMaxComponentTypes);
+        }
+        return id;
+    }
+
+    ComponentColumn::ComponentColumn(const ComponentTypeInfo& info)
+        : m_info(&info)
+    {
+        KBK_ASSERT(info.size > 0 && info.moveConstruct && info.destroy, "Incomplete component type info");
+    }
+
+    ComponentColumn::~ComponentColumn()
+    {
+        Clear();
+        if (m_data)
+            Free(m_data, m_info->alignment);
+    }
+
+    void ComponentColumn::Reserve(std::size_t capacity)
+    {
+        if (capacity <= m_capacity)
+            return;
+
+        std::byte* data = Allocate(capacity * m_info->size, m_info->alignment);
+        for (std::size_t i = 0; i < m_size; ++i) {
+            void* src = At(i);
+            m_info->moveConstruct(data + i * m_info->size, src);
+            m_info->destroy(src);
+        }
+
+        if (m_data)
+            Free(m_data, m_info->alignment);
+
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    void* ComponentColumn::PrepareBack()
+    {
+        if (m_size == m_capacity)
+            Reserve(std::max(kMinCapacity, m_capacity * 2));
+        return At(m_size);
+    }
+
+    void ComponentColumn::SwapRemove(std::size_t index)
+    {
+        KBK_ASSERT(index < m_size, "ComponentColumn index out of range");
+
+        const std::size_t last = m_size - 1;
+        if (index != last)
+            Relocate(index, last);
+        Truncate(last);
+    }
+
+    void ComponentColumn::Relocate(std::size_t dst, std::size_t src)
+    {
+        void* target = At(dst);
+        m_info->destroy(target);
+        m_info->moveConstruct(target, At(src));
+    }
+
+    void ComponentColumn::Truncate(std::size_t size)
+    {
+        for (std::size_t i = size; i < m_size; ++i)
+            m_info->destroy(At(i));
+        m_size = std::min(size, m_size);
+    }
+
+} // namespace KibakoEngine
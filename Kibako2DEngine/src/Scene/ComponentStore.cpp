@@ -0,0 +1,160 @@
+// Type-independent half of the component stores (lookup, removal, stamps, partition)
+#include "KibakoEngine/Scene/ComponentStore.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace KibakoEngine {
+
+    ComponentStoreBase::ComponentStoreBase(ComponentTypeId typeId, const ComponentTypeInfo& info)
+        : m_column(info)
+        , m_typeId(typeId)
+    {
+    }
+
+    ComponentStoreBase::~ComponentStoreBase() = default;
+
+    void ComponentStoreBase::Reserve(std::size_t count)
+    {
+        m_column.Reserve(count);
+        m_denseEntities.reserve(count);
+        m_addedTicks.reserve(count);
+        m_changedTicks.reserve(count);
+        m_sparse.reserve(count);
+    }
+
+    void ComponentStoreBase::SetEnabled(EntityID id, bool enabled)
+    {
+        auto it = m_sparse.find(id);
+        if (it == m_sparse.end())
+            return;
+
+        const std::size_t index = it->second;
+        if ((index < m_enabledCount) == enabled)
+            return;
+
+        // Swap with the first disabled slot (enable) or the last enabled one (disable)
+        const std::size_t boundary = enabled ? m_enabledCount++ : --m_enabledCount;
+        if (index != boundary)
+        {
+            SwapSlots(index, boundary);
+            ++m_layoutVersion;
+        }
+    }
+
+    bool ComponentStoreBase::MoveToSlot(EntityID id, std::size_t slot)
+    {
+        auto it = m_sparse.find(id);
+        if (it == m_sparse.end() || slot >= Size())
+            return false;
+
+        const std::size_t index = it->second;
+        if ((index < m_enabledCount) != (slot < m_enabledCount))
+            return false;
+
+        if (index != slot)
+        {
+            SwapSlots(index, slot);
+            ++m_layoutVersion;
+        }
+        return true;
+    }
+
+    void ComponentStoreBase::Remove(EntityID id)
+    {
+        auto it = m_sparse.find(id);
+        if (it == m_sparse.end())
+            return;
+
+        std::size_t hole = it->second;
+        const std::size_t last = Size() - 1;
+        ++m_layoutVersion;
+
+        // An enabled hole is filled from the end of the enabled prefix first,
+        // which moves the hole to the boundary
+        if (hole < m_enabledCount)
+        {
+            const std::size_t boundary = --m_enabledCount;
+            if (hole != boundary)
+                MoveSlot(hole, boundary);
+            hole = boundary;
+        }
+
+        // Move last into the hole (swap-remove)
+        if (hole != last)
+            MoveSlot(hole, last);
+
+        m_column.Truncate(last);
+        m_denseEntities.pop_back();
+        m_addedTicks.pop_back();
+        m_changedTicks.pop_back();
+        m_sparse.erase(it);
+
+        NotifyMask(id, false);
+    }
+
+    void ComponentStoreBase::Clear()
+    {
+        if (m_maskSink.update)
+        {
+            for (EntityID id : m_denseEntities)
+                NotifyMask(id, false);
+        }
+
+        ++m_layoutVersion;
+        m_enabledCount = 0;
+        m_column.Clear();
+        m_denseEntities.clear();
+        m_addedTicks.clear();
+        m_changedTicks.clear();
+        m_sparse.clear();
+    }
+
+    std::size_t ComponentStoreBase::CommitAdd(EntityID id, std::uint64_t stamp)
+    {
+        m_column.CommitBack();
+        m_denseEntities.push_back(id);
+        m_addedTicks.push_back(stamp);
+        m_changedTicks.push_back(stamp);
+
+        // New components are enabled: the first disabled one trades places with it
+        const std::size_t last = Size() - 1;
+        const std::size_t slot = m_enabledCount++;
+        if (slot != last)
+        {
+            SwapSlots(slot, last);
+            ++m_layoutVersion;
+        }
+
+        NotifyMask(id, true);
+        return slot;
+    }
+
+    void ComponentStoreBase::MoveSlot(std::size_t dst, std::size_t src)
+    {
+        m_column.Relocate(dst, src);
+        m_denseEntities[dst] = m_denseEntities[src];
+        m_addedTicks[dst] = m_addedTicks[src];
+        m_changedTicks[dst] = m_changedTicks[src];
+        m_sparse[m_denseEntities[dst]] = dst;
+    }
+
+    void ComponentStoreBase::SwapSlots(std::size_t a, std::size_t b)
+    {
+        m_column.Swap(a, b);
+        std::swap(m_denseEntities[a], m_denseEntities[b]);
+        std::swap(m_addedTicks[a], m_addedTicks[b]);
+        std::swap(m_changedTicks[a], m_changedTicks[b]);
+        m_sparse[m_denseEntities[a]] = a;
+        m_sparse[m_denseEntities[b]] = b;
+    }
+
+    void ComponentStoreBase::Grow(std::size_t extra)
+    {
+        // Geometric growth: per-wave exact reserves would reallocate every wave
+        const std::size_t needed = Size() + extra;
+        if (needed > m_column.Capacity())
+            Reserve(std::max(needed, m_column.Capacity() * 2));
+    }
+
+} // namespace KibakoEngine
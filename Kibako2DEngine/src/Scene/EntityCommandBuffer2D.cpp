@@ -0,0 +1,271 @@
+// Per-thread command recording and batched playback into Scene2D
+#include "KibakoEngine/Scene/EntityCommandBuffer2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "EntityCommands";
+    }
+
+    void EntityCommandBuffer2D::Stream::Clear()
+    {
+        commands.clear();
+        transforms.clear();
+        sprites.clear();
+        names.clear();
+        scripts.clear();
+    }
+
+    EntityCommandBuffer2D::EntityCommandBuffer2D(Scene2D& scene)
+        : m_scene(&scene)
+    {
+    }
+
+    EntityID EntityCommandBuffer2D::CreateEntity(const Transform2D& transform, bool active)
+    {
+        const EntityID id = m_scene->ReserveEntityID();
+
+        Stream& stream = LocalStream();
+        Command& cmd = Push(stream, CommandType::Create, id);
+        cmd.flag = active;
+        cmd.payload = static_cast<std::uint32_t>(stream.transforms.size());
+        stream.transforms.push_back(transform);
+        return id;
+    }
+
+    void EntityCommandBuffer2D::DestroyEntity(EntityID id)
+    {
+        Push(LocalStream(), CommandType::Destroy, id);
+    }
+
+    void EntityCommandBuffer2D::SetTransform(EntityID id, const Transform2D& transform)
+    {
+        Stream& stream = LocalStream();
+        Command& cmd = Push(stream, CommandType::SetTransform, id);
+        cmd.payload = static_cast<std::uint32_t>(stream.transforms.size());
+        stream.transforms.push_back(transform);
+    }
+
+    void EntityCommandBuffer2D::SetActive(EntityID id, bool active)
+    {
+        Push(LocalStream(), CommandType::SetActive, id).flag = active;
+    }
+
+    void EntityCommandBuffer2D::SetParent(EntityID child, EntityID parent, bool keepWorld)
+    {
+        Command& cmd = Push(LocalStream(), CommandType::SetParent, child);
+        cmd.other = parent;
+        cmd.flag = keepWorld;
+    }
+
+    void EntityCommandBuffer2D::AddSprite(EntityID id, SpriteRenderer2D sprite)
+    {
+        Stream& stream = LocalStream();
+        Command& cmd = Push(stream, CommandType::AddSprite, id);
+        cmd.payload = static_cast<std::uint32_t>(stream.sprites.size());
+        stream.sprites.push_back(std::move(sprite));
+    }
+
+    void EntityCommandBuffer2D::RemoveSprite(EntityID id)
+    {
+        Push(LocalStream(), CommandType::RemoveSprite, id);
+    }
+
+    void EntityCommandBuffer2D::AddName(EntityID id, std::string name)
+    {
+        Stream& stream = LocalStream();
+        Command& cmd = Push(stream, CommandType::AddName, id);
+        cmd.payload = static_cast<std::uint32_t>(stream.names.size());
+        stream.names.push_back(std::move(name));
+    }
+
+    void EntityCommandBuffer2D::AddScript(EntityID id, ScriptComponent script)
+    {
+        Stream& stream = LocalStream();
+        Command& cmd = Push(stream, CommandType::AddScript, id);
+        cmd.payload = static_cast<std::uint32_t>(stream.scripts.size());
+        stream.scripts.push_back(std::move(script));
+    }
+
+    void EntityCommandBuffer2D::RemoveScript(EntityID id)
+    {
+        Push(LocalStream(), CommandType::RemoveScript, id);
+    }
+
+    void EntityCommandBuffer2D::AddCircleCollider(EntityID id, float radius, bool active)
+    {
+        Command& cmd = Push(LocalStream(), CommandType::AddCircleCollider, id);
+        cmd.a = radius;
+        cmd.flag = active;
+    }
+
+    void EntityCommandBuffer2D::AddAABBCollider(EntityID id, float halfW, float halfH, bool active)
+    {
+        Command& cmd = Push(LocalStream(), CommandType::AddAABBCollider, id);
+        cmd.a = halfW;
+        cmd.b = halfH;
+        cmd.flag = active;
+    }
+
+    void EntityCommandBuffer2D::RemoveCollider(EntityID id)
+    {
+        Push(LocalStream(), CommandType::RemoveCollider, id);
+    }
+
+    std::size_t EntityCommandBuffer2D::CommandCount() const
+    {
+        std::size_t count = 0;
+        for (const auto& stream : m_streams) {
+            if (stream)
+                count += stream->commands.size();
+        }
+        return count;
+    }
+
+    void EntityCommandBuffer2D::Playback()
+    {
+        KBK_PROFILE_SCOPE("EntityCommands.Playback");
+
+        m_destroyed.clear();
+        m_creates.clear();
+
+        for (const auto& stream : m_streams) {
+            if (!stream)
+                continue;
+
+            for (const Command& cmd : stream->commands) {
+                if (cmd.type == CommandType::Destroy)
+                    m_destroyed.push_back(cmd.id);
+                else if (cmd.type == CommandType::Create)
+                    m_creates.emplace_back(stream.get(), &cmd);
+            }
+        }
+
+        std::sort(m_destroyed.begin(), m_destroyed.end());
+        m_destroyed.erase(std::unique(m_destroyed.begin(), m_destroyed.end()), m_destroyed.end());
+
+        // 1) Creations, in ID order so playback does not depend on which worker ran what
+        std::sort(m_creates.begin(), m_creates.end(),
+            [](const auto& a, const auto& b) { return a.second->id < b.second->id; });
+
+        for (const auto& [stream, cmd] : m_creates) {
+            if (IsDestroyed(cmd->id))
+                continue; // created and destroyed in the same frame: never materialised
+
+            (void)m_scene->CreateEntityWithID(cmd->id);
+            // Through SetTransform so the culling bounds and change stamp follow
+            m_scene->SetTransform(cmd->id, stream->transforms[cmd->payload]);
+            m_scene->SetActive(cmd->id, cmd->flag);
+        }
+
+        // 2) Edits, record order within each thread
+        for (const auto& stream : m_streams) {
+            if (!stream)
+                continue;
+
+            for (const Command& cmd : stream->commands) {
+                if (cmd.type == CommandType::Create || cmd.type == CommandType::Destroy)
+                    continue;
+                if (IsDestroyed(cmd.id))
+                    continue;
+
+                ApplyEdit(*stream, cmd);
+            }
+        }
+
+        // 3) Destructions in one batch (compacted in bulk, swap-removed when few)
+        if (!m_destroyed.empty())
+            m_scene->DestroyEntities(m_destroyed);
+
+        Discard();
+    }
+
+    void EntityCommandBuffer2D::Discard()
+    {
+        for (const auto& stream : m_streams) {
+            if (stream)
+                stream->Clear();
+        }
+        m_creates.clear();
+    }
+
+    EntityCommandBuffer2D::Stream& EntityCommandBuffer2D::LocalStream()
+    {
+        const std::uint32_t index = JobSystem::CurrentThreadIndex();
+        KBK_ASSERT(index < m_streams.size(), "Thread index out of range");
+
+        std::unique_ptr<Stream>& stream = m_streams[index];
+        if (!stream)
+            stream = std::make_unique<Stream>();
+        return *stream;
+    }
+
+    EntityCommandBuffer2D::Command& EntityCommandBuffer2D::Push(Stream& stream, CommandType type, EntityID id)
+    {
+        Command& cmd = stream.commands.emplace_back();
+        cmd.type = type;
+        cmd.id = id;
+        return cmd;
+    }
+
+    void EntityCommandBuffer2D::ApplyEdit(Stream& stream, const Command& cmd)
+    {
+        if (!m_scene->FindEntity(cmd.id)) {
+            KbkWarn(kLogChannel, "Dropping command for unknown entity %u", cmd.id);
+            return;
+        }
+
+        switch (cmd.type) {
+        case CommandType::SetTransform:
+            m_scene->SetTransform(cmd.id, stream.transforms[cmd.payload]); // marks it dirty
+            break;
+        case CommandType::SetActive:
+            m_scene->SetActive(cmd.id, cmd.flag);
+            break;
+        case CommandType::SetParent:
+            m_scene->SetParent(cmd.id, cmd.other, cmd.flag);
+            break;
+        case CommandType::AddSprite:
+            m_scene->AddSprite(cmd.id) = std::move(stream.sprites[cmd.payload]);
+            break;
+        case CommandType::RemoveSprite:
+            m_scene->RemoveSprite(cmd.id);
+            break;
+        case CommandType::AddName:
+            m_scene->AddName(cmd.id, stream.names[cmd.payload]);
+            break;
+        case CommandType::AddScript:
+            m_scene->AddScript(cmd.id) = std::move(stream.scripts[cmd.payload]);
+            break;
+        case CommandType::RemoveScript:
+            m_scene->RemoveScript(cmd.id);
+            break;
+        case CommandType::AddCircleCollider:
+            m_scene->AddCircleCollider(cmd.id, cmd.a, cmd.flag);
+            break;
+        case CommandType::AddAABBCollider:
+            m_scene->AddAABBCollider(cmd.id, cmd.a, cmd.b, cmd.flag);
+            break;
+        case CommandType::RemoveCollider:
+            m_scene->RemoveCollider(cmd.id);
+            break;
+        case CommandType::Create:
+        case CommandType::Destroy:
+            break;
+        }
+    }
+
+    bool EntityCommandBuffer2D::IsDestroyed(EntityID id) const
+    {
+        return std::binary_search(m_destroyed.begin(), m_destroyed.end(), id);
+    }
+
+} // namespace KibakoEngine
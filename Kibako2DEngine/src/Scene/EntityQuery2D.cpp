@@ -0,0 +1,140 @@
+// Incremental membership merge and slot caching for persistent queries
+#include "KibakoEngine/Scene/EntityQuery2D.h"
+
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "EntityQuery2D";
+    }
+
+    EntityQuery2D::EntityQuery2D(Scene2D& scene, const SignatureQuery& filter, bool activeOnly)
+        : m_scene(&scene)
+        , m_filter(filter)
+        , m_activeOnly(activeOnly)
+    {
+        Rebuild();
+    }
+
+    void EntityQuery2D::Rebuild()
+    {
+        m_members.clear();
+        m_dirty.clear();
+
+        const std::vector<Entity2D>& entities = m_scene->m_entities;
+        const std::vector<EntitySignature>& signatures = m_scene->m_signatures;
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            if (Wants(&signatures[i], entities[i].active))
+                m_members.push_back(entities[i].id);
+        }
+
+        std::sort(m_members.begin(), m_members.end());
+        ++m_membersVersion;
+    }
+
+    void EntityQuery2D::Flush()
+    {
+        if (m_dirty.empty())
+            return;
+
+        KBK_PROFILE_SCOPE("EntityQuery2D.Flush");
+
+        std::sort(m_dirty.begin(), m_dirty.end());
+        m_dirty.erase(std::unique(m_dirty.begin(), m_dirty.end()), m_dirty.end());
+
+        // One merge pass: members untouched by the dirty set are copied through,
+        // dirty entities are re-evaluated against the scene's current state
+        m_mergeScratch.clear();
+        m_mergeScratch.reserve(m_members.size() + m_dirty.size());
+
+        std::size_t m = 0;
+        for (EntityID id : m_dirty) {
+            while (m < m_members.size() && m_members[m] < id)
+                m_mergeScratch.push_back(m_members[m++]);
+            if (m < m_members.size() && m_members[m] == id)
+                ++m;
+
+            const auto it = m_scene->m_entityIndex.find(id);
+            if (it != m_scene->m_entityIndex.end() &&
+                Wants(&m_scene->m_signatures[it->second], m_scene->m_entities[it->second].active)) {
+                m_mergeScratch.push_back(id);
+            }
+        }
+        m_mergeScratch.insert(m_mergeScratch.end(), m_members.begin() + static_cast<std::ptrdiff_t>(m), m_members.end());
+
+        m_members.swap(m_mergeScratch);
+        m_dirty.clear();
+        ++m_membersVersion;
+    }
+
+    void EntityQuery2D::RefreshEntitySlots()
+    {
+        const std::uint64_t layout = m_scene->m_entityLayoutVersion;
+        if (m_entitySlots.valid && m_entitySlots.layoutVersion == layout &&
+            m_entitySlots.membersVersion == m_membersVersion) {
+            return;
+        }
+
+        m_entitySlots.slots.resize(m_members.size());
+        for (std::size_t i = 0; i < m_members.size(); ++i)
+            m_entitySlots.slots[i] = static_cast<std::uint32_t>(m_scene->m_entityIndex.find(m_members[i])->second);
+
+        m_entitySlots.valid = true;
+        m_entitySlots.layoutVersion = layout;
+        m_entitySlots.membersVersion = m_membersVersion;
+    }
+
+    bool EntityQuery2D::RequireComponent(ComponentTypeId type)
+    {
+        // Every member of the filter has the component, so its store exists once
+        // there are members; for any other type neither is guaranteed
+        const bool inFilter = (m_filter.all.components & ComponentBit(type)) != 0;
+        if (!inFilter || type >= m_scene->m_storeTable.size() || !m_scene->m_storeTable[type]) {
+            KBK_ASSERT(false, "EntityQuery2D::ForEach component type is not part of the query filter");
+            if (!m_reportedMisuse) {
+                KbkError(kLogChannel, "ForEach over component type #%u, which is not part of the query filter; "
+                    "the walk is skipped", type);
+                m_reportedMisuse = true;
+            }
+            return false;
+        }
+
+        const ComponentStoreBase& store = *m_scene->m_storeTable[type];
+
+        auto cache = std::find_if(m_componentSlots.begin(), m_componentSlots.end(),
+            [type](const SlotCache& c) { return c.type == type; });
+        if (cache == m_componentSlots.end()) {
+            cache = m_componentSlots.emplace(m_componentSlots.end());
+            cache->type = type;
+        }
+
+        if (cache->valid && cache->layoutVersion == store.LayoutVersion() &&
+            cache->membersVersion == m_membersVersion) {
+            return true;
+        }
+
+        cache->slots.resize(m_members.size());
+        for (std::size_t i = 0; i < m_members.size(); ++i)
+            cache->slots[i] = static_cast<std::uint32_t>(store.IndexOf(m_members[i]));
+
+        cache->valid = true;
+        cache->layoutVersion = store.LayoutVersion();
+        cache->membersVersion = m_membersVersion;
+        return true;
+    }
+
+    const std::uint32_t* EntityQuery2D::ComponentSlots(ComponentTypeId type) const
+    {
+        for (const SlotCache& cache : m_componentSlots) {
+            if (cache.type == type)
+                return cache.slots.data();
+        }
+        return nullptr;
+    }
+
+} // namespace KibakoEngine
@@ -0,0 +1,25 @@
+// Tag type ID allocation
+#include "KibakoEngine/Scene/EntitySignature.h"
+
+#include "KibakoEngine/Core/Log.h"
+
+#include <atomic>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Components";
+
+        std::atomic<TagTypeId> g_nextTagType{ 0 };
+    }
+
+    TagTypeId AllocateTagTypeId()
+    {
+        const TagTypeId id = g_nextTagType.fetch_add(1, std::memory_order_relaxed);
+        if (id >= kMaxTagTypes)
+            KbkError(kLogChannel, "Tag type #%u exceeds kMaxTagTypes (%u): it has no signature bit", id, kMaxTagTypes);
+        return id;
+    }
+
+} // namespace KibakoEngine
@@ -1,14 +1,25 @@
 // Stores and renders collections of 2D entities (Phase 3A)
 #include "KibakoEngine/Scene/Scene2D.h"
+#include "KibakoEngine/Scene/EntityQuery2D.h"
 
 #include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/GameServices.h"
+#include "KibakoEngine/Core/JobSystem.h"
 #include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
 #include "KibakoEngine/Renderer/SpriteBatch2D.h"
 #include "KibakoEngine/Renderer/DebugDraw2D.h"
+#include "KibakoEngine/Renderer/LightGrid2D.h"
+#include "KibakoEngine/Renderer/RenderView2D.h"
+#include "KibakoEngine/Renderer/ViewFrustum2D.h"
 #include "KibakoEngine/Resources/AssetManager.h"
+#include "KibakoEngine/Utils/Math.h"
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <system_error>
@@ -19,6 +30,15 @@ namespace KibakoEngine {
     {
         constexpr const char* kLogChannel = "Scene2D";
 
+        // DestroyEntities compacts everything only for batches of at least
+        // 1/kBulkDestroyDivisor of the entities; smaller ones swap-remove
+        constexpr std::size_t kBulkDestroyDivisor = 16;
+
+#if KBK_DEBUG_BUILD
+        // Sprites whose culling bounds are re-derived per FlushDirtyBounds
+        constexpr std::size_t kBoundsChecksPerFlush = 4;
+#endif
+
         std::string ReadAllText(const char* path)
         {
             if (!path || path[0] == '\0')
@@ -80,11 +100,162 @@ namespace KibakoEngine {
             };
         }
 
+        BlendMode ReadBlendMode(const std::string& text, BlendMode def)
+        {
+            if (text == "alpha")
+                return BlendMode::Alpha;
+            if (text == "additive")
+                return BlendMode::Additive;
+            if (text == "multiply")
+                return BlendMode::Multiply;
+            if (text == "premultiplied")
+                return BlendMode::Premultiplied;
+            return def;
+        }
+
+        SpriteOpacity ReadSpriteOpacity(const std::string& text, SpriteOpacity def)
+        {
+            if (text == "translucent")
+                return SpriteOpacity::Translucent;
+            if (text == "opaque")
+                return SpriteOpacity::Opaque;
+            if (text == "alphaTested")
+                return SpriteOpacity::AlphaTested;
+            return def;
+        }
+
+        SpriteDrawMode ReadSpriteDrawMode(const std::string& text, SpriteDrawMode def)
+        {
+            if (text == "simple")
+                return SpriteDrawMode::Simple;
+            if (text == "nineSlice")
+                return SpriteDrawMode::NineSlice;
+            if (text == "tiled")
+                return SpriteDrawMode::Tiled;
+            return def;
+        }
+
         bool IsFiniteFloat(float v)
         {
             return std::isfinite(v);
         }
 
+        // World-space quad of a sprite, matching how SpriteBatch2D expands it
+        OrientedRect2D SpriteBounds(const Transform2D& t, const SpriteRenderer2D& spr)
+        {
+            const float halfW = std::fabs(spr.dst.w * t.scale.x) * 0.5f;
+            const float halfH = std::fabs(spr.dst.h * t.scale.y) * 0.5f;
+            return OrientedRect2D::FromRotation(t.position, { halfW, halfH }, t.rotation);
+        }
+
+#if KBK_DEBUG_BUILD
+        // Hierarchy propagation and CombineTransforms round differently
+        bool NearlyEqualRect(const RectF& a, const RectF& b)
+        {
+            const auto closeEnough = [](float x, float y) {
+                return std::fabs(x - y) <= 0.01f + 1e-4f * std::max(std::fabs(x), std::fabs(y));
+            };
+            return closeEnough(a.x, b.x) && closeEnough(a.y, b.y) && closeEnough(a.w, b.w) && closeEnough(a.h, b.h);
+        }
+#endif
+
+        ExtractedSprite2D ExtractSprite(const Transform2D& t, const SpriteRenderer2D& spr)
+        {
+            const float w = spr.dst.w * t.scale.x;
+            const float h = spr.dst.h * t.scale.y;
+
+            ExtractedSprite2D out;
+            out.texture = spr.texture;
+            out.dst.w = w;
+            out.dst.h = h;
+            out.dst.x = t.position.x - (w * 0.5f);
+            out.dst.y = t.position.y - (h * 0.5f);
+            out.src = spr.src;
+            out.color = spr.color;
+            out.rotation = t.rotation;
+            out.layer = spr.layer;
+            out.blend = spr.blend;
+            out.opacity = spr.opacity;
+            out.mode = spr.mode;
+            out.slices = spr.slices;
+            out.tileSize = spr.tileSize;
+            return out;
+        }
+
+        void PushSprite(SpriteBatch2D& batch, const Transform2D& t, const SpriteRenderer2D& spr)
+        {
+            SubmitExtractedSprite(batch, ExtractSprite(t, spr));
+        }
+
+        constexpr float kMaxTilemapSide = 16384.0f; // tiles per side accepted from scene files
+
+        TileIndex ReadTileIndex(const nlohmann::json& value)
+        {
+            if (!value.is_number_integer())
+                return kEmptyTile;
+            const std::int64_t tile = value.get<std::int64_t>();
+            return (tile < 0 || tile >= kEmptyTile) ? kEmptyTile : static_cast<TileIndex>(tile);
+        }
+
+        void ReadTilemap(const nlohmann::json& m, TilemapComponent2D& map)
+        {
+            if (auto itTex = m.find("texture"); itTex != m.end() && itTex->is_object()) {
+                const auto& tex = *itTex;
+
+                if (auto it = tex.find("id"); it != tex.end() && it->is_string())
+                    map.textureId = it->get<std::string>();
+
+                if (auto it = tex.find("path"); it != tex.end() && it->is_string())
+                    map.texturePath = it->get<std::string>();
+
+                if (auto it = tex.find("sRGB"); it != tex.end() && it->is_boolean())
+                    map.textureSRGB = it->get<bool>();
+            }
+
+            if (auto it = m.find("atlas"); it != m.end()) {
+                const DirectX::XMFLOAT2 grid = ReadVec2(*it, 1.0f, 1.0f);
+                map.SetAtlasGrid(static_cast<std::int32_t>(std::clamp(grid.x, 1.0f, 65535.0f)),
+                    static_cast<std::int32_t>(std::clamp(grid.y, 1.0f, 65535.0f)));
+            }
+
+            if (auto it = m.find("tileSize"); it != m.end()) {
+                const DirectX::XMFLOAT2 size = ReadVec2(*it, map.TileWidth(), map.TileHeight());
+                if (size.x > 0.0f && size.y > 0.0f)
+                    map.SetTileSize(size.x, size.y);
+            }
+
+            if (auto it = m.find("color"); it != m.end())
+                map.SetColor(ReadColor4(*it, map.Color()));
+
+            if (auto it = m.find("layer"); it != m.end() && it->is_number_integer())
+                map.layer = it->get<int>();
+
+            if (auto it = m.find("size"); it != m.end()) {
+                const DirectX::XMFLOAT2 size = ReadVec2(*it, 0.0f, 0.0f);
+                map.Resize(static_cast<std::int32_t>(std::clamp(size.x, 0.0f, kMaxTilemapSide)),
+                    static_cast<std::int32_t>(std::clamp(size.y, 0.0f, kMaxTilemapSide)));
+            }
+
+            if (auto it = m.find("fill"); it != m.end())
+                map.Fill(0, 0, map.Width(), map.Height(), ReadTileIndex(*it));
+
+            auto itTiles = m.find("tiles");
+            if (itTiles == m.end() || !itTiles->is_array())
+                return;
+
+            const std::size_t expected = map.Tiles().size();
+            if (itTiles->size() != expected) {
+                KbkWarn(kLogChannel, "LoadFromFile: tilemap has %zu tiles, expected %zu", itTiles->size(), expected);
+                return;
+            }
+
+            std::vector<TileIndex> tiles;
+            tiles.reserve(expected);
+            for (const auto& value : *itTiles)
+                tiles.push_back(ReadTileIndex(value));
+            map.SetTiles(tiles);
+        }
+
         // Reads a generic script params object into ScriptComponent::params.
         // Supported param types: bool, int, float, string. Others are ignored safely.
         void ReadScriptParams(const nlohmann::json& paramsObj, ScriptComponent& outScript)
@@ -121,6 +292,123 @@ namespace KibakoEngine {
 
     // ------------------------------------------------------------------------
 
+    Scene2D::~Scene2D() = default;
+
+    Scene2D::Scene2D()
+    {
+        RegisterStore(m_sprites);
+        RegisterStore(m_collisions);
+        RegisterStore(m_names);
+        RegisterStore(m_scripts);
+    }
+
+    void Scene2D::RegisterStore(ComponentStoreBase& store)
+    {
+        const ComponentTypeId type = store.TypeId();
+
+        if (type >= m_storeTable.size())
+            m_storeTable.resize(type + 1, nullptr);
+        KBK_ASSERT(m_storeTable[type] == nullptr, "Component store registered twice");
+
+        m_storeTable[type] = &store;
+        store.SetClock(&m_changeClock);
+        // Past the signature's width the store still holds values, but entities
+        // never show the type (AllocateComponentTypeId already logged it)
+        if (ComponentBit(type) != 0)
+            store.SetMaskSink(ComponentMaskSink{ this, &Scene2D::OnComponentMaskChanged });
+    }
+
+    void Scene2D::OnComponentMaskChanged(void* owner, EntityID id, ComponentTypeId type, bool present)
+    {
+        Scene2D& scene = *static_cast<Scene2D*>(owner);
+
+        // Entities being destroyed are already out of the index: nothing to patch
+        const auto it = scene.m_entityIndex.find(id);
+        if (it == scene.m_entityIndex.end())
+            return;
+
+        EntitySignature& sig = scene.m_signatures[it->second];
+        const EntitySignature before = sig;
+
+        const std::uint64_t bit = ComponentBit(type);
+        sig.components = present ? (sig.components | bit) : (sig.components & ~bit);
+
+        const bool active = scene.m_entities[it->second].active;
+        scene.NotifyQueries(id, &before, active, &sig, active);
+    }
+
+    EntitySignature Scene2D::Signature(EntityID id) const
+    {
+        const auto it = m_entityIndex.find(id);
+        return (it == m_entityIndex.end()) ? EntitySignature{} : m_signatures[it->second];
+    }
+
+    bool Scene2D::Matches(EntityID id, const SignatureQuery& query) const
+    {
+        const auto it = m_entityIndex.find(id);
+        return it != m_entityIndex.end() && query.Matches(m_signatures[it->second]);
+    }
+
+    void Scene2D::SetTag(EntityID id, TagTypeId tag, bool present)
+    {
+        const auto it = m_entityIndex.find(id);
+        if (it == m_entityIndex.end())
+            return;
+
+        EntitySignature& sig = m_signatures[it->second];
+        const EntitySignature before = sig;
+
+        const std::uint64_t bit = TagBit(tag);
+        if (bit == 0)
+            return; // past kMaxTagTypes, logged when the ID was handed out
+
+        sig.tags = present ? (sig.tags | bit) : (sig.tags & ~bit);
+
+        const bool active = m_entities[it->second].active;
+        NotifyQueries(id, &before, active, &sig, active);
+    }
+
+    void Scene2D::SetActive(EntityID id, bool active)
+    {
+        const auto it = m_entityIndex.find(id);
+        if (it == m_entityIndex.end())
+            return;
+
+        const std::size_t index = it->second;
+        if ((index < m_activeCount) == active)
+            return;
+
+        // Trade places with the first inactive (enable) or last active (disable) entity
+        const std::size_t boundary = active ? m_activeCount++ : --m_activeCount;
+        if (index != boundary)
+            SwapEntitySlots(index, boundary);
+
+        m_entities[boundary].active = active;
+        const EntitySignature& sig = m_signatures[boundary];
+        NotifyQueries(id, &sig, !active, &sig, active);
+    }
+
+    EntityQuery2D& Scene2D::CreateQuery(const SignatureQuery& filter, bool activeOnly)
+    {
+        // EntityQuery2D's constructor is private to the scene
+        m_queries.push_back(std::unique_ptr<EntityQuery2D>(new EntityQuery2D(*this, filter, activeOnly)));
+        return *m_queries.back();
+    }
+
+    void Scene2D::DestroyQuery(EntityQuery2D& query)
+    {
+        std::erase_if(m_queries, [&query](const std::unique_ptr<EntityQuery2D>& q) { return q.get() == &query; });
+    }
+
+    void Scene2D::NotifyQueries(EntityID id, const EntitySignature* before, bool beforeActive,
+        const EntitySignature* after, bool afterActive)
+    {
+        for (const std::unique_ptr<EntityQuery2D>& query : m_queries) {
+            if (query->Wants(before, beforeActive) != query->Wants(after, afterActive))
+                query->MarkDirty(id);
+        }
+    }
+
     void Scene2D::BumpRevision()
     {
         ++m_revision;
@@ -132,11 +420,21 @@ namespace KibakoEngine {
     {
         const std::size_t index = m_entities.size();
         Entity2D& e = m_entities.emplace_back();
-        e.id = m_nextID++;
+        e.id = m_nextID.fetch_add(1, std::memory_order_relaxed);
         e.active = true;
+        e.changeTick = m_changeClock.Next();
+        m_signatures.emplace_back();
+        m_worldNodes.push_back(TransformHierarchy2D::kNoNode);
         m_entityIndex.emplace(e.id, index);
+        NotifyQueries(e.id, nullptr, false, &m_signatures.back(), true);
+
+        // New entities are active: the first inactive one trades places with it
+        const std::size_t slot = m_activeCount++;
+        if (slot != index)
+            SwapEntitySlots(slot, index);
+
         BumpRevision();
-        return e;
+        return m_entities[slot];
     }
 
     Entity2D& Scene2D::CreateEntityWithID(EntityID forcedId)
@@ -145,13 +443,69 @@ namespace KibakoEngine {
         Entity2D& e = m_entities.emplace_back();
         e.id = forcedId;
         e.active = true;
+        e.changeTick = m_changeClock.Next();
+        m_signatures.emplace_back();
+        m_worldNodes.push_back(TransformHierarchy2D::kNoNode);
         m_entityIndex.emplace(e.id, index);
+        NotifyQueries(e.id, nullptr, false, &m_signatures.back(), true);
+
+        const std::size_t slot = m_activeCount++;
+        if (slot != index)
+            SwapEntitySlots(slot, index);
+
+        EntityID next = m_nextID.load(std::memory_order_relaxed);
+        while (forcedId >= next &&
+            !m_nextID.compare_exchange_weak(next, forcedId + 1, std::memory_order_relaxed)) {
+        }
+
+        BumpRevision();
+        return m_entities[slot];
+    }
+
+    void Scene2D::CreateEntities(std::size_t count, std::span<EntityID> outIds,
+        std::span<const Transform2D> transforms)
+    {
+        KBK_ASSERT(outIds.size() >= count, "CreateEntities: output span too small");
+        KBK_ASSERT(transforms.empty() || transforms.size() == 1 || transforms.size() >= count,
+            "CreateEntities: transform count mismatch");
+
+        count = std::min(count, outIds.size());
+        if (count == 0)
+            return;
+
+        KBK_PROFILE_SCOPE("Scene2D.CreateEntities");
+
+        const EntityID firstId = m_nextID.fetch_add(static_cast<EntityID>(count), std::memory_order_relaxed);
+        const std::uint64_t stamp = m_changeClock.Next();
+
+        const std::size_t base = m_entities.size();
+        if (base + count > m_entities.capacity())
+            m_entities.reserve(std::max(base + count, m_entities.capacity() * 2));
+        m_signatures.resize(base + count);
+        m_worldNodes.resize(base + count, TransformHierarchy2D::kNoNode);
+        m_entityIndex.reserve(base + count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            Entity2D& e = m_entities.emplace_back();
+            e.id = firstId + static_cast<EntityID>(i);
+            e.active = true;
+            e.changeTick = stamp;
+            if (!transforms.empty())
+                e.m_transform = transforms[transforms.size() == 1 ? 0 : i];
+
+            m_entityIndex.emplace(e.id, base + i);
+            NotifyQueries(e.id, nullptr, false, &m_signatures[base + i], true);
+            outIds[i] = e.id;
+        }
 
-        if (forcedId >= m_nextID)
-            m_nextID = forcedId + 1;
+        // Move the wave in front of the inactive entities (at most one swap each)
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t slot = m_activeCount++;
+            if (slot != base + i)
+                SwapEntitySlots(slot, base + i);
+        }
 
         BumpRevision();
-        return e;
     }
 
     void Scene2D::DestroyEntity(EntityID id)
@@ -161,45 +515,158 @@ namespace KibakoEngine {
             return;
 
         const std::size_t index = it->second;
+        NotifyQueries(id, &m_signatures[index], m_entities[index].active, nullptr, false);
         m_entityIndex.erase(it);
 
-        m_entities[index].active = false;
+        std::uint64_t mask = m_signatures[index].components;
 
-        if (const NameComponent* n = m_names.TryGet(id); n && !n->name.empty()) {
-            const auto nameIt = m_nameLookup.find(n->name);
-            if (nameIt != m_nameLookup.end() && nameIt->second == id)
-                m_nameLookup.erase(nameIt);
+        if (m_hierarchy.Contains(id)) {
+            DetachChildrenOf(std::span<const EntityID>(&id, 1));
+            m_hierarchy.Remove(id);
         }
+        ForgetName(id);
 
-        // Remove components for that entity (keeps stores coherent)
-        m_sprites.Remove(id);
-        m_collisions.Remove(id);
-        m_names.Remove(id);
-        m_scripts.Remove(id);
+        // Only the stores that actually hold a component for it
+        while (mask != 0) {
+            const int type = std::countr_zero(mask);
+            mask &= mask - 1;
+            m_storeTable[type]->Remove(id);
+        }
+        m_spatialIndex.Remove(id);
 
         RemoveEntityAtSwapIndex(index);
         BumpRevision();
     }
 
+    void Scene2D::DestroyEntities(std::span<const EntityID> ids)
+    {
+        KBK_PROFILE_SCOPE("Scene2D.DestroyEntities");
+
+        // A swap-remove costs a few hash updates per entity; the compaction below
+        // touches every survivor after the first hole, so it only pays off in bulk
+        if (ids.size() * kBulkDestroyDivisor < m_entities.size()) {
+            for (EntityID id : ids)
+                DestroyEntity(id);
+            return;
+        }
+
+        std::vector<EntityID> doomed;
+        doomed.reserve(ids.size());
+        std::uint64_t storeMask = 0;
+        for (EntityID id : ids) {
+            const auto it = m_entityIndex.find(id);
+            if (it == m_entityIndex.end())
+                continue;
+
+            doomed.push_back(id);
+            storeMask |= m_signatures[it->second].components;
+            NotifyQueries(id, &m_signatures[it->second], m_entities[it->second].active, nullptr, false);
+
+            // Out of the index before the stores drop them, so their mask
+            // updates find nothing to patch (as in DestroyEntity)
+            m_entityIndex.erase(it);
+        }
+        if (doomed.empty())
+            return;
+
+        std::sort(doomed.begin(), doomed.end());
+        doomed.erase(std::unique(doomed.begin(), doomed.end()), doomed.end());
+
+        DetachChildrenOf(doomed);
+        for (EntityID id : doomed) {
+            m_hierarchy.Remove(id);
+            ForgetName(id);
+            m_spatialIndex.Remove(id);
+        }
+
+        const auto isDoomed = [&doomed](EntityID id) {
+            return std::binary_search(doomed.begin(), doomed.end(), id);
+            };
+
+        // One compaction per store that holds any of them
+        while (storeMask != 0) {
+            const int type = std::countr_zero(storeMask);
+            storeMask &= storeMask - 1;
+            m_storeTable[type]->RemoveIf(isDoomed);
+        }
+
+        // Order-preserving compaction: only survivors that actually move get
+        // reindexed, and the active entities stay in front
+        std::size_t write = 0;
+        std::size_t activeCount = 0;
+        for (std::size_t read = 0; read < m_entities.size(); ++read) {
+            const EntityID id = m_entities[read].id;
+            if (isDoomed(id))
+                continue;
+
+            if (read < m_activeCount)
+                ++activeCount;
+
+            if (write != read) {
+                m_entities[write] = std::move(m_entities[read]);
+                m_signatures[write] = m_signatures[read];
+                m_worldNodes[write] = m_worldNodes[read];
+                m_entityIndex[id] = write;
+            }
+            ++write;
+        }
+        m_entities.erase(m_entities.begin() + static_cast<std::ptrdiff_t>(write), m_entities.end());
+        m_signatures.resize(write);
+        m_worldNodes.resize(write);
+        m_activeCount = activeCount;
+        ++m_entityLayoutVersion;
+
+        BumpRevision();
+    }
+
+    EntityID Scene2D::ReserveEntityID()
+    {
+        return m_nextID.fetch_add(1, std::memory_order_relaxed);
+    }
+
     void Scene2D::Clear()
     {
+        // Entities first, so the stores' mask updates have nothing to patch
         m_entities.clear();
-
-        m_sprites.Clear();
-        m_collisions.Clear();
-        m_names.Clear();
-        m_scripts.Clear();
+        m_signatures.clear();
+        m_worldNodes.clear();
+        m_entityIndex.clear();
+        m_activeCount = 0;
+        ++m_entityLayoutVersion;
+        m_reorder.running = false;
+
+        // Custom stores stay registered (and their type IDs valid), just emptied
+        for (ComponentStoreBase* store : m_storeTable) {
+            if (store)
+                store->Clear();
+        }
 
         m_circlePool.clear();
         m_aabbPool.clear();
         m_nameLookup.clear();
-        m_entityIndex.clear();
+
+        for (AnimationClipId clip : m_sceneClips)
+            m_animationClips.Remove(clip);
+        m_sceneClips.clear();
+
+        m_hierarchy.Clear();
+        m_spatialIndex.Clear();
+        m_boundsDirty.clear();
+        m_boundsStamp = 0;
+        m_visibleScratch.clear();
+        m_activeIdOrder = {};
+        m_extractSlots.clear();
+        m_extractTouched.clear();
 
 #if KBK_DEBUG_BUILD
         m_collisionDebugEnabled = false;
 #endif
 
-        m_nextID = 1;
+        // Queries stay registered, just empty
+        for (const std::unique_ptr<EntityQuery2D>& query : m_queries)
+            query->Rebuild();
+
+        m_nextID.store(1, std::memory_order_relaxed);
         BumpRevision();
     }
 
@@ -247,14 +714,269 @@ namespace KibakoEngine {
 
     // ------------------------------------------------------------------------
 
+    void Scene2D::SetTransform(EntityID id, const Transform2D& transform)
+    {
+        Entity2D* entity = FindEntity(id);
+        if (!entity)
+            return;
+
+        entity->m_transform = transform;
+        MarkTransformDirty(id);
+    }
+
+    void Scene2D::MarkTransformDirty(EntityID id)
+    {
+        Entity2D* entity = FindEntity(id);
+        if (!entity)
+            return;
+
+        entity->changeTick = m_changeClock.Next();
+        // The sprite's stamp is what FlushDirtyBounds picks the edit up from
+        m_sprites.MarkChanged(id);
+
+        // Hierarchy nodes report their whole subtree once propagated
+        if (m_hierarchy.Contains(id))
+            m_hierarchy.SetLocal(id, entity->m_transform);
+    }
+
+    void Scene2D::QueueBoundsUpdate(EntityID id) const
+    {
+        // Nothing to keep in step until a culled render has built the index;
+        // its first flush resynchronises every sprite
+        if (m_spatialIndexInUse)
+            m_boundsDirty.push_back(id);
+    }
+
+    bool Scene2D::SetParent(EntityID child, EntityID parent, bool keepWorld)
+    {
+        Entity2D* childEntity = FindEntity(child);
+        const Entity2D* parentEntity = (parent != 0) ? FindEntity(parent) : nullptr;
+        if (!childEntity || child == parent || (parent != 0 && !parentEntity))
+            return false;
+
+        const Transform2D childWorld = WorldTransform(child);
+
+        m_hierarchy.Attach(child, childEntity->m_transform);
+        if (parentEntity && !m_hierarchy.Contains(parent))
+            m_hierarchy.Attach(parent, parentEntity->m_transform);
+
+        if (!m_hierarchy.SetParent(child, parent))
+            return false;
+
+        if (keepWorld) {
+            childEntity->m_transform = parentEntity
+                ? RelativeTransform(WorldTransform(parent), childWorld)
+                : childWorld;
+            m_hierarchy.SetLocal(child, childEntity->m_transform);
+        }
+
+        BumpRevision();
+        return true;
+    }
+
+    EntityID Scene2D::GetParent(EntityID id) const
+    {
+        return m_hierarchy.GetParent(id);
+    }
+
+    void Scene2D::UpdateTransforms(JobSystem* jobs)
+    {
+        SyncHierarchy(jobs);
+        if (!m_hierarchy.Empty() && m_worldNodesVersion != m_hierarchy.LayoutVersion())
+            RefreshWorldNodes();
+        if (m_spatialIndexInUse)
+            FlushDirtyBounds();
+    }
+
+    Transform2D Scene2D::WorldTransform(EntityID id) const
+    {
+        const auto it = m_entityIndex.find(id);
+        if (it == m_entityIndex.end())
+            return {};
+
+        SyncHierarchy(nullptr);
+        return WorldAt(it->second);
+    }
+
+    Transform2D Scene2D::WorldAt(std::size_t slot) const
+    {
+        const Entity2D& entity = m_entities[slot];
+        if (m_hierarchy.Empty())
+            return entity.m_transform;
+
+        if (m_worldNodesVersion != m_hierarchy.LayoutVersion())
+            RefreshWorldNodes();
+        const std::uint32_t node = m_worldNodes[slot];
+        return (node != TransformHierarchy2D::kNoNode) ? m_hierarchy.World(node) : entity.m_transform;
+    }
+
+    void Scene2D::RefreshWorldNodes() const
+    {
+        // Only when hierarchy nodes are added, removed or relaid out; entity
+        // moves carry their node along (m_worldNodes is parallel to m_entities)
+        std::fill(m_worldNodes.begin(), m_worldNodes.end(), TransformHierarchy2D::kNoNode);
+        const std::span<const EntityID> nodes = m_hierarchy.NodeEntities();
+        for (std::uint32_t node = 0; node < static_cast<std::uint32_t>(nodes.size()); ++node) {
+            if (nodes[node] == 0)
+                continue; // removed, compacted on the next rebuild
+            if (const auto it = m_entityIndex.find(nodes[node]); it != m_entityIndex.end())
+                m_worldNodes[it->second] = node;
+        }
+        m_worldNodesVersion = m_hierarchy.LayoutVersion();
+    }
+
+    // ------------------------------------------------------------------------
+
+    bool Scene2D::ReorderSpatially(std::size_t budget, float cellSize)
+    {
+        KBK_PROFILE_SCOPE("Scene2D.ReorderSpatially");
+
+        SpatialReorder& r = m_reorder;
+        if (!r.running) {
+            if (budget == 0 || m_activeCount < 2)
+                return false;
+            BeginSpatialReorder(cellSize);
+        }
+
+        std::size_t work = 0;
+
+        // Phase 1: place the active entities in plan order. Edits made between
+        // calls only cost precision: stale entries are skipped, never misplaced.
+        if (!r.storePhase) {
+            while (work < budget && r.cursor < r.order.size() && r.slot < m_activeCount) {
+                ++work;
+                const auto it = m_entityIndex.find(r.order[r.cursor++]);
+                if (it == m_entityIndex.end() || it->second >= m_activeCount || it->second < r.slot)
+                    continue;
+
+                if (it->second != r.slot)
+                    SwapEntitySlots(r.slot, it->second);
+                ++r.slot;
+            }
+            if (r.cursor < r.order.size() && r.slot < m_activeCount)
+                return false;
+
+            r.storePhase = true;
+            r.store = 0;
+            r.cursor = 0;
+            r.slot = 0;
+        }
+
+        // Phase 2: each store's enabled prefix follows the entity order
+        while (r.store < m_storeTable.size()) {
+            ComponentStoreBase* store = m_storeTable[r.store];
+            while (store && work < budget && r.cursor < m_activeCount && r.slot < store->EnabledCount()) {
+                ++work;
+                const EntityID id = m_entities[r.cursor++].id;
+                const std::size_t index = store->IndexOf(id);
+                if (index == ComponentStoreBase::kNoSlot || index >= store->EnabledCount() || index < r.slot)
+                    continue;
+
+                store->MoveToSlot(id, r.slot);
+                ++r.slot;
+            }
+            if (work >= budget)
+                return false;
+
+            ++r.store;
+            r.cursor = 0;
+            r.slot = 0;
+        }
+
+        // Cache misses cannot be read portably: report how often a spatial walk
+        // leaves the current/adjacent cache line of the entity array instead
+        const float jumpsAfter = EstimateSpatialLineJumps();
+        KBK_PROFILE_COUNTER("Scene2D.SpatialReorder.LineJumpsBefore", r.jumpsBefore);
+        KBK_PROFILE_COUNTER("Scene2D.SpatialReorder.LineJumpsAfter", jumpsAfter);
+        if (r.jumpsBefore > 0.0f)
+            KBK_PROFILE_COUNTER("Scene2D.SpatialReorder.MissReductionPct", 100.0f * (1.0f - jumpsAfter / r.jumpsBefore));
+
+        r.running = false;
+        return true;
+    }
+
+    void Scene2D::BeginSpatialReorder(float cellSize)
+    {
+        SpatialReorder& r = m_reorder;
+        SyncHierarchy(nullptr);
+
+        // Quantise to cells, then flip the sign bit so negative coordinates sort first
+        constexpr float kCoordLimit = 1.0e9f;
+        const float invCell = 1.0f / std::max(cellSize, 1.0e-3f);
+        const auto cellOf = [invCell](float v) {
+            const float c = Math::Clamp(std::floor(v * invCell), -kCoordLimit, kCoordLimit);
+            return static_cast<std::uint32_t>(static_cast<std::int32_t>(c)) ^ 0x80000000u;
+            };
+
+        r.keyed.clear();
+        r.keyed.reserve(m_activeCount);
+        for (std::size_t i = 0; i < m_activeCount; ++i) {
+            const DirectX::XMFLOAT2 p = WorldAt(i).position;
+            r.keyed.emplace_back(Math::MortonEncode2D(cellOf(p.x), cellOf(p.y)), m_entities[i].id);
+        }
+        std::sort(r.keyed.begin(), r.keyed.end());
+
+        r.order.resize(r.keyed.size());
+        for (std::size_t i = 0; i < r.keyed.size(); ++i)
+            r.order[i] = r.keyed[i].second;
+
+        r.cursor = 0;
+        r.slot = 0;
+        r.store = 0;
+        r.storePhase = false;
+        r.running = true;
+        r.jumpsBefore = EstimateSpatialLineJumps();
+    }
+
+    float Scene2D::EstimateSpatialLineJumps() const
+    {
+        constexpr std::size_t kCacheLine = 64;
+        constexpr std::size_t kNoLine = static_cast<std::size_t>(-1);
+
+        std::size_t visited = 0;
+        std::size_t jumps = 0;
+        std::size_t prevLine = kNoLine;
+        for (EntityID id : m_reorder.order) {
+            const auto it = m_entityIndex.find(id);
+            if (it == m_entityIndex.end())
+                continue;
+
+            const std::size_t line = (it->second * sizeof(Entity2D)) / kCacheLine;
+            if (prevLine != kNoLine && line != prevLine && line != prevLine + 1 && line + 1 != prevLine)
+                ++jumps;
+            prevLine = line;
+            ++visited;
+        }
+        return visited ? (1000.0f * static_cast<float>(jumps)) / static_cast<float>(visited) : 0.0f;
+    }
+
+    void Scene2D::SyncHierarchy(JobSystem* jobs) const
+    {
+        if (!m_hierarchy.NeedsPropagate())
+            return;
+
+        m_hierarchy.Propagate(jobs);
+        for (EntityID id : m_hierarchy.Changed()) {
+            if (m_sprites.Has(id))
+                QueueBoundsUpdate(id);
+        }
+    }
+
+    // ------------------------------------------------------------------------
+
     SpriteRenderer2D& Scene2D::AddSprite(EntityID id)
     {
+        QueueBoundsUpdate(id);
         return m_sprites.Add(id);
     }
 
     SpriteRenderer2D* Scene2D::TryGetSprite(EntityID id)
     {
-        return m_sprites.TryGet(id);
+        // Mutable access counts as an edit: the caller may change dst
+        SpriteRenderer2D* sprite = m_sprites.TryGet(id);
+        if (sprite)
+            m_sprites.MarkChanged(id);
+        return sprite;
     }
 
     const SpriteRenderer2D* Scene2D::TryGetSprite(EntityID id) const
@@ -262,6 +984,15 @@ namespace KibakoEngine {
         return m_sprites.TryGet(id);
     }
 
+    void Scene2D::RemoveSprite(EntityID id)
+    {
+        if (!m_sprites.Has(id))
+            return;
+
+        m_sprites.Remove(id);
+        QueueBoundsUpdate(id);
+    }
+
     NameComponent& Scene2D::AddName(EntityID id, const std::string& name)
     {
         NameComponent& n = m_names.Add(id);
@@ -291,6 +1022,74 @@ namespace KibakoEngine {
         return m_names.TryGet(id);
     }
 
+    SpriteAnimator2D& Scene2D::AddAnimator(EntityID id, AnimationClipId clip)
+    {
+        SpriteAnimator2D& animator = Store<SpriteAnimator2D>().Add(id);
+        animator.Play(clip);
+        return animator;
+    }
+
+    SpriteAnimator2D* Scene2D::TryGetAnimator(EntityID id)
+    {
+        return TryStore<SpriteAnimator2D>() ? Store<SpriteAnimator2D>().TryGet(id) : nullptr;
+    }
+
+    const SpriteAnimator2D* Scene2D::TryGetAnimator(EntityID id) const
+    {
+        const ComponentStore<SpriteAnimator2D>* animators = TryStore<SpriteAnimator2D>();
+        return animators ? animators->TryGet(id) : nullptr;
+    }
+
+    void Scene2D::RemoveAnimator(EntityID id)
+    {
+        if (TryStore<SpriteAnimator2D>())
+            Store<SpriteAnimator2D>().Remove(id);
+    }
+
+    TilemapComponent2D& Scene2D::AddTilemap(EntityID id)
+    {
+        return Store<TilemapComponent2D>().Add(id);
+    }
+
+    TilemapComponent2D* Scene2D::TryGetTilemap(EntityID id)
+    {
+        return TryStore<TilemapComponent2D>() ? Store<TilemapComponent2D>().TryGet(id) : nullptr;
+    }
+
+    const TilemapComponent2D* Scene2D::TryGetTilemap(EntityID id) const
+    {
+        const ComponentStore<TilemapComponent2D>* tilemaps = TryStore<TilemapComponent2D>();
+        return tilemaps ? tilemaps->TryGet(id) : nullptr;
+    }
+
+    void Scene2D::RemoveTilemap(EntityID id)
+    {
+        if (TryStore<TilemapComponent2D>())
+            Store<TilemapComponent2D>().Remove(id);
+    }
+
+    PointLight2D& Scene2D::AddLight(EntityID id)
+    {
+        return Store<PointLight2D>().Add(id);
+    }
+
+    PointLight2D* Scene2D::TryGetLight(EntityID id)
+    {
+        return TryStore<PointLight2D>() ? Store<PointLight2D>().TryGet(id) : nullptr;
+    }
+
+    const PointLight2D* Scene2D::TryGetLight(EntityID id) const
+    {
+        const ComponentStore<PointLight2D>* lights = TryStore<PointLight2D>();
+        return lights ? lights->TryGet(id) : nullptr;
+    }
+
+    void Scene2D::RemoveLight(EntityID id)
+    {
+        if (TryStore<PointLight2D>())
+            Store<PointLight2D>().Remove(id);
+    }
+
     ScriptComponent& Scene2D::AddScript(EntityID id)
     {
         return m_scripts.Add(id);
@@ -306,6 +1105,11 @@ namespace KibakoEngine {
         return m_scripts.TryGet(id);
     }
 
+    void Scene2D::RemoveScript(EntityID id)
+    {
+        m_scripts.Remove(id);
+    }
+
     CircleCollider2D* Scene2D::AddCircleCollider(EntityID id, float radius, bool active)
     {
         auto& c = m_circlePool.emplace_back();
@@ -315,6 +1119,7 @@ namespace KibakoEngine {
         auto& comp = m_collisions.Add(id);
         comp.circle = &c;
         comp.aabb = nullptr;
+        m_collisions.SetEnabled(id, active);
 
         return &c;
     }
@@ -329,10 +1134,62 @@ namespace KibakoEngine {
         auto& comp = m_collisions.Add(id);
         comp.aabb = &b;
         comp.circle = nullptr;
+        m_collisions.SetEnabled(id, active);
 
         return &b;
     }
 
+    void Scene2D::SetColliderActive(EntityID id, bool active)
+    {
+        CollisionComponent2D* comp = m_collisions.TryGet(id);
+        if (!comp)
+            return;
+
+        if (comp->circle)
+            comp->circle->active = active;
+        if (comp->aabb)
+            comp->aabb->active = active;
+        m_collisions.SetEnabled(id, active);
+    }
+
+    std::size_t Scene2D::AddCircleColliders(std::span<const EntityID> ids, float radius, bool active)
+    {
+        std::vector<EntityID> fresh;
+        std::vector<CollisionComponent2D> values;
+        fresh.reserve(ids.size());
+        values.reserve(ids.size());
+
+        for (EntityID id : ids) {
+            // Existing components are re-pointed, same as the single-entity call
+            if (m_collisions.Has(id)) {
+                AddCircleCollider(id, radius, active);
+                continue;
+            }
+
+            auto& c = m_circlePool.emplace_back();
+            c.radius = radius;
+            c.active = active;
+
+            CollisionComponent2D& comp = values.emplace_back();
+            comp.circle = &c;
+            comp.aabb = nullptr;
+            fresh.push_back(id);
+        }
+
+        const std::size_t added = m_collisions.AddMany(fresh, values);
+        if (!active) {
+            for (EntityID id : fresh)
+                m_collisions.SetEnabled(id, false);
+        }
+        return added + (ids.size() - fresh.size());
+    }
+
+    void Scene2D::RemoveCollider(EntityID id)
+    {
+        // Pooled shapes stay allocated, like when the entity is destroyed
+        m_collisions.Remove(id);
+    }
+
     // ------------------------------------------------------------------------
 
     void Scene2D::Update(float dt)
@@ -340,6 +1197,83 @@ namespace KibakoEngine {
         KBK_UNUSED(dt);
     }
 
+    void Scene2D::UpdateAnimations(const GameTime& time, JobSystem* jobs)
+    {
+        if (!TryStore<SpriteAnimator2D>())
+            return;
+
+        KBK_PROFILE_SCOPE("Scene2D.UpdateAnimations");
+
+        ComponentStore<SpriteAnimator2D>& animators = Store<SpriteAnimator2D>();
+        const std::span<SpriteAnimator2D> states = animators.Values();
+
+        // Hash lookups only when a store was restructured, not per frame change
+        AnimationSpriteSlots& cache = m_animationSlots;
+        if (!cache.valid || cache.animatorLayout != animators.LayoutVersion() || cache.animatorCount != animators.Size() ||
+            cache.spriteLayout != m_sprites.LayoutVersion() || cache.spriteCount != m_sprites.Size()) {
+            const std::span<const EntityID> owners = animators.Entities();
+            cache.slots.resize(owners.size());
+            for (std::size_t i = 0; i < owners.size(); ++i)
+                cache.slots[i] = static_cast<std::uint32_t>(m_sprites.IndexOf(owners[i]));
+
+            cache.animatorLayout = animators.LayoutVersion();
+            cache.animatorCount = animators.Size();
+            cache.spriteLayout = m_sprites.LayoutVersion();
+            cache.spriteCount = m_sprites.Size();
+            cache.valid = true;
+        }
+
+        const std::span<SpriteRenderer2D> sprites = m_sprites.Values();
+        const std::uint32_t* spriteSlots = cache.slots.data();
+        const float scaledDt = static_cast<float>(time.scaledDeltaSeconds);
+        const float rawDt = static_cast<float>(time.rawDeltaSeconds);
+
+        // Each slot only touches its own animator and its own entity's sprite
+        // (change stamps come from an atomic clock)
+        const auto animate = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                SpriteAnimator2D& state = states[i];
+                const RectF* src = m_animationClips.Advance(state, state.unscaledTime ? rawDt : scaledDt);
+                if (!src)
+                    continue;
+
+                const std::uint32_t slot = spriteSlots[i];
+                if (slot == static_cast<std::uint32_t>(ComponentStoreBase::kNoSlot))
+                    continue;
+
+                sprites[slot].src = *src;
+                m_sprites.MarkChangedAt(slot);
+            }
+            };
+
+        constexpr std::size_t kAnimatorsPerChunk = 4096;
+        if (jobs && states.size() > kAnimatorsPerChunk)
+            jobs->ParallelFor(states.size(), kAnimatorsPerChunk, animate);
+        else
+            animate(0, states.size());
+    }
+
+    void Scene2D::CollectLights(const Camera2D& camera, const RectF& viewport, std::vector<LightInstance2D>& out) const
+    {
+        const ComponentStore<PointLight2D>* lights = TryStore<PointLight2D>();
+        if (!lights)
+            return;
+
+        lights->ForEach([&](EntityID id, const PointLight2D& light) {
+            if (!light.enabled || !(light.radius > 0.0f) || !(light.intensity > 0.0f))
+                return;
+            const auto it = m_entityIndex.find(id);
+            if (it == m_entityIndex.end() || it->second >= m_activeCount)
+                return;
+
+            const DirectX::XMFLOAT3 color{
+                light.color.r * light.intensity,
+                light.color.g * light.intensity,
+                light.color.b * light.intensity };
+            out.push_back(ProjectLight2D(camera, viewport, WorldAt(it->second).position, light.radius, color));
+            });
+    }
+
     void Scene2D::SetCollisionDebugEnabled(bool enabled)
     {
 #if KBK_DEBUG_BUILD
@@ -361,56 +1295,377 @@ namespace KibakoEngine {
     void Scene2D::RemoveEntityAtSwapIndex(std::size_t index)
     {
         const std::size_t last = m_entities.size() - 1;
+
+        // An active hole is filled by the last active entity first, which moves
+        // the hole to the partition boundary
+        if (index < m_activeCount) {
+            const std::size_t boundary = --m_activeCount;
+            if (index != boundary) {
+                m_entities[index] = std::move(m_entities[boundary]);
+                m_signatures[index] = m_signatures[boundary];
+                m_worldNodes[index] = m_worldNodes[boundary];
+                m_entityIndex[m_entities[index].id] = index;
+            }
+            index = boundary;
+        }
+
         if (index != last) {
             m_entities[index] = std::move(m_entities[last]);
+            m_signatures[index] = m_signatures[last];
+            m_worldNodes[index] = m_worldNodes[last];
             m_entityIndex[m_entities[index].id] = index;
         }
         m_entities.pop_back();
+        m_signatures.pop_back();
+        m_worldNodes.pop_back();
+        ++m_entityLayoutVersion;
     }
 
-    void Scene2D::Render(SpriteBatch2D& batch, const RectF* visibleRect) const
+    void Scene2D::SwapEntitySlots(std::size_t a, std::size_t b)
     {
-        auto intersects = [](const RectF& a, const RectF& b) {
-            return a.x < (b.x + b.w) &&
-                (a.x + a.w) > b.x &&
-                a.y < (b.y + b.h) &&
-                (a.y + a.h) > b.y;
-            };
+        std::swap(m_entities[a], m_entities[b]);
+        std::swap(m_signatures[a], m_signatures[b]);
+        std::swap(m_worldNodes[a], m_worldNodes[b]);
+        m_entityIndex[m_entities[a].id] = a;
+        m_entityIndex[m_entities[b].id] = b;
+        ++m_entityLayoutVersion;
+    }
+
+    void Scene2D::DetachChildrenOf(std::span<const EntityID> sortedIds)
+    {
+        if (m_hierarchy.Empty())
+            return;
+
+        SyncHierarchy(nullptr);
+
+        // Gather first: the layout is only valid until the first SetParent
+        std::vector<std::pair<EntityID, Transform2D>> children;
+        for (EntityID id : sortedIds) {
+            m_hierarchy.ForEachChild(id, [&](EntityID child) {
+                if (std::binary_search(sortedIds.begin(), sortedIds.end(), child))
+                    return;
+
+                Transform2D world;
+                if (m_hierarchy.TryGetWorld(child, world))
+                    children.emplace_back(child, world);
+                });
+        }
 
-        for (const Entity2D& entity : m_entities) {
-            if (!entity.active)
+        for (const auto& [child, world] : children) {
+            Entity2D* childEntity = FindEntity(child);
+            if (!childEntity)
                 continue;
 
+            childEntity->m_transform = world;
+            m_hierarchy.SetParent(child, 0);
+            m_hierarchy.SetLocal(child, world);
+        }
+    }
+
+    void Scene2D::ForgetName(EntityID id)
+    {
+        const NameComponent* n = m_names.TryGet(id);
+        if (!n || n->name.empty())
+            return;
+
+        const auto nameIt = m_nameLookup.find(n->name);
+        if (nameIt != m_nameLookup.end() && nameIt->second == id)
+            m_nameLookup.erase(nameIt);
+    }
+
+    void Scene2D::FlushDirtyBounds() const
+    {
+        m_spatialIndexInUse = true;
+        SyncHierarchy(nullptr);
+
+        // Transform and sprite edits stamp the sprite store (SetTransform,
+        // PatchTransform, Patch(), MarkChanged()); everything stamped since the
+        // last flush gets its bounds rebuilt. Only the stamps are scanned.
+        m_sprites.ForEachChanged(m_boundsStamp, [&](EntityID id, const SpriteRenderer2D&) {
+            m_boundsDirty.push_back(id);
+            });
+        m_boundsStamp = m_sprites.ChangeTick();
+
+        // Sprites added/removed straight through Sprites() bypass the dirty list:
+        // resynchronise the whole index in that (rare) case.
+        if (m_spatialIndex.Size() + m_boundsDirty.size() < m_sprites.Size() ||
+            m_spatialIndex.Size() > m_sprites.Size()) {
+            m_spatialIndex.Clear();
+            m_boundsDirty.clear();
+            m_sprites.ForEach([&](EntityID id, const SpriteRenderer2D&) {
+                m_boundsDirty.push_back(id);
+                });
+        }
+
+        if (!m_boundsDirty.empty()) {
+            std::sort(m_boundsDirty.begin(), m_boundsDirty.end());
+            m_boundsDirty.erase(std::unique(m_boundsDirty.begin(), m_boundsDirty.end()), m_boundsDirty.end());
+
+            for (EntityID id : m_boundsDirty) {
+                const auto it = m_entityIndex.find(id);
+                const SpriteRenderer2D* spr = m_sprites.TryGet(id);
+                if (it == m_entityIndex.end() || !spr) {
+                    m_spatialIndex.Remove(id);
+                    continue;
+                }
+
+                m_spatialIndex.Update(id, SpriteBounds(WorldAt(it->second), *spr).BoundingRect());
+            }
+
+            m_boundsDirty.clear();
+        }
+
+#if KBK_DEBUG_BUILD
+        ValidateSampledBounds();
+#endif
+    }
+
+#if KBK_DEBUG_BUILD
+    void Scene2D::ValidateSampledBounds() const
+    {
+        // Transforms are only written through the scene, but a sprite's dst can
+        // still be edited through a raw store pointer without a stamp. Bounds are
+        // rebuilt here from the entity's own transform (through its parent's
+        // world, not the hierarchy's copy of it) and compared with the grid.
+        if (m_entities.empty())
+            return;
+
+        const std::size_t samples = std::min(kBoundsChecksPerFlush, m_entities.size());
+        for (std::size_t n = 0; n < samples; ++n) {
+            if (m_boundsCheckCursor >= m_entities.size())
+                m_boundsCheckCursor = 0;
+            const Entity2D& entity = m_entities[m_boundsCheckCursor++];
+
             const SpriteRenderer2D* spr = m_sprites.TryGet(entity.id);
+            RectF indexed{};
+            if (!spr || !m_spatialIndex.TryGetBounds(entity.id, indexed))
+                continue;
+
+            Transform2D world = entity.m_transform;
+            Transform2D parentWorld;
+            if (const EntityID parent = m_hierarchy.GetParent(entity.id); parent != 0 &&
+                m_hierarchy.TryGetWorld(parent, parentWorld)) {
+                world = CombineTransforms(parentWorld, entity.m_transform);
+            }
+
+            const RectF expected = SpriteBounds(world, *spr).BoundingRect();
+            if (!NearlyEqualRect(indexed, expected)) {
+                KbkError(kLogChannel,
+                    "Entity %u: culling bounds (%.2f, %.2f, %.2f, %.2f) are stale, expected (%.2f, %.2f, %.2f, %.2f)",
+                    entity.id, indexed.x, indexed.y, indexed.w, indexed.h, expected.x, expected.y, expected.w, expected.h);
+                KBK_ASSERT(false, "SpriteRenderer2D::dst edited in place without MarkChanged/MarkTransformDirty");
+            }
+        }
+    }
+#endif
+
+    void Scene2D::Render(SpriteBatch2D& batch, const RectF* visibleRect) const
+    {
+        if (visibleRect) {
+            Render(batch, ViewFrustum2D::FromRect(*visibleRect));
+            return;
+        }
+
+        // Keeps the index current for the culled paths if any of them uses it,
+        // and the dirty list from growing between culled renders
+        if (m_spatialIndexInUse)
+            FlushDirtyBounds();
+        else
+            SyncHierarchy(nullptr);
+        RenderTilemaps(batch, nullptr);
+
+        // Walked in EntityID order, so nothing needs sorting per frame
+        RefreshActiveIdOrder();
+        const ActiveIdOrder& order = m_activeIdOrder;
+        for (std::size_t i = 0; i < order.ids.size(); ++i) {
+            const SpriteRenderer2D* spr = m_sprites.TryGet(order.ids[i]);
             if (!spr || !spr->texture || !spr->texture->IsValid())
                 continue;
 
-            const RectF& local = spr->dst;
-            const Transform2D& t = entity.transform;
+            PushSprite(batch, WorldAt(order.slots[i]), *spr);
+        }
+
+        RenderCollisionDebug(batch);
+    }
+
+    void Scene2D::RefreshActiveIdOrder() const
+    {
+        ActiveIdOrder& order = m_activeIdOrder;
+        if (order.valid && order.layoutVersion == m_entityLayoutVersion && order.ids.size() == m_activeCount)
+            return;
+
+        // Same count and every cached id still active means the same set (ids
+        // are unique): only slots moved, e.g. a ReorderSpatially step
+        bool sameSet = order.valid && order.ids.size() == m_activeCount;
+        for (std::size_t i = 0; sameSet && i < order.ids.size(); ++i) {
+            const auto it = m_entityIndex.find(order.ids[i]);
+            sameSet = it != m_entityIndex.end() && it->second < m_activeCount;
+            if (sameSet)
+                order.slots[i] = static_cast<std::uint32_t>(it->second);
+        }
+
+        if (!sameSet) {
+            order.ids.resize(m_activeCount);
+            for (std::size_t i = 0; i < m_activeCount; ++i)
+                order.ids[i] = m_entities[i].id;
+            std::sort(order.ids.begin(), order.ids.end());
+
+            order.slots.resize(m_activeCount);
+            for (std::size_t i = 0; i < m_activeCount; ++i)
+                order.slots[i] = static_cast<std::uint32_t>(m_entityIndex.find(order.ids[i])->second);
+        }
+
+        order.valid = true;
+        order.layoutVersion = m_entityLayoutVersion;
+    }
+
+    void Scene2D::OrderVisibleByEntityID() const
+    {
+        // IDs never change, so the batch's tie-break on submission order keeps
+        // overlapping same-layer sprites in place while storage is permuted.
+        // A sort costs about n log n of the visible count, a pass over the
+        // cached order the active count: take whichever is smaller.
+        const std::size_t count = m_visibleScratch.size();
+        if (count * static_cast<std::size_t>(std::bit_width(count)) < m_activeCount) {
+            std::sort(m_visibleScratch.begin(), m_visibleScratch.end(),
+                [](const VisibleSprite& a, const VisibleSprite& b) { return a.id < b.id; });
+            return;
+        }
+
+        RefreshActiveIdOrder();
+        m_visibleBySlot.assign(m_activeCount, nullptr);
+        for (const VisibleSprite& visible : m_visibleScratch)
+            m_visibleBySlot[visible.entityIndex] = visible.sprite;
+
+        m_visibleScratch.clear();
+        const ActiveIdOrder& order = m_activeIdOrder;
+        for (std::size_t i = 0; i < order.ids.size(); ++i) {
+            if (const SpriteRenderer2D* spr = m_visibleBySlot[order.slots[i]])
+                m_visibleScratch.push_back({ order.ids[i], order.slots[i], spr });
+        }
+    }
+
+    std::uint32_t Scene2D::CollectVisible(const ViewFrustum2D& frustum, std::uint32_t layerMask) const
+    {
+        m_visibleScratch.clear();
+
+        std::size_t candidates = 0;
+        std::uint32_t rejected = 0;
+        m_spatialIndex.Query(frustum.bounds, [&](EntityID id, const RectF& /*bounds*/) {
+            ++candidates;
+
+            // Inactive entities sit past the partition boundary
+            const auto it = m_entityIndex.find(id);
+            if (it == m_entityIndex.end() || it->second >= m_activeCount)
+                return;
+
+            const SpriteRenderer2D* spr = m_sprites.TryGet(id);
+            if (!spr || !spr->texture || !spr->texture->IsValid())
+                return;
+
+            if ((layerMask & RenderLayerBit(spr->layer)) == 0u)
+                return;
+
+            if (!frustum.Intersects(SpriteBounds(WorldAt(it->second), *spr))) {
+                ++rejected;
+                return;
+            }
+
+            m_visibleScratch.push_back({ id, it->second, spr });
+            });
+
+        // Keep submission order identical to the unculled path (stable layer sorting)
+        OrderVisibleByEntityID();
+
+        // Everything the grid never visited was culled without being touched
+        return rejected + static_cast<std::uint32_t>(m_spatialIndex.Size() - candidates);
+    }
+
+    void Scene2D::Render(SpriteBatch2D& batch, const ViewFrustum2D& frustum) const
+    {
+        FlushDirtyBounds();
+
+        batch.RecordSpritesCulled(CollectVisible(frustum, kAllRenderLayers));
+        RenderTilemaps(batch, &frustum.bounds);
+
+        for (const VisibleSprite& visible : m_visibleScratch)
+            PushSprite(batch, WorldAt(visible.entityIndex), *visible.sprite);
+
+        RenderCollisionDebug(batch);
+    }
+
+    void Scene2D::ExtractVisible(std::span<const RenderView2D> views, SceneVisibility2D& out) const
+    {
+        KBK_PROFILE_SCOPE("SceneExtractVisible");
 
-            const float w = local.w * t.scale.x;
-            const float h = local.h * t.scale.y;
+        out.Reset(views.size());
+        FlushDirtyBounds();
 
-            RectF dst{};
-            dst.w = w;
-            dst.h = h;
-            dst.x = t.position.x - (w * 0.5f);
-            dst.y = t.position.y - (h * 0.5f);
+        const ComponentStore<TilemapComponent2D>* tilemaps = TryStore<TilemapComponent2D>();
 
-            if (visibleRect && !intersects(dst, *visibleRect)) {
-                batch.RecordSpriteCulled();
+        // Slots are reset after use, so only the first extraction pays for the fill
+        constexpr std::uint32_t kNoSlot = ~0u;
+        if (m_extractSlots.size() < m_entities.size())
+            m_extractSlots.resize(m_entities.size(), kNoSlot);
+        m_extractTouched.clear();
+
+        for (std::size_t v = 0; v < views.size(); ++v) {
+            const RenderView2D& view = views[v];
+            if (!view.enabled)
                 continue;
+
+            SceneVisibility2D::ViewList& list = out.m_views[v];
+            const ViewFrustum2D frustum = ViewFrustum2D::FromCamera(view.camera);
+            list.culled = CollectVisible(frustum, view.layerMask);
+            list.sprites.reserve(m_visibleScratch.size());
+
+            if (tilemaps) {
+                tilemaps->ForEach([&](EntityID id, const TilemapComponent2D& map) {
+                    const auto it = m_entityIndex.find(id);
+                    if (it == m_entityIndex.end() || it->second >= m_activeCount)
+                        return;
+                    if ((view.layerMask & RenderLayerBit(map.layer)) == 0u)
+                        return;
+
+                    const DirectX::XMFLOAT2 origin = WorldAt(it->second).position;
+                    const RectF local = map.LocalBounds();
+                    if (Overlaps(RectF::FromXYWH(origin.x, origin.y, local.w, local.h), frustum.bounds))
+                        list.tilemaps.push_back({ &map, origin, frustum.bounds });
+                    });
             }
 
-            batch.Push(
-                *spr->texture,
-                dst,
-                spr->src,
-                spr->color,
-                t.rotation,
-                spr->layer);
+            for (const VisibleSprite& visible : m_visibleScratch) {
+                std::uint32_t& slot = m_extractSlots[visible.entityIndex];
+                if (slot == kNoSlot) {
+                    slot = static_cast<std::uint32_t>(out.m_sprites.size());
+                    out.m_sprites.push_back(ExtractSprite(WorldAt(visible.entityIndex), *visible.sprite));
+                    m_extractTouched.push_back(visible.entityIndex);
+                }
+                list.sprites.push_back(slot);
+            }
         }
 
+        for (std::size_t entityIndex : m_extractTouched)
+            m_extractSlots[entityIndex] = kNoSlot;
+    }
+
+    void Scene2D::RenderTilemaps(SpriteBatch2D& batch, const RectF* area) const
+    {
+        const ComponentStore<TilemapComponent2D>* tilemaps = TryStore<TilemapComponent2D>();
+        if (!tilemaps)
+            return;
+
+        tilemaps->ForEach([&](EntityID id, const TilemapComponent2D& map) {
+            const auto it = m_entityIndex.find(id);
+            if (it == m_entityIndex.end() || it->second >= m_activeCount)
+                return;
+
+            map.Render(batch, WorldAt(it->second).position, area);
+            });
+    }
+
+    void Scene2D::RenderCollisionDebug(SpriteBatch2D& batch) const
+    {
 #if KBK_DEBUG_BUILD
         if (!m_collisionDebugEnabled)
             return;
@@ -421,17 +1676,21 @@ namespace KibakoEngine {
         constexpr Color4 kAABBColor = Color4{ 1.0f, 1.0f, 0.0f, 1.0f };
         constexpr Color4 kCrossColor = Color4{ 1.0f, 0.0f, 0.0f, 1.0f };
 
-        for (const Entity2D& entity : m_entities) {
-            if (!entity.active)
-                continue;
+        const RenderQueue2D previousQueue = batch.SetQueue(RenderQueue2D::Debug);
 
-            const CollisionComponent2D* col = m_collisions.TryGet(entity.id);
-            if (!col)
+        // Only enabled colliders; the entity lookup drops those on inactive entities
+        const std::span<const EntityID> owners = m_collisions.EnabledEntities();
+        const std::span<const CollisionComponent2D> colliders = m_collisions.EnabledValues();
+        for (std::size_t i = 0; i < owners.size(); ++i) {
+            const auto it = m_entityIndex.find(owners[i]);
+            if (it == m_entityIndex.end() || it->second >= m_activeCount)
                 continue;
 
+            const CollisionComponent2D* col = &colliders[i];
+            const Transform2D world = WorldAt(it->second);
             const bool drew = DebugDraw2D::DrawCollisionComponent(
                 batch,
-                entity.transform,
+                world,
                 *col,
                 kCircleColor,
                 kAABBColor,
@@ -442,13 +1701,17 @@ namespace KibakoEngine {
             if (drew) {
                 DebugDraw2D::DrawCross(
                     batch,
-                    entity.transform.position,
+                    world.position,
                     10.0f,
                     kCrossColor,
                     kColliderThickness,
                     kDebugDrawLayer);
             }
         }
+
+        batch.SetQueue(previousQueue);
+#else
+        KBK_UNUSED(batch);
 #endif
     }
 
@@ -478,6 +1741,14 @@ namespace KibakoEngine {
 
         Clear();
 
+        // Clip files first, so entities can name their clips
+        if (auto itAnim = root.find("animations"); itAnim != root.end() && itAnim->is_array()) {
+            for (const auto& file : *itAnim) {
+                if (file.is_string())
+                    m_animationClips.LoadFromFile(file.get<std::string>().c_str(), &m_sceneClips);
+            }
+        }
+
         // entities array validation
         auto itEntities = root.find("entities");
         if (itEntities == root.end() || !itEntities->is_array()) {
@@ -489,6 +1760,8 @@ namespace KibakoEngine {
         const auto& entitiesJson = *itEntities;
 
         m_entities.reserve(entitiesJson.size());
+        m_signatures.reserve(entitiesJson.size());
+        m_worldNodes.reserve(entitiesJson.size());
         m_entityIndex.reserve(entitiesJson.size());
 
         m_sprites.Reserve(entitiesJson.size());
@@ -498,6 +1771,9 @@ namespace KibakoEngine {
 
         m_nameLookup.reserve(entitiesJson.size());
 
+        // Parents may appear after their children: link once everything exists
+        std::vector<std::pair<EntityID, EntityID>> parentLinks;
+
         for (const auto& eJson : entitiesJson)
         {
             if (!eJson.is_object())
@@ -506,7 +1782,7 @@ namespace KibakoEngine {
             EntityID id = eJson.value("id", 0u);
             Entity2D& e = (id != 0) ? CreateEntityWithID(id) : CreateEntity();
 
-            e.active = eJson.value("active", true);
+            SetActive(e.id, eJson.value("active", true));
 
             // name
             if (auto itName = eJson.find("name"); itName != eJson.end() && itName->is_string()) {
@@ -518,15 +1794,18 @@ namespace KibakoEngine {
                 const auto& t = *itT;
 
                 if (auto it = t.find("pos"); it != t.end())
-                    e.transform.position = ReadVec2(*it, 0.0f, 0.0f);
+                    e.m_transform.position = ReadVec2(*it, 0.0f, 0.0f);
 
                 if (auto it = t.find("rot"); it != t.end() && it->is_number())
-                    e.transform.rotation = it->get<float>();
+                    e.m_transform.rotation = it->get<float>();
 
                 if (auto it = t.find("scale"); it != t.end())
-                    e.transform.scale = ReadVec2(*it, 1.0f, 1.0f);
+                    e.m_transform.scale = ReadVec2(*it, 1.0f, 1.0f);
             }
 
+            if (auto itP = eJson.find("parent"); itP != eJson.end() && itP->is_number_unsigned())
+                parentLinks.emplace_back(e.id, itP->get<EntityID>());
+
             // sprite
             if (auto itS = eJson.find("sprite"); itS != eJson.end() && itS->is_object()) {
                 auto& spr = AddSprite(e.id);
@@ -556,6 +1835,54 @@ namespace KibakoEngine {
 
                 if (auto it = s.find("layer"); it != s.end() && it->is_number_integer())
                     spr.layer = it->get<int>();
+
+                if (auto it = s.find("blend"); it != s.end() && it->is_string())
+                    spr.blend = ReadBlendMode(it->get<std::string>(), spr.blend);
+
+                if (auto it = s.find("opacity"); it != s.end() && it->is_string())
+                    spr.opacity = ReadSpriteOpacity(it->get<std::string>(), spr.opacity);
+
+                if (auto it = s.find("mode"); it != s.end() && it->is_string())
+                    spr.mode = ReadSpriteDrawMode(it->get<std::string>(), spr.mode);
+
+                if (auto it = s.find("slices"); it != s.end()) {
+                    const RectF slices = ReadRectF(*it, RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f));
+                    spr.slices = { slices.x, slices.y, slices.w, slices.h };
+                }
+
+                if (auto it = s.find("tileSize"); it != s.end())
+                    spr.tileSize = ReadVec2(*it, 0.0f, 0.0f);
+            }
+
+            // animation (clip by name, from the "animations" clip files)
+            if (auto itA = eJson.find("animation"); itA != eJson.end() && itA->is_object()) {
+                const auto& a = *itA;
+                const std::string clipName = a.value("clip", "");
+                const AnimationClipId clip = m_animationClips.Find(clipName);
+                if (clip == kInvalidAnimationClip)
+                    KbkWarn(kLogChannel, "LoadFromFile: unknown animation clip '%s'", clipName.c_str());
+
+                SpriteAnimator2D& animator = AddAnimator(e.id, clip);
+                animator.time = a.value("time", 0.0f);
+                animator.speed = a.value("speed", 1.0f);
+                animator.playing = a.value("playing", true);
+                animator.unscaledTime = a.value("unscaled", false);
+            }
+
+            // tilemap (one layer per entity; tiles row-major, negative = empty)
+            if (auto itM = eJson.find("tilemap"); itM != eJson.end() && itM->is_object()) {
+                ReadTilemap(*itM, AddTilemap(e.id));
+            }
+
+            // light
+            if (auto itL = eJson.find("light"); itL != eJson.end() && itL->is_object()) {
+                const auto& l = *itL;
+                PointLight2D& light = AddLight(e.id);
+                if (auto it = l.find("color"); it != l.end())
+                    light.color = ReadColor4(*it, light.color);
+                light.intensity = l.value("intensity", light.intensity);
+                light.radius = l.value("radius", light.radius);
+                light.enabled = l.value("enabled", light.enabled);
             }
 
             // collision
@@ -594,6 +1921,11 @@ namespace KibakoEngine {
             }
         }
 
+        for (const auto& [child, parent] : parentLinks) {
+            if (!SetParent(child, parent))
+                KbkWarn(kLogChannel, "LoadFromFile: cannot parent entity %u to %u", child, parent);
+        }
+
         ResolveAssets(assets);
 
         KbkLog(kLogChannel, "Loaded scene '%s' (%zu entities)", path, m_entities.size());
@@ -602,7 +1934,8 @@ namespace KibakoEngine {
 
     void Scene2D::ResolveAssets(AssetManager& assets)
     {
-        m_sprites.ForEach([&](EntityID /*id*/, SpriteRenderer2D& spr) {
+        std::vector<EntityID> resolved;
+        m_sprites.ForEach([&](EntityID id, SpriteRenderer2D& spr) {
 
             if (spr.texture && spr.texture->IsValid())
                 return;
@@ -617,7 +1950,28 @@ namespace KibakoEngine {
                 key,
                 spr.texturePath,
                 spr.textureSRGB);
+            resolved.push_back(id);
             });
+
+        for (EntityID id : resolved)
+            m_sprites.MarkChanged(id);
+
+        if (!TryStore<TilemapComponent2D>())
+            return;
+
+        ComponentStore<TilemapComponent2D>& tilemaps = Store<TilemapComponent2D>();
+        resolved.clear();
+        tilemaps.ForEach([&](EntityID id, TilemapComponent2D& map) {
+            if ((map.texture && map.texture->IsValid()) || map.texturePath.empty())
+                return;
+
+            const std::string& key = map.textureId.empty() ? map.texturePath : map.textureId;
+            map.texture = assets.LoadTexture(key, map.texturePath, map.textureSRGB);
+            resolved.push_back(id);
+            });
+
+        for (EntityID id : resolved)
+            tilemaps.MarkChanged(id);
     }
 
 } // namespace KibakoEngine
\ No newline at end of file
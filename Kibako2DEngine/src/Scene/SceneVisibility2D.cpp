@@ -0,0 +1,58 @@
+// Replays extracted sprites for a single render view
+#include "KibakoEngine/Scene/SceneVisibility2D.h"
+
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+#include "KibakoEngine/Renderer/SpriteShapes2D.h"
+#include "KibakoEngine/Scene/Tilemap2D.h"
+
+namespace KibakoEngine {
+
+    void SubmitExtractedSprite(SpriteBatch2D& batch, const ExtractedSprite2D& sprite)
+    {
+        if (sprite.mode == SpriteDrawMode::Simple) {
+            batch.Push(*sprite.texture, sprite.dst, sprite.src, sprite.color, sprite.rotation, sprite.layer,
+                sprite.blend, sprite.opacity);
+            return;
+        }
+
+        SpriteShapeDesc shape;
+        shape.mode = sprite.mode;
+        shape.dst = sprite.dst;
+        shape.src = sprite.src;
+        shape.color = sprite.color;
+        shape.rotation = sprite.rotation;
+        shape.slices = sprite.slices;
+        shape.tileWidth = sprite.tileSize.x;
+        shape.tileHeight = sprite.tileSize.y;
+        batch.PushSpriteShape(sprite.texture, shape, sprite.layer, sprite.blend, sprite.opacity);
+    }
+
+    void SceneVisibility2D::Reset(std::size_t viewCount)
+    {
+        m_sprites.clear();
+
+        // Keep per-view allocations alive between frames
+        m_views.resize(viewCount);
+        for (ViewList& view : m_views) {
+            view.sprites.clear();
+            view.tilemaps.clear();
+            view.culled = 0;
+        }
+    }
+
+    void SceneVisibility2D::Submit(SpriteBatch2D& batch, std::size_t viewIndex) const
+    {
+        if (viewIndex >= m_views.size())
+            return;
+
+        const ViewList& view = m_views[viewIndex];
+        batch.RecordSpritesCulled(view.culled);
+
+        for (const ExtractedTilemap2D& t : view.tilemaps)
+            t.tilemap->Render(batch, t.origin, &t.area);
+
+        for (std::uint32_t index : view.sprites)
+            SubmitExtractedSprite(batch, m_sprites[index]);
+    }
+
+} // namespace KibakoEngine
@@ -0,0 +1,134 @@
+// Incrementally maintained loose grid of entity bounds
+#include "KibakoEngine/Scene/SpatialGrid2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+
+#include <utility>
+
+namespace KibakoEngine {
+
+    SpatialGrid2D::SpatialGrid2D(float cellSize)
+    {
+        SetCellSize(cellSize);
+    }
+
+    void SpatialGrid2D::SetCellSize(float cellSize)
+    {
+        if (cellSize <= 0.0f)
+            cellSize = 256.0f;
+        if (cellSize == m_cellSize)
+            return;
+
+        m_cellSize = cellSize;
+        m_invCellSize = 1.0f / cellSize;
+
+        // Re-bucket everything with the new cell size
+        m_cells.clear();
+        m_oversized.clear();
+        for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(m_items.size()); ++i) {
+            m_items[i].placement = PlacementFor(m_items[i].bounds);
+            Link(i);
+        }
+    }
+
+    void SpatialGrid2D::Update(EntityID id, const RectF& bounds)
+    {
+        const auto [it, inserted] = m_itemIndex.try_emplace(id, static_cast<std::uint32_t>(m_items.size()));
+        const std::uint32_t itemIndex = it->second;
+
+        if (inserted) {
+            Item& item = m_items.emplace_back();
+            item.id = id;
+            item.bounds = bounds;
+            item.placement = PlacementFor(bounds);
+            Link(itemIndex);
+            return;
+        }
+
+        Item& item = m_items[itemIndex];
+        item.bounds = bounds;
+
+        const Placement placement = PlacementFor(bounds);
+        if (placement == item.placement)
+            return;
+
+        Unlink(itemIndex);
+        item.placement = placement;
+        Link(itemIndex);
+    }
+
+    void SpatialGrid2D::Remove(EntityID id)
+    {
+        const auto it = m_itemIndex.find(id);
+        if (it == m_itemIndex.end())
+            return;
+
+        const std::uint32_t itemIndex = it->second;
+        m_itemIndex.erase(it);
+        Unlink(itemIndex);
+
+        // Swap-remove the item record and patch the moved item's references
+        const std::uint32_t last = static_cast<std::uint32_t>(m_items.size() - 1);
+        if (itemIndex != last) {
+            m_items[itemIndex] = m_items[last];
+
+            const Item& moved = m_items[itemIndex];
+            ListFor(moved.placement)[moved.slot] = itemIndex;
+            m_itemIndex[moved.id] = itemIndex;
+        }
+        m_items.pop_back();
+    }
+
+    void SpatialGrid2D::Clear()
+    {
+        m_items.clear();
+        m_itemIndex.clear();
+        m_cells.clear();
+        m_oversized.clear();
+    }
+
+    SpatialGrid2D::Placement SpatialGrid2D::PlacementFor(const RectF& bounds) const
+    {
+        if (bounds.w > m_cellSize || bounds.h > m_cellSize)
+            return { 0, true };
+
+        const float cx = bounds.x + bounds.w * 0.5f;
+        const float cy = bounds.y + bounds.h * 0.5f;
+        return { MakeKey(CellCoord(cx), CellCoord(cy)), false };
+    }
+
+    std::vector<std::uint32_t>& SpatialGrid2D::ListFor(const Placement& placement)
+    {
+        if (placement.oversized)
+            return m_oversized;
+        return m_cells[placement.cell];
+    }
+
+    void SpatialGrid2D::Link(std::uint32_t itemIndex)
+    {
+        Item& item = m_items[itemIndex];
+        std::vector<std::uint32_t>& list = ListFor(item.placement);
+        item.slot = static_cast<std::uint32_t>(list.size());
+        list.push_back(itemIndex);
+    }
+
+    void SpatialGrid2D::Unlink(std::uint32_t itemIndex)
+    {
+        const Item& item = m_items[itemIndex];
+
+        std::vector<std::uint32_t>& list = ListFor(item.placement);
+        KBK_ASSERT(item.slot < list.size() && list[item.slot] == itemIndex, "SpatialGrid2D slot out of sync");
+
+        const std::uint32_t lastSlot = static_cast<std::uint32_t>(list.size() - 1);
+        if (item.slot != lastSlot) {
+            list[item.slot] = list[lastSlot];
+            m_items[list[item.slot]].slot = item.slot;
+        }
+        list.pop_back();
+
+        // Keep the cell map sparse so range queries only find occupied cells
+        if (list.empty() && !item.placement.oversized)
+            m_cells.erase(item.placement.cell);
+    }
+
+} // namespace KibakoEngine
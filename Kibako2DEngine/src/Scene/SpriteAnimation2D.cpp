@@ -0,0 +1,332 @@
+// Clip storage, clip file loading and frame evaluation for sprite flipbooks
+#include "KibakoEngine/Scene/SpriteAnimation2D.h"
+
+#include "KibakoEngine/Core/Log.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Animation";
+
+        constexpr std::size_t kMaxClipFrames = kNoAnimationFrame; // frame indices are 16-bit
+        constexpr float       kMinFrameDuration = 1.0e-4f;
+
+        std::string ReadAllText(const char* path)
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                return {};
+
+            std::ostringstream ss;
+            ss << file.rdbuf();
+            return ss.str();
+        }
+
+        // t mod period, in [0, period). Playback time stays wrapped, so one
+        // step rarely crosses more than a single period: skip fmod for that.
+        float Wrap(float t, float period)
+        {
+            if (!(period > 0.0f))
+                return 0.0f;
+
+            if (t >= period)
+                t -= period;
+            else if (t < 0.0f)
+                t += period;
+
+            if (t < 0.0f || t >= period) {
+                t = std::fmod(t, period);
+                if (t < 0.0f)
+                    t += period;
+            }
+            return (t >= period) ? 0.0f : t;
+        }
+
+        AnimationLoop ParseLoop(const std::string& text)
+        {
+            if (text == "once")
+                return AnimationLoop::Once;
+            if (text == "pingpong")
+                return AnimationLoop::PingPong;
+            return AnimationLoop::Loop;
+        }
+
+        // "frames" list or a uniform "grid" over the whole texture
+        bool ReadFrames(const nlohmann::json& clip, std::vector<AnimationFrame2D>& out)
+        {
+            out.clear();
+
+            if (auto it = clip.find("frames"); it != clip.end() && it->is_array()) {
+                for (const auto& f : *it) {
+                    if (!f.is_object())
+                        continue;
+
+                    AnimationFrame2D frame;
+                    if (auto src = f.find("src"); src != f.end() && src->is_array() && src->size() >= 4) {
+                        const auto& a = *src;
+                        if (a[0].is_number() && a[1].is_number() && a[2].is_number() && a[3].is_number())
+                            frame.src = RectF::FromXYWH(a[0].get<float>(), a[1].get<float>(), a[2].get<float>(), a[3].get<float>());
+                    }
+                    frame.duration = f.value("duration", frame.duration);
+                    out.push_back(frame);
+                }
+                return !out.empty();
+            }
+
+            if (auto it = clip.find("grid"); it != clip.end() && it->is_object()) {
+                const auto& g = *it;
+                const int columns = std::max(g.value("columns", 1), 1);
+                const int rows = std::max(g.value("rows", 1), 1);
+                const int first = std::max(g.value("first", 0), 0);
+                const int count = std::min(g.value("count", columns * rows - first), columns * rows - first);
+                const float fps = g.value("fps", 10.0f);
+                if (count <= 0 || !(fps > 0.0f))
+                    return false;
+
+                const float w = 1.0f / static_cast<float>(columns);
+                const float h = 1.0f / static_cast<float>(rows);
+                for (int i = first; i < first + count; ++i) {
+                    AnimationFrame2D frame;
+                    frame.src = RectF::FromXYWH(static_cast<float>(i % columns) * w, static_cast<float>(i / columns) * h, w, h);
+                    frame.duration = 1.0f / fps;
+                    out.push_back(frame);
+                }
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    AnimationClipId AnimationLibrary2D::Add(std::string_view name, std::span<const AnimationFrame2D> frames, AnimationLoop loop)
+    {
+        if (frames.empty() || frames.size() > kMaxClipFrames) {
+            KbkWarn(kLogChannel, "Clip '%.*s' needs 1..%zu frames (got %zu)",
+                static_cast<int>(name.size()), name.data(), kMaxClipFrames, frames.size());
+            return kInvalidAnimationClip;
+        }
+
+        std::string key(name);
+        AnimationClipId id = Find(key);
+        if (id == kInvalidAnimationClip) {
+            if (!m_freeIds.empty()) {
+                id = m_freeIds.back();
+                m_freeIds.pop_back();
+            }
+            else {
+                id = static_cast<AnimationClipId>(m_clips.size());
+                m_clips.emplace_back();
+            }
+            m_clips[id].name = key;
+            m_byName.emplace(std::move(key), id);
+        }
+
+        // A replaced clip (scene reloads re-add every clip) is rewritten where
+        // it is when it fits or sits last; otherwise it moves to the end
+        Clip& clip = m_clips[id];
+        const std::size_t count = frames.size();
+        const bool last = clip.frameCount > 0 && clip.firstFrame + clip.frameCount == m_frameSrc.size();
+        if (last) {
+            m_frameSrc.resize(clip.firstFrame + count);
+            m_frameEnd.resize(clip.firstFrame + count);
+        }
+        else if (count <= clip.frameCount) {
+            m_deadFrames += clip.frameCount - count;
+        }
+        else {
+            m_deadFrames += clip.frameCount;
+            clip.firstFrame = static_cast<std::uint32_t>(m_frameSrc.size());
+            m_frameSrc.resize(m_frameSrc.size() + count);
+            m_frameEnd.resize(m_frameEnd.size() + count);
+        }
+        clip.frameCount = static_cast<std::uint16_t>(count);
+        clip.loop = loop;
+
+        float end = 0.0f;
+        for (std::size_t i = 0; i < count; ++i) {
+            end += std::max(frames[i].duration, kMinFrameDuration);
+            m_frameSrc[clip.firstFrame + i] = frames[i].src;
+            m_frameEnd[clip.firstFrame + i] = end;
+        }
+        clip.duration = end;
+
+        if (m_deadFrames * 2 > m_frameSrc.size())
+            CompactFrames();
+        return id;
+    }
+
+    void AnimationLibrary2D::Remove(AnimationClipId id)
+    {
+        if (id >= m_clips.size() || m_clips[id].frameCount == 0)
+            return;
+
+        Clip& clip = m_clips[id];
+        if (clip.firstFrame + clip.frameCount == m_frameSrc.size()) {
+            m_frameSrc.resize(clip.firstFrame);
+            m_frameEnd.resize(clip.firstFrame);
+        }
+        else {
+            m_deadFrames += clip.frameCount;
+        }
+
+        m_byName.erase(clip.name);
+        clip = Clip{};
+        m_freeIds.push_back(id);
+
+        if (m_deadFrames * 2 > m_frameSrc.size())
+            CompactFrames();
+    }
+
+    void AnimationLibrary2D::CompactFrames()
+    {
+        std::vector<RectF> frameSrc;
+        std::vector<float> frameEnd;
+        frameSrc.reserve(m_frameSrc.size() - m_deadFrames);
+        frameEnd.reserve(m_frameEnd.size() - m_deadFrames);
+
+        for (Clip& clip : m_clips) {
+            const auto first = static_cast<std::ptrdiff_t>(clip.firstFrame);
+            const auto count = static_cast<std::ptrdiff_t>(clip.frameCount);
+            clip.firstFrame = static_cast<std::uint32_t>(frameSrc.size());
+            frameSrc.insert(frameSrc.end(), m_frameSrc.begin() + first, m_frameSrc.begin() + first + count);
+            frameEnd.insert(frameEnd.end(), m_frameEnd.begin() + first, m_frameEnd.begin() + first + count);
+        }
+
+        m_frameSrc.swap(frameSrc);
+        m_frameEnd.swap(frameEnd);
+        m_deadFrames = 0;
+    }
+
+    AnimationClipId AnimationLibrary2D::Find(std::string_view name) const
+    {
+        const auto it = m_byName.find(std::string(name));
+        return (it == m_byName.end()) ? kInvalidAnimationClip : it->second;
+    }
+
+    float AnimationLibrary2D::Duration(AnimationClipId clip) const
+    {
+        return (clip < m_clips.size()) ? m_clips[clip].duration : 0.0f;
+    }
+
+    std::size_t AnimationLibrary2D::FrameCount(AnimationClipId clip) const
+    {
+        return (clip < m_clips.size()) ? m_clips[clip].frameCount : 0;
+    }
+
+    void AnimationLibrary2D::Clear()
+    {
+        m_clips.clear();
+        m_frameSrc.clear();
+        m_frameEnd.clear();
+        m_byName.clear();
+        m_freeIds.clear();
+        m_deadFrames = 0;
+    }
+
+    std::size_t AnimationLibrary2D::LoadFromFile(const char* path, std::vector<AnimationClipId>* added)
+    {
+        const std::string text = (path && path[0] != '\0') ? ReadAllText(path) : std::string{};
+        if (text.empty()) {
+            KbkError(kLogChannel, "LoadFromFile: failed to read '%s'", path ? path : "");
+            return 0;
+        }
+
+        nlohmann::json root;
+        try {
+            root = nlohmann::json::parse(text);
+        }
+        catch (const std::exception& e) {
+            KbkError(kLogChannel, "LoadFromFile: JSON parse error in '%s': %s", path, e.what());
+            return 0;
+        }
+
+        auto itClips = root.find("clips");
+        if (itClips == root.end() || !itClips->is_array()) {
+            KbkWarn(kLogChannel, "LoadFromFile: no 'clips' array in '%s'", path);
+            return 0;
+        }
+
+        std::size_t addedCount = 0;
+        std::vector<AnimationFrame2D> frames;
+        for (const auto& c : *itClips) {
+            if (!c.is_object())
+                continue;
+
+            const std::string name = c.value("name", "");
+            if (name.empty() || !ReadFrames(c, frames)) {
+                KbkWarn(kLogChannel, "LoadFromFile: skipping clip '%s' in '%s' (no name or frames)", name.c_str(), path);
+                continue;
+            }
+
+            const AnimationClipId id = Add(name, frames, ParseLoop(c.value("loop", "loop")));
+            if (id == kInvalidAnimationClip)
+                continue;
+
+            ++addedCount;
+            if (added)
+                added->push_back(id);
+        }
+
+        KbkLog(kLogChannel, "Loaded %zu clips from '%s'", addedCount, path);
+        return addedCount;
+    }
+
+    const RectF* AnimationLibrary2D::Advance(SpriteAnimator2D& state, float dt) const
+    {
+        if (state.clip >= m_clips.size() || m_clips[state.clip].frameCount == 0)
+            return nullptr;
+
+        // Stopped and already showing its frame: nothing to evaluate
+        if (!state.playing && state.frame != kNoAnimationFrame)
+            return nullptr;
+
+        const Clip& clip = m_clips[state.clip];
+        if (state.playing)
+            state.time += dt * state.speed;
+
+        float local = state.time;
+        switch (clip.loop) {
+        case AnimationLoop::Once:
+            if ((state.speed >= 0.0f && local >= clip.duration) || (state.speed < 0.0f && local <= 0.0f))
+                state.playing = false;
+            local = std::clamp(local, 0.0f, clip.duration);
+            state.time = local;
+            break;
+        case AnimationLoop::Loop:
+            local = Wrap(local, clip.duration);
+            state.time = local;
+            break;
+        case AnimationLoop::PingPong:
+            state.time = Wrap(local, clip.duration * 2.0f);
+            local = (state.time > clip.duration) ? clip.duration * 2.0f - state.time : state.time;
+            break;
+        }
+
+        const float* ends = m_frameEnd.data() + clip.firstFrame;
+
+        // Most steps stay inside the frame already shown
+        if (state.frame < clip.frameCount) {
+            const float start = (state.frame == 0) ? 0.0f : ends[state.frame - 1];
+            if (local >= start && (local < ends[state.frame] || state.frame + 1u == clip.frameCount))
+                return nullptr;
+        }
+
+        const std::size_t found = static_cast<std::size_t>(std::upper_bound(ends, ends + clip.frameCount, local) - ends);
+        const std::uint16_t frame = static_cast<std::uint16_t>(std::min<std::size_t>(found, clip.frameCount - 1u));
+
+        if (frame == state.frame)
+            return nullptr;
+
+        state.frame = frame;
+        return &m_frameSrc[clip.firstFrame + frame];
+    }
+
+} // namespace KibakoEngine
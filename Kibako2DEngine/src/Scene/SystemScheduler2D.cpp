@@ -0,0 +1,178 @@
+// Conflict-DAG wave scheduling of scene systems over the JobSystem
+#include "KibakoEngine/Scene/SystemScheduler2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/JobSystem.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <span>
+#include <unordered_set>
+#include <utility>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Systems";
+
+        // The profiler queues raw name pointers until its next flush, so labels
+        // live for the whole program (registration happens on the main thread)
+        const char* InternProfileName(const std::string& systemName)
+        {
+            static std::unordered_set<std::string> s_names;
+            return s_names.insert("System." + systemName).first->c_str();
+        }
+    }
+
+    SystemScheduler2D::SystemScheduler2D(Scene2D& scene)
+        : m_scene(&scene)
+        , m_commands(scene)
+    {
+    }
+
+    void SystemScheduler2D::Add(std::string name, const SystemAccess& access, SystemFn fn)
+    {
+        KBK_ASSERT(static_cast<bool>(fn), "SystemScheduler2D::Add: empty system function");
+
+        if (System* existing = Find(name)) {
+            KbkWarn(kLogChannel, "System '%s' registered twice, replacing it", name.c_str());
+            existing->access = access;
+            existing->fn = std::move(fn);
+            existing->enabled = true;
+        }
+        else {
+            System& system = m_systems.emplace_back();
+            system.profileName = InternProfileName(name);
+            system.name = std::move(name);
+            system.access = access;
+            system.fn = std::move(fn);
+        }
+        m_wavesDirty = true;
+    }
+
+    bool SystemScheduler2D::Remove(std::string_view name)
+    {
+        const auto it = std::find_if(m_systems.begin(), m_systems.end(),
+            [name](const System& s) { return s.name == name; });
+        if (it == m_systems.end())
+            return false;
+
+        m_systems.erase(it);
+        m_wavesDirty = true;
+        return true;
+    }
+
+    void SystemScheduler2D::SetEnabled(std::string_view name, bool enabled)
+    {
+        System* system = Find(name);
+        if (!system || system->enabled == enabled)
+            return;
+
+        system->enabled = enabled;
+        m_wavesDirty = true;
+    }
+
+    SystemScheduler2D::System* SystemScheduler2D::Find(std::string_view name)
+    {
+        for (System& system : m_systems) {
+            if (system.name == name)
+                return &system;
+        }
+        return nullptr;
+    }
+
+    std::size_t SystemScheduler2D::WaveCount()
+    {
+        if (m_wavesDirty)
+            BuildWaves();
+        return m_waveStarts.empty() ? 0 : m_waveStarts.size() - 1;
+    }
+
+    void SystemScheduler2D::BuildWaves()
+    {
+        // Longest-path layering of the conflict DAG (edges run from earlier to
+        // later registrations). A handful of systems: O(n^2) is fine.
+        const std::size_t count = m_systems.size();
+        std::vector<std::uint32_t> wave(count, 0);
+        std::uint32_t waveCount = 0;
+
+        for (std::size_t j = 0; j < count; ++j) {
+            if (!m_systems[j].enabled)
+                continue;
+
+            for (std::size_t i = 0; i < j; ++i) {
+                if (m_systems[i].enabled && m_systems[i].access.ConflictsWith(m_systems[j].access))
+                    wave[j] = std::max(wave[j], wave[i] + 1);
+            }
+            waveCount = std::max(waveCount, wave[j] + 1);
+        }
+
+        // Counting sort by wave, stable so each wave keeps registration order
+        m_waveStarts.assign(waveCount + 1, 0);
+        for (std::size_t j = 0; j < count; ++j) {
+            if (m_systems[j].enabled)
+                ++m_waveStarts[wave[j] + 1];
+        }
+        for (std::uint32_t w = 0; w < waveCount; ++w)
+            m_waveStarts[w + 1] += m_waveStarts[w];
+
+        m_order.resize(m_waveStarts.back());
+        std::vector<std::uint32_t> fill(m_waveStarts.begin(), m_waveStarts.end() - 1);
+        for (std::size_t j = 0; j < count; ++j) {
+            if (m_systems[j].enabled)
+                m_order[fill[wave[j]]++] = static_cast<std::uint32_t>(j);
+        }
+
+        m_wavesDirty = false;
+    }
+
+    void SystemScheduler2D::Run(float dt, JobSystem* jobs)
+    {
+        KBK_PROFILE_SCOPE("SystemScheduler2D.Run");
+
+        if (m_wavesDirty)
+            BuildWaves();
+
+        const std::uint64_t spriteBit = ComponentBit(ComponentType<SpriteRenderer2D>());
+        bool settle = true; // whatever ran before Run() may have left work
+
+        for (std::size_t w = 0; w + 1 < m_waveStarts.size(); ++w) {
+            const std::span<const std::uint32_t> waveSystems(
+                m_order.data() + m_waveStarts[w], m_waveStarts[w + 1] - m_waveStarts[w]);
+
+            // Hierarchy propagation and bounds flushing write shared scene state:
+            // done here, between waves, never by readers racing inside one
+            if (settle)
+                m_scene->UpdateTransforms(jobs);
+            settle = false;
+            for (std::uint32_t index : waveSystems) {
+                const SystemAccess& access = m_systems[index].access;
+                settle = settle || access.writesTransforms || access.exclusive || (access.writes & spriteBit) != 0;
+            }
+
+            if (!jobs || waveSystems.size() == 1) {
+                for (std::uint32_t index : waveSystems)
+                    RunSystem(m_systems[index], dt);
+                continue;
+            }
+
+            jobs->ParallelFor(waveSystems.size(), 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i)
+                    RunSystem(m_systems[waveSystems[i]], dt);
+                });
+        }
+
+        m_commands.Playback();
+    }
+
+    void SystemScheduler2D::RunSystem(System& system, float dt)
+    {
+        KBK_PROFILE_SCOPE(system.profileName);
+
+        SystemContext context{ *m_scene, m_commands, dt };
+        system.fn(context);
+    }
+
+} // namespace KibakoEngine
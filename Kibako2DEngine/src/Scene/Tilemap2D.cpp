@@ -0,0 +1,318 @@
+// Chunk mesh building, caching and culling for TilemapComponent2D
+#include "KibakoEngine/Scene/Tilemap2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Tilemap2D";
+
+        constexpr std::size_t kTilesPerChunk =
+            static_cast<std::size_t>(TilemapComponent2D::kChunkSize) * TilemapComponent2D::kChunkSize;
+
+        // Every chunk mesh is a run of quads, so all of them share one index list
+        const std::vector<std::uint32_t>& ChunkQuadIndices()
+        {
+            static const std::vector<std::uint32_t> s_indices = [] {
+                std::vector<std::uint32_t> indices(kTilesPerChunk * 6);
+                for (std::size_t q = 0; q < kTilesPerChunk; ++q) {
+                    const std::uint32_t base = static_cast<std::uint32_t>(q * 4);
+                    std::uint32_t* idx = indices.data() + q * 6;
+                    idx[0] = base;
+                    idx[1] = base + 1;
+                    idx[2] = base + 2;
+                    idx[3] = base;
+                    idx[4] = base + 2;
+                    idx[5] = base + 3;
+                }
+                return indices;
+                }();
+            return s_indices;
+        }
+
+        // floor(value) clamped to [0, limit], safe for huge or non-finite input
+        std::int32_t ClampedFloor(float value, std::int32_t limit)
+        {
+            if (!(value > 0.0f))
+                return 0;
+            const float f = std::floor(value);
+            return f >= static_cast<float>(limit) ? limit : static_cast<std::int32_t>(f);
+        }
+    }
+
+    void TilemapComponent2D::Resize(std::int32_t width, std::int32_t height)
+    {
+        m_width = std::max(width, 0);
+        m_height = std::max(height, 0);
+        m_chunksX = (m_width + kChunkSize - 1) / kChunkSize;
+        m_chunksY = (m_height + kChunkSize - 1) / kChunkSize;
+
+        m_tiles.assign(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height), kEmptyTile);
+        m_chunks.clear();
+        m_chunks.resize(static_cast<std::size_t>(m_chunksX) * static_cast<std::size_t>(m_chunksY));
+        m_cachedChunks.clear();
+    }
+
+    void TilemapComponent2D::SetTileSize(float width, float height)
+    {
+        KBK_ASSERT(width > 0.0f && height > 0.0f, "TilemapComponent2D::SetTileSize: size must be positive");
+        if (width == m_tileWidth && height == m_tileHeight)
+            return;
+
+        m_tileWidth = width;
+        m_tileHeight = height;
+        MarkAllDirty();
+    }
+
+    void TilemapComponent2D::SetAtlasGrid(std::int32_t columns, std::int32_t rows)
+    {
+        columns = std::max(columns, 1);
+        rows = std::max(rows, 1);
+        if (columns == m_atlasColumns && rows == m_atlasRows)
+            return;
+
+        m_atlasColumns = columns;
+        m_atlasRows = rows;
+        MarkAllDirty();
+    }
+
+    void TilemapComponent2D::SetColor(const Color4& color)
+    {
+        m_color = color;
+        MarkAllDirty();
+    }
+
+    void TilemapComponent2D::SetTile(std::int32_t x, std::int32_t y, TileIndex tile)
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return;
+
+        TileIndex& slot = m_tiles[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(x)];
+        if (slot == tile)
+            return;
+
+        slot = tile;
+        MarkTileDirty(x, y);
+    }
+
+    TileIndex TilemapComponent2D::GetTile(std::int32_t x, std::int32_t y) const
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return kEmptyTile;
+        return m_tiles[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(x)];
+    }
+
+    void TilemapComponent2D::Fill(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, TileIndex tile)
+    {
+        const std::int32_t x0 = std::max(x, 0);
+        const std::int32_t y0 = std::max(y, 0);
+        const std::int32_t x1 = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t{ x } + width, m_width));
+        const std::int32_t y1 = static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t{ y } + height, m_height));
+        if (x0 >= x1 || y0 >= y1)
+            return;
+
+        for (std::int32_t row = y0; row < y1; ++row) {
+            const auto begin = m_tiles.begin() + (static_cast<std::ptrdiff_t>(row) * m_width + x0);
+            std::fill(begin, begin + (x1 - x0), tile);
+        }
+
+        for (std::int32_t cy = y0 / kChunkSize; cy <= (y1 - 1) / kChunkSize; ++cy) {
+            for (std::int32_t cx = x0 / kChunkSize; cx <= (x1 - 1) / kChunkSize; ++cx)
+                MarkTileDirty(cx * kChunkSize, cy * kChunkSize);
+        }
+    }
+
+    void TilemapComponent2D::SetTiles(std::span<const TileIndex> tiles)
+    {
+        if (tiles.size() != m_tiles.size()) {
+            KbkWarn(kLogChannel, "SetTiles: got %zu tiles for a %dx%d map", tiles.size(), m_width, m_height);
+            return;
+        }
+
+        std::copy(tiles.begin(), tiles.end(), m_tiles.begin());
+        MarkAllDirty();
+    }
+
+    RectF TilemapComponent2D::LocalBounds() const
+    {
+        return RectF::FromXYWH(0.0f, 0.0f,
+            static_cast<float>(m_width) * m_tileWidth,
+            static_cast<float>(m_height) * m_tileHeight);
+    }
+
+    void TilemapComponent2D::MarkTileDirty(std::int32_t x, std::int32_t y)
+    {
+        m_chunks[static_cast<std::size_t>(y / kChunkSize) * static_cast<std::size_t>(m_chunksX) +
+            static_cast<std::size_t>(x / kChunkSize)].dirty = true;
+    }
+
+    void TilemapComponent2D::MarkAllDirty()
+    {
+        // Chunks without a cached mesh are dirty already
+        for (std::uint32_t index : m_cachedChunks)
+            m_chunks[index].dirty = true;
+    }
+
+    void TilemapComponent2D::ReleaseMeshes()
+    {
+        for (std::uint32_t index : m_cachedChunks) {
+            Chunk& chunk = m_chunks[index];
+            std::vector<SpriteBatch2D::Vertex>().swap(chunk.vertices);
+            chunk.dirty = true;
+            chunk.cached = false;
+        }
+        m_cachedChunks.clear();
+    }
+
+    void TilemapComponent2D::BuildChunk(std::int32_t cx, std::int32_t cy) const
+    {
+        KBK_PROFILE_SCOPE("Tilemap2D.BuildChunk");
+
+        const std::size_t chunkIndex = static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_chunksX) + static_cast<std::size_t>(cx);
+        Chunk& chunk = m_chunks[chunkIndex];
+
+        const std::int32_t x0 = cx * kChunkSize;
+        const std::int32_t y0 = cy * kChunkSize;
+        const std::int32_t x1 = std::min(x0 + kChunkSize, m_width);
+        const std::int32_t y1 = std::min(y0 + kChunkSize, m_height);
+
+        // Cells past the atlas draw nothing, like kEmptyTile
+        const std::uint32_t cellCount = std::min(
+            static_cast<std::uint32_t>(m_atlasColumns) * static_cast<std::uint32_t>(m_atlasRows),
+            std::uint32_t{ kEmptyTile });
+        const auto tileAt = [&](std::int32_t x, std::int32_t y) {
+            return m_tiles[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(x)];
+            };
+
+        std::size_t quadCount = 0;
+        for (std::int32_t y = y0; y < y1; ++y) {
+            for (std::int32_t x = x0; x < x1; ++x) {
+                if (std::uint32_t{ tileAt(x, y) } < cellCount)
+                    ++quadCount;
+            }
+        }
+
+        // Counted first so the quads are written without growing the vector
+        chunk.vertices.resize(quadCount * 4);
+
+        const float du = 1.0f / static_cast<float>(m_atlasColumns);
+        const float dv = 1.0f / static_cast<float>(m_atlasRows);
+        const DirectX::XMFLOAT4 color{ m_color.r, m_color.g, m_color.b, m_color.a };
+
+        SpriteBatch2D::Vertex* v = chunk.vertices.data();
+        for (std::int32_t y = y0; y < y1; ++y) {
+            const float top = static_cast<float>(y) * m_tileHeight;
+            const float bottom = top + m_tileHeight;
+
+            for (std::int32_t x = x0; x < x1; ++x) {
+                const TileIndex tile = tileAt(x, y);
+                if (std::uint32_t{ tile } >= cellCount)
+                    continue;
+
+                const float u0 = static_cast<float>(tile % m_atlasColumns) * du;
+                const float v0 = static_cast<float>(tile / m_atlasColumns) * dv;
+                const float u1 = u0 + du;
+                const float v1 = v0 + dv;
+                const float left = static_cast<float>(x) * m_tileWidth;
+                const float right = left + m_tileWidth;
+
+                v[0] = { { left,  top,    0.0f }, { u0, v0 }, color };
+                v[1] = { { right, top,    0.0f }, { u1, v0 }, color };
+                v[2] = { { right, bottom, 0.0f }, { u1, v1 }, color };
+                v[3] = { { left,  bottom, 0.0f }, { u0, v1 }, color };
+                v += 4;
+            }
+        }
+
+        chunk.dirty = false;
+        if (!chunk.cached) {
+            chunk.cached = true;
+            m_cachedChunks.push_back(static_cast<std::uint32_t>(chunkIndex));
+        }
+    }
+
+    std::size_t TilemapComponent2D::Render(SpriteBatch2D& batch, DirectX::XMFLOAT2 origin, const RectF* worldArea) const
+    {
+        if (m_chunks.empty())
+            return 0;
+
+        // Camera tile range, in whole chunks (end exclusive)
+        std::int32_t cx0 = 0;
+        std::int32_t cy0 = 0;
+        std::int32_t cx1 = m_chunksX;
+        std::int32_t cy1 = m_chunksY;
+        if (worldArea) {
+            const float chunkW = m_tileWidth * static_cast<float>(kChunkSize);
+            const float chunkH = m_tileHeight * static_cast<float>(kChunkSize);
+            const float localX = worldArea->x - origin.x;
+            const float localY = worldArea->y - origin.y;
+
+            cx0 = ClampedFloor(localX / chunkW, m_chunksX);
+            cy0 = ClampedFloor(localY / chunkH, m_chunksY);
+            cx1 = ClampedFloor((localX + worldArea->w) / chunkW + 1.0f, m_chunksX);
+            cy1 = ClampedFloor((localY + worldArea->h) / chunkH + 1.0f, m_chunksY);
+            if (cx0 >= cx1 || cy0 >= cy1)
+                return 0;
+        }
+
+        KBK_PROFILE_SCOPE("Tilemap2D.Render");
+
+        ++m_renderStamp;
+        const std::vector<std::uint32_t>& indices = ChunkQuadIndices();
+
+        std::size_t submitted = 0;
+        for (std::int32_t cy = cy0; cy < cy1; ++cy) {
+            for (std::int32_t cx = cx0; cx < cx1; ++cx) {
+                Chunk& chunk = m_chunks[static_cast<std::size_t>(cy) * static_cast<std::size_t>(m_chunksX) + static_cast<std::size_t>(cx)];
+                if (chunk.dirty)
+                    BuildChunk(cx, cy);
+                chunk.lastDrawn = m_renderStamp;
+
+                if (chunk.vertices.empty())
+                    continue;
+
+                batch.PushGeometryView(texture,
+                    chunk.vertices.data(), chunk.vertices.size(),
+                    indices.data(), chunk.vertices.size() / 4 * 6,
+                    layer, RectF{}, origin);
+                ++submitted;
+            }
+        }
+
+        TrimMeshes();
+        return submitted;
+    }
+
+    void TilemapComponent2D::TrimMeshes() const
+    {
+        if (m_meshBudget == 0 || m_cachedChunks.size() <= m_meshBudget)
+            return;
+
+        // Least recently drawn first; whatever this Render() submitted stays,
+        // even when the view alone needs more than the budget
+        std::sort(m_cachedChunks.begin(), m_cachedChunks.end(), [this](std::uint32_t a, std::uint32_t b) {
+            return m_chunks[a].lastDrawn < m_chunks[b].lastDrawn;
+            });
+
+        const std::size_t excess = m_cachedChunks.size() - m_meshBudget;
+        std::size_t dropped = 0;
+        for (; dropped < excess; ++dropped) {
+            Chunk& chunk = m_chunks[m_cachedChunks[dropped]];
+            if (chunk.lastDrawn == m_renderStamp)
+                break;
+
+            std::vector<SpriteBatch2D::Vertex>().swap(chunk.vertices);
+            chunk.dirty = true;
+            chunk.cached = false;
+        }
+        m_cachedChunks.erase(m_cachedChunks.begin(), m_cachedChunks.begin() + static_cast<std::ptrdiff_t>(dropped));
+    }
+
+} // namespace KibakoEngine
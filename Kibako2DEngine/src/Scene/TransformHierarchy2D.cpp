@@ -0,0 +1,444 @@
+// Breadth-first transform tree and level-by-level dirty propagation
+#include "KibakoEngine/Scene/TransformHierarchy2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/JobSystem.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Hierarchy";
+
+        // Below this many nodes in a level, dispatch costs more than it saves
+        constexpr std::size_t kParallelMinNodes = 4096;
+        constexpr std::size_t kParallelChunk = 1024;
+
+        float SafeInverse(float v)
+        {
+            return (std::fabs(v) > 1.0e-8f) ? 1.0f / v : 0.0f;
+        }
+    }
+
+    Transform2D CombineTransforms(const Transform2D& parentWorld, const Transform2D& local)
+    {
+        const float c = std::cos(parentWorld.rotation);
+        const float s = std::sin(parentWorld.rotation);
+        const float x = local.position.x * parentWorld.scale.x;
+        const float y = local.position.y * parentWorld.scale.y;
+
+        Transform2D world;
+        world.position = { parentWorld.position.x + x * c - y * s, parentWorld.position.y + x * s + y * c };
+        world.rotation = parentWorld.rotation + local.rotation;
+        world.scale = { parentWorld.scale.x * local.scale.x, parentWorld.scale.y * local.scale.y };
+        return world;
+    }
+
+    Transform2D RelativeTransform(const Transform2D& parentWorld, const Transform2D& world)
+    {
+        const float c = std::cos(parentWorld.rotation);
+        const float s = std::sin(parentWorld.rotation);
+        const float dx = world.position.x - parentWorld.position.x;
+        const float dy = world.position.y - parentWorld.position.y;
+        const float invSX = SafeInverse(parentWorld.scale.x);
+        const float invSY = SafeInverse(parentWorld.scale.y);
+
+        Transform2D local;
+        local.position = { (dx * c + dy * s) * invSX, (-dx * s + dy * c) * invSY };
+        local.rotation = world.rotation - parentWorld.rotation;
+        local.scale = { world.scale.x * invSX, world.scale.y * invSY };
+        return local;
+    }
+
+    // ------------------------------------------------------------------------
+
+    void TransformHierarchy2D::Attach(EntityID id, const Transform2D& local)
+    {
+        if (Contains(id)) {
+            SetLocal(id, local);
+            return;
+        }
+        AddNode(id, local);
+    }
+
+    std::uint32_t TransformHierarchy2D::AddNode(EntityID id, const Transform2D& local)
+    {
+        const auto node = static_cast<std::uint32_t>(m_entity.size());
+        const float c = std::cos(local.rotation);
+        const float s = std::sin(local.rotation);
+
+        m_entity.push_back(id);
+        m_parent.push_back(kNoNode);
+        m_firstChild.push_back(0);
+        m_childCount.push_back(0);
+
+        m_localX.push_back(local.position.x);
+        m_localY.push_back(local.position.y);
+        m_localRot.push_back(local.rotation);
+        m_localSX.push_back(local.scale.x);
+        m_localSY.push_back(local.scale.y);
+
+        // A new root's world is its local transform
+        m_worldX.push_back(local.position.x);
+        m_worldY.push_back(local.position.y);
+        m_worldRot.push_back(local.rotation);
+        m_worldSX.push_back(local.scale.x);
+        m_worldSY.push_back(local.scale.y);
+        m_worldCos.push_back(c);
+        m_worldSin.push_back(s);
+
+        m_queued.push_back(0);
+        m_nodeIndex.emplace(id, node);
+        ++m_layoutVersion;
+
+        m_layoutDirty = true;
+        return node;
+    }
+
+    void TransformHierarchy2D::Remove(EntityID id)
+    {
+        const auto it = m_nodeIndex.find(id);
+        if (it == m_nodeIndex.end())
+            return;
+
+        // Tombstone: children become roots and storage is compacted on rebuild
+        m_entity[it->second] = 0;
+        m_nodeIndex.erase(it);
+        m_layoutDirty = true;
+        ++m_layoutVersion;
+    }
+
+    void TransformHierarchy2D::Clear()
+    {
+        m_entity.clear();
+        m_parent.clear();
+        m_firstChild.clear();
+        m_childCount.clear();
+        m_depthStart.clear();
+
+        for (auto* v : { &m_localX, &m_localY, &m_localRot, &m_localSX, &m_localSY,
+                         &m_worldX, &m_worldY, &m_worldRot, &m_worldSX, &m_worldSY,
+                         &m_worldCos, &m_worldSin })
+            v->clear();
+
+        m_nodeIndex.clear();
+        m_dirty.clear();
+        m_queued.clear();
+        m_levelWork.clear();
+        m_changed.clear();
+        m_layoutDirty = false;
+        m_fullDirty = false;
+        ++m_layoutVersion;
+    }
+
+    bool TransformHierarchy2D::SetParent(EntityID child, EntityID parent)
+    {
+        const std::uint32_t childNode = NodeIndex(child);
+        if (childNode == kNoNode)
+            return false;
+
+        std::uint32_t parentNode = kNoNode;
+        if (parent != 0) {
+            parentNode = NodeIndex(parent);
+            if (parentNode == kNoNode)
+                return false;
+
+            for (std::uint32_t n = parentNode; n != kNoNode; n = m_parent[n]) {
+                if (n == childNode) {
+                    KbkWarn(kLogChannel, "Refusing to parent %u under %u: would create a cycle", child, parent);
+                    return false;
+                }
+                if (m_entity[n] == 0)
+                    break; // removed ancestor: the chain ends here after the rebuild
+            }
+        }
+
+        if (m_parent[childNode] == parentNode)
+            return true;
+
+        m_parent[childNode] = parentNode;
+        m_layoutDirty = true;
+        return true;
+    }
+
+    EntityID TransformHierarchy2D::GetParent(EntityID id) const
+    {
+        const std::uint32_t node = NodeIndex(id);
+        if (node == kNoNode || m_parent[node] == kNoNode)
+            return 0;
+        return m_entity[m_parent[node]];
+    }
+
+    void TransformHierarchy2D::SetLocal(EntityID id, const Transform2D& local)
+    {
+        const std::uint32_t node = NodeIndex(id);
+        if (node == kNoNode)
+            return;
+
+        m_localX[node] = local.position.x;
+        m_localY[node] = local.position.y;
+        m_localRot[node] = local.rotation;
+        m_localSX[node] = local.scale.x;
+        m_localSY[node] = local.scale.y;
+        m_dirty.push_back(node);
+    }
+
+    std::uint32_t TransformHierarchy2D::NodeIndex(EntityID id) const
+    {
+        const auto it = m_nodeIndex.find(id);
+        return (it != m_nodeIndex.end()) ? it->second : kNoNode;
+    }
+
+    bool TransformHierarchy2D::TryGetWorld(EntityID id, Transform2D& out) const
+    {
+        const std::uint32_t node = NodeIndex(id);
+        if (node == kNoNode)
+            return false;
+
+        out = World(node);
+        return true;
+    }
+
+    Transform2D TransformHierarchy2D::World(std::uint32_t node) const
+    {
+        Transform2D t;
+        t.position = { m_worldX[node], m_worldY[node] };
+        t.rotation = m_worldRot[node];
+        t.scale = { m_worldSX[node], m_worldSY[node] };
+        return t;
+    }
+
+    std::size_t TransformHierarchy2D::DepthOf(std::uint32_t node) const
+    {
+        const auto it = std::upper_bound(m_depthStart.begin(), m_depthStart.end(), node);
+        return static_cast<std::size_t>(it - m_depthStart.begin()) - 1;
+    }
+
+    // ------------------------------------------------------------------------
+
+    void TransformHierarchy2D::RebuildLayout()
+    {
+        KBK_PROFILE_SCOPE("HierarchyRebuild");
+
+        const auto oldCount = static_cast<std::uint32_t>(m_entity.size());
+
+        // Children adjacency (CSR) of the live nodes, in current index order
+        std::vector<std::uint32_t> childOffset(oldCount + 1, 0);
+        std::vector<std::uint32_t> order;
+        order.reserve(m_nodeIndex.size());
+
+        for (std::uint32_t i = 0; i < oldCount; ++i) {
+            if (m_entity[i] == 0)
+                continue;
+
+            const std::uint32_t p = m_parent[i];
+            if (p == kNoNode || m_entity[p] == 0)
+                order.push_back(i); // root
+            else
+                ++childOffset[p + 1];
+        }
+        for (std::uint32_t i = 0; i < oldCount; ++i)
+            childOffset[i + 1] += childOffset[i];
+
+        std::vector<std::uint32_t> children(childOffset[oldCount]);
+        std::vector<std::uint32_t> cursor(childOffset.begin(), childOffset.end() - 1);
+        for (std::uint32_t i = 0; i < oldCount; ++i) {
+            const std::uint32_t p = m_parent[i];
+            if (m_entity[i] != 0 && p != kNoNode && m_entity[p] != 0)
+                children[cursor[p]++] = i;
+        }
+
+        // Breadth-first: one contiguous range per depth, siblings contiguous
+        const std::size_t liveCount = m_nodeIndex.size();
+        std::vector<std::uint32_t> firstChild(liveCount, 0);
+        std::vector<std::uint32_t> childCount(liveCount, 0);
+        m_depthStart.assign(1, 0);
+
+        std::size_t levelBegin = 0;
+        while (levelBegin < order.size()) {
+            const std::size_t levelEnd = order.size();
+            for (std::size_t k = levelBegin; k < levelEnd; ++k) {
+                const std::uint32_t old = order[k];
+                firstChild[k] = static_cast<std::uint32_t>(order.size());
+                childCount[k] = childOffset[old + 1] - childOffset[old];
+                order.insert(order.end(), children.begin() + childOffset[old], children.begin() + childOffset[old + 1]);
+            }
+            m_depthStart.push_back(static_cast<std::uint32_t>(levelEnd));
+            levelBegin = levelEnd;
+        }
+
+        std::vector<std::uint32_t> newIndex(oldCount, kNoNode);
+        for (std::uint32_t k = 0; k < static_cast<std::uint32_t>(order.size()); ++k)
+            newIndex[order[k]] = k;
+
+        auto permute = [&](std::vector<float>& values) {
+            std::vector<float> out(order.size());
+            for (std::size_t k = 0; k < order.size(); ++k)
+                out[k] = values[order[k]];
+            values.swap(out);
+        };
+
+        for (auto* v : { &m_localX, &m_localY, &m_localRot, &m_localSX, &m_localSY,
+                         &m_worldX, &m_worldY, &m_worldRot, &m_worldSX, &m_worldSY,
+                         &m_worldCos, &m_worldSin })
+            permute(*v);
+
+        std::vector<EntityID> entity(order.size());
+        std::vector<std::uint32_t> parent(order.size());
+        for (std::size_t k = 0; k < order.size(); ++k) {
+            const std::uint32_t old = order[k];
+            const std::uint32_t p = m_parent[old];
+            entity[k] = m_entity[old];
+            parent[k] = (p != kNoNode && m_entity[p] != 0) ? newIndex[p] : kNoNode;
+        }
+
+        KBK_ASSERT(order.size() == liveCount, "Transform hierarchy lost nodes during rebuild");
+
+        m_entity.swap(entity);
+        m_parent.swap(parent);
+        m_firstChild.swap(firstChild);
+        m_childCount.swap(childCount);
+
+        m_nodeIndex.clear();
+        m_nodeIndex.reserve(m_entity.size());
+        for (std::uint32_t k = 0; k < static_cast<std::uint32_t>(m_entity.size()); ++k)
+            m_nodeIndex.emplace(m_entity[k], k);
+
+        m_queued.assign(m_entity.size(), 0);
+        m_dirty.clear();
+        m_layoutDirty = false;
+        m_fullDirty = true;
+        ++m_layoutVersion;
+    }
+
+    void TransformHierarchy2D::ComputeNode(std::uint32_t node)
+    {
+        const std::uint32_t p = m_parent[node];
+        const float localRot = m_localRot[node];
+
+        if (p == kNoNode) {
+            m_worldX[node] = m_localX[node];
+            m_worldY[node] = m_localY[node];
+            m_worldRot[node] = localRot;
+            m_worldSX[node] = m_localSX[node];
+            m_worldSY[node] = m_localSY[node];
+            m_worldCos[node] = std::cos(localRot);
+            m_worldSin[node] = std::sin(localRot);
+            return;
+        }
+
+        // Parent basis is cached, so attachments without own rotation skip the trig
+        const float c = m_worldCos[p];
+        const float s = m_worldSin[p];
+        const float x = m_localX[node] * m_worldSX[p];
+        const float y = m_localY[node] * m_worldSY[p];
+
+        m_worldX[node] = m_worldX[p] + x * c - y * s;
+        m_worldY[node] = m_worldY[p] + x * s + y * c;
+        m_worldSX[node] = m_worldSX[p] * m_localSX[node];
+        m_worldSY[node] = m_worldSY[p] * m_localSY[node];
+
+        const float rot = m_worldRot[p] + localRot;
+        m_worldRot[node] = rot;
+        if (localRot == 0.0f) {
+            m_worldCos[node] = c;
+            m_worldSin[node] = s;
+        }
+        else {
+            m_worldCos[node] = std::cos(rot);
+            m_worldSin[node] = std::sin(rot);
+        }
+    }
+
+    void TransformHierarchy2D::ComputeRange(const std::uint32_t* nodes, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            ComputeNode(nodes[i]);
+    }
+
+    void TransformHierarchy2D::Propagate(JobSystem* jobs)
+    {
+        KBK_PROFILE_SCOPE("HierarchyPropagate");
+
+        m_changed.clear();
+
+        if (m_layoutDirty)
+            RebuildLayout();
+
+        const std::size_t depthCount = DepthCount();
+
+        // Full pass (after a rebuild): each depth is a contiguous node range
+        if (m_fullDirty) {
+            for (std::size_t d = 0; d < depthCount; ++d) {
+                const auto [begin, end] = DepthRange(d);
+                auto computeSpan = [&](std::size_t b, std::size_t e) {
+                    for (std::size_t i = b; i < e; ++i)
+                        ComputeNode(static_cast<std::uint32_t>(begin + i));
+                };
+
+                if (jobs && end - begin >= kParallelMinNodes)
+                    jobs->ParallelFor(end - begin, kParallelChunk, computeSpan);
+                else
+                    computeSpan(0, end - begin);
+            }
+
+            m_changed.assign(m_entity.begin(), m_entity.end());
+            m_dirty.clear();
+            m_fullDirty = false;
+            return;
+        }
+
+        if (m_dirty.empty())
+            return;
+
+        // Incremental pass: bucket dirty nodes per depth, then walk down subtrees
+        if (m_levelWork.size() < depthCount)
+            m_levelWork.resize(depthCount);
+        for (std::size_t d = 0; d < depthCount; ++d)
+            m_levelWork[d].clear();
+
+        for (std::uint32_t node : m_dirty) {
+            if (m_queued[node] != 0u)
+                continue;
+            m_queued[node] = 1;
+            m_levelWork[DepthOf(node)].push_back(node);
+        }
+        m_dirty.clear();
+
+        for (std::size_t d = 0; d < depthCount; ++d) {
+            std::vector<std::uint32_t>& work = m_levelWork[d];
+            if (work.empty())
+                continue;
+
+            if (jobs && work.size() >= kParallelMinNodes) {
+                jobs->ParallelFor(work.size(), kParallelChunk, [&](std::size_t b, std::size_t e) {
+                    ComputeRange(work.data() + b, e - b);
+                    });
+            }
+            else {
+                ComputeRange(work.data(), work.size());
+            }
+
+            // Children of every recomputed node are dirty too (contiguous ranges)
+            for (std::uint32_t node : work) {
+                m_queued[node] = 0;
+                m_changed.push_back(m_entity[node]);
+
+                const std::uint32_t first = m_firstChild[node];
+                const std::uint32_t last = first + m_childCount[node];
+                for (std::uint32_t child = first; child < last; ++child) {
+                    if (m_queued[child] != 0u)
+                        continue;
+                    m_queued[child] = 1;
+                    m_levelWork[d + 1].push_back(child);
+                }
+            }
+        }
+    }
+
+} // namespace KibakoEngine
@@ -0,0 +1,301 @@
+// Distance-field generation and atlas page management for glyphs
+#include "KibakoEngine/Text/GlyphAtlas2D.h"
+
+#include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Core/Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr const char* kLogChannel = "Text";
+
+        constexpr float kFar = 1.0e20f;
+
+        // Squared distance to the nearest zero sample along one line
+        // (Felzenszwalb & Huttenlocher lower envelope of parabolas)
+        void DistanceTransform1D(const float* f, int n, float* d, int* v, float* z)
+        {
+            int k = 0;
+            v[0] = 0;
+            z[0] = -kFar;
+            z[1] = kFar;
+            for (int q = 1; q < n; ++q) {
+                const float fq = f[q] + static_cast<float>(q * q);
+                float s = 0.0f;
+                // z[0] = -kFar is never reached: every s is above -kFar / 2
+                for (;;) {
+                    const int p = v[k];
+                    s = (fq - (f[p] + static_cast<float>(p * p))) / static_cast<float>(2 * (q - p));
+                    if (s > z[k])
+                        break;
+                    --k;
+                }
+                ++k;
+                v[k] = q;
+                z[k] = s;
+                z[k + 1] = kFar;
+            }
+
+            k = 0;
+            for (int q = 0; q < n; ++q) {
+                while (z[k + 1] < static_cast<float>(q))
+                    ++k;
+                const int dq = q - v[k];
+                d[q] = static_cast<float>(dq * dq) + f[v[k]];
+            }
+        }
+
+        // In place: 0 = feature texel, kFar = anything else
+        void DistanceTransform2D(std::vector<float>& grid, int size)
+        {
+            std::vector<float> f(static_cast<std::size_t>(size));
+            std::vector<float> d(static_cast<std::size_t>(size));
+            std::vector<int>   v(static_cast<std::size_t>(size));
+            std::vector<float> z(static_cast<std::size_t>(size) + 1u);
+
+            for (int x = 0; x < size; ++x) {
+                for (int y = 0; y < size; ++y)
+                    f[static_cast<std::size_t>(y)] = grid[static_cast<std::size_t>(y * size + x)];
+                DistanceTransform1D(f.data(), size, d.data(), v.data(), z.data());
+                for (int y = 0; y < size; ++y)
+                    grid[static_cast<std::size_t>(y * size + x)] = d[static_cast<std::size_t>(y)];
+            }
+
+            for (int y = 0; y < size; ++y) {
+                float* row = grid.data() + static_cast<std::size_t>(y * size);
+                std::copy(row, row + size, f.begin());
+                DistanceTransform1D(f.data(), size, row, v.data(), z.data());
+            }
+        }
+    }
+
+    void BuildGlyphDistanceField(const GlyphBitmap& glyph, int cellSize, int spread, float texelsPerEm,
+        std::uint8_t* out)
+    {
+        KBK_ASSERT(out != nullptr, "BuildGlyphDistanceField requires an output buffer");
+        KBK_ASSERT(cellSize > 2 * spread && spread > 0, "BuildGlyphDistanceField: cell too small for its spread");
+
+        const int inner = cellSize - 2 * spread;
+        const int gw = std::clamp(static_cast<int>(std::lround(glyph.boxWidth * texelsPerEm)), 1, inner);
+        const int gh = std::clamp(static_cast<int>(std::lround(glyph.boxHeight * texelsPerEm)), 1, inner);
+        const bool hasBitmap = glyph.width > 0 && glyph.height > 0 &&
+            glyph.coverage.size() >= static_cast<std::size_t>(glyph.width) * static_cast<std::size_t>(glyph.height);
+
+        // Inside mask at cell resolution, nearest-sampled from the bitmap
+        const std::size_t count = static_cast<std::size_t>(cellSize) * static_cast<std::size_t>(cellSize);
+        std::vector<float> toInside(count, kFar);
+        std::vector<float> toOutside(count, 0.0f);
+        if (hasBitmap) {
+            for (int y = 0; y < gh; ++y) {
+                const int by = y * glyph.height / gh;
+                for (int x = 0; x < gw; ++x) {
+                    const int bx = x * glyph.width / gw;
+                    if (glyph.coverage[static_cast<std::size_t>(by * glyph.width + bx)] < 128)
+                        continue;
+                    const std::size_t i = static_cast<std::size_t>((y + spread) * cellSize + x + spread);
+                    toInside[i] = 0.0f;
+                    toOutside[i] = kFar;
+                }
+            }
+        }
+
+        DistanceTransform2D(toInside, cellSize);
+        DistanceTransform2D(toOutside, cellSize);
+
+        // Texel centres sit half a texel off the outline at best
+        const float scale = 0.5f / static_cast<float>(spread);
+        for (std::size_t i = 0; i < count; ++i) {
+            const bool inside = toInside[i] == 0.0f;
+            const float distance = inside
+                ? std::sqrt(toOutside[i]) - 0.5f
+                : 0.5f - std::sqrt(toInside[i]);
+            const float value = std::clamp(0.5f + distance * scale, 0.0f, 1.0f);
+            out[i] = static_cast<std::uint8_t>(std::lround(value * 255.0f));
+        }
+    }
+
+    GlyphAtlas2D::GlyphAtlas2D(const GlyphSource2D& source, const GlyphAtlasDesc& desc)
+        : m_source(source)
+        , m_desc(desc)
+    {
+        m_desc.spread = std::max(m_desc.spread, 1);
+        m_desc.cellSize = std::max(m_desc.cellSize, 2 * m_desc.spread + 4);
+        m_desc.pageSize = std::max(m_desc.pageSize, m_desc.cellSize);
+        m_desc.maxPages = std::clamp<std::size_t>(m_desc.maxPages, 1, 0xFFFF);
+
+        m_cellsPerRow = static_cast<std::uint32_t>(m_desc.pageSize / m_desc.cellSize);
+        m_cellsPerPage = m_cellsPerRow * m_cellsPerRow;
+        m_texelsPerEm = static_cast<float>(m_desc.cellSize - 2 * m_desc.spread);
+
+        m_pages.reserve(m_desc.maxPages);
+    }
+
+    const AtlasGlyph* GlyphAtlas2D::Acquire(char32_t codepoint)
+    {
+        const AtlasGlyph* glyph = (codepoint < kDirectGlyphs) ? m_direct[codepoint] : nullptr;
+        if (glyph == nullptr) {
+            const auto it = m_glyphs.find(codepoint);
+            if (it != m_glyphs.end())
+                glyph = &it->second;
+        }
+        if (glyph != nullptr) {
+            if (glyph->hasQuad)
+                m_pages[glyph->page].lastUsed = m_frame;
+            return glyph;
+        }
+
+        if (!m_source.Rasterize(codepoint, m_bitmap))
+            return nullptr;
+
+        KBK_PROFILE_SCOPE("GlyphGenerate");
+
+        AtlasGlyph entry;
+        entry.advance = m_bitmap.advance;
+
+        const bool blank = std::none_of(m_bitmap.coverage.begin(), m_bitmap.coverage.end(),
+            [](std::uint8_t c) { return c >= 128; });
+        if (!blank) {
+            std::uint16_t page = 0;
+            std::uint32_t cell = 0;
+            if (!AllocateCell(page, cell)) {
+                ++m_stats.acquireFailures;
+                if (m_lastFailureFrame != m_frame) {
+                    m_lastFailureFrame = m_frame;
+                    KbkWarn(kLogChannel, "Glyph atlas full: all %zu pages are in use this frame", m_pages.size());
+                }
+                return nullptr;
+            }
+
+            const std::size_t texels = static_cast<std::size_t>(m_desc.cellSize) * static_cast<std::size_t>(m_desc.cellSize);
+            m_field.resize(texels);
+            BuildGlyphDistanceField(m_bitmap, m_desc.cellSize, m_desc.spread, m_texelsPerEm, m_field.data());
+
+            // White texels, distance in alpha
+            const std::size_t offset = m_staging.size();
+            m_staging.resize(offset + texels * 4u, 255);
+            for (std::size_t i = 0; i < texels; ++i)
+                m_staging[offset + i * 4u + 3u] = m_field[i];
+            m_pending.push_back({ page, cell, offset });
+
+            const float cellEm = static_cast<float>(m_desc.cellSize) / m_texelsPerEm;
+            const float marginEm = static_cast<float>(m_desc.spread) / m_texelsPerEm;
+            entry.x0 = m_bitmap.boxX - marginEm;
+            entry.y0 = m_bitmap.boxY - marginEm;
+            entry.x1 = entry.x0 + cellEm;
+            entry.y1 = entry.y0 + cellEm;
+
+            const float cellUV = static_cast<float>(m_desc.cellSize) / static_cast<float>(m_desc.pageSize);
+            entry.u0 = static_cast<float>(cell % m_cellsPerRow) * cellUV;
+            entry.v0 = static_cast<float>(cell / m_cellsPerRow) * cellUV;
+            entry.u1 = entry.u0 + cellUV;
+            entry.v1 = entry.v0 + cellUV;
+
+            entry.page = page;
+            entry.hasQuad = true;
+
+            Page& p = m_pages[page];
+            p.glyphs.push_back(codepoint);
+            p.lastUsed = m_frame;
+            ++m_stats.glyphsGenerated;
+        }
+
+        const AtlasGlyph* stored = &m_glyphs.emplace(codepoint, entry).first->second;
+        if (codepoint < kDirectGlyphs)
+            m_direct[codepoint] = stored;
+        return stored;
+    }
+
+    bool GlyphAtlas2D::AllocateCell(std::uint16_t& page, std::uint32_t& cell)
+    {
+        for (std::size_t i = 0; i < m_pages.size(); ++i) {
+            if (m_pages[i].usedCells < m_cellsPerPage) {
+                page = static_cast<std::uint16_t>(i);
+                cell = m_pages[i].usedCells++;
+                return true;
+            }
+        }
+
+        if (m_pages.size() < m_desc.maxPages) {
+            m_pages.emplace_back();
+            page = static_cast<std::uint16_t>(m_pages.size() - 1);
+            cell = m_pages.back().usedCells++;
+            return true;
+        }
+
+        // Least recently used page that nothing drawn this frame points into
+        std::size_t victim = m_pages.size();
+        for (std::size_t i = 0; i < m_pages.size(); ++i) {
+            if (m_pages[i].lastUsed >= m_frame)
+                continue;
+            if (victim == m_pages.size() || m_pages[i].lastUsed < m_pages[victim].lastUsed)
+                victim = i;
+        }
+        if (victim == m_pages.size())
+            return false;
+
+        page = static_cast<std::uint16_t>(victim);
+        EvictPage(page);
+        cell = m_pages[victim].usedCells++;
+        return true;
+    }
+
+    void GlyphAtlas2D::EvictPage(std::uint16_t page)
+    {
+        Page& p = m_pages[page];
+        for (const char32_t codepoint : p.glyphs) {
+            m_glyphs.erase(codepoint);
+            if (codepoint < kDirectGlyphs)
+                m_direct[codepoint] = nullptr;
+        }
+        p.glyphs.clear();
+        p.usedCells = 0;
+        ++m_stats.pagesEvicted;
+    }
+
+    void GlyphAtlas2D::Upload(ID3D11Device* device, ID3D11DeviceContext* context)
+    {
+        KBK_PROFILE_SCOPE("GlyphAtlasUpload");
+
+        if (device == nullptr || context == nullptr)
+            return;
+
+        for (Page& page : m_pages) {
+            if (!page.texture.IsValid() && !page.texture.CreateUpdatable(device, m_desc.pageSize, m_desc.pageSize))
+                return; // keep the cells pending; CreateUpdatable logged why
+        }
+
+        const int cellSize = m_desc.cellSize;
+        for (const PendingCell& pending : m_pending) {
+            const int x = static_cast<int>(pending.cell % m_cellsPerRow) * cellSize;
+            const int y = static_cast<int>(pending.cell / m_cellsPerRow) * cellSize;
+            m_pages[pending.page].texture.UpdateRegion(context, x, y, cellSize, cellSize,
+                m_staging.data() + pending.offset, cellSize * 4);
+        }
+        KBK_PROFILE_COUNTER("Text.GlyphCellsUploaded", m_pending.size());
+
+        m_pending.clear();
+        m_staging.clear();
+    }
+
+    void GlyphAtlas2D::Clear()
+    {
+        m_pages.clear();
+        m_glyphs.clear();
+        std::fill(std::begin(m_direct), std::end(m_direct), nullptr);
+        m_pending.clear();
+        m_staging.clear();
+    }
+
+    const Texture2D* GlyphAtlas2D::PageTexture(std::size_t page) const
+    {
+        if (page >= m_pages.size() || !m_pages[page].texture.IsValid())
+            return nullptr;
+        return &m_pages[page].texture;
+    }
+
+} // namespace KibakoEngine
@@ -0,0 +1,267 @@
+// Lays out UTF-8 runs with the glyph atlas and writes the quads into the sprite batch
+#include "KibakoEngine/Text/TextRenderer2D.h"
+
+#include "KibakoEngine/Core/Profiler.h"
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+
+#include <algorithm>
+
+namespace KibakoEngine {
+
+    namespace
+    {
+        constexpr char32_t kReplacementGlyph = U'?';
+        constexpr float    kMissingAdvance = 0.5f; // em, when not even the replacement exists
+
+        // Next codepoint of a UTF-8 run; malformed bytes decode as U+FFFD one at a time
+        char32_t DecodeUtf8(std::string_view text, std::size_t& i)
+        {
+            const auto byte = [&](std::size_t at) { return static_cast<std::uint8_t>(text[at]); };
+
+            const std::uint8_t lead = byte(i++);
+            if (lead < 0x80)
+                return lead;
+
+            int extra = 0;
+            char32_t cp = 0;
+            if ((lead & 0xE0) == 0xC0) {
+                extra = 1;
+                cp = lead & 0x1Fu;
+            }
+            else if ((lead & 0xF0) == 0xE0) {
+                extra = 2;
+                cp = lead & 0x0Fu;
+            }
+            else if ((lead & 0xF8) == 0xF0) {
+                extra = 3;
+                cp = lead & 0x07u;
+            }
+            else {
+                return 0xFFFD;
+            }
+
+            if (i + static_cast<std::size_t>(extra) > text.size())
+                return 0xFFFD;
+            for (int k = 0; k < extra; ++k) {
+                const std::uint8_t next = byte(i);
+                if ((next & 0xC0) != 0x80)
+                    return 0xFFFD;
+                cp = (cp << 6) | (next & 0x3Fu);
+                ++i;
+            }
+            return cp;
+        }
+    }
+
+    TextRenderer2D::TextRenderer2D(const GlyphAtlasDesc& desc, const GlyphSource2D* source)
+        : m_atlas(source ? *source : m_builtinSource, desc)
+    {
+    }
+
+    void TextRenderer2D::Init(ID3D11Device* device, ID3D11DeviceContext* context)
+    {
+        m_device = device;
+        m_context = context;
+    }
+
+    void TextRenderer2D::Shutdown()
+    {
+        Clear();
+        m_atlas.Clear();
+        m_device = nullptr;
+        m_context = nullptr;
+    }
+
+    TextRenderer2D::Bucket& TextRenderer2D::BucketFor(std::uint16_t page, int layer, BlendMode blend)
+    {
+        if (m_lastBucket < m_buckets.size()) {
+            Bucket& last = m_buckets[m_lastBucket];
+            if (last.page == page && last.layer == layer && last.blend == blend)
+                return last;
+        }
+
+        for (std::size_t i = 0; i < m_buckets.size(); ++i) {
+            if (m_buckets[i].page == page && m_buckets[i].layer == layer && m_buckets[i].blend == blend) {
+                m_lastBucket = i;
+                return m_buckets[i];
+            }
+        }
+
+        m_lastBucket = m_buckets.size();
+        Bucket& bucket = m_buckets.emplace_back();
+        bucket.page = page;
+        bucket.layer = layer;
+        bucket.blend = blend;
+        return bucket;
+    }
+
+    void TextRenderer2D::EndLine(float lineWidth, float anchorX, TextAlign align)
+    {
+        float offset = anchorX;
+        if (align == TextAlign::Center)
+            offset -= lineWidth * 0.5f;
+        else if (align == TextAlign::Right)
+            offset -= lineWidth;
+
+        for (const LineGlyph& g : m_line) {
+            GlyphQuad& q = m_buckets[g.bucket].quads[g.quad];
+            q.x0 += offset;
+            q.x1 += offset;
+        }
+        m_line.clear();
+    }
+
+    void TextRenderer2D::DrawLabel(std::string_view utf8, const DirectX::XMFLOAT2& position, const TextStyle& style)
+    {
+        if (utf8.empty() || !(style.size > 0.0f))
+            return;
+
+        const float size = style.size;
+        const float lineHeight = m_atlas.LineHeight() * size;
+
+        float penX = 0.0f; // from the line start; the alignment offset is applied per line
+        float penY = position.y;
+        m_line.clear();
+
+        std::size_t i = 0;
+        while (i < utf8.size()) {
+            const char32_t cp = DecodeUtf8(utf8, i);
+            if (cp == U'\n') {
+                EndLine(penX, position.x, style.align);
+                penX = 0.0f;
+                penY += lineHeight;
+                continue;
+            }
+            if (cp == U'\r')
+                continue;
+
+            const AtlasGlyph* glyph = m_atlas.Acquire(cp);
+            if (glyph == nullptr)
+                glyph = m_atlas.Acquire(kReplacementGlyph);
+            if (glyph == nullptr) {
+                penX += kMissingAdvance * size;
+                continue;
+            }
+
+            if (glyph->hasQuad) {
+                Bucket& bucket = BucketFor(glyph->page, style.layer, style.blend);
+                m_line.push_back({ static_cast<std::uint32_t>(m_lastBucket), static_cast<std::uint32_t>(bucket.quads.size()) });
+                bucket.quads.push_back({
+                    penX + glyph->x0 * size, penY + glyph->y0 * size,
+                    penX + glyph->x1 * size, penY + glyph->y1 * size,
+                    glyph->u0, glyph->v0, glyph->u1, glyph->v1,
+                    style.color });
+            }
+            penX += glyph->advance * size;
+        }
+        EndLine(penX, position.x, style.align);
+
+        ++m_queuedLabels;
+    }
+
+    DirectX::XMFLOAT2 TextRenderer2D::Measure(std::string_view utf8, float size)
+    {
+        if (utf8.empty())
+            return { 0.0f, 0.0f };
+
+        float width = 0.0f;
+        float line = 0.0f;
+        int lines = 1;
+
+        std::size_t i = 0;
+        while (i < utf8.size()) {
+            const char32_t cp = DecodeUtf8(utf8, i);
+            if (cp == U'\n') {
+                width = std::max(width, line);
+                line = 0.0f;
+                ++lines;
+                continue;
+            }
+            if (cp == U'\r')
+                continue;
+
+            const AtlasGlyph* glyph = m_atlas.Acquire(cp);
+            if (glyph == nullptr)
+                glyph = m_atlas.Acquire(kReplacementGlyph);
+            line += glyph ? glyph->advance : kMissingAdvance;
+        }
+        width = std::max(width, line);
+
+        return { width * size, static_cast<float>(lines) * m_atlas.LineHeight() * size };
+    }
+
+    void TextRenderer2D::Flush(SpriteBatch2D& batch)
+    {
+        KBK_PROFILE_SCOPE("TextFlush");
+
+        m_stats = {};
+        m_stats.labels = m_queuedLabels;
+        m_queuedLabels = 0;
+
+        m_atlas.Upload(m_device, m_context);
+
+        for (Bucket& bucket : m_buckets) {
+            const std::size_t count = bucket.quads.size();
+            if (count == 0)
+                continue;
+
+            // No texture yet (no device, or the page could not be created): drop the glyphs
+            const Texture2D* page = m_atlas.PageTexture(bucket.page);
+            const SpriteBatch2D::GeometryWriter out = page
+                ? batch.AllocateGeometry(page, count * 4, count * 6, bucket.layer, bucket.blend)
+                : SpriteBatch2D::GeometryWriter{};
+            if (out.vertices == nullptr) {
+                bucket.quads.clear();
+                continue;
+            }
+
+            constexpr float mode = SpriteBatch2D::kShadeDistanceField;
+            SpriteBatch2D::Vertex* v = out.vertices;
+            std::uint32_t* idx = out.indices;
+            std::uint32_t base = 0;
+            for (const GlyphQuad& q : bucket.quads) {
+                const DirectX::XMFLOAT4 color{ q.color.r, q.color.g, q.color.b, q.color.a };
+                v[0] = { { q.x0, q.y0, mode }, { q.u0, q.v0 }, color };
+                v[1] = { { q.x1, q.y0, mode }, { q.u1, q.v0 }, color };
+                v[2] = { { q.x1, q.y1, mode }, { q.u1, q.v1 }, color };
+                v[3] = { { q.x0, q.y1, mode }, { q.u0, q.v1 }, color };
+                v += 4;
+
+                idx[0] = base;
+                idx[1] = base + 1;
+                idx[2] = base + 2;
+                idx[3] = base;
+                idx[4] = base + 2;
+                idx[5] = base + 3;
+                idx += 6;
+                base += 4;
+            }
+
+            m_stats.glyphs += static_cast<std::uint32_t>(count);
+            ++m_stats.submissions;
+            bucket.quads.clear();
+        }
+
+        m_atlas.NextFrame();
+
+        KBK_PROFILE_COUNTER("Text.Glyphs", m_stats.glyphs);
+        KBK_PROFILE_COUNTER("Text.Submissions", m_stats.submissions);
+    }
+
+    void TextRenderer2D::Clear()
+    {
+        for (Bucket& bucket : m_buckets)
+            bucket.quads.clear();
+        m_line.clear();
+        m_queuedLabels = 0;
+    }
+
+    std::size_t TextRenderer2D::QueuedGlyphs() const
+    {
+        std::size_t count = 0;
+        for (const Bucket& bucket : m_buckets)
+            count += bucket.quads.size();
+        return count;
+    }
+
+} // namespace KibakoEngine
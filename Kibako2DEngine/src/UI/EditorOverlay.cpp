@@ -502,17 +502,12 @@ namespace KibakoEngine {
                 m_statsEntities->SetInnerRML("Entities: (no scene)");
             }
             else {
-                const auto& ents = m_scene->Entities();
-                int activeCount = 0;
-                for (const auto& e : ents)
-                    if (e.active) ++activeCount;
-
                 std::string text;
                 text.reserve(64);
                 text.append("Entities: ");
-                text.append(std::to_string(ents.size()));
+                text.append(std::to_string(m_scene->Entities().size()));
                 text.append(" (active ");
-                text.append(std::to_string(activeCount));
+                text.append(std::to_string(m_scene->ActiveCount()));
                 text.append(")");
                 m_statsEntities->SetInnerRML(text.c_str());
             }
@@ -596,11 +591,11 @@ namespace KibakoEngine {
         const auto* name = m_scene->TryGetName(entity->id);
 
         const std::string nameText = name ? name->name : "";
-        const std::string posXText = FormatFloat(entity->transform.position.x);
-        const std::string posYText = FormatFloat(entity->transform.position.y);
-        const std::string rotText = FormatFloat(entity->transform.rotation);
-        const std::string scaleXText = FormatFloat(entity->transform.scale.x);
-        const std::string scaleYText = FormatFloat(entity->transform.scale.y);
+        const std::string posXText = FormatFloat(entity->Transform().position.x);
+        const std::string posYText = FormatFloat(entity->Transform().position.y);
+        const std::string rotText = FormatFloat(entity->Transform().rotation);
+        const std::string scaleXText = FormatFloat(entity->Transform().scale.x);
+        const std::string scaleYText = FormatFloat(entity->Transform().scale.y);
 
         auto maybeSet = [this](Rml::ElementFormControlInput* input,
             const std::string& value,
@@ -658,12 +653,14 @@ namespace KibakoEngine {
         }
 
         // Transform
+        Transform2D transform = entity->Transform();
         float v = 0.0f;
-        if (m_insPosX && ParseFloat(m_insPosX->GetValue(), v)) { entity->transform.position.x = v; m_lastInsPosX = m_insPosX->GetValue().c_str(); }
-        if (m_insPosY && ParseFloat(m_insPosY->GetValue(), v)) { entity->transform.position.y = v; m_lastInsPosY = m_insPosY->GetValue().c_str(); }
-        if (m_insRot && ParseFloat(m_insRot->GetValue(), v)) { entity->transform.rotation = v; m_lastInsRot = m_insRot->GetValue().c_str(); }
-        if (m_insScaleX && ParseFloat(m_insScaleX->GetValue(), v)) { entity->transform.scale.x = v; m_lastInsScaleX = m_insScaleX->GetValue().c_str(); }
-        if (m_insScaleY && ParseFloat(m_insScaleY->GetValue(), v)) { entity->transform.scale.y = v; m_lastInsScaleY = m_insScaleY->GetValue().c_str(); }
+        if (m_insPosX && ParseFloat(m_insPosX->GetValue(), v)) { transform.position.x = v; m_lastInsPosX = m_insPosX->GetValue().c_str(); }
+        if (m_insPosY && ParseFloat(m_insPosY->GetValue(), v)) { transform.position.y = v; m_lastInsPosY = m_insPosY->GetValue().c_str(); }
+        if (m_insRot && ParseFloat(m_insRot->GetValue(), v)) { transform.rotation = v; m_lastInsRot = m_insRot->GetValue().c_str(); }
+        if (m_insScaleX && ParseFloat(m_insScaleX->GetValue(), v)) { transform.scale.x = v; m_lastInsScaleX = m_insScaleX->GetValue().c_str(); }
+        if (m_insScaleY && ParseFloat(m_insScaleY->GetValue(), v)) { transform.scale.y = v; m_lastInsScaleY = m_insScaleY->GetValue().c_str(); }
+        m_scene->SetTransform(entity->id, transform);
 
         // Refresh immediately (inspector) – tree rebuild will happen on next cadence tick.
         m_inspectorDirty = true;
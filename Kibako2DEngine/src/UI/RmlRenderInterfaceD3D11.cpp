@@ -10,6 +10,7 @@ namespace KibakoEngine {
 
     namespace {
         constexpr const char* kLog = "RmlRender";
+        constexpr int kUILayer = 100000;
 
         static RectF BuildClipRect(const Rml::Rectanglei& region)
         {
@@ -96,26 +97,21 @@ namespace KibakoEngine {
             texPtr = m_Renderer.Batch().DefaultWhiteTexture();
         }
 
-        if (m_scissorEnabled) {
-            m_Renderer.Batch().PushGeometryView(
-                texPtr,
-                geo.vertices.data(), geo.vertices.size(),
-                geo.indices.data(), geo.indices.size(),
-                100000,
-                BuildClipRect(m_scissorRegion),
-                { translation.x, translation.y }
-            );
-            return;
-        }
+        // Rml paints in order: its queue is never re-sorted, and above the
+        // lit world layers so the sprite lighting leaves it alone
+        SpriteBatch2D& batch = m_Renderer.Batch();
+        const RenderQueue2D previousQueue = batch.SetQueue(RenderQueue2D::UI);
 
-        m_Renderer.Batch().PushGeometryView(
+        batch.PushGeometryView(
             texPtr,
             geo.vertices.data(), geo.vertices.size(),
             geo.indices.data(), geo.indices.size(),
-            100000,
-            RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f),
+            kUILayer,
+            m_scissorEnabled ? BuildClipRect(m_scissorRegion) : RectF::FromXYWH(0.0f, 0.0f, 0.0f, 0.0f),
             { translation.x, translation.y }
         );
+
+        batch.SetQueue(previousQueue);
     }
 
     void RmlRenderInterfaceD3D11::EnableScissorRegion(bool enable)
@@ -0,0 +1,11 @@
+// Times the batched flipbook update on a large crowd of animated sprites
+#pragma once
+
+#include <cstddef>
+
+namespace KibakoEngine {
+    class JobSystem;
+}
+
+// Logs animators updated per ms and sprite writes per frame, serial vs. JobSystem
+void RunAnimationBenchmark(KibakoEngine::JobSystem& jobs, std::size_t spriteCount = 100000);
@@ -1,9 +1,18 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
+#include "KibakoEngine/Core/Input.h"
 #include "KibakoEngine/Core/Layer.h"
+#include "KibakoEngine/Particles/ParticleSystem2D.h"
+#include "KibakoEngine/Renderer/LightGrid2D.h"
+#include "KibakoEngine/Renderer/SpriteLighting2D.h"
+#include "KibakoEngine/Renderer/Texture2D.h"
 #include "KibakoEngine/Scene/Scene2D.h"
+#include "KibakoEngine/Scene/SceneVisibility2D.h"
+#include "KibakoEngine/Scene/SystemScheduler2D.h"
+#include "KibakoEngine/Text/TextRenderer2D.h"
 
 namespace KibakoEngine {
     class Application;
@@ -22,19 +31,67 @@ public:
     void OnFixedUpdate(float fixedDt) override;
     void OnRender(KibakoEngine::SpriteBatch2D& batch) override;
 
+    void OnPrepareViews(std::span<const KibakoEngine::RenderView2D> views) override;
+    void OnRenderView(KibakoEngine::SpriteBatch2D& batch,
+        std::size_t viewIndex,
+        const KibakoEngine::RenderView2D& view) override;
+
     KibakoEngine::Scene2D& GetScene() { return m_scene; }
     const KibakoEngine::Scene2D& GetScene() const { return m_scene; }
 
 private:
+    void RegisterSystems();
     void FixedSimStep(float fixedDt);
     void ToggleCollisionDebug();
+    void ToggleMinimap();
 
 private:
     KibakoEngine::Application& m_app;
     KibakoEngine::Scene2D      m_scene;
 
+    // Fixed-step gameplay systems (declared after the scene they run on)
+    KibakoEngine::SystemScheduler2D m_systems{ m_scene };
+
     std::uint32_t m_entityLeft = 0;
     std::uint32_t m_entityRight = 0;
 
     float m_simTime = 0.0f;
+
+    // Resolved once in OnAttach
+    KibakoEngine::ActionId m_actionToggleDebug;
+    KibakoEngine::ActionId m_actionToggleMinimap;
+    KibakoEngine::ActionId m_actionHierarchyBench;
+    KibakoEngine::ActionId m_actionParticleBench;
+    KibakoEngine::ActionId m_actionAnimationBench;
+    KibakoEngine::ActionId m_actionTextBench;
+    KibakoEngine::ActionId m_actionToggleLighting;
+    KibakoEngine::ActionId m_actionLightingBench;
+    KibakoEngine::ActionId m_actionToggleOpaquePass;
+    KibakoEngine::ActionId m_actionOverdrawBench;
+    KibakoEngine::ActionId m_actionShaderCacheBench;
+
+    // Sparks trailing the left star
+    KibakoEngine::ParticleSystem2D   m_particles;
+    KibakoEngine::ParticleEmitter2D* m_trail = nullptr;
+
+    // Name labels over the stars; the text benchmark runs in the next OnRender
+    KibakoEngine::TextRenderer2D m_text;
+    bool                         m_textBenchPending = false;
+
+    // Point lights from the scene, binned per frame for the main view
+    KibakoEngine::LightGrid2D                  m_lightGrid;
+    KibakoEngine::SpriteLighting2D             m_lighting;
+    std::vector<KibakoEngine::LightInstance2D> m_frameLights;
+    bool                                       m_lightingEnabled = true;
+
+    // Depth-tested opaque sprite pass; the live frame's overdraw estimate is
+    // requested in one OnRender and logged in the next (the batch computes it at End)
+    bool m_opaquePassEnabled = true;
+    bool m_overdrawRequestPending = false;
+    bool m_overdrawReportPending = false;
+
+    // Minimap (render-to-texture view)
+    KibakoEngine::SceneVisibility2D m_visibility;
+    KibakoEngine::Texture2D         m_minimapTarget;
+    bool                            m_minimapEnabled = false;
 };
\ No newline at end of file
@@ -0,0 +1,11 @@
+// Times transform propagation on a synthetic ship/turret hierarchy
+#pragma once
+
+#include <cstddef>
+
+namespace KibakoEngine {
+    class JobSystem;
+}
+
+// Logs layout rebuild, full and partial propagation timings, serial vs. JobSystem
+void RunHierarchyBenchmark(KibakoEngine::JobSystem& jobs, std::size_t nodeCount = 100000);
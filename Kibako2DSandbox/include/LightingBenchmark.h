@@ -0,0 +1,14 @@
+// Times tiled light binning and checks it against the brute-force lighting reference
+#pragma once
+
+#include <cstddef>
+
+namespace KibakoEngine {
+    class JobSystem;
+}
+
+// Logs light-grid build times, serial vs. JobSystem (one chunk per few tile
+// rows), then compares the per-tile shading with the all-lights loop at
+// random pixels and logs the largest difference
+void RunLightingBenchmark(KibakoEngine::JobSystem& jobs, std::size_t lightCount = 1000,
+    float width = 1920.0f, float height = 1080.0f);
@@ -0,0 +1,8 @@
+// Headless overdraw estimate for a layered 2D scene, painter's order vs. the depth-tested opaque pass
+#pragma once
+
+// Builds a parallax-heavy frame (full-screen opaque backdrops, alpha-tested
+// foliage bands, an opaque tile floor, translucent actors and particles) in
+// painter's order, runs OverdrawEstimator2D over it at width x height and
+// logs the layers shaded per pixel both ways and the saving
+void RunOverdrawBenchmark(float width = 1920.0f, float height = 1080.0f);
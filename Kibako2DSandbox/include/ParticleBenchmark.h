@@ -0,0 +1,12 @@
+// Times the particle kernels on many saturated emitters
+#pragma once
+
+#include <cstddef>
+
+namespace KibakoEngine {
+    class JobSystem;
+}
+
+// Logs particles simulated per ms, serial vs. JobSystem (one emitter per chunk)
+void RunParticleBenchmark(KibakoEngine::JobSystem& jobs, std::size_t emitterCount = 64,
+    std::size_t particlesPerEmitter = 4096);
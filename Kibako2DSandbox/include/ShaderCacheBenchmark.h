@@ -0,0 +1,18 @@
+// Shader cache checks with a stub compiler, and SpriteBatch2D shader startup with and without the cache
+#pragma once
+
+#include <filesystem>
+
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+
+// Drives ShaderCache with a stub compiler in `directory` (emptied first): miss,
+// memory and disk hits, corrupt and truncated files, and key changes (source,
+// defines, compiler version). Logs each failed expectation; true when all pass.
+// Needs nothing but ShaderCache, so it runs on any platform.
+bool RunShaderCacheChecks(const std::filesystem::path& directory);
+
+// Runs the checks, then times SpriteBatch2D::Init with no cache (compiles
+// every launch), with an empty cache directory (first launch) and with a
+// filled one (later launches), each through a fresh ShaderCache
+void RunShaderCacheBenchmark(ID3D11Device* device, ID3D11DeviceContext* context);
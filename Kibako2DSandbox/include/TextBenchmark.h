@@ -0,0 +1,14 @@
+// Times distance-field label layout and batch output for thousands of short labels
+#pragma once
+
+#include <cstddef>
+
+namespace KibakoEngine {
+    class SpriteBatch2D;
+    class TextRenderer2D;
+}
+
+// Logs labels and glyphs laid out per ms, then flushes one frame's worth into
+// the batch (so call it between Begin and End: the labels show for a frame)
+void RunTextBenchmark(KibakoEngine::TextRenderer2D& text, KibakoEngine::SpriteBatch2D& batch,
+    std::size_t labelCount = 5000);
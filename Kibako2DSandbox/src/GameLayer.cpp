@@ -1,31 +1,72 @@
 #include "GameLayer.h"
+#include "AnimationBenchmark.h"
+#include "HierarchyBenchmark.h"
+#include "LightingBenchmark.h"
+#include "OverdrawBenchmark.h"
+#include "ParticleBenchmark.h"
+#include "ShaderCacheBenchmark.h"
+#include "TextBenchmark.h"
 
 #include "KibakoEngine/Core/Application.h"
 #include "KibakoEngine/Core/Debug.h"
+#include "KibakoEngine/Core/GameServices.h"
 #include "KibakoEngine/Core/Log.h"
 #include "KibakoEngine/Core/Profiler.h"
 #include "KibakoEngine/Renderer/Camera2D.h"
+#include "KibakoEngine/Renderer/RenderView2D.h"
+#include "KibakoEngine/Renderer/ViewFrustum2D.h"
 
 #include <SDL2/SDL_scancode.h>
-#include <cmath>
 
 using namespace KibakoEngine;
 
 namespace {
     constexpr const char* kLogChannel = "Sandbox";
     constexpr const char* kScenePath = "assets/scenes/test.scene.json";
+    constexpr const char* kMinimapView = "Sandbox.Minimap";
+
+    constexpr int   kMinimapWidth = 240;
+    constexpr int   kMinimapHeight = 135;
+    constexpr float kMinimapZoom = 0.25f;
+    constexpr int   kMinimapLayer = 500;
+
+    // World layers take the lights; the spark trail (10) and labels (20) stay unlit
+    constexpr int    kMaxLitLayer = 9;
+    constexpr Color4 kAmbientLight{ 0.35f, 0.35f, 0.45f, 1.0f };
+
+    // Spatial reorder steps per frame: a pass over a few thousand entities spreads over a handful of frames
+    constexpr std::size_t kSpatialReorderBudget = 1024;
 }
 
 GameLayer::GameLayer(Application& app)
     : Layer("Sandbox.GameLayer")
     , m_app(app)
 {
+    RegisterSystems();
 }
 
 void GameLayer::OnAttach()
 {
     KBK_PROFILE_SCOPE("Sandbox.GameLayer.Attach");
 
+    auto& input = m_app.InputSys();
+    m_actionToggleDebug = input.BindAction("Sandbox.ToggleCollisionDebug", SDL_SCANCODE_F1);
+    m_actionToggleMinimap = input.BindAction("Sandbox.ToggleMinimap", SDL_SCANCODE_F2);
+    input.BindGamepadButton("Sandbox.ToggleMinimap", SDL_CONTROLLER_BUTTON_BACK);
+    m_actionHierarchyBench = input.BindAction("Sandbox.HierarchyBenchmark", SDL_SCANCODE_F3);
+    m_actionParticleBench = input.BindAction("Sandbox.ParticleBenchmark", SDL_SCANCODE_F4);
+    m_actionAnimationBench = input.BindAction("Sandbox.AnimationBenchmark", SDL_SCANCODE_F5);
+    m_actionTextBench = input.BindAction("Sandbox.TextBenchmark", SDL_SCANCODE_F6);
+    m_actionToggleLighting = input.BindAction("Sandbox.ToggleLighting", SDL_SCANCODE_F7);
+    m_actionLightingBench = input.BindAction("Sandbox.LightingBenchmark", SDL_SCANCODE_F8);
+    m_actionToggleOpaquePass = input.BindAction("Sandbox.ToggleOpaquePass", SDL_SCANCODE_F9);
+    m_actionOverdrawBench = input.BindAction("Sandbox.OverdrawBenchmark", SDL_SCANCODE_F10);
+    m_actionShaderCacheBench = input.BindAction("Sandbox.ShaderCacheBenchmark", SDL_SCANCODE_F11);
+
+    m_text.Init(m_app.Renderer().GetDevice(), m_app.Renderer().GetImmediateContext());
+    if (!m_lighting.Init(m_app.Renderer().GetDevice()))
+        KbkWarn(kLogChannel, "Lighting unavailable");
+
     if (!m_scene.LoadFromFile(kScenePath, m_app.Assets())) {
         KbkError(kLogChannel, "Failed to load scene: %s", kScenePath);
         return;
@@ -40,6 +81,23 @@ void GameLayer::OnAttach()
     // Default: debug OFF
     m_scene.SetCollisionDebugEnabled(false);
 
+    ParticleEmitterDesc trail;
+    trail.capacity = 512;
+    trail.rate = 120.0f;
+    trail.lifeMin = 0.4f;
+    trail.lifeMax = 0.9f;
+    trail.speedMin = 20.0f;
+    trail.speedMax = 60.0f;
+    trail.gravity = { 0.0f, 40.0f };
+    trail.drag = 1.5f;
+    trail.sizeStart = 6.0f;
+    trail.sizeEnd = 1.0f;
+    trail.colorStart = Color4{ 1.0f, 0.85f, 0.4f, 1.0f };
+    trail.colorEnd = Color4{ 1.0f, 0.3f, 0.1f, 0.0f };
+    trail.layer = 10;
+    trail.blend = BlendMode::Additive;
+    m_trail = &m_particles.CreateEmitter(trail);
+
     KbkLog(kLogChannel, "GameLayer attached (scene loaded, %zu entities)", m_scene.Entities().size());
 }
 
@@ -47,22 +105,78 @@ void GameLayer::OnDetach()
 {
     KBK_PROFILE_SCOPE("Sandbox.GameLayer.Detach");
 
+    if (m_minimapEnabled)
+        ToggleMinimap();
+    m_minimapTarget.Reset();
+
     m_scene.SetCollisionDebugEnabled(false);
     m_scene.Clear();
+    m_particles.Clear();
+    m_trail = nullptr;
+    m_text.Shutdown();
+    m_textBenchPending = false;
+    m_lighting.Shutdown();
+    m_lightGrid.Clear();
+    m_frameLights.clear();
 
     m_entityLeft = 0;
     m_entityRight = 0;
     m_simTime = 0.0f;
 }
 
-void GameLayer::OnUpdate(float /*dt*/)
+void GameLayer::OnUpdate(float dt)
 {
     KBK_PROFILE_SCOPE("Sandbox.GameLayer.Update");
 
     auto& input = m_app.InputSys();
-    if (input.KeyPressed(SDL_SCANCODE_F1)) {
+    if (input.ActionPressed(m_actionToggleDebug)) {
         ToggleCollisionDebug();
     }
+    if (input.ActionPressed(m_actionToggleMinimap)) {
+        ToggleMinimap();
+    }
+    if (input.ActionPressed(m_actionHierarchyBench)) {
+        RunHierarchyBenchmark(m_app.Jobs());
+    }
+    if (input.ActionPressed(m_actionParticleBench)) {
+        RunParticleBenchmark(m_app.Jobs());
+    }
+    if (input.ActionPressed(m_actionAnimationBench)) {
+        RunAnimationBenchmark(m_app.Jobs());
+    }
+    if (input.ActionPressed(m_actionTextBench)) {
+        m_textBenchPending = true; // needs the batch: runs in OnRender
+    }
+    if (input.ActionPressed(m_actionToggleLighting)) {
+        m_lightingEnabled = !m_lightingEnabled;
+        KbkLog(kLogChannel, "Lighting %s", m_lightingEnabled ? "ON" : "OFF");
+    }
+    if (input.ActionPressed(m_actionLightingBench)) {
+        RunLightingBenchmark(m_app.Jobs());
+    }
+    if (input.ActionPressed(m_actionToggleOpaquePass)) {
+        m_opaquePassEnabled = !m_opaquePassEnabled;
+        KbkLog(kLogChannel, "Opaque pass %s", m_opaquePassEnabled ? "ON" : "OFF");
+    }
+    if (input.ActionPressed(m_actionOverdrawBench)) {
+        RunOverdrawBenchmark();
+        m_overdrawRequestPending = true; // the live frame's estimate needs the batch
+    }
+    if (input.ActionPressed(m_actionShaderCacheBench)) {
+        RunShaderCacheBenchmark(m_app.Renderer().GetDevice(), m_app.Renderer().GetImmediateContext());
+    }
+
+    m_scene.UpdateTransforms(&m_app.Jobs());
+    m_scene.UpdateAnimations(GameServices::GetTime(), &m_app.Jobs());
+
+    if (m_trail) {
+        const Entity2D* left = m_scene.FindEntity(m_entityLeft);
+        m_trail->SetEmitting(left != nullptr);
+        if (left)
+            m_trail->SetPosition(m_scene.WorldTransform(m_entityLeft).position);
+    }
+    m_particles.Update(dt, &m_app.Jobs());
+    m_scene.ReorderSpatially(kSpatialReorderBudget);
 }
 
 void GameLayer::OnFixedUpdate(float fixedDt)
@@ -75,21 +189,81 @@ void GameLayer::OnRender(SpriteBatch2D& batch)
 {
     KBK_PROFILE_SCOPE("Sandbox.GameLayer.Render");
 
-    const Camera2D& camera = m_app.Renderer().Camera();
+    batch.SetOpaquePass(m_opaquePassEnabled);
+    if (m_overdrawReportPending) {
+        m_overdrawReportPending = false;
+        const OverdrawEstimate& estimate = batch.LastOverdrawEstimate();
+        KbkLog(kLogChannel, "Frame overdraw: %u items (%u opaque), %.2f layers per pixel, %.2f with the opaque pass",
+            estimate.quads, estimate.opaqueQuads, estimate.PainterOverdraw(), estimate.DepthOverdraw());
+    }
+    if (m_overdrawRequestPending) {
+        m_overdrawRequestPending = false;
+        m_overdrawReportPending = true;
+        batch.RequestOverdrawEstimate();
+    }
 
-    // If camera rotates, conservative render (no culling rect)
-    if (std::fabs(camera.GetRotation()) > 0.0001f) {
-        m_scene.Render(batch);
-        return;
+    // Lights of the main view, binned into screen tiles for the sprite shader
+    if (m_lightingEnabled) {
+        const Camera2D& camera = m_app.Renderer().Camera();
+        const RectF viewport = RectF::FromXYWH(0.0f, 0.0f,
+            static_cast<float>(m_app.Width()), static_cast<float>(m_app.Height()));
+
+        m_frameLights.clear();
+        m_scene.CollectLights(camera, viewport, m_frameLights);
+        m_lightGrid.Build(m_frameLights, viewport, &m_app.Jobs());
+        if (m_lighting.Upload(m_app.Renderer().GetImmediateContext(), m_lightGrid, kAmbientLight))
+            batch.SetLighting(&m_lighting, kMaxLitLayer);
+    }
+
+    // Rotation-aware culling (bounding AABB broadphase + exact OBB test)
+    const ViewFrustum2D frustum = ViewFrustum2D::FromCamera(m_app.Renderer().Camera());
+    m_scene.Render(batch, frustum);
+    m_particles.Render(batch);
+
+    if (m_textBenchPending) {
+        m_textBenchPending = false;
+        RunTextBenchmark(m_text, batch);
     }
 
-    const RectF visibleRect = RectF::FromXYWH(
-        camera.GetPosition().x,
-        camera.GetPosition().y,
-        camera.GetViewportWidth(),
-        camera.GetViewportHeight());
+    TextStyle label;
+    label.size = 12.0f;
+    label.align = TextAlign::Center;
+    label.layer = 20;
+    for (const EntityID id : { m_entityLeft, m_entityRight }) {
+        const Entity2D* e = m_scene.FindEntity(id);
+        const NameComponent* name = m_scene.Names().TryGet(id);
+        if (!e || !e->active || !name)
+            continue;
+        // Centred just above the 64 px star sprite
+        const auto position = m_scene.WorldTransform(id).position;
+        m_text.DrawLabel(name->name, { position.x, position.y - 52.0f }, label);
+    }
+
+    // Labels and the minimap frame draw over the whole world pass, whatever its layers
+    const RenderQueue2D worldQueue = batch.SetQueue(RenderQueue2D::WorldOverlay);
+    m_text.Flush(batch);
+
+    if (m_minimapEnabled && m_minimapTarget.IsValid()) {
+        const float x = static_cast<float>(m_app.Width() - kMinimapWidth - 16);
+        batch.Push(m_minimapTarget,
+            RectF::FromXYWH(x, 16.0f, static_cast<float>(kMinimapWidth), static_cast<float>(kMinimapHeight)),
+            RectF::FromXYWH(0.0f, 0.0f, 1.0f, 1.0f),
+            Color4::White(),
+            0.0f,
+            kMinimapLayer);
+    }
+    batch.SetQueue(worldQueue);
+}
+
+void GameLayer::OnPrepareViews(std::span<const RenderView2D> views)
+{
+    KBK_PROFILE_SCOPE("Sandbox.GameLayer.PrepareViews");
+    m_scene.ExtractVisible(views, m_visibility);
+}
 
-    m_scene.Render(batch, &visibleRect);
+void GameLayer::OnRenderView(SpriteBatch2D& batch, std::size_t viewIndex, const RenderView2D& /*view*/)
+{
+    m_visibility.Submit(batch, viewIndex);
 }
 
 void GameLayer::ToggleCollisionDebug()
@@ -98,32 +272,70 @@ void GameLayer::ToggleCollisionDebug()
     m_scene.SetCollisionDebugEnabled(enabled);
 }
 
-void GameLayer::FixedSimStep(float fixedDt)
+void GameLayer::ToggleMinimap()
 {
-    m_simTime += fixedDt;
+    RendererD3D11& renderer = m_app.Renderer();
 
-    Entity2D* left = m_scene.FindEntity(m_entityLeft);
-    Entity2D* right = m_scene.FindEntity(m_entityRight);
+    if (m_minimapEnabled) {
+        renderer.RemoveView(kMinimapView);
+        m_minimapEnabled = false;
+        return;
+    }
 
-    if (left) {
-        left->transform.position.y += 0.1f;
+    if (!m_minimapTarget.IsValid() &&
+        !m_minimapTarget.CreateRenderTarget(renderer.GetDevice(), kMinimapWidth, kMinimapHeight)) {
+        KbkError(kLogChannel, "Failed to create minimap render target");
+        return;
     }
 
-    const auto* leftCol = m_scene.Collisions().TryGet(m_entityLeft);
-    const auto* rightCol = m_scene.Collisions().TryGet(m_entityRight);
+    RenderView2D& view = renderer.AddView(kMinimapView);
+    view.target = &m_minimapTarget;
+    view.SetViewport(RectF::FromXYWH(0.0f, 0.0f,
+        static_cast<float>(kMinimapWidth), static_cast<float>(kMinimapHeight)));
+    view.camera.SetZoom(kMinimapZoom);
+    view.clear = true;
+    view.clearColor = Color4{ 0.05f, 0.05f, 0.1f, 1.0f };
 
-    bool hit = false;
-    if (left && right && leftCol && rightCol && leftCol->circle && rightCol->circle) {
-        hit = Intersects(*leftCol->circle, left->transform, *rightCol->circle, right->transform);
-    }
+    m_minimapEnabled = true;
+}
 
-    if (auto* spr = m_scene.Sprites().TryGet(m_entityLeft)) {
-        spr->color = hit ? Color4::White() : Color4{ 0.9f, 0.9f, 0.9f, 1.0f };
-    }
+void GameLayer::RegisterSystems()
+{
+    // Drift writes transforms and the tint reads them, so the scheduler runs
+    // them in that order (separate waves); unrelated systems would share a wave.
+    m_systems.Add("Sandbox.Drift", SystemAccess{}.Write<Transform2D>(), [this](SystemContext& ctx) {
+        ctx.scene.PatchTransform(m_entityLeft, [](Transform2D& t) { t.position.y += 0.1f; });
+        });
 
-    if (auto* spr = m_scene.Sprites().TryGet(m_entityRight)) {
-        spr->color = hit ? Color4{ 0.85f, 0.85f, 0.85f, 1.0f } : Color4{ 0.55f, 0.55f, 0.55f, 1.0f };
-    }
+    m_systems.Add("Sandbox.CollisionTint",
+        SystemAccess{}.Read<Transform2D, CollisionComponent2D>().Write<SpriteRenderer2D>(),
+        [this](SystemContext& ctx) {
+            Scene2D& scene = ctx.scene;
+            const auto* leftCol = scene.Collisions().TryGet(m_entityLeft);
+            const auto* rightCol = scene.Collisions().TryGet(m_entityRight);
+
+            bool hit = false;
+            if (leftCol && rightCol && leftCol->circle && rightCol->circle) {
+                // World transforms: colliders follow their parents when attached
+                hit = Intersects(*leftCol->circle, scene.WorldTransform(m_entityLeft),
+                    *rightCol->circle, scene.WorldTransform(m_entityRight));
+            }
+
+            // Patch() stamps the sprites so change-tracking consumers pick up the tint
+            scene.Sprites().Patch(m_entityLeft, [hit](SpriteRenderer2D& spr) {
+                spr.color = hit ? Color4::White() : Color4{ 0.9f, 0.9f, 0.9f, 1.0f };
+                });
 
+            scene.Sprites().Patch(m_entityRight, [hit](SpriteRenderer2D& spr) {
+                spr.color = hit ? Color4{ 0.85f, 0.85f, 0.85f, 1.0f } : Color4{ 0.55f, 0.55f, 0.55f, 1.0f };
+                });
+        });
+}
+
+void GameLayer::FixedSimStep(float fixedDt)
+{
+    m_simTime += fixedDt;
+
+    m_systems.Run(fixedDt, &m_app.Jobs());
     m_scene.Update(fixedDt);
-}
\ No newline at end of file
+}
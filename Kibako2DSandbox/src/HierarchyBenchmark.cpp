@@ -0,0 +1,93 @@
+#include "HierarchyBenchmark.h"
+
+#include "KibakoEngine/Core/JobSystem.h"
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Scene/TransformHierarchy2D.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using namespace KibakoEngine;
+
+namespace {
+    constexpr const char* kLogChannel = "Sandbox.Bench";
+    constexpr int kIterations = 20;
+
+    // Deterministic, so runs are comparable between machines and builds
+    struct Lcg
+    {
+        std::uint32_t state = 12345u;
+        std::uint32_t Next() { state = state * 1664525u + 1013904223u; return state >> 8; }
+        float Unit() { return static_cast<float>(Next() & 0xFFFFu) / 65535.0f; }
+    };
+
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Marks `stride`-spaced entities dirty and returns the average propagate time
+    double TimePropagate(TransformHierarchy2D& hierarchy, std::size_t nodeCount, std::size_t stride, JobSystem* jobs)
+    {
+        Transform2D local;
+        double totalMs = 0.0;
+
+        for (int i = 0; i < kIterations; ++i) {
+            for (std::size_t id = 1; id <= nodeCount; id += stride) {
+                local.position = { static_cast<float>(i), static_cast<float>(id % 64) };
+                local.rotation = 0.01f * static_cast<float>(i);
+                hierarchy.SetLocal(static_cast<EntityID>(id), local);
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            hierarchy.Propagate(jobs);
+            totalMs += ElapsedMs(start);
+        }
+        return totalMs / kIterations;
+    }
+}
+
+void RunHierarchyBenchmark(JobSystem& jobs, std::size_t nodeCount)
+{
+    // One ship per 100 nodes, the rest are turrets/attachments hanging off
+    // earlier nodes of the same ship (depth ~ log of the ship size)
+    constexpr std::size_t kNodesPerShip = 100;
+
+    TransformHierarchy2D hierarchy;
+    Lcg rng;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t id = 1; id <= nodeCount; ++id) {
+        Transform2D local;
+        local.position = { rng.Unit() * 64.0f, rng.Unit() * 64.0f };
+        local.rotation = (rng.Next() % 4u == 0u) ? rng.Unit() : 0.0f;
+        hierarchy.Attach(static_cast<EntityID>(id), local);
+
+        const std::size_t shipRoot = ((id - 1) / kNodesPerShip) * kNodesPerShip + 1;
+        if (id != shipRoot) {
+            const std::size_t parent = shipRoot + rng.Next() % (id - shipRoot);
+            hierarchy.SetParent(static_cast<EntityID>(id), static_cast<EntityID>(parent));
+        }
+    }
+    const double buildMs = ElapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    hierarchy.Propagate(&jobs);
+    const double firstMs = ElapsedMs(start);
+
+    // Dirty roots only (stride = ship size) -> every node recomputed
+    const double fullSerial = TimePropagate(hierarchy, nodeCount, kNodesPerShip, nullptr);
+    const double fullParallel = TimePropagate(hierarchy, nodeCount, kNodesPerShip, &jobs);
+
+    // ~1% of the nodes touched, subtrees only
+    const double partialSerial = TimePropagate(hierarchy, nodeCount, 997, nullptr);
+    const double partialParallel = TimePropagate(hierarchy, nodeCount, 997, &jobs);
+
+    KbkLog(kLogChannel, "Hierarchy: %zu nodes, %zu depths, %u workers", hierarchy.NodeCount(),
+        hierarchy.DepthCount(), jobs.WorkerCount());
+    KbkLog(kLogChannel, "  build %.2f ms, rebuild + first propagate %.2f ms", buildMs, firstMs);
+    KbkLog(kLogChannel, "  all dirty : serial %.3f ms, parallel %.3f ms", fullSerial, fullParallel);
+    KbkLog(kLogChannel, "  ~1%% dirty: serial %.3f ms, parallel %.3f ms (%zu nodes updated)",
+        partialSerial, partialParallel, hierarchy.Changed().size());
+}
@@ -0,0 +1,66 @@
+#include "ShaderCacheBenchmark.h"
+
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Renderer/ShaderCache.h"
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+
+#include <chrono>
+#include <system_error>
+
+using namespace KibakoEngine;
+
+namespace {
+    constexpr const char* kLogChannel = "Sandbox.Bench";
+    constexpr int         kIterations = 5;
+
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // One simulated launch: a fresh batch and a fresh cache (nothing in memory)
+    double TimeBatchInit(ID3D11Device* device, ID3D11DeviceContext* context, const std::filesystem::path* directory)
+    {
+        ShaderCache cache(directory ? *directory : std::filesystem::path{});
+        SpriteBatch2D batch;
+
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = batch.Init(device, context, directory ? &cache : nullptr);
+        const double ms = ElapsedMs(start);
+
+        if (!ok)
+            KbkError(kLogChannel, "SpriteBatch2D::Init failed during the shader cache benchmark");
+        batch.Shutdown();
+        return ms;
+    }
+}
+
+void RunShaderCacheBenchmark(ID3D11Device* device, ID3D11DeviceContext* context)
+{
+    std::error_code ec;
+    const std::filesystem::path root = std::filesystem::temp_directory_path(ec) / "kibako_shadercache_bench";
+
+    RunShaderCacheChecks(root / "checks");
+
+    if (!device || !context)
+        return;
+
+    const std::filesystem::path directory = root / "sprites";
+
+    double uncachedMs = 0.0;
+    double firstLaunchMs = 0.0;
+    double laterLaunchMs = 0.0;
+    for (int i = 0; i < kIterations; ++i) {
+        uncachedMs += TimeBatchInit(device, context, nullptr);
+
+        std::filesystem::remove_all(directory, ec);
+        firstLaunchMs += TimeBatchInit(device, context, &directory);
+        laterLaunchMs += TimeBatchInit(device, context, &directory);
+    }
+    std::filesystem::remove_all(root, ec);
+
+    KbkLog(kLogChannel, "SpriteBatch2D::Init, mean of %d:", kIterations);
+    KbkLog(kLogChannel, "  no cache (compiles)   %.2f ms", uncachedMs / kIterations);
+    KbkLog(kLogChannel, "  empty cache (writes)  %.2f ms", firstLaunchMs / kIterations);
+    KbkLog(kLogChannel, "  filled cache (reads)  %.2f ms", laterLaunchMs / kIterations);
+}
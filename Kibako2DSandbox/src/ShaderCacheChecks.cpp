@@ -0,0 +1,179 @@
+#include "ShaderCacheBenchmark.h"
+
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Renderer/ShaderCache.h"
+
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace KibakoEngine;
+
+namespace {
+    constexpr const char* kLogChannel = "Sandbox.Bench";
+
+    constexpr std::string_view kVertexSource = "float4 main(float4 p : POSITION) : SV_Position { return p; }";
+    constexpr std::string_view kPixelSource = "float4 main() : SV_Target { return 1; }";
+
+    // Stands in for D3DCompile: the "bytecode" is the target, defines and
+    // source, so equal inputs give equal bytes. Source containing "#error" fails.
+    class StubShaderCompiler final : public ShaderCompiler
+    {
+    public:
+        bool Compile(const ShaderDesc& desc, std::vector<std::uint8_t>& bytecode, std::string& errors) override
+        {
+            ++compiles;
+            if (desc.source.find("#error") != std::string_view::npos) {
+                errors = "stub: #error";
+                return false;
+            }
+
+            bytecode.assign(desc.target.begin(), desc.target.end());
+            for (const ShaderDefine& define : desc.defines) {
+                bytecode.insert(bytecode.end(), define.name.begin(), define.name.end());
+                bytecode.insert(bytecode.end(), define.value.begin(), define.value.end());
+            }
+            bytecode.insert(bytecode.end(), desc.source.begin(), desc.source.end());
+            return true;
+        }
+
+        [[nodiscard]] std::string_view Version() const override { return version; }
+
+        int         compiles = 0;
+        std::string version = "stub-1";
+    };
+
+    struct Checker
+    {
+        int failures = 0;
+
+        void Expect(bool condition, const char* what)
+        {
+            if (!condition) {
+                ++failures;
+                KbkError(kLogChannel, "Shader cache check failed: %s", what);
+            }
+        }
+    };
+
+    ShaderDesc PixelDesc()
+    {
+        ShaderDesc desc;
+        desc.source = kPixelSource;
+        desc.target = "ps_5_0";
+        desc.debugName = "check PS";
+        return desc;
+    }
+
+    // Overwrites one byte past the header, or cuts the file short
+    void DamageFile(const std::filesystem::path& path, bool truncate)
+    {
+        std::error_code ec;
+        const std::uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec || size < 2)
+            return;
+
+        if (truncate) {
+            std::filesystem::resize_file(path, size / 2, ec);
+            return;
+        }
+
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(size - 1));
+        file.put('\x7f');
+    }
+}
+
+bool RunShaderCacheChecks(const std::filesystem::path& directory)
+{
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+
+    Checker check;
+    StubShaderCompiler compiler;
+    const ShaderDesc pixel = PixelDesc();
+    const std::filesystem::path pixelFile = ShaderCache(directory).FilePath(ShaderCache::MakeKey(pixel, compiler.Version()));
+
+    std::vector<std::uint8_t> expected;
+    {
+        ShaderCache cache(directory);
+        const std::vector<std::uint8_t>* bytecode = cache.Get(pixel, compiler);
+        check.Expect(bytecode && compiler.compiles == 1, "miss compiles");
+        check.Expect(std::filesystem::exists(pixelFile), "miss writes the file");
+        if (bytecode)
+            expected = *bytecode;
+
+        check.Expect(cache.Get(pixel, compiler) == bytecode && compiler.compiles == 1 && cache.Stats().memoryHits == 1,
+            "second Get is a memory hit");
+    }
+
+    {
+        ShaderCache cache(directory);
+        const std::vector<std::uint8_t>* bytecode = cache.Get(pixel, compiler);
+        check.Expect(bytecode && *bytecode == expected, "disk hit returns the stored bytecode");
+        check.Expect(compiler.compiles == 1 && cache.Stats().diskHits == 1, "disk hit does not compile");
+    }
+
+    for (const bool truncate : { false, true }) {
+        DamageFile(pixelFile, truncate);
+        const int compilesBefore = compiler.compiles;
+        {
+            ShaderCache cache(directory);
+            const std::vector<std::uint8_t>* bytecode = cache.Get(pixel, compiler);
+            check.Expect(cache.Stats().rejectedFiles == 1, truncate ? "truncated file is rejected" : "corrupt file is rejected");
+            check.Expect(bytecode && *bytecode == expected && compiler.compiles == compilesBefore + 1,
+                "rejected file is recompiled");
+        }
+        {
+            ShaderCache cache(directory);
+            (void)cache.Get(pixel, compiler);
+            check.Expect(cache.Stats().diskHits == 1 && compiler.compiles == compilesBefore + 1,
+                "recompiled file is read back");
+        }
+    }
+
+    // Anything that changes the bytecode is a different key; the debug name is not
+    {
+        ShaderCache cache(directory);
+        (void)cache.Get(pixel, compiler);
+        const int compilesBefore = compiler.compiles;
+
+        static constexpr ShaderDefine kDefines[] = { { "KBK_DISTANCE_FIELD", "1" } };
+        ShaderDesc defined = pixel;
+        defined.defines = kDefines;
+        (void)cache.Get(defined, compiler);
+        check.Expect(compiler.compiles == compilesBefore + 1, "new define is a miss");
+
+        ShaderDesc vertex = pixel;
+        vertex.source = kVertexSource;
+        vertex.target = "vs_5_0";
+        (void)cache.Get(vertex, compiler);
+        check.Expect(compiler.compiles == compilesBefore + 2, "new source is a miss");
+
+        ShaderDesc renamed = pixel;
+        renamed.debugName = "renamed PS";
+        (void)cache.Get(renamed, compiler);
+        check.Expect(compiler.compiles == compilesBefore + 2, "debug name is not part of the key");
+
+        ShaderDesc failing = pixel;
+        failing.source = "#error";
+        check.Expect(cache.Get(failing, compiler) == nullptr && cache.Stats().compileFailures == 1,
+            "compile failure returns null");
+    }
+
+    {
+        compiler.version = "stub-2";
+        const int compilesBefore = compiler.compiles;
+        ShaderCache cache(directory);
+        (void)cache.Get(pixel, compiler);
+        check.Expect(compiler.compiles == compilesBefore + 1 && cache.Stats().diskHits == 0,
+            "new compiler version is a miss");
+    }
+
+    std::filesystem::remove_all(directory, ec);
+
+    if (check.failures == 0)
+        KbkLog(kLogChannel, "Shader cache checks passed (stub compiler, %d compiles)", compiler.compiles);
+    return check.failures == 0;
+}
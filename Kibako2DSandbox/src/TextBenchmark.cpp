@@ -0,0 +1,72 @@
+#include "TextBenchmark.h"
+
+#include "KibakoEngine/Core/Log.h"
+#include "KibakoEngine/Renderer/SpriteBatch2D.h"
+#include "KibakoEngine/Text/TextRenderer2D.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace KibakoEngine;
+
+namespace {
+    constexpr const char* kLogChannel = "Sandbox.Bench";
+    constexpr int kIterations = 60;
+
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Damage-number style labels on a grid, a few colors and sizes
+    void QueueLabels(TextRenderer2D& text, std::size_t labelCount, int seed)
+    {
+        static const Color4 kColors[] = {
+            { 1.0f, 0.9f, 0.3f, 1.0f },
+            { 1.0f, 0.35f, 0.25f, 1.0f },
+            { 0.5f, 1.0f, 0.5f, 1.0f },
+        };
+
+        char buffer[16];
+        TextStyle style;
+        style.align = TextAlign::Center;
+        style.layer = 20;
+        for (std::size_t i = 0; i < labelCount; ++i) {
+            std::snprintf(buffer, sizeof(buffer), "-%d", static_cast<int>((i * 37 + static_cast<std::size_t>(seed)) % 1000));
+            style.size = 12.0f + static_cast<float>(i % 3) * 4.0f;
+            style.color = kColors[i % 3];
+            text.DrawLabel(buffer, { 20.0f + static_cast<float>(i % 80) * 16.0f, 20.0f + static_cast<float>(i / 80) * 11.0f }, style);
+        }
+    }
+}
+
+void RunTextBenchmark(TextRenderer2D& text, SpriteBatch2D& batch, std::size_t labelCount)
+{
+    // Glyphs first seen here are generated once, outside the timing
+    QueueLabels(text, labelCount, 0);
+    text.Clear();
+
+    double layoutMs = 0.0;
+    std::size_t glyphs = 0;
+    for (int i = 0; i < kIterations; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        QueueLabels(text, labelCount, i);
+        layoutMs += ElapsedMs(start);
+
+        glyphs += text.QueuedGlyphs();
+        text.Clear();
+    }
+
+    QueueLabels(text, labelCount, kIterations);
+    const auto flushStart = std::chrono::steady_clock::now();
+    text.Flush(batch);
+    const double flushMs = ElapsedMs(flushStart);
+
+    const TextRendererStats& stats = text.Stats();
+    const double frameLayoutMs = layoutMs / kIterations;
+    KbkLog(kLogChannel, "Text: %zu labels, %.0f glyphs per frame, %zu atlas pages",
+        labelCount, static_cast<double>(glyphs) / kIterations, text.Atlas().PageCount());
+    KbkLog(kLogChannel, "  layout %.3f ms/frame (%.0f labels/ms)", frameLayoutMs,
+        (frameLayoutMs > 0.0) ? static_cast<double>(labelCount) / frameLayoutMs : 0.0);
+    KbkLog(kLogChannel, "  flush  %.3f ms: %u quads in %u geometry commands", flushMs, stats.glyphs, stats.submissions);
+}
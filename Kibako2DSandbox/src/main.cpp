@@ -16,10 +16,23 @@
 #include "KibakoEngine/Core/Log.h"
 #include "GameLayer.h"
 
+#include <cstring>
+
 using namespace KibakoEngine;
 
-int main()
+int main(int argc, char** argv)
 {
+    // --record <file> captures the session, --replay <file> plays it back
+    // with a fixed 60 Hz frame delta and no vsync (reproducible benchmark)
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0)
+            recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--replay") == 0)
+            replayPath = argv[++i];
+    }
+
     Application app;
     if (!app.Init(960, 540, "KibakoEngine Sandbox")) {
         KbkError("Sandbox", "Failed to initialize Application");
@@ -37,8 +50,24 @@ int main()
         });
 #endif
 
+    bool waitForVSync = true;
+    if (replayPath) {
+        if (!app.StartInputPlayback(replayPath)) {
+            app.Shutdown();
+            return 1;
+        }
+        app.SetFixedFrameDelta(1.0 / 60.0);
+        waitForVSync = false;
+    }
+    else if (recordPath) {
+        app.StartInputRecording();
+    }
+
     const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    app.Run(clearColor, true);
+    app.Run(clearColor, waitForVSync);
+
+    if (recordPath && app.IsRecordingInput() && !app.StopInputRecording(recordPath))
+        KbkError("Sandbox", "Failed to save input recording: %s", recordPath);
 
     app.Shutdown();
     return 0;